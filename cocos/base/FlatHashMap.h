@@ -0,0 +1,137 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace cc {
+
+/**
+ * A hash map with open addressing and linear probing, for hot lookups with small keys.
+ * Entries are stored in a single array and can only be removed all at once by clear,
+ * pointers to values stay valid until the next insertion.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap final {
+public:
+    explicit FlatHashMap(size_t capacity = 16) { rehash(capacity); }
+
+    inline size_t size() const { return _size; }
+    inline bool   empty() const { return _size == 0; }
+
+    Value *find(const Key &key) {
+        for (size_t i = indexOf(key);; i = (i + 1) & _mask) {
+            auto &slot = _slots[i];
+            if (!slot.used) return nullptr;
+            if (KeyEqual()(slot.key, key)) return &slot.value;
+        }
+    }
+
+    const Value *find(const Key &key) const {
+        return const_cast<FlatHashMap *>(this)->find(key);
+    }
+
+    // Inserts the value if the key is missing, returns the value of the key and whether it was inserted.
+    std::pair<Value *, bool> insert(const Key &key, const Value &value) {
+        if ((_size + 1) * 2 > _slots.size()) {
+            rehash(_slots.size() * 2);
+        }
+        for (size_t i = indexOf(key);; i = (i + 1) & _mask) {
+            auto &slot = _slots[i];
+            if (!slot.used) {
+                slot.key   = key;
+                slot.value = value;
+                slot.used  = true;
+                ++_size;
+                return {&slot.value, true};
+            }
+            if (KeyEqual()(slot.key, key)) return {&slot.value, false};
+        }
+    }
+
+    inline Value &operator[](const Key &key) { return *insert(key, Value{}).first; }
+
+    void clear() {
+        for (auto &slot : _slots) {
+            slot = Slot{};
+        }
+        _size = 0;
+    }
+
+    template <typename Fn>
+    void forEach(Fn &&fn) {
+        for (auto &slot : _slots) {
+            if (slot.used) fn(slot.key, slot.value);
+        }
+    }
+
+private:
+    struct Slot {
+        Key   key{};
+        Value value{};
+        bool  used{false};
+    };
+
+    // Fibonacci hashing spreads keys like pointers, whose low bits are mostly zero.
+    inline size_t indexOf(const Key &key) const {
+        return static_cast<size_t>((static_cast<uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ULL) >> _shift);
+    }
+
+    void rehash(size_t capacity) {
+        size_t   newSize = 4;
+        uint32_t bits    = 2;
+        while (newSize < capacity) {
+            newSize <<= 1;
+            ++bits;
+        }
+
+        std::vector<Slot> slots(newSize);
+        std::swap(_slots, slots);
+        _mask  = newSize - 1;
+        _shift = 64 - bits;
+        _size  = 0;
+        for (auto &slot : slots) {
+            if (!slot.used) continue;
+            for (size_t i = indexOf(slot.key);; i = (i + 1) & _mask) {
+                if (!_slots[i].used) {
+                    _slots[i] = std::move(slot);
+                    ++_size;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<Slot> _slots;
+    size_t            _mask{0};
+    uint32_t          _shift{64};
+    size_t            _size{0};
+};
+
+} // namespace cc
@@ -25,6 +25,7 @@
 
 #include "MessageQueue.h"
 #include "AutoReleasePool.h"
+#include "MessageQueueProfiler.h"
 #include "base/Utils.h"
 
 namespace cc {
@@ -42,12 +43,17 @@ MessageQueue::MemoryAllocator &MessageQueue::MemoryAllocator::getInstance() noex
 uint8_t *MessageQueue::MemoryAllocator::request() noexcept {
     uint8_t *newChunk = nullptr;
 
-    if (_chunkPool.try_dequeue(newChunk)) {
+    bool const fromPool = _chunkPool.try_dequeue(newChunk);
+    if (fromPool) {
         _chunkCount.fetch_sub(1, std::memory_order_acq_rel);
     } else {
         newChunk = memoryAllocateForMultiThread<uint8_t>(MEMORY_CHUNK_SIZE);
     }
 
+#if CC_MESSAGE_QUEUE_PROFILING
+    MessageQueueProfiler::getInstance().onChunkRequested(fromPool);
+#endif
+
     return newChunk;
 }
 
@@ -115,7 +121,13 @@ void MessageQueue::kickAndWait() noexcept {
                       });
 
     kick();
+#if CC_MESSAGE_QUEUE_PROFILING
+    auto const stallBegin = MessageQueueProfiler::now();
+    event.wait();
+    MessageQueueProfiler::getInstance().onProducerStalled(stallBegin, MessageQueueProfiler::now());
+#else
     event.wait();
+#endif
 }
 
 void MessageQueue::runConsumerThread() noexcept {
@@ -227,7 +239,13 @@ void MessageQueue::executeMessages() noexcept {
         return;
     }
 
+#if CC_MESSAGE_QUEUE_PROFILING
+    auto const executeBegin = MessageQueueProfiler::now();
+    msg->execute();
+    MessageQueueProfiler::getInstance().onMessageExecuted(msg->getName(), executeBegin, MessageQueueProfiler::now());
+#else
     msg->execute();
+#endif
     msg->~Message();
 }
 
@@ -0,0 +1,171 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "MessageQueueProfiler.h"
+
+#if CC_MESSAGE_QUEUE_PROFILING
+
+    #include <algorithm>
+    #include <cstring>
+    #include <fstream>
+
+namespace cc {
+
+namespace {
+uint64_t nanoseconds(MessageQueueProfiler::TimePoint::duration duration) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+} // namespace
+
+MessageQueueProfiler &MessageQueueProfiler::getInstance() noexcept {
+    static MessageQueueProfiler instance;
+    return instance;
+}
+
+void MessageQueueProfiler::onMessageExecuted(char const *name, TimePoint begin, TimePoint end) {
+    uint64_t duration = nanoseconds(end - begin);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    RawStats &stats = _messageStats[name];
+    ++stats.count;
+    stats.totalTime += duration;
+    stats.maxTime = std::max(stats.maxTime, duration);
+
+    record(name, begin, end);
+}
+
+void MessageQueueProfiler::onProducerStalled(TimePoint begin, TimePoint end) {
+    _producerStallCount.fetch_add(1, std::memory_order_relaxed);
+    _producerStallTime.fetch_add(nanoseconds(end - begin), std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    record("ProducerStall", begin, end);
+}
+
+void MessageQueueProfiler::onChunkRequested(bool fromPool) {
+    _chunkRequestCount.fetch_add(1, std::memory_order_relaxed);
+    if (!fromPool) {
+        _chunkAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MessageQueueProfiler::markFrame() {
+    _frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MessageQueueProfiler::captureFrames(uint32_t firstFrame, uint32_t frameCount) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _traceEvents.clear();
+    _captureBegin.store(firstFrame, std::memory_order_relaxed);
+    _captureEnd.store(firstFrame + frameCount, std::memory_order_relaxed);
+}
+
+bool MessageQueueProfiler::isCapturing(uint32_t frame) const noexcept {
+    return frame >= _captureBegin.load(std::memory_order_relaxed) && frame < _captureEnd.load(std::memory_order_relaxed);
+}
+
+uint32_t MessageQueueProfiler::getThreadIndex(std::thread::id id) {
+    auto iter = _threadIndices.find(id);
+    if (iter == _threadIndices.end()) {
+        iter = _threadIndices.emplace(id, static_cast<uint32_t>(_threadIndices.size())).first;
+    }
+    return iter->second;
+}
+
+void MessageQueueProfiler::record(char const *name, TimePoint begin, TimePoint end) {
+    uint32_t frame = getFrame();
+    if (!isCapturing(frame)) return;
+
+    TraceEvent event;
+    event.name        = name;
+    event.begin       = nanoseconds(begin - _epoch);
+    event.duration    = nanoseconds(end - begin);
+    event.threadIndex = getThreadIndex(std::this_thread::get_id());
+    event.frame       = frame;
+    _traceEvents.push_back(event);
+}
+
+bool MessageQueueProfiler::dumpTrace(std::string const &path) const {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) return false;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto &event : _traceEvents) {
+        file << (first ? "\n" : ",\n");
+        first = false;
+        // complete events, timestamps in microseconds
+        file << R"({"name":")" << event.name << R"(","cat":"MessageQueue","ph":"X","pid":0,"tid":)" << event.threadIndex
+             << ",\"ts\":" << static_cast<double>(event.begin) / 1000.0
+             << ",\"dur\":" << static_cast<double>(event.duration) / 1000.0
+             << ",\"args\":{\"frame\":" << event.frame << "}}";
+    }
+    file << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    return static_cast<bool>(file);
+}
+
+std::vector<MessageQueueProfiler::MessageStats> MessageQueueProfiler::getMessageStats() const {
+    std::vector<MessageStats> result;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto &pair : _messageStats) {
+        auto iter = std::find_if(result.begin(), result.end(), [&](const MessageStats &stats) {
+            return !strcmp(stats.name.c_str(), pair.first);
+        });
+        if (iter == result.end()) {
+            result.emplace_back();
+            iter       = result.end() - 1;
+            iter->name = pair.first;
+        }
+        iter->count += pair.second.count;
+        iter->totalTime += pair.second.totalTime;
+        iter->maxTime = std::max(iter->maxTime, pair.second.maxTime);
+    }
+
+    std::sort(result.begin(), result.end(), [](const MessageStats &lhs, const MessageStats &rhs) {
+        return lhs.totalTime > rhs.totalTime;
+    });
+    return result;
+}
+
+void MessageQueueProfiler::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _messageStats.clear();
+    _traceEvents.clear();
+    _captureBegin.store(0U, std::memory_order_relaxed);
+    _captureEnd.store(0U, std::memory_order_relaxed);
+    _producerStallCount.store(0U, std::memory_order_relaxed);
+    _producerStallTime.store(0U, std::memory_order_relaxed);
+    _chunkRequestCount.store(0U, std::memory_order_relaxed);
+    _chunkAllocationCount.store(0U, std::memory_order_relaxed);
+}
+
+} // namespace cc
+
+#endif // CC_MESSAGE_QUEUE_PROFILING
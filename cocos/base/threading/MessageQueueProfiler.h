@@ -0,0 +1,124 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+// Instrumentation of MessageQueue execution. Off by default, define to 1 in the build to enable;
+// when disabled none of the hooks are compiled.
+#ifndef CC_MESSAGE_QUEUE_PROFILING
+    #define CC_MESSAGE_QUEUE_PROFILING 0
+#endif
+
+#if CC_MESSAGE_QUEUE_PROFILING
+
+    #include <atomic>
+    #include <chrono>
+    #include <cstdint>
+    #include <mutex>
+    #include <string>
+    #include <thread>
+    #include <unordered_map>
+    #include <vector>
+
+namespace cc {
+
+class MessageQueueProfiler final {
+public:
+    using Clock     = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    struct MessageStats {
+        std::string name;
+        uint32_t    count{0U};
+        uint64_t    totalTime{0U}; // in nanoseconds
+        uint64_t    maxTime{0U};   // in nanoseconds
+    };
+
+    static MessageQueueProfiler &getInstance() noexcept;
+
+    static inline TimePoint now() noexcept { return Clock::now(); }
+
+    // hooks, see MessageQueue.cpp
+    void onMessageExecuted(char const *name, TimePoint begin, TimePoint end);
+    void onProducerStalled(TimePoint begin, TimePoint end);
+    void onChunkRequested(bool fromPool);
+
+    // called by the consumer at the end of each frame
+    void markFrame();
+
+    // record trace events for frames [firstFrame, firstFrame + frameCount)
+    void captureFrames(uint32_t firstFrame, uint32_t frameCount);
+    // write the captured events in the Chrome about:tracing JSON format
+    bool dumpTrace(std::string const &path) const;
+
+    std::vector<MessageStats> getMessageStats() const;
+    inline uint32_t           getFrame() const noexcept { return _frame.load(std::memory_order_relaxed); }
+    inline uint32_t           getProducerStallCount() const noexcept { return _producerStallCount.load(std::memory_order_relaxed); }
+    inline uint64_t           getProducerStallTime() const noexcept { return _producerStallTime.load(std::memory_order_relaxed); }
+    inline uint32_t           getChunkRequestCount() const noexcept { return _chunkRequestCount.load(std::memory_order_relaxed); }
+    inline uint32_t           getChunkAllocationCount() const noexcept { return _chunkAllocationCount.load(std::memory_order_relaxed); }
+
+    void reset();
+
+private:
+    struct RawStats {
+        uint32_t count{0U};
+        uint64_t totalTime{0U};
+        uint64_t maxTime{0U};
+    };
+
+    struct TraceEvent {
+        char const *name{nullptr};
+        uint64_t    begin{0U}; // in nanoseconds since _epoch
+        uint64_t    duration{0U};
+        uint32_t    threadIndex{0U};
+        uint32_t    frame{0U};
+    };
+
+    MessageQueueProfiler() = default;
+
+    bool     isCapturing(uint32_t frame) const noexcept;
+    uint32_t getThreadIndex(std::thread::id id);
+    void     record(char const *name, TimePoint begin, TimePoint end);
+
+    TimePoint _epoch{Clock::now()};
+
+    mutable std::mutex                            _mutex;
+    std::unordered_map<char const *, RawStats>    _messageStats; // keyed by the names' addresses, merged on query
+    std::vector<TraceEvent>                       _traceEvents;
+    std::unordered_map<std::thread::id, uint32_t> _threadIndices;
+
+    std::atomic<uint32_t> _frame{0U};
+    std::atomic<uint32_t> _captureBegin{0U};
+    std::atomic<uint32_t> _captureEnd{0U};
+    std::atomic<uint32_t> _producerStallCount{0U};
+    std::atomic<uint64_t> _producerStallTime{0U}; // in nanoseconds
+    std::atomic<uint32_t> _chunkRequestCount{0U};
+    std::atomic<uint32_t> _chunkAllocationCount{0U}; // requests that missed the chunk pool
+};
+
+} // namespace cc
+
+#endif // CC_MESSAGE_QUEUE_PROFILING
@@ -6030,6 +6030,34 @@ static bool js_dragonbones_ArmatureCacheMgr_buildArmatureCache(se::State& s) //
 }
 SE_BIND_FUNC(js_dragonbones_ArmatureCacheMgr_buildArmatureCache)
 
+static bool js_dragonbones_ArmatureCacheMgr_loadArmatureCache(se::State& s) // NOLINT(readability-identifier-naming)
+{
+    auto* cobj = SE_THIS_OBJECT<dragonBones::ArmatureCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_dragonbones_ArmatureCacheMgr_loadArmatureCache : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 4) {
+        HolderType<std::string, true> arg0 = {};
+        HolderType<std::string, true> arg1 = {};
+        HolderType<std::string, true> arg2 = {};
+        HolderType<std::string, true> arg3 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        ok &= sevalue_to_native(args[2], &arg2, s.thisObject());
+        ok &= sevalue_to_native(args[3], &arg3, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_dragonbones_ArmatureCacheMgr_loadArmatureCache : Error processing arguments");
+        dragonBones::ArmatureCache* result = cobj->loadArmatureCache(arg0.value(), arg1.value(), arg2.value(), arg3.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_dragonbones_ArmatureCacheMgr_loadArmatureCache : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 4);
+    return false;
+}
+SE_BIND_FUNC(js_dragonbones_ArmatureCacheMgr_loadArmatureCache)
+
 static bool js_dragonbones_ArmatureCacheMgr_removeArmatureCache(se::State& s) // NOLINT(readability-identifier-naming)
 {
     auto* cobj = SE_THIS_OBJECT<dragonBones::ArmatureCacheMgr>(s);
@@ -6098,6 +6126,7 @@ bool js_register_dragonbones_ArmatureCacheMgr(se::Object* obj) // NOLINT(readabi
     auto* cls = se::Class::create("ArmatureCacheMgr", obj, nullptr, nullptr);
 
     cls->defineFunction("buildArmatureCache", _SE(js_dragonbones_ArmatureCacheMgr_buildArmatureCache));
+    cls->defineFunction("loadArmatureCache", _SE(js_dragonbones_ArmatureCacheMgr_loadArmatureCache));
     cls->defineFunction("removeArmatureCache", _SE(js_dragonbones_ArmatureCacheMgr_removeArmatureCache));
     cls->defineStaticFunction("getInstance", _SE(js_dragonbones_ArmatureCacheMgr_getInstance));
     cls->defineStaticFunction("destroyInstance", _SE(js_dragonbones_ArmatureCacheMgr_destroyInstance));
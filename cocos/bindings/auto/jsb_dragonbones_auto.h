@@ -388,6 +388,7 @@ bool register_all_dragonbones(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(dragonBones::ArmatureCacheMgr);
 SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_buildArmatureCache);
+SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_loadArmatureCache);
 SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_removeArmatureCache);
 SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_getInstance);
 SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_destroyInstance);
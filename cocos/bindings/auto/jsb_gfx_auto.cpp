@@ -4010,6 +4010,33 @@ static bool js_gfx_DeviceInfo_set_bindingMappingInfo(se::State& s) // NOLINT(rea
 }
 SE_BIND_PROP_SET(js_gfx_DeviceInfo_set_bindingMappingInfo)
 
+static bool js_gfx_DeviceInfo_get_framesInFlight(se::State& s) // NOLINT(readability-identifier-naming)
+{
+    auto* cobj = SE_THIS_OBJECT<cc::gfx::DeviceInfo>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_DeviceInfo_get_framesInFlight : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    se::Value jsret;
+    ok &= nativevalue_to_se(cobj->framesInFlight, jsret, s.thisObject() /*ctx*/);
+    s.rval() = jsret;
+    SE_HOLD_RETURN_VALUE(cobj->framesInFlight, s.thisObject(), s.rval());
+    return true;
+}
+SE_BIND_PROP_GET(js_gfx_DeviceInfo_get_framesInFlight)
+
+static bool js_gfx_DeviceInfo_set_framesInFlight(se::State& s) // NOLINT(readability-identifier-naming)
+{
+    const auto& args = s.args();
+    auto* cobj = SE_THIS_OBJECT<cc::gfx::DeviceInfo>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_DeviceInfo_set_framesInFlight : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    ok &= sevalue_to_native(args[0], &cobj->framesInFlight, s.thisObject());
+    SE_PRECONDITION2(ok, false, "js_gfx_DeviceInfo_set_framesInFlight : Error processing new value");
+    return true;
+}
+SE_BIND_PROP_SET(js_gfx_DeviceInfo_set_framesInFlight)
+
 
 template<>
 bool sevalue_to_native(const se::Value &from, cc::gfx::DeviceInfo * to, se::Object *ctx)
@@ -4027,6 +4054,10 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::DeviceInfo * to, se::Obje
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->bindingMappingInfo), ctx);
     }
+    json->getProperty("framesInFlight", &field);
+    if(!field.isNullOrUndefined()) {
+        ok &= sevalue_to_native(field, &(to->framesInFlight), ctx);
+    }
     return ok;
 }
 
@@ -4050,6 +4081,9 @@ static bool js_gfx_DeviceInfo_constructor(se::State& s) // NOLINT(readability-id
     if (argc > 0 && !args[0].isUndefined()) {
         ok &= sevalue_to_native(args[0], &(cobj->bindingMappingInfo), nullptr);
     }
+    if (argc > 1 && !args[1].isUndefined()) {
+        ok &= sevalue_to_native(args[1], &(cobj->framesInFlight), nullptr);
+    }
 
     if(!ok) {
         JSB_FREE(cobj);
@@ -4083,6 +4117,7 @@ bool js_register_gfx_DeviceInfo(se::Object* obj) // NOLINT(readability-identifie
     auto* cls = se::Class::create("DeviceInfo", obj, nullptr, _SE(js_gfx_DeviceInfo_constructor));
 
     cls->defineProperty("bindingMappingInfo", _SE(js_gfx_DeviceInfo_get_bindingMappingInfo), _SE(js_gfx_DeviceInfo_set_bindingMappingInfo));
+    cls->defineProperty("framesInFlight", _SE(js_gfx_DeviceInfo_get_framesInFlight), _SE(js_gfx_DeviceInfo_set_framesInFlight));
     cls->defineFinalizeFunction(_SE(js_cc_gfx_DeviceInfo_finalize));
     cls->install();
     JSBClassType::registerClass<cc::gfx::DeviceInfo>(cls);
@@ -141,6 +141,21 @@ static bool js_physics_World_emitEvents(se::State& s) // NOLINT(readability-iden
 }
 SE_BIND_FUNC(js_physics_World_emitEvents)
 
+static bool js_physics_World_fetchResults(se::State& s) // NOLINT(readability-identifier-naming)
+{
+    auto* cobj = SE_THIS_OBJECT<cc::physics::World>(s);
+    SE_PRECONDITION2(cobj, false, "js_physics_World_fetchResults : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->fetchResults();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_physics_World_fetchResults)
+
 static bool js_physics_World_getContactEventPairs(se::State& s) // NOLINT(readability-identifier-naming)
 {
     auto* cobj = SE_THIS_OBJECT<cc::physics::World>(s);
@@ -343,6 +358,25 @@ static bool js_physics_World_step(se::State& s) // NOLINT(readability-identifier
 }
 SE_BIND_FUNC(js_physics_World_step)
 
+static bool js_physics_World_stepAsync(se::State& s) // NOLINT(readability-identifier-naming)
+{
+    auto* cobj = SE_THIS_OBJECT<cc::physics::World>(s);
+    SE_PRECONDITION2(cobj, false, "js_physics_World_stepAsync : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<float, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_physics_World_stepAsync : Error processing arguments");
+        cobj->stepAsync(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_physics_World_stepAsync)
+
 static bool js_physics_World_syncSceneToPhysics(se::State& s) // NOLINT(readability-identifier-naming)
 {
     auto* cobj = SE_THIS_OBJECT<cc::physics::World>(s);
@@ -409,6 +443,7 @@ bool js_register_physics_World(se::Object* obj) // NOLINT(readability-identifier
     cls->defineFunction("createTrimesh", _SE(js_physics_World_createTrimesh));
     cls->defineFunction("destroy", _SE(js_physics_World_destroy));
     cls->defineFunction("emitEvents", _SE(js_physics_World_emitEvents));
+    cls->defineFunction("fetchResults", _SE(js_physics_World_fetchResults));
     cls->defineFunction("getContactEventPairs", _SE(js_physics_World_getContactEventPairs));
     cls->defineFunction("getTriggerEventPairs", _SE(js_physics_World_getTriggerEventPairs));
     cls->defineFunction("raycast", _SE(js_physics_World_raycast));
@@ -419,6 +454,7 @@ bool js_register_physics_World(se::Object* obj) // NOLINT(readability-identifier
     cls->defineFunction("setCollisionMatrix", _SE(js_physics_World_setCollisionMatrix));
     cls->defineFunction("setGravity", _SE(js_physics_World_setGravity));
     cls->defineFunction("step", _SE(js_physics_World_step));
+    cls->defineFunction("stepAsync", _SE(js_physics_World_stepAsync));
     cls->defineFunction("syncSceneToPhysics", _SE(js_physics_World_syncSceneToPhysics));
     cls->defineFunction("syncSceneWithCheck", _SE(js_physics_World_syncSceneWithCheck));
     cls->defineFinalizeFunction(_SE(js_cc_physics_World_finalize));
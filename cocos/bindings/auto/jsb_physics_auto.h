@@ -20,6 +20,7 @@ SE_DECLARE_FUNC(js_physics_World_createMaterial);
 SE_DECLARE_FUNC(js_physics_World_createTrimesh);
 SE_DECLARE_FUNC(js_physics_World_destroy);
 SE_DECLARE_FUNC(js_physics_World_emitEvents);
+SE_DECLARE_FUNC(js_physics_World_fetchResults);
 SE_DECLARE_FUNC(js_physics_World_getContactEventPairs);
 SE_DECLARE_FUNC(js_physics_World_getTriggerEventPairs);
 SE_DECLARE_FUNC(js_physics_World_raycast);
@@ -30,6 +31,7 @@ SE_DECLARE_FUNC(js_physics_World_setAllowSleep);
 SE_DECLARE_FUNC(js_physics_World_setCollisionMatrix);
 SE_DECLARE_FUNC(js_physics_World_setGravity);
 SE_DECLARE_FUNC(js_physics_World_step);
+SE_DECLARE_FUNC(js_physics_World_stepAsync);
 SE_DECLARE_FUNC(js_physics_World_syncSceneToPhysics);
 SE_DECLARE_FUNC(js_physics_World_syncSceneWithCheck);
 SE_DECLARE_FUNC(js_physics_World_World);
@@ -4120,6 +4120,33 @@ static bool js_scene_OctreeInfo_set_depth(se::State& s) // NOLINT(readability-id
 }
 SE_BIND_PROP_SET(js_scene_OctreeInfo_set_depth)
 
+static bool js_scene_OctreeInfo_get_linear(se::State& s) // NOLINT(readability-identifier-naming)
+{
+    auto* cobj = SE_THIS_OBJECT<cc::scene::OctreeInfo>(s);
+    SE_PRECONDITION2(cobj, false, "js_scene_OctreeInfo_get_linear : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    se::Value jsret;
+    ok &= nativevalue_to_se(cobj->linear, jsret, s.thisObject() /*ctx*/);
+    s.rval() = jsret;
+    SE_HOLD_RETURN_VALUE(cobj->linear, s.thisObject(), s.rval());
+    return true;
+}
+SE_BIND_PROP_GET(js_scene_OctreeInfo_get_linear)
+
+static bool js_scene_OctreeInfo_set_linear(se::State& s) // NOLINT(readability-identifier-naming)
+{
+    const auto& args = s.args();
+    auto* cobj = SE_THIS_OBJECT<cc::scene::OctreeInfo>(s);
+    SE_PRECONDITION2(cobj, false, "js_scene_OctreeInfo_set_linear : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    ok &= sevalue_to_native(args[0], &cobj->linear, s.thisObject());
+    SE_PRECONDITION2(ok, false, "js_scene_OctreeInfo_set_linear : Error processing new value");
+    return true;
+}
+SE_BIND_PROP_SET(js_scene_OctreeInfo_set_linear)
+
 
 template<>
 bool sevalue_to_native(const se::Value &from, cc::scene::OctreeInfo * to, se::Object *ctx)
@@ -4149,6 +4176,10 @@ bool sevalue_to_native(const se::Value &from, cc::scene::OctreeInfo * to, se::Ob
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depth), ctx);
     }
+    json->getProperty("linear", &field);
+    if(!field.isNullOrUndefined()) {
+        ok &= sevalue_to_native(field, &(to->linear), ctx);
+    }
     return ok;
 }
 
@@ -4199,6 +4230,9 @@ static bool js_scene_OctreeInfo_constructor(se::State& s) // NOLINT(readability-
     if (argc > 3 && !args[3].isUndefined()) {
         ok &= sevalue_to_native(args[3], &(cobj->depth), nullptr);
     }
+    if (argc > 4 && !args[4].isUndefined()) {
+        ok &= sevalue_to_native(args[4], &(cobj->linear), nullptr);
+    }
 
     if(!ok) {
         JSB_FREE(cobj);
@@ -4235,6 +4269,7 @@ bool js_register_scene_OctreeInfo(se::Object* obj) // NOLINT(readability-identif
     cls->defineProperty("minPos", _SE(js_scene_OctreeInfo_get_minPos), _SE(js_scene_OctreeInfo_set_minPos));
     cls->defineProperty("maxPos", _SE(js_scene_OctreeInfo_get_maxPos), _SE(js_scene_OctreeInfo_set_maxPos));
     cls->defineProperty("depth", _SE(js_scene_OctreeInfo_get_depth), _SE(js_scene_OctreeInfo_set_depth));
+    cls->defineProperty("linear", _SE(js_scene_OctreeInfo_get_linear), _SE(js_scene_OctreeInfo_set_linear));
     cls->defineFinalizeFunction(_SE(js_cc_scene_OctreeInfo_finalize));
     cls->install();
     JSBClassType::registerClass<cc::scene::OctreeInfo>(cls);
@@ -15947,6 +15947,30 @@ static bool js_spine_SkeletonCacheMgr_buildSkeletonCache(se::State& s) // NOLINT
 }
 SE_BIND_FUNC(js_spine_SkeletonCacheMgr_buildSkeletonCache)
 
+static bool js_spine_SkeletonCacheMgr_loadSkeletonCache(se::State& s) // NOLINT(readability-identifier-naming)
+{
+    auto* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_loadSkeletonCache : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<std::string, true> arg0 = {};
+        HolderType<std::string, true> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_loadSkeletonCache : Error processing arguments");
+        spine::SkeletonCache* result = cobj->loadSkeletonCache(arg0.value(), arg1.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_loadSkeletonCache : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_loadSkeletonCache)
+
 static bool js_spine_SkeletonCacheMgr_removeSkeletonCache(se::State& s) // NOLINT(readability-identifier-naming)
 {
     auto* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
@@ -16015,6 +16039,7 @@ bool js_register_spine_SkeletonCacheMgr(se::Object* obj) // NOLINT(readability-i
     auto* cls = se::Class::create("SkeletonCacheMgr", obj, nullptr, nullptr);
 
     cls->defineFunction("buildSkeletonCache", _SE(js_spine_SkeletonCacheMgr_buildSkeletonCache));
+    cls->defineFunction("loadSkeletonCache", _SE(js_spine_SkeletonCacheMgr_loadSkeletonCache));
     cls->defineFunction("removeSkeletonCache", _SE(js_spine_SkeletonCacheMgr_removeSkeletonCache));
     cls->defineStaticFunction("getInstance", _SE(js_spine_SkeletonCacheMgr_getInstance));
     cls->defineStaticFunction("destroyInstance", _SE(js_spine_SkeletonCacheMgr_destroyInstance));
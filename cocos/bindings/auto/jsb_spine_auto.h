@@ -1136,6 +1136,7 @@ bool register_all_spine(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(spine::SkeletonCacheMgr);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_buildSkeletonCache);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_loadSkeletonCache);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_removeSkeletonCache);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_getInstance);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_destroyInstance);
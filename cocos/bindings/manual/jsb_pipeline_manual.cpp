@@ -49,15 +49,22 @@ static bool js_pipeline_RenderPipeline_getMacros(se::State &s) {
 }
 SE_BIND_PROP_GET(js_pipeline_RenderPipeline_getMacros)
 
+// returns nullptr if the value is not an object bound to a native object
+template <typename T>
+static T *getNativeObject(const se::Value &value) {
+    return value.isObject() ? static_cast<T *>(value.toObject()->getPrivateData()) : nullptr;
+}
+
 static bool JSB_getOrCreatePipelineState(se::State &s) {
     const auto &args = s.args();
     size_t      argc = args.size();
     if (argc == 4) {
-        auto *pass           = static_cast<cc::scene::Pass *>(args[0].toObject()->getPrivateData());
-        auto *shader         = static_cast<cc::gfx::Shader *>(args[1].toObject()->getPrivateData());
-        auto *renderPass     = static_cast<cc::gfx::RenderPass *>(args[2].toObject()->getPrivateData());
-        auto *inputAssembler = static_cast<cc::gfx::InputAssembler *>(args[3].toObject()->getPrivateData());
-        auto *pipelineState  = cc::pipeline::PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
+        auto *pass           = getNativeObject<cc::scene::Pass>(args[0]);
+        auto *shader         = getNativeObject<cc::gfx::Shader>(args[1]);
+        auto *renderPass     = getNativeObject<cc::gfx::RenderPass>(args[2]);
+        auto *inputAssembler = getNativeObject<cc::gfx::InputAssembler>(args[3]);
+        SE_PRECONDITION2(pass && shader && renderPass && inputAssembler, false, "JSB_getOrCreatePipelineState : Invalid Native Object.");
+        auto *pipelineState = cc::pipeline::PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
         native_ptr_to_seval<cc::gfx::PipelineState>(pipelineState, &s.rval());
         return true;
     }
@@ -66,6 +73,74 @@ static bool JSB_getOrCreatePipelineState(se::State &s) {
 }
 SE_BIND_FUNC(JSB_getOrCreatePipelineState);
 
+// warmUp([[pass, shader, renderPass, inputAssembler, subpass?], ...])
+static bool JSB_warmUpPipelineStates(se::State &s) {
+    const auto &args = s.args();
+    size_t      argc = args.size();
+    if (argc == 1) {
+        SE_PRECONDITION2(args[0].isObject() && args[0].toObject()->isArray(), false, "JSB_warmUpPipelineStates : Error processing arguments.");
+        se::Object *infoList = args[0].toObject();
+        uint32_t    length   = 0;
+        infoList->getArrayLength(&length);
+
+        cc::vector<cc::pipeline::PipelineStateWarmUpInfo> infos;
+        infos.reserve(length);
+        se::Value element;
+        se::Value field;
+        for (uint32_t i = 0; i < length; ++i) {
+            if (!infoList->getArrayElement(i, &element) || !element.isObject() || !element.toObject()->isArray()) continue;
+            se::Object *                          entry = element.toObject();
+            cc::pipeline::PipelineStateWarmUpInfo info;
+            if (entry->getArrayElement(0, &field)) info.pass = getNativeObject<cc::scene::Pass>(field);
+            if (entry->getArrayElement(1, &field)) info.shader = getNativeObject<cc::gfx::Shader>(field);
+            if (entry->getArrayElement(2, &field)) info.renderPass = getNativeObject<cc::gfx::RenderPass>(field);
+            if (entry->getArrayElement(3, &field)) info.inputAssembler = getNativeObject<cc::gfx::InputAssembler>(field);
+            if (entry->getArrayElement(4, &field) && field.isNumber()) {
+                info.subpass = field.toUint32();
+            }
+            // skip the entries with missing or destroyed native objects
+            if (!info.pass || !info.shader || !info.renderPass || !info.inputAssembler) {
+                SE_LOGE("JSB_warmUpPipelineStates : Invalid Native Object in entry %u, skipped.\n", i);
+                continue;
+            }
+            infos.emplace_back(info);
+        }
+        cc::pipeline::PipelineStateManager::warmUp(infos);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_warmUpPipelineStates);
+
+// setCapacity(capacity), 0 keeps every pipeline state alive
+static bool JSB_setPipelineStateCapacity(se::State &s) {
+    const auto &args = s.args();
+    size_t      argc = args.size();
+    if (argc == 1) {
+        uint32_t capacity = 0;
+        bool     ok       = seval_to_uint32(args[0], &capacity);
+        SE_PRECONDITION2(ok, false, "JSB_setPipelineStateCapacity : Error processing arguments.");
+        cc::pipeline::PipelineStateManager::setCapacity(capacity);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_setPipelineStateCapacity);
+
+static bool JSB_getPipelineStateCapacity(se::State &s) {
+    const auto &args = s.args();
+    size_t      argc = args.size();
+    if (argc == 0) {
+        s.rval().setUint32(cc::pipeline::PipelineStateManager::getCapacity());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_getPipelineStateCapacity);
+
 bool register_all_pipeline_manual(se::Object *obj) {
     // Get the ns
     se::Value nrVal;
@@ -81,6 +156,9 @@ bool register_all_pipeline_manual(se::Object *obj) {
     psmVal.setObject(jsobj);
     nr->setProperty("PipelineStateManager", psmVal);
     psmVal.toObject()->defineFunction("getOrCreatePipelineState", _SE(JSB_getOrCreatePipelineState));
+    psmVal.toObject()->defineFunction("warmUp", _SE(JSB_warmUpPipelineStates));
+    psmVal.toObject()->defineFunction("setCapacity", _SE(JSB_setPipelineStateCapacity));
+    psmVal.toObject()->defineFunction("getCapacity", _SE(JSB_getPipelineStateCapacity));
 
     __jsb_cc_pipeline_RenderPipeline_proto->defineProperty("macros", _SE(js_pipeline_RenderPipeline_getMacros), nullptr);
     return true;
@@ -1,18 +1,19 @@
 
+#include <cstring>
 #include "bindings/auto/jsb_scene_auto.h"
 #include "jsb_scene_manual.h"
+#include "scene/Camera.h"
+#include "scene/CommandStream.h"
+#include "scene/Define.h"
+#include "scene/DirectionalLight.h"
 #include "scene/Model.h"
 #include "scene/Node.h"
+#include "scene/SphereLight.h"
+#include "scene/SpotLight.h"
 
 namespace {
 
-template <class T>
-struct alignas(uint32_t) AlignedPtr {
-    char _data[8];
-    T *  get() {
-        return reinterpret_cast<T *>(static_cast<uintptr_t>(*reinterpret_cast<uint64_t *>(this)));
-    }
-};
+using cc::scene::AlignedPtr;
 
 void fastSetFlag(void *buffer) {
     struct Heap {
@@ -107,6 +108,141 @@ void fastSetPassDescriptorSet(void *buffer) {
     heap->selfPtr.get()->setDescriptorSet(heap->dsPtr.get());
 }
 
+namespace cmd = cc::scene::command;
+
+void runNodeLocalTRS(const cmd::NodeLocalTRS *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto &e    = elements[i];
+        auto *      node = e.node.get();
+        node->setLocalPosition(e.position[0], e.position[1], e.position[2]);
+        node->setLocalRotation(e.rotation[0], e.rotation[1], e.rotation[2], e.rotation[3]);
+        node->setLocalScale(cc::Vec3(e.scale));
+        node->invalidateChildren(cc::scene::TransformBit::TRS);
+    }
+}
+
+void runNodeWorldMatrix(const cmd::NodeWorldMatrix *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        elements[i].node.get()->setWorldMatrix(cc::Mat4(elements[i].matrix));
+    }
+}
+
+void runNodeLayer(const cmd::NodeLayer *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        elements[i].node.get()->setLayer(elements[i].layer);
+    }
+}
+
+void runModelEnabled(const cmd::ModelEnabled *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        elements[i].model.get()->setEnabled(elements[i].enabled != 0);
+    }
+}
+
+void runModelShadows(const cmd::ModelShadows *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        auto *model = elements[i].model.get();
+        model->setCastShadow(elements[i].castShadow != 0);
+        model->setReceiveShadow(elements[i].receiveShadow != 0);
+    }
+}
+
+void runModelInstMatWorldIdx(const cmd::ModelInstMatWorldIdx *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        elements[i].model.get()->setInstMatWorldIdx(elements[i].index);
+    }
+}
+
+void runModelTransform(const cmd::ModelTransform *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        auto *model = elements[i].model.get();
+        model->setNode(elements[i].node.get());
+        model->setTransform(elements[i].transform.get());
+    }
+}
+
+void runCameraView(const cmd::CameraView *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto &e      = elements[i];
+        auto *      camera = e.camera.get();
+        camera->width        = e.width;
+        camera->height       = e.height;
+        camera->nearClip     = e.nearClip;
+        camera->farClip      = e.farClip;
+        camera->clearFlag    = e.clearFlag;
+        camera->clearStencil = e.clearStencil;
+        camera->visibility   = e.visibility;
+        camera->exposure     = e.exposure;
+        camera->clearDepth   = e.clearDepth;
+        camera->fov          = e.fov;
+        camera->aspect       = e.aspect;
+        camera->viewPort.set(e.viewPort[0], e.viewPort[1], e.viewPort[2], e.viewPort[3]);
+        camera->clearColor = {e.clearColor[0], e.clearColor[1], e.clearColor[2], e.clearColor[3]};
+        camera->forward.set(e.forward);
+        camera->position.set(e.position);
+    }
+}
+
+void runCameraMatrices(const cmd::CameraMatrices *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto &e      = elements[i];
+        auto *      camera = e.camera.get();
+        camera->matView.set(e.matView);
+        camera->matViewProj.set(e.matViewProj);
+        camera->matViewProjInv.set(e.matViewProjInv);
+        camera->matProj.set(e.matProj);
+        camera->matProjInv.set(e.matProjInv);
+    }
+}
+
+void runLightColor(const cmd::LightColor *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto &e     = elements[i];
+        auto *      light = e.light.get();
+        light->setColor(cc::Vec3(e.color));
+        light->setColorTemperatureRGB(cc::Vec3(e.colorTemperatureRGB));
+        light->setUseColorTemperature(e.useColorTemperature != 0);
+        light->setBaked(e.baked != 0);
+    }
+}
+
+void runSphereLight(const cmd::SphereLightState *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto &e     = elements[i];
+        auto *      light = e.light.get();
+        light->setPosition(cc::Vec3(e.position));
+        light->setSize(e.size);
+        light->setRange(e.range);
+        light->setLuminanceHDR(e.luminanceHDR);
+        light->setLuminanceLDR(e.luminanceLDR);
+    }
+}
+
+void runSpotLight(const cmd::SpotLightState *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto &e     = elements[i];
+        auto *      light = e.light.get();
+        light->setPosition(cc::Vec3(e.position));
+        light->setDirection(cc::Vec3(e.direction));
+        light->setSize(e.size);
+        light->setRange(e.range);
+        light->setAngle(e.angle);
+        light->setAspect(e.aspect);
+        light->setLuminanceHDR(e.luminanceHDR);
+        light->setLuminanceLDR(e.luminanceLDR);
+    }
+}
+
+void runDirectionalLight(const cmd::DirectionalLightState *elements, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto &e     = elements[i];
+        auto *      light = e.light.get();
+        light->setDirection(cc::Vec3(e.direction));
+        light->setIlluminanceHDR(e.illuminanceHDR);
+        light->setIlluminanceLDR(e.illuminanceLDR);
+    }
+}
+
 template <typename F>
 uint64_t convertPtr(F *in) {
     return static_cast<uint64_t>(reinterpret_cast<intptr_t>(in));
@@ -118,6 +254,13 @@ constexpr size_t       BUFFER_SIZE{1 * 1024 * 1024}; // 1MB;
 se::Object *           msgQueueInfo{nullptr};
 uint32_t *             msgInfoPtr{nullptr};
 std::vector<uint8_t *> msgQueuePtrs;
+
+cc::scene::CommandStream commandStream;
+se::Object *             commandStreamObj{nullptr};
+uint8_t *                commandStreamPtr{nullptr};
+uint32_t                 commandStreamSize{0};
+constexpr uint32_t       COMMAND_STREAM_INITIAL_SIZE{64 * 1024};   // 64KB
+constexpr uint32_t       COMMAND_STREAM_MAX_SIZE{64 * 1024 * 1024}; // 64MB
 } // namespace
 
 /**
@@ -125,6 +268,10 @@ std::vector<uint8_t *> msgQueuePtrs;
  *  which sync data to native objects.
  */
 void jsbFlushFastMQ() {
+    if (commandStreamPtr) {
+        commandStream.execute(commandStreamPtr, commandStreamSize);
+    }
+
     if (!mqInitialized || !msgInfoPtr || msgInfoPtr[1] == 0) {
         return;
     }
@@ -200,6 +347,93 @@ void registerPassFunction(se::Object *cls) {
     jsObj->setProperty("fnTable", se::Value(fnTable));
 }
 
+static bool js_scene_fastCS_grow(se::State &s) { // NOLINT(readability-identifier-naming)
+    const auto &args = s.args();
+    if (args.size() != 1 || !args[0].isNumber()) {
+        SE_REPORT_ERROR("__fastCS__.grow : wrong number of arguments: %d, was expecting %d", (int)args.size(), 1);
+        return false;
+    }
+    const uint32_t minSize = args[0].toUint32();
+    uint32_t       size    = commandStreamSize;
+    while (size < minSize && size < COMMAND_STREAM_MAX_SIZE) {
+        size *= 2;
+    }
+    if (size < minSize) {
+        SE_REPORT_ERROR("__fastCS__.grow : %u bytes exceed the limit of %u", minSize, COMMAND_STREAM_MAX_SIZE);
+        return false;
+    }
+
+    se::Value bufferVal;
+    if (size > commandStreamSize) {
+        // keep the commands written so far, the old buffer is released by JS
+        se::HandleObject arrayBuffer(se::Object::createArrayBufferObject(nullptr, size));
+        uint8_t *        data{nullptr};
+        arrayBuffer->getArrayBufferData(&data, nullptr);
+        memcpy(data, commandStreamPtr, reinterpret_cast<cc::scene::CommandStream::StreamHeader *>(commandStreamPtr)->size);
+        commandStreamPtr  = data;
+        commandStreamSize = size;
+        bufferVal.setObject(arrayBuffer);
+        commandStreamObj->setProperty("buffer", bufferVal);
+    } else {
+        commandStreamObj->getProperty("buffer", &bufferVal);
+    }
+    s.rval() = bufferVal;
+    return true;
+}
+SE_BIND_FUNC(js_scene_fastCS_grow)
+
+static bool js_scene_fastCS_flush(se::State &s) { // NOLINT(readability-identifier-naming)
+    s.rval().setBoolean(commandStream.execute(commandStreamPtr, commandStreamSize));
+    return true;
+}
+SE_BIND_FUNC(js_scene_fastCS_flush)
+
+void registerCommandStream() {
+    using cc::scene::SceneCommand;
+    commandStream.registerCommand<cmd::NodeLocalTRS, runNodeLocalTRS>(SceneCommand::NODE_LOCAL_TRS);
+    commandStream.registerCommand<cmd::NodeWorldMatrix, runNodeWorldMatrix>(SceneCommand::NODE_WORLD_MATRIX);
+    commandStream.registerCommand<cmd::NodeLayer, runNodeLayer>(SceneCommand::NODE_LAYER);
+    commandStream.registerCommand<cmd::ModelEnabled, runModelEnabled>(SceneCommand::MODEL_ENABLED);
+    commandStream.registerCommand<cmd::ModelShadows, runModelShadows>(SceneCommand::MODEL_SHADOWS);
+    commandStream.registerCommand<cmd::ModelInstMatWorldIdx, runModelInstMatWorldIdx>(SceneCommand::MODEL_INST_MAT_WORLD_IDX);
+    commandStream.registerCommand<cmd::ModelTransform, runModelTransform>(SceneCommand::MODEL_TRANSFORM);
+    commandStream.registerCommand<cmd::CameraView, runCameraView>(SceneCommand::CAMERA_VIEW);
+    commandStream.registerCommand<cmd::CameraMatrices, runCameraMatrices>(SceneCommand::CAMERA_MATRICES);
+    commandStream.registerCommand<cmd::LightColor, runLightColor>(SceneCommand::LIGHT_COLOR);
+    commandStream.registerCommand<cmd::SphereLightState, runSphereLight>(SceneCommand::SPHERE_LIGHT);
+    commandStream.registerCommand<cmd::SpotLightState, runSpotLight>(SceneCommand::SPOT_LIGHT);
+    commandStream.registerCommand<cmd::DirectionalLightState, runDirectionalLight>(SceneCommand::DIRECTIONAL_LIGHT);
+
+    // __fastCS__ = { version, buffer, commands: { NAME: id }, grow(minBytes), flush() }
+    se::HandleObject arrayBuffer(se::Object::createArrayBufferObject(nullptr, COMMAND_STREAM_INITIAL_SIZE));
+    arrayBuffer->getArrayBufferData(&commandStreamPtr, nullptr);
+    commandStreamSize = COMMAND_STREAM_INITIAL_SIZE;
+    cc::scene::CommandStream::resetBuffer(commandStreamPtr);
+
+    se::HandleObject commands(se::Object::createPlainObject());
+    commands->setProperty("NODE_LOCAL_TRS", se::Value(static_cast<uint32_t>(SceneCommand::NODE_LOCAL_TRS)));
+    commands->setProperty("NODE_WORLD_MATRIX", se::Value(static_cast<uint32_t>(SceneCommand::NODE_WORLD_MATRIX)));
+    commands->setProperty("NODE_LAYER", se::Value(static_cast<uint32_t>(SceneCommand::NODE_LAYER)));
+    commands->setProperty("MODEL_ENABLED", se::Value(static_cast<uint32_t>(SceneCommand::MODEL_ENABLED)));
+    commands->setProperty("MODEL_SHADOWS", se::Value(static_cast<uint32_t>(SceneCommand::MODEL_SHADOWS)));
+    commands->setProperty("MODEL_INST_MAT_WORLD_IDX", se::Value(static_cast<uint32_t>(SceneCommand::MODEL_INST_MAT_WORLD_IDX)));
+    commands->setProperty("MODEL_TRANSFORM", se::Value(static_cast<uint32_t>(SceneCommand::MODEL_TRANSFORM)));
+    commands->setProperty("CAMERA_VIEW", se::Value(static_cast<uint32_t>(SceneCommand::CAMERA_VIEW)));
+    commands->setProperty("CAMERA_MATRICES", se::Value(static_cast<uint32_t>(SceneCommand::CAMERA_MATRICES)));
+    commands->setProperty("LIGHT_COLOR", se::Value(static_cast<uint32_t>(SceneCommand::LIGHT_COLOR)));
+    commands->setProperty("SPHERE_LIGHT", se::Value(static_cast<uint32_t>(SceneCommand::SPHERE_LIGHT)));
+    commands->setProperty("SPOT_LIGHT", se::Value(static_cast<uint32_t>(SceneCommand::SPOT_LIGHT)));
+    commands->setProperty("DIRECTIONAL_LIGHT", se::Value(static_cast<uint32_t>(SceneCommand::DIRECTIONAL_LIGHT)));
+
+    commandStreamObj = se::Object::createPlainObject();
+    commandStreamObj->setProperty("version", se::Value(cc::scene::CommandStream::VERSION));
+    commandStreamObj->setProperty("buffer", se::Value(arrayBuffer));
+    commandStreamObj->setProperty("commands", se::Value(commands));
+    commandStreamObj->defineFunction("grow", _SE(js_scene_fastCS_grow));
+    commandStreamObj->defineFunction("flush", _SE(js_scene_fastCS_flush));
+    globalThis->setProperty("__fastCS__", se::Value(commandStreamObj));
+}
+
 bool register_all_scene_ext_manual(se::Object *obj) { //NOLINT
     // allocate global message queue
 
@@ -227,6 +461,8 @@ bool register_all_scene_ext_manual(se::Object *obj) { //NOLINT
 
     mqInitialized = true;
 
+    registerCommandStream();
+
     // register function table, serialize to queue
     se::Object *nsObj{nullptr};
 
@@ -0,0 +1,477 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "BakedCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MIDDLEWARE_BEGIN
+
+namespace {
+const uint32_t QUANTIZED_MAX = 65535;
+
+inline uint32_t align4(std::size_t size) {
+    return static_cast<uint32_t>((size + 3) & ~static_cast<std::size_t>(3));
+}
+
+std::size_t hashBytes(const uint8_t *bytes, std::size_t size) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<std::size_t>(hash);
+}
+
+inline bool inRange(uint64_t offset, uint64_t size, uint64_t limit) {
+    return offset <= limit && size <= limit - offset;
+}
+
+template <typename T>
+void copyRecords(std::vector<uint8_t> &out, uint32_t offset, const T *records, std::size_t count) {
+    if (count > 0) {
+        memcpy(out.data() + offset, records, count * sizeof(T));
+    }
+}
+} // namespace
+
+BakedCacheWriter::BakedCacheWriter(uint32_t vertexFloats, float colorDivisor, bool quantize)
+: _vertexFloats(vertexFloats),
+  _colorDivisor(colorDivisor),
+  _quantize(quantize) {
+}
+
+uint32_t BakedCacheWriter::addString(const std::string &value, BakedCacheFormat::StringRecord &record) {
+    record.offset = static_cast<uint32_t>(_strings.size());
+    record.length = static_cast<uint32_t>(value.size());
+    _strings += value;
+    return record.offset;
+}
+
+uint32_t BakedCacheWriter::addTexture(const std::string &key) {
+    auto it = _textureIndices.find(key);
+    if (it != _textureIndices.end()) {
+        return it->second;
+    }
+    auto index = static_cast<uint32_t>(_textures.size());
+    BakedCacheFormat::StringRecord record;
+    addString(key, record);
+    _textures.push_back(record);
+    _textureIndices[key] = index;
+    return index;
+}
+
+void BakedCacheWriter::beginAnimation(const std::string &name, bool isComplete, float totalTime) {
+    BakedCacheFormat::AnimationRecord animation;
+    addString(name, animation.name);
+    animation.firstFrame = static_cast<uint32_t>(_frames.size());
+    animation.frameCount = 0;
+    animation.isComplete = isComplete ? 1 : 0;
+    animation.totalTime = totalTime;
+    _animations.push_back(animation);
+}
+
+void BakedCacheWriter::beginFrame() {
+    BakedCacheFormat::FrameRecord frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.firstBone = static_cast<uint32_t>(_bones.size() / BakedCacheFormat::BONE_FLOATS);
+    frame.firstColor = static_cast<uint32_t>(_colors.size());
+    frame.firstSegment = static_cast<uint32_t>(_segments.size());
+    _frames.push_back(frame);
+    _animations.back().frameCount++;
+}
+
+void BakedCacheWriter::addBone(const float *matrix) {
+    _bones.push_back(matrix[0]);
+    _bones.push_back(matrix[1]);
+    _bones.push_back(matrix[4]);
+    _bones.push_back(matrix[5]);
+    _bones.push_back(matrix[12]);
+    _bones.push_back(matrix[13]);
+    _frames.back().boneCount++;
+}
+
+void BakedCacheWriter::addColor(const float *finalColor, const float *darkColor, uint32_t vertexFloatOffset) {
+    BakedCacheFormat::ColorRecord color;
+    memcpy(color.finalColor, finalColor, sizeof(color.finalColor));
+    if (darkColor) {
+        memcpy(color.darkColor, darkColor, sizeof(color.darkColor));
+    } else {
+        memset(color.darkColor, 0, sizeof(color.darkColor));
+    }
+    color.vertexFloatOffset = vertexFloatOffset;
+    _colors.push_back(color);
+    _frames.back().colorCount++;
+}
+
+void BakedCacheWriter::addSegment(uint32_t texture, uint32_t blendMode, uint32_t indexCount, uint32_t vertexFloatCount) {
+    BakedCacheFormat::SegmentRecord segment;
+    segment.texture = texture;
+    segment.blendMode = blendMode;
+    segment.indexCount = indexCount;
+    segment.vertexFloatCount = vertexFloatCount;
+    _segments.push_back(segment);
+    _frames.back().segmentCount++;
+}
+
+void BakedCacheWriter::quantizeVertices(BakedCacheFormat::FrameRecord &frame, const float *vertices, uint32_t vertexCount) {
+    float minValues[4] = {0.F, 0.F, 0.F, 0.F};
+    float maxValues[4] = {0.F, 0.F, 0.F, 0.F};
+    // x, y, u, v
+    const uint32_t components[4] = {0, 1, 3, 4};
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        const float *vertex = vertices + i * _vertexFloats;
+        for (uint32_t c = 0; c < 4; ++c) {
+            float value = vertex[components[c]];
+            minValues[c] = i == 0 ? value : std::min(minValues[c], value);
+            maxValues[c] = i == 0 ? value : std::max(maxValues[c], value);
+        }
+    }
+
+    float scales[4];
+    for (uint32_t c = 0; c < 4; ++c) {
+        scales[c] = (maxValues[c] - minValues[c]) / static_cast<float>(QUANTIZED_MAX);
+    }
+    frame.positionMin[0] = minValues[0];
+    frame.positionMin[1] = minValues[1];
+    frame.positionScale[0] = scales[0];
+    frame.positionScale[1] = scales[1];
+    frame.uvMin[0] = minValues[2];
+    frame.uvMin[1] = minValues[3];
+    frame.uvScale[0] = scales[2];
+    frame.uvScale[1] = scales[3];
+
+    std::size_t offset = _vertices.size();
+    _vertices.resize(offset + vertexCount * BakedCacheFormat::QUANTIZED_VERTEX_BYTES);
+    auto *dst = reinterpret_cast<uint16_t *>(_vertices.data() + offset);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        const float *vertex = vertices + i * _vertexFloats;
+        for (uint32_t c = 0; c < 4; ++c) {
+            float q = scales[c] > 0.F ? std::round((vertex[components[c]] - minValues[c]) / scales[c]) : 0.F;
+            *dst++ = static_cast<uint16_t>(std::min(std::max(q, 0.F), static_cast<float>(QUANTIZED_MAX)));
+        }
+    }
+}
+
+void BakedCacheWriter::endFrame(const uint8_t *vertices, std::size_t vertexBytes, const uint8_t *indices, std::size_t indexBytes) {
+    auto &frame = _frames.back();
+
+    frame.vertexOffset = static_cast<uint32_t>(_vertices.size());
+    frame.vertexBytes = static_cast<uint32_t>(vertexBytes);
+    if (_quantize) {
+        auto vertexCount = static_cast<uint32_t>(vertexBytes / (_vertexFloats * sizeof(float)));
+        quantizeVertices(frame, reinterpret_cast<const float *>(vertices), vertexCount);
+    } else if (vertexBytes > 0) {
+        _vertices.insert(_vertices.end(), vertices, vertices + vertexBytes);
+    }
+    frame.vertexSize = static_cast<uint32_t>(_vertices.size()) - frame.vertexOffset;
+
+    frame.indexBytes = static_cast<uint32_t>(indexBytes);
+    frame.indexOffset = 0;
+    if (indexBytes == 0) return;
+
+    // frames with the same geometry share one index block
+    auto hash = hashBytes(indices, indexBytes);
+    auto &offsets = _indexBlocks[hash];
+    for (auto offset : offsets) {
+        if (offset + indexBytes <= _indices.size() && memcmp(_indices.data() + offset, indices, indexBytes) == 0) {
+            frame.indexOffset = offset;
+            return;
+        }
+    }
+    frame.indexOffset = static_cast<uint32_t>(_indices.size());
+    offsets.push_back(frame.indexOffset);
+    _indices.insert(_indices.end(), indices, indices + indexBytes);
+    _indices.resize(align4(_indices.size()), 0);
+}
+
+std::vector<uint8_t> BakedCacheWriter::serialize() const {
+    BakedCacheFormat::Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = BakedCacheFormat::MAGIC;
+    header.version = BakedCacheFormat::VERSION;
+    header.flags = _quantize ? BakedCacheFormat::QUANTIZED : 0;
+    header.vertexFloats = _vertexFloats;
+    header.colorDivisor = _colorDivisor;
+    header.animationCount = static_cast<uint32_t>(_animations.size());
+    header.frameCount = static_cast<uint32_t>(_frames.size());
+    header.textureCount = static_cast<uint32_t>(_textures.size());
+    header.boneCount = static_cast<uint32_t>(_bones.size() / BakedCacheFormat::BONE_FLOATS);
+    header.colorCount = static_cast<uint32_t>(_colors.size());
+    header.segmentCount = static_cast<uint32_t>(_segments.size());
+
+    uint32_t offset = align4(sizeof(header));
+    header.animationsOffset = offset;
+    offset += align4(_animations.size() * sizeof(BakedCacheFormat::AnimationRecord));
+    header.framesOffset = offset;
+    offset += align4(_frames.size() * sizeof(BakedCacheFormat::FrameRecord));
+    header.texturesOffset = offset;
+    offset += align4(_textures.size() * sizeof(BakedCacheFormat::StringRecord));
+    header.bonesOffset = offset;
+    offset += align4(_bones.size() * sizeof(float));
+    header.colorsOffset = offset;
+    offset += align4(_colors.size() * sizeof(BakedCacheFormat::ColorRecord));
+    header.segmentsOffset = offset;
+    offset += align4(_segments.size() * sizeof(BakedCacheFormat::SegmentRecord));
+    header.verticesOffset = offset;
+    header.verticesSize = static_cast<uint32_t>(_vertices.size());
+    offset += align4(_vertices.size());
+    header.indicesOffset = offset;
+    header.indicesSize = static_cast<uint32_t>(_indices.size());
+    offset += align4(_indices.size());
+    header.stringsOffset = offset;
+    header.stringsSize = static_cast<uint32_t>(_strings.size());
+    offset += align4(_strings.size());
+
+    std::vector<uint8_t> out(offset, 0);
+    memcpy(out.data(), &header, sizeof(header));
+    copyRecords(out, header.animationsOffset, _animations.data(), _animations.size());
+    copyRecords(out, header.framesOffset, _frames.data(), _frames.size());
+    copyRecords(out, header.texturesOffset, _textures.data(), _textures.size());
+    copyRecords(out, header.bonesOffset, _bones.data(), _bones.size());
+    copyRecords(out, header.colorsOffset, _colors.data(), _colors.size());
+    copyRecords(out, header.segmentsOffset, _segments.data(), _segments.size());
+    copyRecords(out, header.verticesOffset, _vertices.data(), _vertices.size());
+    copyRecords(out, header.indicesOffset, _indices.data(), _indices.size());
+    copyRecords(out, header.stringsOffset, _strings.data(), _strings.size());
+    return out;
+}
+
+bool BakedCacheWriter::save(const std::string &fullPath) const {
+    auto content = serialize();
+    FILE *fp = fopen(fullPath.c_str(), "wb");
+    if (!fp) return false;
+    auto written = fwrite(content.data(), 1, content.size(), fp);
+    fclose(fp);
+    return written == content.size();
+}
+
+BakedCacheFile *BakedCacheFile::openMapped(const std::string &fullPath) {
+    void *mapping = nullptr;
+    std::size_t size = 0;
+
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    HANDLE file = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (fileMapping) {
+            mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+            size = static_cast<std::size_t>(fileSize.QuadPart);
+            // the view keeps the mapping alive
+            CloseHandle(fileMapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        mapping = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+        }
+        size = static_cast<std::size_t>(st.st_size);
+    }
+    close(fd);
+#endif
+
+    if (!mapping) return nullptr;
+
+    auto *file = new BakedCacheFile();
+    file->_mapping = mapping;
+    if (!file->init(static_cast<const uint8_t *>(mapping), size)) {
+        delete file;
+        return nullptr;
+    }
+    return file;
+}
+
+BakedCacheFile *BakedCacheFile::createWithData(const uint8_t *data, std::size_t size) {
+    auto *file = new BakedCacheFile();
+    file->_content.assign(data, data + size);
+    if (!file->init(file->_content.data(), file->_content.size())) {
+        delete file;
+        return nullptr;
+    }
+    return file;
+}
+
+BakedCacheFile::~BakedCacheFile() {
+    if (_mapping) {
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+        UnmapViewOfFile(_mapping);
+#else
+        munmap(_mapping, _size);
+#endif
+        _mapping = nullptr;
+    }
+}
+
+bool BakedCacheFile::init(const uint8_t *data, std::size_t size) {
+    _data = data;
+    _size = size;
+    if (size < sizeof(BakedCacheFormat::Header)) return false;
+
+    const auto &header = *reinterpret_cast<const BakedCacheFormat::Header *>(data);
+    if (header.magic != BakedCacheFormat::MAGIC || header.version != BakedCacheFormat::VERSION) return false;
+    if (header.vertexFloats != 9 && header.vertexFloats != 13) return false;
+
+    auto sectionValid = [&](uint32_t offset, uint64_t bytes) {
+        return offset % 4 == 0 && inRange(offset, bytes, size);
+    };
+    if (!sectionValid(header.animationsOffset, uint64_t(header.animationCount) * sizeof(BakedCacheFormat::AnimationRecord)) ||
+        !sectionValid(header.framesOffset, uint64_t(header.frameCount) * sizeof(BakedCacheFormat::FrameRecord)) ||
+        !sectionValid(header.texturesOffset, uint64_t(header.textureCount) * sizeof(BakedCacheFormat::StringRecord)) ||
+        !sectionValid(header.bonesOffset, uint64_t(header.boneCount) * BakedCacheFormat::BONE_FLOATS * sizeof(float)) ||
+        !sectionValid(header.colorsOffset, uint64_t(header.colorCount) * sizeof(BakedCacheFormat::ColorRecord)) ||
+        !sectionValid(header.segmentsOffset, uint64_t(header.segmentCount) * sizeof(BakedCacheFormat::SegmentRecord)) ||
+        !sectionValid(header.verticesOffset, header.verticesSize) ||
+        !sectionValid(header.indicesOffset, header.indicesSize) ||
+        !inRange(header.stringsOffset, header.stringsSize, size)) {
+        return false;
+    }
+
+    _header = &header;
+    _animations = reinterpret_cast<const BakedCacheFormat::AnimationRecord *>(data + header.animationsOffset);
+    _frames = reinterpret_cast<const BakedCacheFormat::FrameRecord *>(data + header.framesOffset);
+    _textures = reinterpret_cast<const BakedCacheFormat::StringRecord *>(data + header.texturesOffset);
+    _bones = reinterpret_cast<const float *>(data + header.bonesOffset);
+    _colors = reinterpret_cast<const BakedCacheFormat::ColorRecord *>(data + header.colorsOffset);
+    _segments = reinterpret_cast<const BakedCacheFormat::SegmentRecord *>(data + header.segmentsOffset);
+
+    auto stringValid = [&](const BakedCacheFormat::StringRecord &record) {
+        return inRange(record.offset, record.length, header.stringsSize);
+    };
+    for (uint32_t i = 0; i < header.textureCount; ++i) {
+        if (!stringValid(_textures[i])) return false;
+    }
+    for (uint32_t i = 0; i < header.animationCount; ++i) {
+        const auto &animation = _animations[i];
+        if (!stringValid(animation.name) || !inRange(animation.firstFrame, animation.frameCount, header.frameCount)) return false;
+    }
+
+    const uint32_t vertexStride = header.vertexFloats * sizeof(float);
+    for (uint32_t i = 0; i < header.frameCount; ++i) {
+        const auto &frame = _frames[i];
+        if (!inRange(frame.firstBone, frame.boneCount, header.boneCount) ||
+            !inRange(frame.firstColor, frame.colorCount, header.colorCount) ||
+            !inRange(frame.firstSegment, frame.segmentCount, header.segmentCount) ||
+            !inRange(frame.vertexOffset, frame.vertexSize, header.verticesSize) ||
+            !inRange(frame.indexOffset, frame.indexBytes, header.indicesSize) ||
+            frame.vertexBytes % vertexStride != 0 || frame.indexOffset % 2 != 0 || frame.indexBytes % 2 != 0) {
+            return false;
+        }
+        uint64_t storedSize = isQuantized() ? uint64_t(frame.vertexBytes / vertexStride) * BakedCacheFormat::QUANTIZED_VERTEX_BYTES : frame.vertexBytes;
+        if (storedSize != frame.vertexSize) return false;
+
+        uint64_t indexBytes = 0;
+        uint64_t vertexBytes = 0;
+        const auto *segments = getSegments(frame);
+        for (uint32_t s = 0; s < frame.segmentCount; ++s) {
+            if (segments[s].texture >= header.textureCount) return false;
+            indexBytes += uint64_t(segments[s].indexCount) * sizeof(uint16_t);
+            vertexBytes += uint64_t(segments[s].vertexFloatCount) * sizeof(float);
+        }
+        if (indexBytes > frame.indexBytes || vertexBytes > frame.vertexBytes) return false;
+
+        const auto *colors = getColors(frame);
+        for (uint32_t c = 0; c < frame.colorCount; ++c) {
+            if (uint64_t(colors[c].vertexFloatOffset) * sizeof(float) > frame.vertexBytes) return false;
+        }
+    }
+    return true;
+}
+
+std::string BakedCacheFile::getAnimationName(uint32_t index) const {
+    const auto &name = _animations[index].name;
+    return std::string(reinterpret_cast<const char *>(_data + _header->stringsOffset + name.offset), name.length);
+}
+
+std::string BakedCacheFile::getTextureKey(uint32_t index) const {
+    const auto &key = _textures[index];
+    return std::string(reinterpret_cast<const char *>(_data + _header->stringsOffset + key.offset), key.length);
+}
+
+const uint8_t *BakedCacheFile::getVertices(const BakedCacheFormat::FrameRecord &frame) const {
+    if (isQuantized()) return nullptr;
+    return _data + _header->verticesOffset + frame.vertexOffset;
+}
+
+void BakedCacheFile::decodeVertices(const BakedCacheFormat::FrameRecord &frame, float *dst) const {
+    const uint32_t vertexFloats = _header->vertexFloats;
+    const uint32_t vertexCount = frame.vertexBytes / (vertexFloats * sizeof(float));
+    const uint8_t *src = _data + _header->verticesOffset + frame.vertexOffset;
+
+    if (!isQuantized()) {
+        memcpy(dst, src, frame.vertexBytes);
+        return;
+    }
+
+    memset(dst, 0, frame.vertexBytes);
+    const auto *quantized = reinterpret_cast<const uint16_t *>(src);
+    for (uint32_t i = 0; i < vertexCount; ++i, quantized += 4) {
+        float *vertex = dst + i * vertexFloats;
+        vertex[0] = frame.positionMin[0] + static_cast<float>(quantized[0]) * frame.positionScale[0];
+        vertex[1] = frame.positionMin[1] + static_cast<float>(quantized[1]) * frame.positionScale[1];
+        vertex[3] = frame.uvMin[0] + static_cast<float>(quantized[2]) * frame.uvScale[0];
+        vertex[4] = frame.uvMin[1] + static_cast<float>(quantized[3]) * frame.uvScale[1];
+    }
+
+    // colors are constant over each color run
+    const float divisor = _header->colorDivisor;
+    const bool twoColors = vertexFloats == 13;
+    const auto *colors = getColors(frame);
+    uint32_t begin = 0;
+    for (uint32_t c = 0; c < frame.colorCount; ++c) {
+        uint32_t end = std::min(colors[c].vertexFloatOffset / vertexFloats, vertexCount);
+        for (uint32_t i = begin; i < end; ++i) {
+            float *vertex = dst + i * vertexFloats;
+            for (uint32_t k = 0; k < 4; ++k) {
+                vertex[5 + k] = colors[c].finalColor[k] / divisor;
+                if (twoColors) {
+                    vertex[9 + k] = colors[c].darkColor[k] / divisor;
+                }
+            }
+        }
+        begin = std::max(begin, end);
+    }
+}
+
+MIDDLEWARE_END
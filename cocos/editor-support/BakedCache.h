@@ -0,0 +1,235 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include "MiddlewareMacro.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+MIDDLEWARE_BEGIN
+
+/**
+ * Baked animation caches, the file form of spine::SkeletonCache and dragonBones::ArmatureCache frames.
+ *
+ * A file is a header followed by 4 byte aligned sections of plain records: animations, frames,
+ * texture keys, bones, color runs, segments, vertices, indices and strings. Frames refer to
+ * ranges of the shared sections, identical index blocks are stored once. Vertices are either
+ * stored as the caches render them, so a read only mapping of the file can be rendered in place,
+ * or with quantized positions and uvs and without colors, which are rebuilt from the color runs
+ * when the frame is decoded.
+ */
+struct BakedCacheFormat {
+    static const uint32_t MAGIC = 0x4B424343; // "CCBK"
+    static const uint16_t VERSION = 1;
+
+    enum Flags : uint16_t {
+        QUANTIZED = 1,
+    };
+
+    // floats per bone: m[0], m[1], m[4], m[5], m[12], m[13] of the bone global transform
+    static const uint32_t BONE_FLOATS = 6;
+    // bytes per quantized vertex: x, y, u, v as unsigned 16 bit values
+    static const uint32_t QUANTIZED_VERTEX_BYTES = 8;
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t flags;
+        // floats per vertex once decoded, 9 with one color or 13 with two
+        uint32_t vertexFloats;
+        // vertex colors are the color run values divided by this
+        float colorDivisor;
+        uint32_t animationCount;
+        uint32_t frameCount;
+        uint32_t textureCount;
+        uint32_t boneCount;
+        uint32_t colorCount;
+        uint32_t segmentCount;
+        // section offsets in bytes from the start of the file
+        uint32_t animationsOffset;
+        uint32_t framesOffset;
+        uint32_t texturesOffset;
+        uint32_t bonesOffset;
+        uint32_t colorsOffset;
+        uint32_t segmentsOffset;
+        uint32_t verticesOffset;
+        uint32_t verticesSize;
+        uint32_t indicesOffset;
+        uint32_t indicesSize;
+        uint32_t stringsOffset;
+        uint32_t stringsSize;
+    };
+
+    struct StringRecord {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct AnimationRecord {
+        StringRecord name;
+        uint32_t firstFrame;
+        uint32_t frameCount;
+        uint32_t isComplete;
+        float totalTime;
+    };
+
+    struct FrameRecord {
+        uint32_t firstBone;
+        uint32_t boneCount;
+        uint32_t firstColor;
+        uint32_t colorCount;
+        uint32_t firstSegment;
+        uint32_t segmentCount;
+        // offset in the vertices section and size of the stored vertices
+        uint32_t vertexOffset;
+        uint32_t vertexSize;
+        // size of the vertices once decoded
+        uint32_t vertexBytes;
+        uint32_t indexOffset;
+        uint32_t indexBytes;
+        // dequantization ranges, value = min + q * scale
+        float positionMin[2];
+        float positionScale[2];
+        float uvMin[2];
+        float uvScale[2];
+    };
+
+    struct ColorRecord {
+        float finalColor[4];
+        float darkColor[4];
+        // vertex float offset at which this color run ends
+        uint32_t vertexFloatOffset;
+    };
+
+    struct SegmentRecord {
+        uint32_t texture;
+        uint32_t blendMode;
+        uint32_t indexCount;
+        uint32_t vertexFloatCount;
+    };
+};
+
+/**
+ * Collects cache frames in order and serializes them to the baked format.
+ */
+class BakedCacheWriter {
+public:
+    BakedCacheWriter(uint32_t vertexFloats, float colorDivisor, bool quantize = false);
+
+    // Returns the index of the texture with the key, adding it if it is new.
+    uint32_t addTexture(const std::string &key);
+
+    void beginAnimation(const std::string &name, bool isComplete, float totalTime);
+    void beginFrame();
+    void addBone(const float *matrix);
+    void addColor(const float *finalColor, const float *darkColor, uint32_t vertexFloatOffset);
+    void addSegment(uint32_t texture, uint32_t blendMode, uint32_t indexCount, uint32_t vertexFloatCount);
+    void endFrame(const uint8_t *vertices, std::size_t vertexBytes, const uint8_t *indices, std::size_t indexBytes);
+
+    std::vector<uint8_t> serialize() const;
+    bool save(const std::string &fullPath) const;
+
+private:
+    uint32_t addString(const std::string &value, BakedCacheFormat::StringRecord &record);
+    void quantizeVertices(BakedCacheFormat::FrameRecord &frame, const float *vertices, uint32_t vertexCount);
+
+    uint32_t _vertexFloats = 0;
+    float _colorDivisor = 1.0F;
+    bool _quantize = false;
+
+    std::vector<BakedCacheFormat::AnimationRecord> _animations;
+    std::vector<BakedCacheFormat::FrameRecord> _frames;
+    std::vector<BakedCacheFormat::StringRecord> _textures;
+    std::vector<float> _bones;
+    std::vector<BakedCacheFormat::ColorRecord> _colors;
+    std::vector<BakedCacheFormat::SegmentRecord> _segments;
+    std::vector<uint8_t> _vertices;
+    std::vector<uint8_t> _indices;
+    std::string _strings;
+
+    std::unordered_map<std::string, uint32_t> _textureIndices;
+    // index block hash to offsets of the blocks stored with that hash
+    std::unordered_map<std::size_t, std::vector<uint32_t>> _indexBlocks;
+};
+
+/**
+ * A validated baked cache, memory mapped read only when the platform allows it.
+ * Frame accessors expect indices below the counts, all ranges are checked on open.
+ */
+class BakedCacheFile {
+public:
+    // Maps the file at the full path, returns nullptr if it can not be mapped or is invalid.
+    static BakedCacheFile *openMapped(const std::string &fullPath);
+    // Copies the file content, for files that can not be mapped such as packed assets.
+    static BakedCacheFile *createWithData(const uint8_t *data, std::size_t size);
+
+    ~BakedCacheFile();
+    BakedCacheFile(const BakedCacheFile &) = delete;
+    BakedCacheFile &operator=(const BakedCacheFile &) = delete;
+
+    inline bool isMapped() const { return _mapping != nullptr; }
+    inline bool isQuantized() const { return (_header->flags & BakedCacheFormat::QUANTIZED) != 0; }
+    inline uint32_t getVertexFloats() const { return _header->vertexFloats; }
+
+    inline uint32_t getAnimationCount() const { return _header->animationCount; }
+    inline const BakedCacheFormat::AnimationRecord &getAnimation(uint32_t index) const { return _animations[index]; }
+    std::string getAnimationName(uint32_t index) const;
+
+    inline uint32_t getTextureCount() const { return _header->textureCount; }
+    std::string getTextureKey(uint32_t index) const;
+
+    inline const BakedCacheFormat::FrameRecord &getFrame(uint32_t index) const { return _frames[index]; }
+    inline const float *getBones(const BakedCacheFormat::FrameRecord &frame) const { return _bones + frame.firstBone * BakedCacheFormat::BONE_FLOATS; }
+    inline const BakedCacheFormat::ColorRecord *getColors(const BakedCacheFormat::FrameRecord &frame) const { return _colors + frame.firstColor; }
+    inline const BakedCacheFormat::SegmentRecord *getSegments(const BakedCacheFormat::FrameRecord &frame) const { return _segments + frame.firstSegment; }
+    inline const uint8_t *getIndices(const BakedCacheFormat::FrameRecord &frame) const { return _data + _header->indicesOffset + frame.indexOffset; }
+    // Returns the frame vertices in place, or nullptr if they are quantized and need decodeVertices.
+    const uint8_t *getVertices(const BakedCacheFormat::FrameRecord &frame) const;
+    // Writes frame.vertexBytes of decoded vertices to dst.
+    void decodeVertices(const BakedCacheFormat::FrameRecord &frame, float *dst) const;
+
+private:
+    BakedCacheFile() = default;
+    bool init(const uint8_t *data, std::size_t size);
+
+    const uint8_t *_data = nullptr;
+    std::size_t _size = 0;
+    void *_mapping = nullptr;
+    std::vector<uint8_t> _content;
+
+    const BakedCacheFormat::Header *_header = nullptr;
+    const BakedCacheFormat::AnimationRecord *_animations = nullptr;
+    const BakedCacheFormat::FrameRecord *_frames = nullptr;
+    const BakedCacheFormat::StringRecord *_textures = nullptr;
+    const float *_bones = nullptr;
+    const BakedCacheFormat::ColorRecord *_colors = nullptr;
+    const BakedCacheFormat::SegmentRecord *_segments = nullptr;
+};
+
+MIDDLEWARE_END
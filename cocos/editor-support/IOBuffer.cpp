@@ -34,8 +34,11 @@ void IOBuffer::resize(std::size_t newLen, bool needCopy) {
             memcpy(newBuffer, _buffer, _bufferSize);
         }
 
-        delete[] _buffer;
+        if (_ownsBuffer) {
+            delete[] _buffer;
+        }
         _buffer = newBuffer;
+        _ownsBuffer = true;
         _bufferSize = newLen;
         _outRange = false;
     }
@@ -49,7 +49,7 @@ public:
     IOBuffer() {}
 
     virtual ~IOBuffer() {
-        if (_buffer) {
+        if (_buffer && _ownsBuffer) {
             delete[] _buffer;
             _buffer = nullptr;
         }
@@ -136,6 +136,26 @@ public:
         return *buffer;
     }
 
+    /**
+     * @brief Uses memory owned elsewhere, such as a mapped baked cache, as the buffer content.
+     * The memory must outlive the buffer and is never written, resizing copies it to an own buffer.
+     */
+    inline void wrap(const uint8_t *data, std::size_t size) {
+        if (_buffer && _ownsBuffer) {
+            delete[] _buffer;
+        }
+        _buffer = const_cast<uint8_t *>(data);
+        _bufferSize = size;
+        _curPos = size;
+        _readPos = 0;
+        _outRange = false;
+        _ownsBuffer = false;
+    }
+
+    inline bool ownsBuffer() const {
+        return _ownsBuffer;
+    }
+
     inline void reset() {
         _curPos = 0;
         _readPos = 0;
@@ -203,6 +223,10 @@ public:
         _maxSize = maxSize;
     }
 
+    std::size_t getMaxSize() const {
+        return _maxSize;
+    }
+
     typedef std::function<void()> fullCallback;
     void setFullCallback(fullCallback callback) {
         _fullCallback = callback;
@@ -226,6 +250,7 @@ protected:
     std::size_t _curPos = 0;
     std::size_t _readPos = 0;
     bool _outRange = false;
+    bool _ownsBuffer = true;
     std::size_t _maxSize = 0;
     fullCallback _fullCallback = nullptr;
     resizeCallback _resizeCallback = nullptr;
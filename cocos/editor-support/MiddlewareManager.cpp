@@ -25,6 +25,8 @@
 
 #include "MiddlewareManager.h"
 #include "SeApi.h"
+#include "base/CoreStd.h"
+#include "base/job-system/JobSystem.h"
 #include <algorithm>
 
 MIDDLEWARE_BEGIN
@@ -55,18 +57,75 @@ MeshBuffer *MiddlewareManager::getMeshBuffer(int format) {
 }
 
 void MiddlewareManager::_clearRemoveList() {
-    for (std::size_t i = 0; i < _removeList.size(); i++) {
-        auto editor = _removeList[i];
-        auto it = std::find(_updateList.begin(), _updateList.end(), editor);
-        if (it != _updateList.end()) {
-            _updateList.erase(it);
+    if (_removeSet.empty()) return;
+
+    _updateList.erase(std::remove_if(_updateList.begin(), _updateList.end(), [this](IMiddleware *editor) {
+        return _removeSet.count(editor) > 0;
+    }),
+                      _updateList.end());
+    for (auto editor : _removeSet) {
+        _updateSet.erase(editor);
+    }
+
+    _removeSet.clear();
+}
+
+uint32_t MiddlewareManager::_getChunkCount(uint32_t threadCount, bool render) const {
+    if (!_parallelUpdateThreshold || _updateList.size() < _parallelUpdateThreshold || threadCount < 2) {
+        return 1;
+    }
+
+    uint32_t safeCount = 0;
+    for (auto editor : _updateList) {
+        if (render ? editor->isParallelRenderSafe() : editor->isParallelUpdateSafe()) safeCount++;
+    }
+    return std::min(threadCount + 1, safeCount / _parallelUpdateThreshold + 1);
+}
+
+void MiddlewareManager::_runChunks(uint32_t chunkCount, const std::function<void(uint32_t)> &work) const {
+    JobGraph g(JobSystem::getInstance());
+    g.createForEachIndexJob(1U, chunkCount, 1U, work);
+    g.run();
+    work(0U);
+    g.waitForAll();
+}
+
+void MiddlewareManager::_updateParallel(float dt, uint32_t chunkCount) {
+    // Middleware which are not parallel safe may call into script, run them first so
+    // that removals they trigger are known before the parallel batch is collected.
+    _parallelList.clear();
+    for (std::size_t i = 0, n = _updateList.size(); i < n; i++) {
+        auto editor = _updateList[i];
+        if (_removeSet.count(editor)) continue;
+        if (editor->isParallelUpdateSafe()) {
+            _parallelList.push_back(editor);
+        } else {
+            editor->update(dt);
         }
     }
 
-    _removeList.clear();
+    const auto parallelCount = static_cast<uint32_t>(_parallelList.size());
+    const uint32_t chunkSize = (parallelCount + chunkCount - 1) / chunkCount;
+    _runChunks(chunkCount, [&](uint32_t chunk) {
+        const uint32_t begin = chunk * chunkSize;
+        const uint32_t end = std::min(begin + chunkSize, parallelCount);
+        for (uint32_t i = begin; i < end; i++) {
+            _parallelList[i]->updateParallel(dt);
+        }
+    });
+
+    // Held callbacks are raised in list order, a callback may remove middleware later in the list.
+    for (auto editor : _parallelList) {
+        if (_removeSet.count(editor)) continue;
+        editor->dispatchDeferredEvents();
+    }
 }
 
 void MiddlewareManager::update(float dt) {
+    update(dt, JobSystem::getInstance()->threadCount());
+}
+
+void MiddlewareManager::update(float dt, uint32_t threadCount) {
     isUpdating = true;
 
     _renderInfo.reset();
@@ -81,22 +140,22 @@ void MiddlewareManager::update(float dt) {
         attachBuffer->writeUint32(0);
     }
 
-    auto isOrderDirty = false;
-    uint32_t maxRenderOrder = 0;
-    for (std::size_t i = 0, n = _updateList.size(); i < n; i++) {
-        auto editor = _updateList[i];
-        uint32_t renderOrder = maxRenderOrder;
-        if (_removeList.size() > 0) {
-            auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
-            if (removeIt == _removeList.end()) {
-                editor->update(dt);
-                renderOrder = editor->getRenderOrder();
-            }
-        } else {
+    const uint32_t chunkCount = _getChunkCount(threadCount, false);
+    if (chunkCount > 1) {
+        _updateParallel(dt, chunkCount);
+    } else {
+        for (std::size_t i = 0, n = _updateList.size(); i < n; i++) {
+            auto editor = _updateList[i];
+            if (_removeSet.count(editor)) continue;
             editor->update(dt);
-            renderOrder = editor->getRenderOrder();
         }
+    }
 
+    auto isOrderDirty = false;
+    uint32_t maxRenderOrder = 0;
+    for (auto editor : _updateList) {
+        if (_removeSet.count(editor)) continue;
+        uint32_t renderOrder = editor->getRenderOrder();
         if (maxRenderOrder > renderOrder) {
             isOrderDirty = true;
         } else {
@@ -115,7 +174,66 @@ void MiddlewareManager::update(float dt) {
     }
 }
 
+bool MiddlewareManager::_reserveRender(IMiddleware *editor, float dt, uint32_t chunkCount) {
+    int vertexFormat = 0;
+    std::size_t vertexBytes = 0;
+    std::size_t indexBytes = 0;
+    editor->getRenderSize(vertexFormat, vertexBytes, indexBytes);
+    if (!vertexBytes) return false;
+
+    MeshBuffer *mb = getMeshBuffer(vertexFormat);
+    IOBuffer &vb = mb->getVB();
+    IOBuffer &ib = mb->getIB();
+    auto fits = [](const IOBuffer &buffer, std::size_t bytes, std::size_t used) {
+        return !buffer.getMaxSize() || used + bytes <= buffer.getMaxSize();
+    };
+    // a range never spans two buffers
+    if (!fits(vb, vertexBytes, 0) || !fits(ib, indexBytes, 0)) return false;
+
+    // A full buffer is uploaded as soon as it rolls over, fill the ranges it holds first.
+    if (!fits(vb, vertexBytes, vb.getCurPos()) || !fits(ib, indexBytes, ib.getCurPos())) {
+        _fillReservedRanges(chunkCount);
+    }
+
+    // ranges are kept as offsets, growing the buffers below keeps their content
+    vb.checkSpace(vertexBytes, true);
+    ib.checkSpace(indexBytes, true);
+    RenderRange range;
+    range.meshBuffer = mb;
+    range.bufferPos = mb->getBufferPos();
+    range.vertexOffset = vb.getCurPos();
+    range.indexOffset = ib.getCurPos();
+    vb.move(static_cast<int>(vertexBytes));
+    ib.move(static_cast<int>(indexBytes));
+
+    editor->beginRender(dt, range);
+    _parallelList.push_back(editor);
+    _renderRanges.push_back(range);
+    return true;
+}
+
+void MiddlewareManager::_fillReservedRanges(uint32_t chunkCount) {
+    const auto rangeCount = static_cast<uint32_t>(_renderRanges.size());
+    if (!rangeCount) return;
+
+    const uint32_t chunkSize = (rangeCount + chunkCount - 1) / chunkCount;
+    _runChunks(chunkCount, [&](uint32_t chunk) {
+        const uint32_t begin = chunk * chunkSize;
+        const uint32_t end = std::min(begin + chunkSize, rangeCount);
+        for (uint32_t i = begin; i < end; i++) {
+            _parallelList[i]->renderParallel(_renderRanges[i]);
+        }
+    });
+
+    _parallelList.clear();
+    _renderRanges.clear();
+}
+
 void MiddlewareManager::render(float dt) {
+    render(dt, JobSystem::getInstance()->threadCount());
+}
+
+void MiddlewareManager::render(float dt, uint32_t threadCount) {
     for (auto it : _mbMap) {
         auto buffer = it.second;
         if (buffer) {
@@ -125,17 +243,19 @@ void MiddlewareManager::render(float dt) {
 
     isRendering = true;
 
+    // Parallel safe middleware reserve their range and write render info in render order, their
+    // vertices are filled on the job system once a middleware that renders by itself comes next.
+    const uint32_t chunkCount = _getChunkCount(threadCount, true);
+    _parallelList.clear();
+    _renderRanges.clear();
     for (std::size_t i = 0, n = _updateList.size(); i < n; i++) {
         auto editor = _updateList[i];
-        if (_removeList.size() > 0) {
-            auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
-            if (removeIt == _removeList.end()) {
-                editor->render(dt);
-            }
-        } else {
-            editor->render(dt);
-        }
+        if (_removeSet.count(editor)) continue;
+        if (chunkCount > 1 && editor->isParallelRenderSafe() && _reserveRender(editor, dt, chunkCount)) continue;
+        _fillReservedRanges(chunkCount);
+        editor->render(dt);
     }
+    _fillReservedRanges(chunkCount);
 
     isRendering = false;
 
@@ -151,26 +271,27 @@ void MiddlewareManager::render(float dt) {
 }
 
 void MiddlewareManager::addTimer(IMiddleware *editor) {
-    auto it0 = std::find(_updateList.begin(), _updateList.end(), editor);
-    if (it0 != _updateList.end()) {
+    // A removal requested during this frame has not been applied yet, cancel it.
+    if (_removeSet.erase(editor) > 0) {
         return;
     }
 
-    auto it1 = std::find(_removeList.begin(), _removeList.end(), editor);
-    if (it1 != _removeList.end()) {
-        _removeList.erase(it1);
+    if (!_updateSet.insert(editor).second) {
+        return;
     }
     _updateList.push_back(editor);
 }
 
 void MiddlewareManager::removeTimer(IMiddleware *editor) {
+    if (!_updateSet.count(editor)) {
+        return;
+    }
+
     if (isUpdating || isRendering) {
-        _removeList.push_back(editor);
+        _removeSet.insert(editor);
     } else {
-        auto it = std::find(_updateList.begin(), _updateList.end(), editor);
-        if (it != _updateList.end()) {
-            _updateList.erase(it);
-        }
+        _updateSet.erase(editor);
+        _updateList.erase(std::find(_updateList.begin(), _updateList.end(), editor));
     }
 }
 
@@ -29,11 +29,23 @@
 #include "MiddlewareMacro.h"
 #include "SharedBufferManager.h"
 #include "base/Ref.h"
+#include <functional>
 #include <map>
+#include <unordered_set>
 #include <vector>
 
 MIDDLEWARE_BEGIN
 
+/**
+ * Part of a mesh buffer reserved for the vertices and indices of one middleware, offsets are in bytes.
+ */
+struct RenderRange {
+    MeshBuffer *meshBuffer = nullptr;
+    std::size_t bufferPos = 0;
+    std::size_t vertexOffset = 0;
+    std::size_t indexOffset = 0;
+};
+
 /**
  * All middleware must implement IMiddleware interface.
  */
@@ -44,6 +56,37 @@ public:
     virtual void update(float dt) = 0;
     virtual void render(float dt) = 0;
     virtual uint32_t getRenderOrder() const = 0;
+
+    /**
+     * @brief Whether updateParallel may run on a job system worker concurrently with other middleware.
+     */
+    virtual bool isParallelUpdateSafe() const { return false; }
+    /**
+     * @brief Update from a worker thread, script callbacks must be held until dispatchDeferredEvents.
+     */
+    virtual void updateParallel(float dt) { update(dt); }
+    /**
+     * @brief Raise callbacks held by updateParallel, called on the main thread in render order.
+     */
+    virtual void dispatchDeferredEvents() {}
+
+    /**
+     * @brief Whether the vertices of the next render may be filled by renderParallel on a job system worker.
+     */
+    virtual bool isParallelRenderSafe() const { return false; }
+    /**
+     * @brief Vertex format and bytes of vertices and indices the next render writes, they are reserved as one range.
+     * Middleware reporting no vertices, or more than a mesh buffer holds, go through render instead.
+     */
+    virtual void getRenderSize(int &vertexFormat, std::size_t &vertexBytes, std::size_t &indexBytes) const {}
+    /**
+     * @brief Write render and attach info for the reserved range, called on the main thread in render order.
+     */
+    virtual void beginRender(float dt, const RenderRange &range) {}
+    /**
+     * @brief Fill the range reserved for beginRender from a worker thread.
+     */
+    virtual void renderParallel(const RenderRange &range) {}
 };
 
 /**
@@ -78,11 +121,13 @@ public:
      * @param[in] dt Delta time.
      */
     void update(float dt);
+    void update(float dt, uint32_t threadCount);
 
     /**
      * @brief render all elements
      */
     void render(float dt);
+    void render(float dt, uint32_t threadCount);
 
     /**
      * @brief Third party module add in _updateMap,it will update perframe.
@@ -104,6 +149,12 @@ public:
     std::size_t getVBTypedArrayLength(int format, std::size_t bufferPos);
     std::size_t getIBTypedArrayLength(int format, std::size_t bufferPos);
 
+    // Frames with at least this many parallel safe middleware update or render them on the job system, 0 disables it.
+    inline uint32_t getParallelUpdateThreshold() const { return _parallelUpdateThreshold; }
+    inline void setParallelUpdateThreshold(uint32_t threshold) { _parallelUpdateThreshold = threshold; }
+
+    static constexpr uint32_t PARALLEL_UPDATE_THRESHOLD = 32U;
+
     SharedBufferManager *getRenderInfoMgr();
     SharedBufferManager *getAttachInfoMgr();
 
@@ -116,10 +167,21 @@ public:
 
 private:
     void _clearRemoveList();
+    uint32_t _getChunkCount(uint32_t threadCount, bool render) const;
+    void _runChunks(uint32_t chunkCount, const std::function<void(uint32_t)> &work) const;
+    void _updateParallel(float dt, uint32_t chunkCount);
+    bool _reserveRender(IMiddleware *editor, float dt, uint32_t chunkCount);
+    void _fillReservedRanges(uint32_t chunkCount);
 
 private:
     std::vector<IMiddleware *> _updateList;
-    std::vector<IMiddleware *> _removeList;
+    std::unordered_set<IMiddleware *> _updateSet;
+    std::unordered_set<IMiddleware *> _removeSet;
+    // kept across frames so steady state updates do not reallocate
+    std::vector<IMiddleware *> _parallelList;
+    // ranges reserved for the parallel render, matching _parallelList
+    std::vector<RenderRange> _renderRanges;
+    uint32_t _parallelUpdateThreshold = PARALLEL_UPDATE_THRESHOLD;
     std::map<int, MeshBuffer *> _mbMap;
 
     SharedBufferManager _renderInfo;
@@ -0,0 +1,309 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "VertexKernels.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+MIDDLEWARE_BEGIN
+
+namespace {
+// Float offsets inside an interleaved vertex
+constexpr uint32_t Z_OFFSET      = 2;
+constexpr uint32_t UV_OFFSET     = 3;
+constexpr uint32_t COLOR_OFFSET  = 5;
+constexpr uint32_t COLOR2_OFFSET = 9;
+
+inline void transformPoint(const float *affine, float vx, float vy, float *dst) {
+    dst[0] = vx * affine[0] + vy * affine[2] + affine[4];
+    dst[1] = vx * affine[1] + vy * affine[3] + affine[5];
+}
+
+// Transforms [begin, count) unweighted vertices one by one
+void computeMeshVerticesScalar(const float *affine, const float *vertices, uint32_t begin, uint32_t count, float *dst, uint32_t stride) {
+    for (uint32_t i = begin; i < count; ++i) {
+        transformPoint(affine, vertices[i * 2], vertices[i * 2 + 1], dst + i * stride);
+    }
+}
+} // namespace
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+void computeRegionVertices(const float *affine, const float *offsets, float *dst, uint32_t stride) {
+    const __m128 lo = _mm_loadu_ps(offsets);
+    const __m128 hi = _mm_loadu_ps(offsets + 4);
+    const __m128 xs = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 ys = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+
+    const __m128 wx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, _mm_set1_ps(affine[0])), _mm_mul_ps(ys, _mm_set1_ps(affine[2]))), _mm_set1_ps(affine[4]));
+    const __m128 wy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, _mm_set1_ps(affine[1])), _mm_mul_ps(ys, _mm_set1_ps(affine[3]))), _mm_set1_ps(affine[5]));
+
+    const __m128 p01 = _mm_unpacklo_ps(wx, wy);
+    const __m128 p23 = _mm_unpackhi_ps(wx, wy);
+    _mm_storeh_pi(reinterpret_cast<__m64 *>(dst), p23);
+    _mm_storel_pi(reinterpret_cast<__m64 *>(dst + stride), p01);
+    _mm_storeh_pi(reinterpret_cast<__m64 *>(dst + stride * 2), p01);
+    _mm_storel_pi(reinterpret_cast<__m64 *>(dst + stride * 3), p23);
+}
+
+void computeMeshVertices(const float *affine, const float *vertices, uint32_t count, float *dst, uint32_t stride) {
+    const __m128   ac  = _mm_set_ps(affine[1], affine[0], affine[1], affine[0]);
+    const __m128   bd  = _mm_set_ps(affine[3], affine[2], affine[3], affine[2]);
+    const __m128   t   = _mm_set_ps(affine[5], affine[4], affine[5], affine[4]);
+    const uint32_t end = count - count % 2;
+    for (uint32_t i = 0; i < end; i += 2) {
+        const __m128 v  = _mm_loadu_ps(vertices + i * 2);
+        const __m128 vx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 vy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128 w  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, ac), _mm_mul_ps(vy, bd)), t);
+        _mm_storel_pi(reinterpret_cast<__m64 *>(dst + i * stride), w);
+        _mm_storeh_pi(reinterpret_cast<__m64 *>(dst + (i + 1) * stride), w);
+    }
+    computeMeshVerticesScalar(affine, vertices, end, count, dst, stride);
+}
+
+void computeWeightedMeshVertices(const float *boneAffines, const size_t *bones, const float *vertices, const float *deform, uint32_t count, float *dst, uint32_t stride) {
+    size_t v = 0;
+    size_t b = 0;
+    size_t f = 0;
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        __m128       acc = _mm_setzero_ps();
+        const size_t n   = v + 1 + bones[v];
+        for (++v; v < n; ++v, b += 3, f += 2) {
+            const float *affine = boneAffines + bones[v] * BONE_AFFINE_STRIDE;
+            float        vx     = vertices[b];
+            float        vy     = vertices[b + 1];
+            if (deform) {
+                vx += deform[f];
+                vy += deform[f + 1];
+            }
+            // lanes 0 and 1 hold vx * a + vy * b and vx * c + vy * d
+            __m128 p = _mm_mul_ps(_mm_loadu_ps(affine), _mm_set_ps(vy, vy, vx, vx));
+            p        = _mm_add_ps(_mm_add_ps(p, _mm_movehl_ps(p, p)), _mm_loadu_ps(affine + 4));
+            acc      = _mm_add_ps(acc, _mm_mul_ps(p, _mm_set1_ps(vertices[b + 2])));
+        }
+        _mm_storel_pi(reinterpret_cast<__m64 *>(dst), acc);
+    }
+}
+
+void fillVertexColors(float *dst, uint32_t stride, uint32_t count, const Color4F &light) {
+    const __m128 c = _mm_loadu_ps(&light.r);
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        _mm_storeu_ps(dst + COLOR_OFFSET, c);
+    }
+}
+
+void fillVertexColors(float *dst, uint32_t stride, uint32_t count, const Color4F &light, const Color4F &dark) {
+    const __m128 c  = _mm_loadu_ps(&light.r);
+    const __m128 c2 = _mm_loadu_ps(&dark.r);
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        _mm_storeu_ps(dst + COLOR_OFFSET, c);
+        _mm_storeu_ps(dst + COLOR2_OFFSET, c2);
+    }
+}
+
+void transformVertices(float *dst, uint32_t stride, uint32_t count, const cc::Mat4 &m) {
+    const __m128 c0 = _mm_loadu_ps(m.m);
+    const __m128 c1 = _mm_loadu_ps(m.m + 4);
+    const __m128 c3 = _mm_loadu_ps(m.m + 12);
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        __m128 r   = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(dst[0])), _mm_mul_ps(c1, _mm_set1_ps(dst[1]))), c3);
+        float  rhw = _mm_cvtss_f32(_mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
+        if (rhw != 1.0F) {
+            rhw = static_cast<bool>(rhw) ? 1.0F / rhw : 1.0F;
+            r   = _mm_mul_ps(r, _mm_set1_ps(rhw));
+        }
+        _mm_storel_pi(reinterpret_cast<__m64 *>(dst), r);
+        _mm_store_ss(dst + Z_OFFSET, _mm_movehl_ps(r, r));
+    }
+}
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+void computeRegionVertices(const float *affine, const float *offsets, float *dst, uint32_t stride) {
+    const float32x4x2_t xy = vld2q_f32(offsets);
+
+    const float32x4_t wx = vaddq_f32(vaddq_f32(vmulq_n_f32(xy.val[0], affine[0]), vmulq_n_f32(xy.val[1], affine[2])), vdupq_n_f32(affine[4]));
+    const float32x4_t wy = vaddq_f32(vaddq_f32(vmulq_n_f32(xy.val[0], affine[1]), vmulq_n_f32(xy.val[1], affine[3])), vdupq_n_f32(affine[5]));
+
+    const float32x4x2_t p = vzipq_f32(wx, wy);
+    vst1_f32(dst, vget_high_f32(p.val[1]));
+    vst1_f32(dst + stride, vget_low_f32(p.val[0]));
+    vst1_f32(dst + stride * 2, vget_high_f32(p.val[0]));
+    vst1_f32(dst + stride * 3, vget_low_f32(p.val[1]));
+}
+
+void computeMeshVertices(const float *affine, const float *vertices, uint32_t count, float *dst, uint32_t stride) {
+    const float32x4_t tx  = vdupq_n_f32(affine[4]);
+    const float32x4_t ty  = vdupq_n_f32(affine[5]);
+    const uint32_t    end = count - count % 4;
+    for (uint32_t i = 0; i < end; i += 4) {
+        const float32x4x2_t v  = vld2q_f32(vertices + i * 2);
+        const float32x4_t   wx = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], affine[0]), vmulq_n_f32(v.val[1], affine[2])), tx);
+        const float32x4_t   wy = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], affine[1]), vmulq_n_f32(v.val[1], affine[3])), ty);
+        const float32x4x2_t p  = vzipq_f32(wx, wy);
+        vst1_f32(dst + i * stride, vget_low_f32(p.val[0]));
+        vst1_f32(dst + (i + 1) * stride, vget_high_f32(p.val[0]));
+        vst1_f32(dst + (i + 2) * stride, vget_low_f32(p.val[1]));
+        vst1_f32(dst + (i + 3) * stride, vget_high_f32(p.val[1]));
+    }
+    computeMeshVerticesScalar(affine, vertices, end, count, dst, stride);
+}
+
+void computeWeightedMeshVertices(const float *boneAffines, const size_t *bones, const float *vertices, const float *deform, uint32_t count, float *dst, uint32_t stride) {
+    size_t v = 0;
+    size_t b = 0;
+    size_t f = 0;
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        float32x2_t  acc = vdup_n_f32(0.F);
+        const size_t n   = v + 1 + bones[v];
+        for (++v; v < n; ++v, b += 3, f += 2) {
+            const float *affine = boneAffines + bones[v] * BONE_AFFINE_STRIDE;
+            float        vx     = vertices[b];
+            float        vy     = vertices[b + 1];
+            if (deform) {
+                vx += deform[f];
+                vy += deform[f + 1];
+            }
+            // low half is vx * (a, c), high half is vy * (b, d)
+            const float32x4_t p = vmulq_f32(vld1q_f32(affine), vcombine_f32(vdup_n_f32(vx), vdup_n_f32(vy)));
+            const float32x2_t w = vadd_f32(vadd_f32(vget_low_f32(p), vget_high_f32(p)), vld1_f32(affine + 4));
+            acc                 = vadd_f32(acc, vmul_n_f32(w, vertices[b + 2]));
+        }
+        vst1_f32(dst, acc);
+    }
+}
+
+void fillVertexColors(float *dst, uint32_t stride, uint32_t count, const Color4F &light) {
+    const float32x4_t c = vld1q_f32(&light.r);
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        vst1q_f32(dst + COLOR_OFFSET, c);
+    }
+}
+
+void fillVertexColors(float *dst, uint32_t stride, uint32_t count, const Color4F &light, const Color4F &dark) {
+    const float32x4_t c  = vld1q_f32(&light.r);
+    const float32x4_t c2 = vld1q_f32(&dark.r);
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        vst1q_f32(dst + COLOR_OFFSET, c);
+        vst1q_f32(dst + COLOR2_OFFSET, c2);
+    }
+}
+
+void transformVertices(float *dst, uint32_t stride, uint32_t count, const cc::Mat4 &m) {
+    const float32x4_t c0 = vld1q_f32(m.m);
+    const float32x4_t c1 = vld1q_f32(m.m + 4);
+    const float32x4_t c3 = vld1q_f32(m.m + 12);
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        float32x4_t r   = vaddq_f32(vaddq_f32(vmulq_n_f32(c0, dst[0]), vmulq_n_f32(c1, dst[1])), c3);
+        float       rhw = vgetq_lane_f32(r, 3);
+        if (rhw != 1.0F) {
+            rhw = static_cast<bool>(rhw) ? 1.0F / rhw : 1.0F;
+            r   = vmulq_n_f32(r, rhw);
+        }
+        vst1_f32(dst, vget_low_f32(r));
+        dst[Z_OFFSET] = vgetq_lane_f32(r, 2);
+    }
+}
+
+#else
+
+void computeRegionVertices(const float *affine, const float *offsets, float *dst, uint32_t stride) {
+    transformPoint(affine, offsets[6], offsets[7], dst);
+    computeMeshVerticesScalar(affine, offsets, 0, 3, dst + stride, stride);
+}
+
+void computeMeshVertices(const float *affine, const float *vertices, uint32_t count, float *dst, uint32_t stride) {
+    computeMeshVerticesScalar(affine, vertices, 0, count, dst, stride);
+}
+
+void computeWeightedMeshVertices(const float *boneAffines, const size_t *bones, const float *vertices, const float *deform, uint32_t count, float *dst, uint32_t stride) {
+    size_t v = 0;
+    size_t b = 0;
+    size_t f = 0;
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        float        wx = 0.F;
+        float        wy = 0.F;
+        const size_t n  = v + 1 + bones[v];
+        for (++v; v < n; ++v, b += 3, f += 2) {
+            const float *affine = boneAffines + bones[v] * BONE_AFFINE_STRIDE;
+            float        vx     = vertices[b];
+            float        vy     = vertices[b + 1];
+            if (deform) {
+                vx += deform[f];
+                vy += deform[f + 1];
+            }
+            const float weight = vertices[b + 2];
+            wx += (vx * affine[0] + vy * affine[2] + affine[4]) * weight;
+            wy += (vx * affine[1] + vy * affine[3] + affine[5]) * weight;
+        }
+        dst[0] = wx;
+        dst[1] = wy;
+    }
+}
+
+void fillVertexColors(float *dst, uint32_t stride, uint32_t count, const Color4F &light) {
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        memcpy(dst + COLOR_OFFSET, &light.r, sizeof(float) * 4);
+    }
+}
+
+void fillVertexColors(float *dst, uint32_t stride, uint32_t count, const Color4F &light, const Color4F &dark) {
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        memcpy(dst + COLOR_OFFSET, &light.r, sizeof(float) * 4);
+        memcpy(dst + COLOR2_OFFSET, &dark.r, sizeof(float) * 4);
+    }
+}
+
+void transformVertices(float *dst, uint32_t stride, uint32_t count, const cc::Mat4 &m) {
+    const float *mat = m.m;
+    for (uint32_t i = 0; i < count; ++i, dst += stride) {
+        const float x   = dst[0];
+        const float y   = dst[1];
+        float       rhw = mat[3] * x + mat[7] * y + mat[15];
+        rhw             = static_cast<bool>(rhw) ? 1.0F / rhw : 1.0F;
+
+        dst[0]        = (mat[0] * x + mat[4] * y + mat[12]) * rhw;
+        dst[1]        = (mat[1] * x + mat[5] * y + mat[13]) * rhw;
+        dst[Z_OFFSET] = (mat[2] * x + mat[6] * y + mat[14]) * rhw;
+    }
+}
+
+#endif
+
+void copyVertexUVs(float *dst, uint32_t stride, const float *src, uint32_t srcStride, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i, dst += stride, src += srcStride) {
+        dst[Z_OFFSET]      = 0.F;
+        dst[UV_OFFSET]     = src[0];
+        dst[UV_OFFSET + 1] = src[1];
+    }
+}
+
+MIDDLEWARE_END
@@ -0,0 +1,99 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include "MiddlewareMacro.h"
+#include "middleware-adapter.h"
+#include "math/Mat4.h"
+#include <cstddef>
+#include <cstdint>
+
+MIDDLEWARE_BEGIN
+
+/**
+ * Vectorized (SSE or NEON when the target supports them) helpers to fill interleaved
+ * middleware vertices in place. Strides are in floats, positions are the first two
+ * floats of a vertex, followed by z, u, v and the color(s).
+ */
+
+/**
+ * Floats per bone in a bone affine table: a, c, b, d, worldX, worldY and two floats of padding.
+ */
+constexpr uint32_t BONE_AFFINE_STRIDE = 8;
+
+/**
+ * @brief Writes a bone world transform in the bone affine table layout.
+ */
+inline void setBoneAffine(float *affine, float a, float b, float c, float d, float worldX, float worldY) {
+    affine[0] = a;
+    affine[1] = c;
+    affine[2] = b;
+    affine[3] = d;
+    affine[4] = worldX;
+    affine[5] = worldY;
+    affine[6] = 0.F;
+    affine[7] = 0.F;
+}
+
+/**
+ * @brief Transforms the four region corners. offsets holds x, y pairs in the spine RegionAttachment
+ * order (bl, ul, ur, br), vertices are written in its world vertex order (br, bl, ul, ur).
+ */
+void computeRegionVertices(const float *affine, const float *offsets, float *dst, uint32_t stride);
+
+/**
+ * @brief Transforms count unweighted x, y pairs by a single bone.
+ */
+void computeMeshVertices(const float *affine, const float *vertices, uint32_t count, float *dst, uint32_t stride);
+
+/**
+ * @brief Transforms count weighted vertices in the spine layout, bones holds the influence count
+ * followed by the bone indices of each vertex, vertices holds x, y, weight of each influence and the
+ * optional deform holds x, y offsets of each influence. boneAffines is a bone affine table.
+ */
+void computeWeightedMeshVertices(const float *boneAffines, const size_t *bones, const float *vertices, const float *deform, uint32_t count, float *dst, uint32_t stride);
+
+/**
+ * @brief Resets z and copies texture coordinates, src points at the first u.
+ */
+void copyVertexUVs(float *dst, uint32_t stride, const float *src, uint32_t srcStride, uint32_t count);
+
+/**
+ * @brief Fills the color of count vertices.
+ */
+void fillVertexColors(float *dst, uint32_t stride, uint32_t count, const Color4F &light);
+
+/**
+ * @brief Fills the light and dark color of count vertices.
+ */
+void fillVertexColors(float *dst, uint32_t stride, uint32_t count, const Color4F &light, const Color4F &dark);
+
+/**
+ * @brief Transforms x, y with z = 0 by m and writes x, y, z back, same as Vec3::transformMat4.
+ */
+void transformVertices(float *dst, uint32_t stride, uint32_t count, const cc::Mat4 &m);
+
+MIDDLEWARE_END
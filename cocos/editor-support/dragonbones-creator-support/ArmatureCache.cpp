@@ -23,6 +23,7 @@
 
 #include "ArmatureCache.h"
 #include "CCFactory.h"
+#include "CCTextureAtlasData.h"
 #include "base/TypeDef.h"
 
 USING_NS_MW;
@@ -152,7 +153,8 @@ std::size_t ArmatureCache::AnimationData::getFrameCount() const {
     return _frames.size();
 }
 
-ArmatureCache::ArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID) {
+ArmatureCache::ArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID)
+: _atlasUUID(atlasUUID) {
     _armatureDisplay = dragonBones::CCFactory::getFactory()->buildArmatureDisplay(armatureName, armatureKey, "", atlasUUID);
     if (_armatureDisplay) {
         _armatureDisplay->retain();
@@ -165,10 +167,17 @@ ArmatureCache::~ArmatureCache() {
         _armatureDisplay = nullptr;
     }
 
+    clearAnimationCaches();
+    delete _bakedFile;
+    _bakedFile = nullptr;
+}
+
+void ArmatureCache::clearAnimationCaches() {
     for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
         delete it->second;
     }
     _animationCaches.clear();
+    _curAnimationName = "";
 }
 
 ArmatureCache::AnimationData *ArmatureCache::buildAnimationData(const std::string &animationName) {
@@ -412,6 +421,135 @@ void ArmatureCache::resetAnimationData(const std::string &animationName) {
     }
 }
 
+bool ArmatureCache::saveBakedData(const std::string &fullPath, bool quantize /*= false*/) {
+    if (!_armatureDisplay) return false;
+
+    // Textures are keyed by their texture data name in the atlas, as runtime textures differ per launch.
+    std::map<middleware::Texture2D *, std::string> textureKeys;
+    auto *atlases = CCFactory::getFactory()->getTextureAtlasData(_atlasUUID);
+    if (atlases) {
+        for (auto *atlas : *atlases) {
+            for (const auto &it : atlas->getTextures()) {
+                auto *textureData = static_cast<CCTextureData *>(it.second);
+                if (!textureData->spriteFrame || !textureData->spriteFrame->getTexture()) continue;
+                textureKeys.insert(std::make_pair(textureData->spriteFrame->getTexture(), it.first));
+            }
+        }
+    }
+
+    // every animation of the armature is baked, not only the ones played so far
+    for (const auto &animationName : _armatureDisplay->getArmature()->getArmatureData()->getAnimationNames()) {
+        buildAnimationData(animationName);
+    }
+
+    middleware::BakedCacheWriter writer(sizeof(middleware::V2F_T2F_C4F) / sizeof(float), 1.0F, quantize);
+    for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
+        updateToFrame(it->first);
+        AnimationData *animationData = it->second;
+        writer.beginAnimation(animationData->_animationName, animationData->_isComplete, animationData->_totalTime);
+
+        for (std::size_t i = 0, c = animationData->getFrameCount(); i < c; i++) {
+            FrameData *frameData = animationData->getFrameData(i);
+            writer.beginFrame();
+            for (auto *boneData : frameData->getBones()) {
+                writer.addBone(boneData->globalTransformMatrix.m);
+            }
+            for (auto *colorData : frameData->getColors()) {
+                writer.addColor(&colorData->color.r, nullptr, (uint32_t)colorData->vertexFloatOffset);
+            }
+            for (auto *segmentData : frameData->getSegments()) {
+                auto keyIt = textureKeys.find(segmentData->getTexture());
+                if (keyIt == textureKeys.end()) return false;
+                writer.addSegment(writer.addTexture(keyIt->second), segmentData->blendMode, (uint32_t)segmentData->indexCount, (uint32_t)segmentData->vertexFloatCount);
+            }
+            writer.endFrame(frameData->vb.getBuffer(), frameData->vb.getCurPos(), frameData->ib.getBuffer(), frameData->ib.getCurPos());
+        }
+    }
+    return writer.save(fullPath);
+}
+
+bool ArmatureCache::loadBakedData(middleware::BakedCacheFile *file) {
+    if (!file) return false;
+    auto *atlases = CCFactory::getFactory()->getTextureAtlasData(_atlasUUID);
+    if (!_armatureDisplay || !atlases || file->getVertexFloats() != sizeof(middleware::V2F_T2F_C4F) / sizeof(float)) {
+        delete file;
+        return false;
+    }
+
+    std::vector<middleware::Texture2D *> textures(file->getTextureCount(), nullptr);
+    for (uint32_t i = 0, n = file->getTextureCount(); i < n; ++i) {
+        std::string key = file->getTextureKey(i);
+        for (auto *atlas : *atlases) {
+            auto *textureData = static_cast<CCTextureData *>(atlas->getTexture(key));
+            if (textureData && textureData->spriteFrame) {
+                textures[i] = textureData->spriteFrame->getTexture();
+                break;
+            }
+        }
+        if (!textures[i]) {
+            CC_LOG_WARNING("Dragonbones: Baked cache texture not found: %s", key.c_str());
+            delete file;
+            return false;
+        }
+    }
+
+    clearAnimationCaches();
+    delete _bakedFile;
+    _bakedFile = file;
+
+    for (uint32_t a = 0, an = file->getAnimationCount(); a < an; ++a) {
+        const auto &animation = file->getAnimation(a);
+        auto *animationData = new AnimationData();
+        animationData->_animationName = file->getAnimationName(a);
+        animationData->_isComplete = animation.isComplete != 0;
+        animationData->_totalTime = animation.totalTime;
+
+        for (uint32_t f = 0; f < animation.frameCount; ++f) {
+            const auto &frame = file->getFrame(animation.firstFrame + f);
+            FrameData *frameData = animationData->buildFrameData(f);
+
+            const float *bones = file->getBones(frame);
+            for (uint32_t i = 0; i < frame.boneCount; ++i, bones += middleware::BakedCacheFormat::BONE_FLOATS) {
+                auto &matm = frameData->buildBoneData(i)->globalTransformMatrix.m;
+                matm[0] = bones[0];
+                matm[1] = bones[1];
+                matm[4] = bones[2];
+                matm[5] = bones[3];
+                matm[12] = bones[4];
+                matm[13] = bones[5];
+            }
+
+            const auto *colors = file->getColors(frame);
+            for (uint32_t i = 0; i < frame.colorCount; ++i) {
+                ColorData *colorData = frameData->buildColorData(i);
+                colorData->color = Color4F(colors[i].finalColor[0], colors[i].finalColor[1], colors[i].finalColor[2], colors[i].finalColor[3]);
+                colorData->vertexFloatOffset = colors[i].vertexFloatOffset;
+            }
+
+            const auto *segments = file->getSegments(frame);
+            for (uint32_t i = 0; i < frame.segmentCount; ++i) {
+                SegmentData *segmentData = frameData->buildSegmentData(i);
+                segmentData->setTexture(textures[segments[i].texture]);
+                segmentData->blendMode = (int)segments[i].blendMode;
+                segmentData->indexCount = segments[i].indexCount;
+                segmentData->vertexFloatCount = segments[i].vertexFloatCount;
+            }
+
+            const uint8_t *vertices = file->getVertices(frame);
+            if (vertices) {
+                frameData->vb.wrap(vertices, frame.vertexBytes);
+            } else if (frame.vertexBytes > 0) {
+                frameData->vb.checkSpace(frame.vertexBytes);
+                file->decodeVertices(frame, (float *)frameData->vb.getBuffer());
+                frameData->vb.move(frame.vertexBytes);
+            }
+            frameData->ib.wrap(file->getIndices(frame), frame.indexBytes);
+        }
+        _animationCaches[animationData->_animationName] = animationData;
+    }
+    return true;
+}
+
 CCArmatureDisplay *ArmatureCache::getArmatureDisplay() {
     return _armatureDisplay;
 }
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "BakedCache.h"
 #include "CCArmatureDisplay.h"
 #include "IOBuffer.h"
 #include "base/Ref.h"
@@ -132,8 +133,15 @@ public:
     void resetAllAnimationData();
     void resetAnimationData(const std::string &animationName);
 
+    // Bakes every animation of the armature to the end and writes them to a baked cache file.
+    bool saveBakedData(const std::string &fullPath, bool quantize = false);
+    // Replaces the animation caches with the frames of a baked cache file and takes the file.
+    // The replaced frames are freed, so only load into a cache nothing plays yet.
+    bool loadBakedData(cc::middleware::BakedCacheFile *file);
+
 private:
     void renderAnimationFrame(AnimationData *animationData);
+    void clearAnimationCaches();
     void traverseArmature(Armature *armature, float parentOpacity = 1.0f);
 
 public:
@@ -154,6 +162,9 @@ private:
     int _materialLen = 0;
     std::string _curAnimationName = "";
     std::map<std::string, AnimationData *> _animationCaches;
+    std::string _atlasUUID;
+    // frames loaded from a baked cache may reference its memory
+    cc::middleware::BakedCacheFile *_bakedFile = nullptr;
 };
 
 DRAGONBONES_NAMESPACE_END
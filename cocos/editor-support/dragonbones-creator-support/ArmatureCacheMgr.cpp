@@ -22,6 +22,7 @@
  */
 
 #include "ArmatureCacheMgr.h"
+#include "platform/FileUtils.h"
 
 DRAGONBONES_NAMESPACE_BEGIN
 
@@ -36,6 +37,30 @@ ArmatureCache *ArmatureCacheMgr::buildArmatureCache(const std::string &armatureN
     return animation;
 }
 
+ArmatureCache *ArmatureCacheMgr::loadArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID, const std::string &bakedFilePath) {
+    // a shared cache may already be played, its frames must not be replaced under the displays using it
+    ArmatureCache *animation = _caches.at(armatureKey);
+    if (animation) return animation;
+
+    animation = buildArmatureCache(armatureName, armatureKey, atlasUUID);
+    auto *fileUtils = cc::FileUtils::getInstance();
+    std::string fullPath = fileUtils->fullPathForFilename(bakedFilePath);
+    if (fullPath.empty()) return animation;
+
+    auto *file = cc::middleware::BakedCacheFile::openMapped(fullPath);
+    if (!file) {
+        // packed assets can not be mapped, read them instead
+        cc::Data data = fileUtils->getDataFromFile(fullPath);
+        if (!data.isNull()) {
+            file = cc::middleware::BakedCacheFile::createWithData(data.getBytes(), (std::size_t)data.getSize());
+        }
+    }
+    if (!animation->loadBakedData(file)) {
+        CC_LOG_WARNING("Dragonbones: Invalid baked cache: %s", bakedFilePath.c_str());
+    }
+    return animation;
+}
+
 void ArmatureCacheMgr::removeArmatureCache(const std::string &uuid) {
     for (auto it = _caches.begin(); it != _caches.end();) {
         auto found = it->first.find(uuid);
@@ -47,6 +47,9 @@ public:
 
     void removeArmatureCache(const std::string &armatureKey);
     ArmatureCache *buildArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID);
+    // Builds the cache with the frames of a baked cache file, if the file can not be loaded
+    // frames are built at runtime as usual. A cache already built under the key is returned as is.
+    ArmatureCache *loadArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID, const std::string &bakedFilePath);
 
 private:
     static ArmatureCacheMgr *_instance;
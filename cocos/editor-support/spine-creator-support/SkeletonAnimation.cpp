@@ -124,6 +124,27 @@ SkeletonAnimation::~SkeletonAnimation() {
 }
 
 void SkeletonAnimation::update(float deltaTime) {
+    dispatchDeferredEvents();
+    advance(deltaTime);
+}
+
+void SkeletonAnimation::updateParallel(float deltaTime) {
+    // Listeners may call into script, the queue holds their events until dispatchDeferredEvents.
+    if (_state && !_eventsDeferred) {
+        _eventsDeferred = true;
+        _state->disableQueue();
+    }
+    advance(deltaTime);
+}
+
+void SkeletonAnimation::dispatchDeferredEvents() {
+    if (!_eventsDeferred) return;
+    _eventsDeferred = false;
+    _state->enableQueue();
+    _state->drainQueue();
+}
+
+void SkeletonAnimation::advance(float deltaTime) {
     if (!_skeleton) return;
     if (!_paused) {
         deltaTime *= _timeScale * GlobalTimeScale;
@@ -142,6 +163,7 @@ void SkeletonAnimation::setAnimationStateData(AnimationStateData *stateData) {
         delete _state;
     }
 
+    _eventsDeferred         = false;
     _ownsAnimationStateData = false;
     _state                  = new (__FILE__, __LINE__) AnimationState(stateData);
     _state->setRendererObject(this);
@@ -51,6 +51,9 @@ public:
     static void setGlobalTimeScale(float timeScale);
 
     virtual void update(float deltaTime) override;
+    virtual bool isParallelUpdateSafe() const override { return _ownsSkeleton; }
+    virtual void updateParallel(float deltaTime) override;
+    virtual void dispatchDeferredEvents() override;
 
     void setAnimationStateData(AnimationStateData *stateData);
     void setMix(const std::string &fromAnimation, const std::string &toAnimation, float duration);
@@ -102,6 +105,11 @@ protected:
     EventListener _eventListener = nullptr;
 
 private:
+    void advance(float deltaTime);
+
+    // Set while the state listeners are held back by updateParallel.
+    bool _eventsDeferred = false;
+
     typedef SkeletonRenderer super;
 };
 
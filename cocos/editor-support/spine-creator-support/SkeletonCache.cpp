@@ -35,6 +35,21 @@ using namespace cc;
 
 namespace spine {
 
+namespace {
+const char TEXTURE_KEY_SEPARATOR = '\n';
+
+middleware::Texture2D *getAttachmentTexture(Attachment *attachment) {
+    if (!attachment) return nullptr;
+    AttachmentVertices *attachmentVertices = nullptr;
+    if (attachment->getRTTI().isExactly(RegionAttachment::rtti)) {
+        attachmentVertices = (AttachmentVertices *)((RegionAttachment *)attachment)->getRendererObject();
+    } else if (attachment->getRTTI().isExactly(MeshAttachment::rtti)) {
+        attachmentVertices = (AttachmentVertices *)((MeshAttachment *)attachment)->getRendererObject();
+    }
+    return attachmentVertices ? attachmentVertices->_texture : nullptr;
+}
+} // namespace
+
 float SkeletonCache::FrameTime = 1.0f / 60.0f;
 float SkeletonCache::MaxCacheTime = 120.0f;
 
@@ -160,10 +175,17 @@ SkeletonCache::SkeletonCache() {
 }
 
 SkeletonCache::~SkeletonCache() {
+    clearAnimationCaches();
+    delete _bakedFile;
+    _bakedFile = nullptr;
+}
+
+void SkeletonCache::clearAnimationCaches() {
     for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
         delete it->second;
     }
     _animationCaches.clear();
+    _curAnimationName = "";
 }
 
 SkeletonCache::AnimationData *SkeletonCache::buildAnimationData(const std::string &animationName) {
@@ -542,6 +564,144 @@ void SkeletonCache::onAnimationStateEvent(TrackEntry *entry, EventType type, Eve
     }
 }
 
+bool SkeletonCache::saveBakedData(const std::string &fullPath, bool quantize /*= false*/) {
+    if (!_skeleton) return false;
+
+    // Textures are keyed by an attachment that renders with them, as runtime textures differ per launch.
+    std::map<middleware::Texture2D *, std::string> textureKeys;
+    auto &skins = _skeleton->getData()->getSkins();
+    for (size_t i = 0, n = skins.size(); i < n; ++i) {
+        Skin *skin = skins[i];
+        auto entries = skin->getAttachments();
+        while (entries.hasNext()) {
+            auto &entry = entries.next();
+            middleware::Texture2D *texture = getAttachmentTexture(entry._attachment);
+            if (!texture || textureKeys.count(texture)) continue;
+            std::string key = skin->getName().buffer();
+            key += TEXTURE_KEY_SEPARATOR;
+            key += std::to_string(entry._slotIndex);
+            key += TEXTURE_KEY_SEPARATOR;
+            key += entry._name.buffer();
+            textureKeys[texture] = key;
+        }
+    }
+
+    // every animation of the skeleton is baked, not only the ones played so far
+    auto &animations = _skeleton->getData()->getAnimations();
+    for (size_t i = 0, n = animations.size(); i < n; ++i) {
+        buildAnimationData(animations[i]->getName().buffer());
+    }
+
+    middleware::BakedCacheWriter writer(sizeof(V2F_T2F_C4F_C4F) / sizeof(float), 255.0F, quantize);
+    for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
+        updateToFrame(it->first);
+        AnimationData *animationData = it->second;
+        writer.beginAnimation(animationData->_animationName, animationData->_isComplete, animationData->_totalTime);
+
+        for (std::size_t i = 0, c = animationData->getFrameCount(); i < c; i++) {
+            FrameData *frameData = animationData->getFrameData(i);
+            writer.beginFrame();
+            for (auto *boneData : frameData->getBones()) {
+                writer.addBone(boneData->globalTransformMatrix.m);
+            }
+            for (auto *colorData : frameData->getColors()) {
+                writer.addColor(&colorData->finalColor.r, &colorData->darkColor.r, colorData->vertexFloatOffset);
+            }
+            for (auto *segmentData : frameData->getSegments()) {
+                auto keyIt = textureKeys.find(segmentData->getTexture());
+                if (keyIt == textureKeys.end()) return false;
+                writer.addSegment(writer.addTexture(keyIt->second), segmentData->blendMode, segmentData->indexCount, segmentData->vertexFloatCount);
+            }
+            writer.endFrame(frameData->vb.getBuffer(), frameData->vb.getCurPos(), frameData->ib.getBuffer(), frameData->ib.getCurPos());
+        }
+    }
+    return writer.save(fullPath);
+}
+
+bool SkeletonCache::loadBakedData(middleware::BakedCacheFile *file) {
+    if (!file) return false;
+    if (!_skeleton || file->getVertexFloats() != sizeof(V2F_T2F_C4F_C4F) / sizeof(float)) {
+        delete file;
+        return false;
+    }
+
+    std::vector<middleware::Texture2D *> textures(file->getTextureCount(), nullptr);
+    for (uint32_t i = 0, n = file->getTextureCount(); i < n; ++i) {
+        std::string key = file->getTextureKey(i);
+        auto slotPos = key.find(TEXTURE_KEY_SEPARATOR);
+        auto namePos = slotPos == std::string::npos ? slotPos : key.find(TEXTURE_KEY_SEPARATOR, slotPos + 1);
+        if (namePos != std::string::npos) {
+            Skin *skin = _skeleton->getData()->findSkin(String(key.substr(0, slotPos).c_str()));
+            auto slotIndex = (size_t)atoi(key.substr(slotPos + 1, namePos - slotPos - 1).c_str());
+            if (skin) {
+                textures[i] = getAttachmentTexture(skin->getAttachment(slotIndex, String(key.substr(namePos + 1).c_str())));
+            }
+        }
+        if (!textures[i]) {
+            CC_LOG_WARNING("Spine: Baked cache texture not found: %s", key.c_str());
+            delete file;
+            return false;
+        }
+    }
+
+    clearAnimationCaches();
+    delete _bakedFile;
+    _bakedFile = file;
+
+    for (uint32_t a = 0, an = file->getAnimationCount(); a < an; ++a) {
+        const auto &animation = file->getAnimation(a);
+        auto *animationData = new AnimationData();
+        animationData->_animationName = file->getAnimationName(a);
+        animationData->_isComplete = animation.isComplete != 0;
+        animationData->_totalTime = animation.totalTime;
+
+        for (uint32_t f = 0; f < animation.frameCount; ++f) {
+            const auto &frame = file->getFrame(animation.firstFrame + f);
+            FrameData *frameData = animationData->buildFrameData(f);
+
+            const float *bones = file->getBones(frame);
+            for (uint32_t i = 0; i < frame.boneCount; ++i, bones += middleware::BakedCacheFormat::BONE_FLOATS) {
+                auto &matm = frameData->buildBoneData(i)->globalTransformMatrix.m;
+                matm[0] = bones[0];
+                matm[1] = bones[1];
+                matm[4] = bones[2];
+                matm[5] = bones[3];
+                matm[12] = bones[4];
+                matm[13] = bones[5];
+            }
+
+            const auto *colors = file->getColors(frame);
+            for (uint32_t i = 0; i < frame.colorCount; ++i) {
+                ColorData *colorData = frameData->buildColorData(i);
+                colorData->finalColor = Color4F(colors[i].finalColor[0], colors[i].finalColor[1], colors[i].finalColor[2], colors[i].finalColor[3]);
+                colorData->darkColor = Color4F(colors[i].darkColor[0], colors[i].darkColor[1], colors[i].darkColor[2], colors[i].darkColor[3]);
+                colorData->vertexFloatOffset = (int)colors[i].vertexFloatOffset;
+            }
+
+            const auto *segments = file->getSegments(frame);
+            for (uint32_t i = 0; i < frame.segmentCount; ++i) {
+                SegmentData *segmentData = frameData->buildSegmentData(i);
+                segmentData->setTexture(textures[segments[i].texture]);
+                segmentData->blendMode = (int)segments[i].blendMode;
+                segmentData->indexCount = (int)segments[i].indexCount;
+                segmentData->vertexFloatCount = (int)segments[i].vertexFloatCount;
+            }
+
+            const uint8_t *vertices = file->getVertices(frame);
+            if (vertices) {
+                frameData->vb.wrap(vertices, frame.vertexBytes);
+            } else if (frame.vertexBytes > 0) {
+                frameData->vb.checkSpace(frame.vertexBytes);
+                file->decodeVertices(frame, (float *)frameData->vb.getBuffer());
+                frameData->vb.move(frame.vertexBytes);
+            }
+            frameData->ib.wrap(file->getIndices(frame), frame.indexBytes);
+        }
+        _animationCaches[animationData->_animationName] = animationData;
+    }
+    return true;
+}
+
 void SkeletonCache::resetAllAnimationData() {
     for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
         it->second->reset();
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "BakedCache.h"
 #include "IOBuffer.h"
 #include "SkeletonAnimation.h"
 #include "middleware-adapter.h"
@@ -143,8 +144,15 @@ public:
     void resetAllAnimationData();
     void resetAnimationData(const std::string &animationName);
 
+    // Bakes every animation of the skeleton to the end and writes them to a baked cache file.
+    bool saveBakedData(const std::string &fullPath, bool quantize = false);
+    // Replaces the animation caches with the frames of a baked cache file and takes the file.
+    // The replaced frames are freed, so only load into a cache nothing plays yet.
+    bool loadBakedData(cc::middleware::BakedCacheFile *file);
+
 private:
     void renderAnimationFrame(AnimationData *animationData);
+    void clearAnimationCaches();
 
 public:
     static float FrameTime;
@@ -153,5 +161,7 @@ public:
 private:
     std::string _curAnimationName = "";
     std::map<std::string, AnimationData *> _animationCaches;
+    // frames loaded from a baked cache may reference its memory
+    cc::middleware::BakedCacheFile *_bakedFile = nullptr;
 };
 } // namespace spine
@@ -159,28 +159,37 @@ void SkeletonCacheAnimation::update(float dt) {
     _curFrameIndex = frameIdx;
 }
 
-void SkeletonCacheAnimation::render(float dt) {
-    if (!_animationData) return;
+SkeletonCache::FrameData *SkeletonCacheAnimation::getRenderFrameData() const {
+    if (!_animationData) return nullptr;
     SkeletonCache::FrameData *frameData = _animationData->getFrameData(_curFrameIndex);
-    if (!frameData) return;
+    if (!frameData) return nullptr;
+    if (frameData->getSegments().size() == 0 || frameData->getColors().size() == 0) return nullptr;
+    return frameData;
+}
 
-    auto &segments = frameData->getSegments();
-    auto &colors = frameData->getColors();
-    if (segments.size() == 0 || colors.size() == 0) return;
+void SkeletonCacheAnimation::getSegmentBytes(const SkeletonCache::SegmentData *segment, int &vertexBytes, int &indexBytes) const {
+    // vertices are cached with two colors, the second one is dropped without tint
+    vertexBytes = segment->vertexFloatCount * sizeof(float);
+    if (!_useTint) {
+        vertexBytes = vertexBytes / sizeof(V2F_T2F_C4F_C4F) * sizeof(V2F_T2F_C4F);
+    }
+    indexBytes = segment->indexCount * sizeof(unsigned short);
+}
 
+bool SkeletonCacheAnimation::writeRenderInfoHead(const SkeletonCache::FrameData *frameData) {
     auto mgr = MiddlewareManager::getInstance();
-    if (!mgr->isRendering) return;
+    if (!mgr->isRendering) return false;
 
     _sharedBufferOffset->reset();
     _sharedBufferOffset->clear();
 
     auto renderMgr = mgr->getRenderInfoMgr();
     auto renderInfo = renderMgr->getBuffer();
-    if (!renderInfo) return;
+    if (!renderInfo) return false;
 
     auto attachMgr = mgr->getAttachInfoMgr();
     auto attachInfo = attachMgr->getBuffer();
-    if (!attachInfo) return;
+    if (!attachInfo) return false;
 
     //  store render info offset
     _sharedBufferOffset->writeUint32((uint32_t)renderInfo->getCurPos() / sizeof(uint32_t));
@@ -193,209 +202,242 @@ void SkeletonCacheAnimation::render(float dt) {
     renderInfo->writeUint32(0xffffffff);
 
     // matieral len
-    renderInfo->writeUint32(segments.size());
+    renderInfo->writeUint32(frameData->getSegments().size());
+    return true;
+}
+
+void SkeletonCacheAnimation::writeSegmentInfo(const SkeletonCache::SegmentData *segment, std::size_t bufferIndex, int indexOffset) {
+    auto renderInfo = MiddlewareManager::getInstance()->getRenderInfoMgr()->getBuffer();
+
+    // check enough space
+    renderInfo->checkSpace(sizeof(uint32_t) * 6, true);
+
+    // fill new texture index
+    renderInfo->writeUint32(segment->getTexture()->getRealTextureIndex());
 
-    auto vertexFormat = _useTint ? VF_XYZUVCC : VF_XYZUVC;
-    middleware::MeshBuffer *mb = mgr->getMeshBuffer(vertexFormat);
-    middleware::IOBuffer &vb = mb->getVB();
-    middleware::IOBuffer &ib = mb->getIB();
-    const auto &srcVB = frameData->vb;
-    const auto &srcIB = frameData->ib;
-
-    // vertex size int bytes with one color
-    int vbs1 = sizeof(V2F_T2F_C4F);
-    // vertex size in floats with one color
-    int vs1 = vbs1 / sizeof(float);
-    // vertex size int bytes with two color
-    int vbs2 = sizeof(V2F_T2F_C4F_C4F);
-    // vertex size in floats with two color
-    int vs2 = vbs2 / sizeof(float);
-
-    int vs = _useTint ? vs2 : vs1;
-    int vbs = _useTint ? vbs2 : vbs1;
-
-    auto paramsBuffer = _paramsBuffer->getBuffer();
-    const cc::Mat4 &nodeWorldMat = *(cc::Mat4 *)&paramsBuffer[4];
-
-    int colorOffset = 0;
-    SkeletonCache::ColorData *nowColor = colors[colorOffset++];
-    auto maxVFOffset = nowColor->vertexFloatOffset;
-
-    Color4F finalColor;
-    Color4F darkColor;
-    float tempR = 0.0f, tempG = 0.0f, tempB = 0.0f, tempA = 0.0f;
-    float multiplier = 1.0f;
-    int srcVertexBytesOffset = 0;
-    int srcVertexBytes = 0;
-    int vertexBytes = 0;
-    int vertexFloats = 0;
-    int tintBytes = 0;
-    int srcIndexBytesOffset = 0;
-    int indexBytes = 0;
-    int curTextureIndex = 0;
-    double effectHash = 0;
-    int blendMode = 0;
-    int dstVertexOffset = 0;
-    int dstIndexOffset = 0;
-    float *dstVertexBuffer = nullptr;
-    unsigned int *dstColorBuffer = nullptr;
-    unsigned short *dstIndexBuffer = nullptr;
-    bool needColor = false;
     int curBlendSrc = -1;
     int curBlendDst = -1;
+    switch (segment->blendMode) {
+        case BlendMode_Additive:
+            curBlendSrc = (int)(_premultipliedAlpha ? BlendFactor::ONE : BlendFactor::SRC_ALPHA);
+            curBlendDst = (int)BlendFactor::ONE;
+            break;
+        case BlendMode_Multiply:
+            curBlendSrc = (int)BlendFactor::DST_COLOR;
+            curBlendDst = (int)BlendFactor::ONE_MINUS_SRC_ALPHA;
+            break;
+        case BlendMode_Screen:
+            curBlendSrc = (int)BlendFactor::ONE;
+            curBlendDst = (int)BlendFactor::ONE_MINUS_SRC_COLOR;
+            break;
+        default:
+            curBlendSrc = (int)(_premultipliedAlpha ? BlendFactor::ONE : BlendFactor::SRC_ALPHA);
+            curBlendDst = (int)BlendFactor::ONE_MINUS_SRC_ALPHA;
+    }
+    // fill new blend src and dst
+    renderInfo->writeUint32(curBlendSrc);
+    renderInfo->writeUint32(curBlendDst);
+
+    // fill new index and vertex buffer id
+    renderInfo->writeUint32(bufferIndex);
 
-    if (abs(_nodeColor.r - 1.0f) > 0.0001f ||
-        abs(_nodeColor.g - 1.0f) > 0.0001f ||
-        abs(_nodeColor.b - 1.0f) > 0.0001f ||
-        abs(_nodeColor.a - 1.0f) > 0.0001f ||
-        _premultipliedAlpha) {
-        needColor = true;
+    // fill new index offset
+    renderInfo->writeUint32(indexOffset);
+    // fill new indice segamentation count
+    renderInfo->writeUint32(segment->indexCount);
+}
+
+void SkeletonCacheAnimation::writeAttachInfo(const SkeletonCache::FrameData *frameData) {
+    if (!_useAttach) return;
+
+    auto attachInfo = MiddlewareManager::getInstance()->getAttachInfoMgr()->getBuffer();
+    auto &bonesData = frameData->getBones();
+    auto boneCount = frameData->getBoneCount();
+
+    for (int i = 0, n = boneCount; i < n; i++) {
+        auto bone = bonesData[i];
+        attachInfo->checkSpace(sizeof(cc::Mat4), true);
+        attachInfo->writeBytes((const char *)&bone->globalTransformMatrix, sizeof(cc::Mat4));
     }
+}
 
-    auto handleColor = [&](SkeletonCache::ColorData *colorData) {
-        tempA = colorData->finalColor.a * _nodeColor.a;
-        multiplier = _premultipliedAlpha ? tempA / 255 : 1;
-        tempR = _nodeColor.r * multiplier;
-        tempG = _nodeColor.g * multiplier;
-        tempB = _nodeColor.b * multiplier;
-
-        finalColor.a = tempA / 255.0f;
-        finalColor.r = (colorData->finalColor.r * tempR) / 255.0f;
-        finalColor.g = (colorData->finalColor.g * tempG) / 255.0f;
-        finalColor.b = (colorData->finalColor.b * tempB) / 255.0f;
-
-        darkColor.r = (colorData->darkColor.r * tempR) / 255.0f;
-        darkColor.g = (colorData->darkColor.g * tempG) / 255.0f;
-        darkColor.b = (colorData->darkColor.b * tempB) / 255.0f;
-        darkColor.a = _premultipliedAlpha ? 1.0f : 0.0f;
-    };
-
-    handleColor(nowColor);
-
-    for (std::size_t segIndex = 0, segLen = segments.size(); segIndex < segLen; segIndex++) {
-        auto segment = segments[segIndex];
-        srcVertexBytes = segment->vertexFloatCount * sizeof(float);
-        if (!_useTint) {
-            tintBytes = segment->vertexFloatCount / vs2 * sizeof(float);
-            vertexBytes = srcVertexBytes - tintBytes;
-            vertexFloats = vertexBytes / sizeof(float);
-        } else {
-            vertexBytes = srcVertexBytes;
-            vertexFloats = segment->vertexFloatCount;
-        }
+void SkeletonCacheAnimation::beginFill(const SkeletonCache::FrameData *frameData, FillState &state) const {
+    state.colorOffset = 0;
+    state.srcVertexBytesOffset = 0;
+    state.srcIndexBytesOffset = 0;
+    state.needColor = abs(_nodeColor.r - 1.0f) > 0.0001f ||
+                      abs(_nodeColor.g - 1.0f) > 0.0001f ||
+                      abs(_nodeColor.b - 1.0f) > 0.0001f ||
+                      abs(_nodeColor.a - 1.0f) > 0.0001f ||
+                      _premultipliedAlpha;
+    nextFillColor(frameData, state);
+}
 
-        // check enough space
-        renderInfo->checkSpace(sizeof(uint32_t) * 6, true);
-
-        // fill new texture index
-        curTextureIndex = segment->getTexture()->getRealTextureIndex();
-        renderInfo->writeUint32(curTextureIndex);
-
-        blendMode = segment->blendMode;
-        switch (blendMode) {
-            case BlendMode_Additive:
-                curBlendSrc = (int)(_premultipliedAlpha ? BlendFactor::ONE : BlendFactor::SRC_ALPHA);
-                curBlendDst = (int)BlendFactor::ONE;
-                break;
-            case BlendMode_Multiply:
-                curBlendSrc = (int)BlendFactor::DST_COLOR;
-                curBlendDst = (int)BlendFactor::ONE_MINUS_SRC_ALPHA;
-                break;
-            case BlendMode_Screen:
-                curBlendSrc = (int)BlendFactor::ONE;
-                curBlendDst = (int)BlendFactor::ONE_MINUS_SRC_COLOR;
-                break;
-            default:
-                curBlendSrc = (int)(_premultipliedAlpha ? BlendFactor::ONE : BlendFactor::SRC_ALPHA);
-                curBlendDst = (int)BlendFactor::ONE_MINUS_SRC_ALPHA;
-        }
-        // fill new blend src and dst
-        renderInfo->writeUint32(curBlendSrc);
-        renderInfo->writeUint32(curBlendDst);
+void SkeletonCacheAnimation::nextFillColor(const SkeletonCache::FrameData *frameData, FillState &state) const {
+    SkeletonCache::ColorData *colorData = frameData->getColors()[state.colorOffset++];
+    state.maxVFOffset = colorData->vertexFloatOffset;
 
-        // fill vertex buffer
-        vb.checkSpace(vertexBytes, true);
-        dstVertexOffset = (int)vb.getCurPos() / vbs;
-        dstVertexBuffer = (float *)vb.getCurBuffer();
-        dstColorBuffer = (unsigned int *)vb.getCurBuffer();
-        if (!_useTint) {
-            char *srcBuffer = (char *)srcVB.getBuffer() + srcVertexBytesOffset;
-            for (std::size_t srcBufferIdx = 0; srcBufferIdx < srcVertexBytes; srcBufferIdx += vbs2) {
-                vb.writeBytes(srcBuffer + srcBufferIdx, vbs);
-            }
-        } else {
-            vb.writeBytes((char *)srcVB.getBuffer() + srcVertexBytesOffset, vertexBytes);
+    float tempA = colorData->finalColor.a * _nodeColor.a;
+    float multiplier = _premultipliedAlpha ? tempA / 255 : 1;
+    float tempR = _nodeColor.r * multiplier;
+    float tempG = _nodeColor.g * multiplier;
+    float tempB = _nodeColor.b * multiplier;
+
+    state.finalColor.a = tempA / 255.0f;
+    state.finalColor.r = (colorData->finalColor.r * tempR) / 255.0f;
+    state.finalColor.g = (colorData->finalColor.g * tempG) / 255.0f;
+    state.finalColor.b = (colorData->finalColor.b * tempB) / 255.0f;
+
+    state.darkColor.r = (colorData->darkColor.r * tempR) / 255.0f;
+    state.darkColor.g = (colorData->darkColor.g * tempG) / 255.0f;
+    state.darkColor.b = (colorData->darkColor.b * tempB) / 255.0f;
+    state.darkColor.a = _premultipliedAlpha ? 1.0f : 0.0f;
+}
+
+void SkeletonCacheAnimation::fillSegment(const SkeletonCache::FrameData *frameData, const SkeletonCache::SegmentData *segment, FillState &state,
+                                         uint8_t *dstVertices, uint8_t *dstIndices, int dstVertexOffset) const {
+    // vertex size in floats with one and with two colors
+    const int vs1 = sizeof(V2F_T2F_C4F) / sizeof(float);
+    const int vs2 = sizeof(V2F_T2F_C4F_C4F) / sizeof(float);
+    const int vs = _useTint ? vs2 : vs1;
+    const int vbs = vs * sizeof(float);
+
+    int vertexBytes = 0;
+    int indexBytes = 0;
+    getSegmentBytes(segment, vertexBytes, indexBytes);
+    const int srcVertexBytes = segment->vertexFloatCount * sizeof(float);
+    const int vertexFloats = vertexBytes / sizeof(float);
+
+    // fill vertex buffer
+    auto dstVertexBuffer = (float *)dstVertices;
+    auto dstColorBuffer = (unsigned int *)dstVertices;
+    char *srcBuffer = (char *)frameData->vb.getBuffer() + state.srcVertexBytesOffset;
+    if (!_useTint) {
+        for (int srcBufferIdx = 0, dstBufferIdx = 0; srcBufferIdx < srcVertexBytes; srcBufferIdx += vs2 * sizeof(float), dstBufferIdx += vbs) {
+            memcpy(dstVertices + dstBufferIdx, srcBuffer + srcBufferIdx, vbs);
         }
+    } else {
+        memcpy(dstVertices, srcBuffer, vertexBytes);
+    }
 
-        // batch handle
-        if (_batch) {
-            cc::Vec3 *point = nullptr;
-            for (auto posIndex = 0; posIndex < vertexFloats; posIndex += vs) {
-                point = (cc::Vec3 *)(dstVertexBuffer + posIndex);
-                // force z value to zero
-                point->z = 0;
-                point->transformMat4(*point, nodeWorldMat);
-            }
+    // batch handle
+    if (_batch) {
+        auto paramsBuffer = _paramsBuffer->getBuffer();
+        const cc::Mat4 &nodeWorldMat = *(cc::Mat4 *)&paramsBuffer[4];
+        cc::Vec3 *point = nullptr;
+        for (auto posIndex = 0; posIndex < vertexFloats; posIndex += vs) {
+            point = (cc::Vec3 *)(dstVertexBuffer + posIndex);
+            // force z value to zero
+            point->z = 0;
+            point->transformMat4(*point, nodeWorldMat);
         }
+    }
 
-        // handle vertex color
-        if (needColor) {
-            int srcVertexFloatOffset = srcVertexBytesOffset / sizeof(float);
+    // handle vertex color
+    if (state.needColor) {
+        int srcVertexFloatOffset = state.srcVertexBytesOffset / sizeof(float);
+        for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertexFloatOffset += vs2) {
+            if (srcVertexFloatOffset >= state.maxVFOffset) {
+                nextFillColor(frameData, state);
+            }
+            memcpy(dstColorBuffer + colorIndex + 5, &state.finalColor, sizeof(state.finalColor));
             if (_useTint) {
-                for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertexFloatOffset += vs2) {
-                    if (srcVertexFloatOffset >= maxVFOffset) {
-                        nowColor = colors[colorOffset++];
-                        handleColor(nowColor);
-                        maxVFOffset = nowColor->vertexFloatOffset;
-                    }
-                    memcpy(dstColorBuffer + colorIndex + 5, &finalColor, sizeof(finalColor));
-                    memcpy(dstColorBuffer + colorIndex + 9, &darkColor, sizeof(darkColor));
-                }
-            } else {
-                for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertexFloatOffset += vs2) {
-                    if (srcVertexFloatOffset >= maxVFOffset) {
-                        nowColor = colors[colorOffset++];
-                        handleColor(nowColor);
-                        maxVFOffset = nowColor->vertexFloatOffset;
-                    }
-                    memcpy(dstColorBuffer + colorIndex + 5, &finalColor, sizeof(finalColor));
-                }
+                memcpy(dstColorBuffer + colorIndex + 9, &state.darkColor, sizeof(state.darkColor));
             }
         }
+    }
+
+    // move src vertex buffer offset
+    state.srcVertexBytesOffset += srcVertexBytes;
 
-        // move src vertex buffer offset
-        srcVertexBytesOffset += srcVertexBytes;
+    // fill index buffer
+    auto dstIndexBuffer = (unsigned short *)dstIndices;
+    memcpy(dstIndices, (char *)frameData->ib.getBuffer() + state.srcIndexBytesOffset, indexBytes);
+    for (auto indexPos = 0; indexPos < segment->indexCount; indexPos++) {
+        dstIndexBuffer[indexPos] += dstVertexOffset;
+    }
+    state.srcIndexBytesOffset += indexBytes;
+}
 
-        // fill index buffer
-        indexBytes = segment->indexCount * sizeof(unsigned short);
+void SkeletonCacheAnimation::render(float dt) {
+    SkeletonCache::FrameData *frameData = getRenderFrameData();
+    if (!frameData || !writeRenderInfoHead(frameData)) return;
+
+    auto vertexFormat = _useTint ? VF_XYZUVCC : VF_XYZUVC;
+    middleware::MeshBuffer *mb = MiddlewareManager::getInstance()->getMeshBuffer(vertexFormat);
+    middleware::IOBuffer &vb = mb->getVB();
+    middleware::IOBuffer &ib = mb->getIB();
+    const int vbs = vertexFormat * sizeof(float);
+
+    FillState state;
+    beginFill(frameData, state);
+    int vertexBytes = 0;
+    int indexBytes = 0;
+    for (auto segment : frameData->getSegments()) {
+        getSegmentBytes(segment, vertexBytes, indexBytes);
+        // a full vertex buffer rolls over to the next buffer, the segment goes there as a whole
+        vb.checkSpace(vertexBytes, true);
         ib.checkSpace(indexBytes, true);
-        dstIndexOffset = (int)ib.getCurPos() / sizeof(unsigned short);
-        dstIndexBuffer = (unsigned short *)ib.getCurBuffer();
-        ib.writeBytes((char *)srcIB.getBuffer() + srcIndexBytesOffset, indexBytes);
-        for (auto indexPos = 0; indexPos < segment->indexCount; indexPos++) {
-            dstIndexBuffer[indexPos] += dstVertexOffset;
-        }
-        srcIndexBytesOffset += indexBytes;
+        writeSegmentInfo(segment, mb->getBufferPos(), (int)ib.getCurPos() / sizeof(unsigned short));
+        fillSegment(frameData, segment, state, vb.getCurBuffer(), ib.getCurBuffer(), (int)vb.getCurPos() / vbs);
+        vb.move(vertexBytes);
+        ib.move(indexBytes);
+    }
 
-        // fill new index and vertex buffer id
-        auto bufferIndex = mb->getBufferPos();
-        renderInfo->writeUint32(bufferIndex);
+    writeAttachInfo(frameData);
+}
 
-        // fill new index offset
-        renderInfo->writeUint32(dstIndexOffset);
-        // fill new indice segamentation count
-        renderInfo->writeUint32(segment->indexCount);
+void SkeletonCacheAnimation::getRenderSize(int &vertexFormat, std::size_t &vertexBytes, std::size_t &indexBytes) const {
+    vertexFormat = _useTint ? VF_XYZUVCC : VF_XYZUVC;
+    vertexBytes = 0;
+    indexBytes = 0;
+    SkeletonCache::FrameData *frameData = getRenderFrameData();
+    if (!frameData) return;
+
+    int segmentVertexBytes = 0;
+    int segmentIndexBytes = 0;
+    for (auto segment : frameData->getSegments()) {
+        getSegmentBytes(segment, segmentVertexBytes, segmentIndexBytes);
+        vertexBytes += segmentVertexBytes;
+        indexBytes += segmentIndexBytes;
     }
+}
 
-    if (_useAttach) {
-        auto &bonesData = frameData->getBones();
-        auto boneCount = frameData->getBoneCount();
+void SkeletonCacheAnimation::beginRender(float dt, const RenderRange &range) {
+    // the frame data is the one getRenderSize measured, nothing runs in between
+    SkeletonCache::FrameData *frameData = getRenderFrameData();
+    _renderFrameData = nullptr;
+    if (!frameData || !writeRenderInfoHead(frameData)) return;
+    _renderFrameData = frameData;
 
-        for (int i = 0, n = boneCount; i < n; i++) {
-            auto bone = bonesData[i];
-            attachInfo->checkSpace(sizeof(cc::Mat4), true);
-            attachInfo->writeBytes((const char *)&bone->globalTransformMatrix, sizeof(cc::Mat4));
-        }
+    int indexOffset = (int)range.indexOffset / sizeof(unsigned short);
+    for (auto segment : frameData->getSegments()) {
+        writeSegmentInfo(segment, range.bufferPos, indexOffset);
+        indexOffset += segment->indexCount;
+    }
+
+    writeAttachInfo(frameData);
+}
+
+void SkeletonCacheAnimation::renderParallel(const RenderRange &range) {
+    if (!_renderFrameData) return;
+
+    // the mesh buffer may have grown since beginRender, the range is resolved now
+    uint8_t *dstVertices = range.meshBuffer->getVB().getBuffer() + range.vertexOffset;
+    uint8_t *dstIndices = range.meshBuffer->getIB().getBuffer() + range.indexOffset;
+
+    const int vbs = (_useTint ? VF_XYZUVCC : VF_XYZUVC) * sizeof(float);
+    int dstVertexOffset = (int)range.vertexOffset / vbs;
+    FillState state;
+    beginFill(_renderFrameData, state);
+    int vertexBytes = 0;
+    int indexBytes = 0;
+    for (auto segment : _renderFrameData->getSegments()) {
+        getSegmentBytes(segment, vertexBytes, indexBytes);
+        fillSegment(_renderFrameData, segment, state, dstVertices, dstIndices, dstVertexOffset);
+        dstVertices += vertexBytes;
+        dstIndices += indexBytes;
+        dstVertexOffset += vertexBytes / vbs;
     }
 }
 
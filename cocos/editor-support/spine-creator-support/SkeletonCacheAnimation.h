@@ -46,6 +46,12 @@ public:
     virtual void render(float dt) override;
     virtual uint32_t getRenderOrder() const override;
 
+    // The cached frames are read only while rendering, only the render info is written in render order.
+    virtual bool isParallelRenderSafe() const override { return true; }
+    virtual void getRenderSize(int &vertexFormat, std::size_t &vertexBytes, std::size_t &indexBytes) const override;
+    virtual void beginRender(float dt, const cc::middleware::RenderRange &range) override;
+    virtual void renderParallel(const cc::middleware::RenderRange &range) override;
+
     Skeleton *getSkeleton() const;
 
     void setTimeScale(float scale);
@@ -102,6 +108,27 @@ public:
     se_object_ptr getParamsBuffer() const;
 
 private:
+    // running source offsets and color while the segments of a frame are filled
+    struct FillState {
+        int colorOffset = 0;
+        int maxVFOffset = 0;
+        int srcVertexBytesOffset = 0;
+        int srcIndexBytesOffset = 0;
+        bool needColor = false;
+        cc::middleware::Color4F finalColor;
+        cc::middleware::Color4F darkColor;
+    };
+
+    SkeletonCache::FrameData *getRenderFrameData() const;
+    void getSegmentBytes(const SkeletonCache::SegmentData *segment, int &vertexBytes, int &indexBytes) const;
+    bool writeRenderInfoHead(const SkeletonCache::FrameData *frameData);
+    void writeSegmentInfo(const SkeletonCache::SegmentData *segment, std::size_t bufferIndex, int indexOffset);
+    void writeAttachInfo(const SkeletonCache::FrameData *frameData);
+    void beginFill(const SkeletonCache::FrameData *frameData, FillState &state) const;
+    void nextFillColor(const SkeletonCache::FrameData *frameData, FillState &state) const;
+    void fillSegment(const SkeletonCache::FrameData *frameData, const SkeletonCache::SegmentData *segment, FillState &state,
+                     uint8_t *dstVertices, uint8_t *dstIndices, int dstVertexOffset) const;
+
     float _timeScale = 1;
     bool _paused = false;
     bool _useAttach = false;
@@ -116,6 +143,8 @@ private:
     SkeletonCache *_skeletonCache = nullptr;
     SkeletonCache::AnimationData *_animationData = nullptr;
     int _curFrameIndex = -1;
+    // frame whose render info beginRender wrote, filled by renderParallel
+    SkeletonCache::FrameData *_renderFrameData = nullptr;
 
     float _accTime = 0.0f;
     int _playCount = 0;
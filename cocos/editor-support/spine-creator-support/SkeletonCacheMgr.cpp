@@ -28,6 +28,7 @@
  *****************************************************************************/
 
 #include "SkeletonCacheMgr.h"
+#include "platform/FileUtils.h"
 
 namespace spine {
 SkeletonCacheMgr *SkeletonCacheMgr::_instance = nullptr;
@@ -42,6 +43,30 @@ SkeletonCache *SkeletonCacheMgr::buildSkeletonCache(const std::string &uuid) {
     return animation;
 }
 
+SkeletonCache *SkeletonCacheMgr::loadSkeletonCache(const std::string &uuid, const std::string &bakedFilePath) {
+    // a shared cache may already be played, its frames must not be replaced under the animations using it
+    SkeletonCache *animation = _caches.at(uuid);
+    if (animation) return animation;
+
+    animation = buildSkeletonCache(uuid);
+    auto *fileUtils = cc::FileUtils::getInstance();
+    std::string fullPath = fileUtils->fullPathForFilename(bakedFilePath);
+    if (fullPath.empty()) return animation;
+
+    auto *file = cc::middleware::BakedCacheFile::openMapped(fullPath);
+    if (!file) {
+        // packed assets can not be mapped, read them instead
+        cc::Data data = fileUtils->getDataFromFile(fullPath);
+        if (!data.isNull()) {
+            file = cc::middleware::BakedCacheFile::createWithData(data.getBytes(), (std::size_t)data.getSize());
+        }
+    }
+    if (!animation->loadBakedData(file)) {
+        CC_LOG_WARNING("Spine: Invalid baked cache: %s", bakedFilePath.c_str());
+    }
+    return animation;
+}
+
 void SkeletonCacheMgr::removeSkeletonCache(const std::string &uuid) {
     auto it = _caches.find(uuid);
     if (it != _caches.end()) {
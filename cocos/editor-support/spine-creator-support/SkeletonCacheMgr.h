@@ -51,6 +51,9 @@ public:
 
     void removeSkeletonCache(const std::string &uuid);
     SkeletonCache *buildSkeletonCache(const std::string &uuid);
+    // Builds the cache with the frames of a baked cache file, if the file can not be loaded
+    // frames are built at runtime as usual. A cache already built under the key is returned as is.
+    SkeletonCache *loadSkeletonCache(const std::string &uuid, const std::string &bakedFilePath);
 
 private:
     static SkeletonCacheMgr *_instance;
@@ -31,6 +31,7 @@
 #include "MiddlewareMacro.h"
 #include "SharedBufferManager.h"
 #include "SkeletonDataMgr.h"
+#include "VertexKernels.h"
 #include "base/TypeDef.h"
 #include "base/memory/Memory.h"
 #include "math/Math.h"
@@ -59,6 +60,11 @@ enum DebugType {
     MESH,
     BONES
 };
+
+static void setBoneAffine(float *affine, Bone &bone) {
+    cc::middleware::setBoneAffine(affine, bone.getA(), bone.getB(), bone.getC(), bone.getD(), bone.getWorldX(), bone.getWorldY());
+}
+
 SkeletonRenderer *SkeletonRenderer::create() {
     auto *skeleton = new SkeletonRenderer();
     skeleton->autorelease();
@@ -267,6 +273,29 @@ void SkeletonRenderer::initWithBinaryFile(const std::string &skeletonDataFile, c
     initialize();
 }
 
+void SkeletonRenderer::computeMeshWorldVertices(Slot &slot, MeshAttachment &attachment, float *worldVertices, unsigned int stride) {
+    auto &      bones     = attachment.getBones();
+    auto &      deform    = slot.getDeform();
+    const auto  vertCount = static_cast<uint32_t>(attachment.getWorldVerticesLength() >> 1);
+    const auto *vertices  = attachment.getVertices().buffer();
+    if (bones.size() == 0) {
+        float boneAffine[BONE_AFFINE_STRIDE];
+        setBoneAffine(boneAffine, slot.getBone());
+        computeMeshVertices(boneAffine, deform.size() > 0 ? deform.buffer() : vertices, vertCount, worldVertices, stride);
+        return;
+    }
+
+    if (_boneAffinesDirty) {
+        auto &skeletonBones = _skeleton->getBones();
+        _boneAffines.resize(skeletonBones.size() * BONE_AFFINE_STRIDE);
+        for (size_t i = 0, n = skeletonBones.size(); i < n; ++i) {
+            setBoneAffine(&_boneAffines[i * BONE_AFFINE_STRIDE], *skeletonBones[i]);
+        }
+        _boneAffinesDirty = false;
+    }
+    computeWeightedMeshVertices(_boneAffines.data(), bones.buffer(), vertices, deform.size() > 0 ? deform.buffer() : nullptr, vertCount, worldVertices, stride);
+}
+
 void SkeletonRenderer::render(float /*deltaTime*/) {
     if (!_skeleton) return;
 
@@ -349,6 +378,10 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
     Slot *slot        = nullptr;
     int   isFull      = 0;
 
+    // world transform of the current slot bone, weighted meshes use the table gathered in computeMeshWorldVertices
+    float boneAffine[BONE_AFFINE_STRIDE];
+    _boneAffinesDirty = true;
+
     if (_debugSlots || _debugBones || _debugMesh) {
         // If enable debug draw,then init debug buffer.
         if (_debugBuffer == nullptr) {
@@ -466,8 +499,9 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
                 vbSize              = triangles.vertCount * sizeof(V2F_T2F_C4F);
                 isFull |= vb.checkSpace(vbSize, true);
                 triangles.verts = reinterpret_cast<V2F_T2F_C4F *>(vb.getCurBuffer());
-                memcpy(static_cast<void *>(triangles.verts), static_cast<void *>(attachmentVertices->_triangles->verts), vbSize);
-                attachment->computeWorldVertices(slot->getBone(), reinterpret_cast<float *>(triangles.verts), 0, vs1);
+                setBoneAffine(boneAffine, slot->getBone());
+                computeRegionVertices(boneAffine, attachment->getOffset().buffer(), reinterpret_cast<float *>(triangles.verts), vs1);
+                copyVertexUVs(reinterpret_cast<float *>(triangles.verts), vs1, &attachmentVertices->_triangles->verts[0].texCoord.u, vs1, triangles.vertCount);
 
                 triangles.indexCount = attachmentVertices->_triangles->indexCount;
                 ibSize               = triangles.indexCount * sizeof(uint16_t);
@@ -479,10 +513,9 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
                 vbSize                      = trianglesTwoColor.vertCount * sizeof(V2F_T2F_C4F_C4F);
                 isFull |= vb.checkSpace(vbSize, true);
                 trianglesTwoColor.verts = reinterpret_cast<V2F_T2F_C4F_C4F *>(vb.getCurBuffer());
-                for (int ii = 0; ii < trianglesTwoColor.vertCount; ii++) {
-                    trianglesTwoColor.verts[ii].texCoord = attachmentVertices->_triangles->verts[ii].texCoord;
-                }
-                attachment->computeWorldVertices(slot->getBone(), reinterpret_cast<float *>(trianglesTwoColor.verts), 0, vs2);
+                setBoneAffine(boneAffine, slot->getBone());
+                computeRegionVertices(boneAffine, attachment->getOffset().buffer(), reinterpret_cast<float *>(trianglesTwoColor.verts), vs2);
+                copyVertexUVs(reinterpret_cast<float *>(trianglesTwoColor.verts), vs2, &attachmentVertices->_triangles->verts[0].texCoord.u, vs1, trianglesTwoColor.vertCount);
 
                 trianglesTwoColor.indexCount = attachmentVertices->_triangles->indexCount;
                 ibSize                       = trianglesTwoColor.indexCount * sizeof(uint16_t);
@@ -523,8 +556,8 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
                 vbSize              = triangles.vertCount * sizeof(V2F_T2F_C4F);
                 isFull |= vb.checkSpace(vbSize, true);
                 triangles.verts = reinterpret_cast<V2F_T2F_C4F *>(vb.getCurBuffer());
-                memcpy(static_cast<void *>(triangles.verts), static_cast<void *>(attachmentVertices->_triangles->verts), vbSize);
-                attachment->computeWorldVertices(*slot, 0, attachment->getWorldVerticesLength(), reinterpret_cast<float *>(triangles.verts), 0, vs1);
+                computeMeshWorldVertices(*slot, *attachment, reinterpret_cast<float *>(triangles.verts), vs1);
+                copyVertexUVs(reinterpret_cast<float *>(triangles.verts), vs1, &attachmentVertices->_triangles->verts[0].texCoord.u, vs1, triangles.vertCount);
 
                 triangles.indexCount = attachmentVertices->_triangles->indexCount;
                 ibSize               = triangles.indexCount * sizeof(uint16_t);
@@ -536,10 +569,8 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
                 vbSize                      = trianglesTwoColor.vertCount * sizeof(V2F_T2F_C4F_C4F);
                 isFull |= vb.checkSpace(vbSize, true);
                 trianglesTwoColor.verts = reinterpret_cast<V2F_T2F_C4F_C4F *>(vb.getCurBuffer());
-                for (int ii = 0; ii < trianglesTwoColor.vertCount; ii++) {
-                    trianglesTwoColor.verts[ii].texCoord = attachmentVertices->_triangles->verts[ii].texCoord;
-                }
-                attachment->computeWorldVertices(*slot, 0, attachment->getWorldVerticesLength(), reinterpret_cast<float *>(trianglesTwoColor.verts), 0, vs2);
+                computeMeshWorldVertices(*slot, *attachment, reinterpret_cast<float *>(trianglesTwoColor.verts), vs2);
+                copyVertexUVs(reinterpret_cast<float *>(trianglesTwoColor.verts), vs2, &attachmentVertices->_triangles->verts[0].texCoord.u, vs1, trianglesTwoColor.vertCount);
 
                 trianglesTwoColor.indexCount = attachmentVertices->_triangles->indexCount;
                 ibSize                       = trianglesTwoColor.indexCount * sizeof(uint16_t);
@@ -693,13 +724,7 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
                         vertex->color.a = lightCopy.a;
                     }
                 } else {
-                    for (int v = 0, vn = triangles.vertCount; v < vn; ++v) {
-                        V2F_T2F_C4F *vertex = triangles.verts + v;
-                        vertex->color.r     = light.r;
-                        vertex->color.g     = light.g;
-                        vertex->color.b     = light.b;
-                        vertex->color.a     = light.a;
-                    }
+                    fillVertexColors(reinterpret_cast<float *>(triangles.verts), vs1, triangles.vertCount, cc::middleware::Color4F(light.r, light.g, light.b, light.a));
                 }
             }
         }
@@ -801,17 +826,8 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
                         vertex->color2.a = dark.a;
                     }
                 } else {
-                    for (int v = 0, vn = trianglesTwoColor.vertCount; v < vn; ++v) {
-                        V2F_T2F_C4F_C4F *vertex = trianglesTwoColor.verts + v;
-                        vertex->color.r         = light.r;
-                        vertex->color.g         = light.g;
-                        vertex->color.b         = light.b;
-                        vertex->color.a         = light.a;
-                        vertex->color2.r        = dark.r;
-                        vertex->color2.g        = dark.g;
-                        vertex->color2.b        = dark.b;
-                        vertex->color2.a        = dark.a;
-                    }
+                    fillVertexColors(reinterpret_cast<float *>(trianglesTwoColor.verts), vs2, trianglesTwoColor.vertCount,
+                                     cc::middleware::Color4F(light.r, light.g, light.b, light.a), cc::middleware::Color4F(dark.r, dark.g, dark.b, dark.a));
                 }
             }
         }
@@ -826,13 +842,7 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
 
         if (vbSize > 0 && ibSize > 0) {
             if (_batch) {
-                uint8_t * vbBuffer = vb.getCurBuffer();
-                cc::Vec3 *point    = nullptr;
-                for (unsigned int ii = 0, nn = vbSize; ii < nn; ii += vbs) {
-                    point = reinterpret_cast<cc::Vec3 *>(vbBuffer + ii);
-                    point->z = 0; //reset for z value
-                    point->transformMat4(*point, nodeWorldMat);
-                }
+                transformVertices(reinterpret_cast<float *>(vb.getCurBuffer()), vbs / sizeof(float), vbSize / vbs, nodeWorldMat);
             }
 
             if (vertexOffset > 0) {
@@ -148,6 +148,8 @@ public:
 
 protected:
     void setSkeletonData(SkeletonData *skeletonData, bool ownsSkeletonData);
+    // Writes the world positions of a mesh attachment straight into interleaved vertices.
+    void computeMeshWorldVertices(Slot &slot, MeshAttachment &attachment, float *worldVertices, unsigned int stride);
 
     bool _ownsSkeletonData = false;
     bool _ownsSkeleton = false;
@@ -177,6 +179,10 @@ protected:
     cc::middleware::IOTypedArray *_debugBuffer = nullptr;
     // Js fill this buffer to send parameter to cpp, avoid to call jsb function.
     cc::middleware::IOTypedArray *_paramsBuffer = nullptr;
+
+    // Bone world transforms gathered once per render for weighted meshes.
+    std::vector<float> _boneAffines;
+    bool _boneAffinesDirty = true;
 };
 
 } // namespace spine
@@ -383,6 +383,8 @@ namespace spine {
 
 		void disableQueue();
 		void enableQueue();
+		/// Raises the events queued while the queue was disabled.
+		void drainQueue();
 
 	private:
 
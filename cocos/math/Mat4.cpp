@@ -398,11 +398,7 @@ void Mat4::add(float scalar) {
 
 void Mat4::add(float scalar, Mat4 *dst) {
     GP_ASSERT(dst);
-#ifdef __SSE__
-    MathUtil::addMatrix(col, scalar, dst->col);
-#else
     MathUtil::addMatrix(m, scalar, dst->m);
-#endif
 }
 
 void Mat4::add(const Mat4 &mat) {
@@ -411,11 +407,7 @@ void Mat4::add(const Mat4 &mat) {
 
 void Mat4::add(const Mat4 &m1, const Mat4 &m2, Mat4 *dst) {
     GP_ASSERT(dst);
-#ifdef __SSE__
-    MathUtil::addMatrix(m1.col, m2.col, dst->col);
-#else
     MathUtil::addMatrix(m1.m, m2.m, dst->m);
-#endif
 }
 
 void Mat4::fromRT(const Quaternion &rotation, const Vec3 &translation, Mat4 *dst) {
@@ -615,51 +607,8 @@ float Mat4::determinant() const {
 }
 
 void Mat4::inverseTranspose(const Mat4& mat, Mat4 *dst) {
-    float a00 = mat.m[0]; float a01 = mat.m[1]; float a02 = mat.m[2]; float a03 = mat.m[3];
-    float a10 = mat.m[4]; float a11 = mat.m[5]; float a12 = mat.m[6]; float a13 = mat.m[7];
-    float a20 = mat.m[8]; float a21 = mat.m[9]; float a22 = mat.m[10]; float a23 = mat.m[11];
-    float a30 = mat.m[12]; float a31 = mat.m[13]; float a32 = mat.m[14]; float a33 = mat.m[15];
-
-    float b00 = a00 * a11 - a01 * a10;
-    float b01 = a00 * a12 - a02 * a10;
-    float b02 = a00 * a13 - a03 * a10;
-    float b03 = a01 * a12 - a02 * a11;
-    float b04 = a01 * a13 - a03 * a11;
-    float b05 = a02 * a13 - a03 * a12;
-    float b06 = a20 * a31 - a21 * a30;
-    float b07 = a20 * a32 - a22 * a30;
-    float b08 = a20 * a33 - a23 * a30;
-    float b09 = a21 * a32 - a22 * a31;
-    float b10 = a21 * a33 - a23 * a31;
-    float b11 = a22 * a33 - a23 * a32;
-
-    // Calculate the determinant
-    float det = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
-
-    if (det == 0.0) {
-        return;
-    }
-    det = 1 / det;
-
-    dst->m[0] = (a11 * b11 - a12 * b10 + a13 * b09) * det;
-    dst->m[1] = (a12 * b08 - a10 * b11 - a13 * b07) * det;
-    dst->m[2] = (a10 * b10 - a11 * b08 + a13 * b06) * det;
-    dst->m[3] = 0;
-
-    dst->m[4] = (a02 * b10 - a01 * b11 - a03 * b09) * det;
-    dst->m[5] = (a00 * b11 - a02 * b08 + a03 * b07) * det;
-    dst->m[6] = (a01 * b08 - a00 * b10 - a03 * b06) * det;
-    dst->m[7] = 0;
-
-    dst->m[8] = (a31 * b05 - a32 * b04 + a33 * b03) * det;
-    dst->m[9] = (a32 * b02 - a30 * b05 - a33 * b01) * det;
-    dst->m[10] = (a30 * b04 - a31 * b02 + a33 * b00) * det;
-    dst->m[11] = 0;
-
-    dst->m[12] = 0;
-    dst->m[13] = 0;
-    dst->m[14] = 0;
-    dst->m[15] = 1;
+    GP_ASSERT(dst);
+    MathUtil::inverseTransposeMatrix(mat.m, dst->m);
 }
 
 void Mat4::getScale(Vec3 *scale) const {
@@ -734,52 +683,7 @@ Mat4 Mat4::getInversed() const {
 }
 
 bool Mat4::inverse() {
-    float a0 = m[0] * m[5] - m[1] * m[4];
-    float a1 = m[0] * m[6] - m[2] * m[4];
-    float a2 = m[0] * m[7] - m[3] * m[4];
-    float a3 = m[1] * m[6] - m[2] * m[5];
-    float a4 = m[1] * m[7] - m[3] * m[5];
-    float a5 = m[2] * m[7] - m[3] * m[6];
-    float b0 = m[8] * m[13] - m[9] * m[12];
-    float b1 = m[8] * m[14] - m[10] * m[12];
-    float b2 = m[8] * m[15] - m[11] * m[12];
-    float b3 = m[9] * m[14] - m[10] * m[13];
-    float b4 = m[9] * m[15] - m[11] * m[13];
-    float b5 = m[10] * m[15] - m[11] * m[14];
-
-    // Calculate the determinant.
-    float det = a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0;
-
-    // Close to zero, can't invert.
-    if (std::abs(det) <= MATH_TOLERANCE) {
-        return false;
-    }
-
-    // Support the case where m == dst.
-    Mat4 inverse;
-    inverse.m[0] = m[5] * b5 - m[6] * b4 + m[7] * b3;
-    inverse.m[1] = -m[1] * b5 + m[2] * b4 - m[3] * b3;
-    inverse.m[2] = m[13] * a5 - m[14] * a4 + m[15] * a3;
-    inverse.m[3] = -m[9] * a5 + m[10] * a4 - m[11] * a3;
-
-    inverse.m[4] = -m[4] * b5 + m[6] * b2 - m[7] * b1;
-    inverse.m[5] = m[0] * b5 - m[2] * b2 + m[3] * b1;
-    inverse.m[6] = -m[12] * a5 + m[14] * a2 - m[15] * a1;
-    inverse.m[7] = m[8] * a5 - m[10] * a2 + m[11] * a1;
-
-    inverse.m[8]  = m[4] * b4 - m[5] * b2 + m[7] * b0;
-    inverse.m[9]  = -m[0] * b4 + m[1] * b2 - m[3] * b0;
-    inverse.m[10] = m[12] * a4 - m[13] * a2 + m[15] * a0;
-    inverse.m[11] = -m[8] * a4 + m[9] * a2 - m[11] * a0;
-
-    inverse.m[12] = -m[4] * b3 + m[5] * b1 - m[6] * b0;
-    inverse.m[13] = m[0] * b3 - m[1] * b1 + m[2] * b0;
-    inverse.m[14] = -m[12] * a3 + m[13] * a1 - m[14] * a0;
-    inverse.m[15] = m[8] * a3 - m[9] * a1 + m[10] * a0;
-
-    multiply(inverse, 1.0F / det, this);
-
-    return true;
+    return MathUtil::inverseMatrix(m, m);
 }
 
 bool Mat4::isIdentity() const {
@@ -796,11 +700,7 @@ void Mat4::multiply(float scalar, Mat4 *dst) const {
 
 void Mat4::multiply(const Mat4 &m, float scalar, Mat4 *dst) {
     GP_ASSERT(dst);
-#ifdef __SSE__
-    MathUtil::multiplyMatrix(m.col, scalar, dst->col);
-#else
     MathUtil::multiplyMatrix(m.m, scalar, dst->m);
-#endif
 }
 
 void Mat4::multiply(const Mat4 &mat) {
@@ -809,19 +709,11 @@ void Mat4::multiply(const Mat4 &mat) {
 
 void Mat4::multiply(const Mat4 &m1, const Mat4 &m2, Mat4 *dst) {
     GP_ASSERT(dst);
-#ifdef __SSE__
-    MathUtil::multiplyMatrix(m1.col, m2.col, dst->col);
-#else
     MathUtil::multiplyMatrix(m1.m, m2.m, dst->m);
-#endif
 }
 
 void Mat4::negate() {
-#ifdef __SSE__
-    MathUtil::negateMatrix(col, col);
-#else
     MathUtil::negateMatrix(m, m);
-#endif
 }
 
 Mat4 Mat4::getNegated() const {
@@ -949,11 +841,7 @@ void Mat4::subtract(const Mat4 &mat) {
 
 void Mat4::subtract(const Mat4 &m1, const Mat4 &m2, Mat4 *dst) {
     GP_ASSERT(dst);
-#ifdef __SSE__
-    MathUtil::subtractMatrix(m1.col, m2.col, dst->col);
-#else
     MathUtil::subtractMatrix(m1.m, m2.m, dst->m);
-#endif
 }
 
 void Mat4::transformVector(Vec3 *vector) const {
@@ -978,11 +866,7 @@ void Mat4::transformVector(Vec4 *vector) const {
 
 void Mat4::transformVector(const Vec4 &vector, Vec4 *dst) const {
     GP_ASSERT(dst);
-#ifdef __SSE__
-    MathUtil::transformVec4(col, vector.v, dst->v);
-#else
     MathUtil::transformVec4(m, reinterpret_cast<const float *>(&vector), reinterpret_cast<float *>(dst));
-#endif
 }
 
 void Mat4::translate(float x, float y, float z) {
@@ -1004,11 +888,7 @@ void Mat4::translate(const Vec3 &t, Mat4 *dst) const {
 }
 
 void Mat4::transpose() {
-#ifdef __SSE__
-    MathUtil::transposeMatrix(col, col);
-#else
     MathUtil::transposeMatrix(m, m);
-#endif
 }
 
 Mat4 Mat4::getTransposed() const {
@@ -28,11 +28,6 @@
 #include "math/Vec3.h"
 #include "math/Vec4.h"
 
-#undef __SSE__
-#ifdef __SSE__
-    #include <xmmintrin.h>
-#endif
-
 /**
  * @addtogroup base
  * @{
@@ -90,14 +85,7 @@ public:
     /**
      * Stores the columns of this 4x4 matrix.
      * */
-#ifdef __SSE__
-    union {
-        __m128 col[4];
-        float  m[16];
-    };
-#else
     float m[16];
-#endif
 
     /**
      * Default constructor.
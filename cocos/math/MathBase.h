@@ -59,6 +59,23 @@
 //#ifndef M_1_PI
 //#define M_1_PI                      0.31830988618379067154
 
+/**
+@{ SIMD configuration, USE_MATH_SIMD is set by the USE_MATH_SIMD build option.
+When enabled, the SSE (x86) or NEON (arm64) kernels in MathUtil are used.
+Mat4 and Vec4 keep their unaligned storage so layouts shared with JS don't change,
+the kernels only use unaligned loads and stores.
+*/
+#ifndef USE_MATH_SIMD
+    #define USE_MATH_SIMD 0
+#endif
+
+#if USE_MATH_SIMD
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define CC_MATH_SSE 1
+    #endif
+#endif
+/**@}*/
+
 #ifdef __cplusplus
     #define NS_CC_MATH_BEGIN namespace cc {
     #define NS_CC_MATH_END   }
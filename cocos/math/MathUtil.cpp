@@ -21,6 +21,7 @@ This file was modified to fit the cocos2d-x project
 */
 
 #include "math/MathUtil.h"
+#include <cmath>
 #include "base/Macros.h"
 
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
@@ -55,7 +56,7 @@ This file was modified to fit the cocos2d-x project
 
 #endif
 
-#if defined(__SSE__)
+#if defined(CC_MATH_SSE)
     #define USE_SSE
     #define INCLUDE_SSE
 #endif
@@ -134,6 +135,8 @@ void MathUtil::addMatrix(const float *m, float scalar, float *dst) {
     MathUtilNeon::addMatrix(m, scalar, dst);
 #elif defined(USE_NEON64)
     MathUtilNeon64::addMatrix(m, scalar, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::addMatrix(m, scalar, dst);
 #elif defined(INCLUDE_NEON32)
     if (isNeon32Enabled())
         MathUtilNeon::addMatrix(m, scalar, dst);
@@ -149,6 +152,8 @@ void MathUtil::addMatrix(const float *m1, const float *m2, float *dst) {
     MathUtilNeon::addMatrix(m1, m2, dst);
 #elif defined(USE_NEON64)
     MathUtilNeon64::addMatrix(m1, m2, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::addMatrix(m1, m2, dst);
 #elif defined(INCLUDE_NEON32)
     if (isNeon32Enabled())
         MathUtilNeon::addMatrix(m1, m2, dst);
@@ -164,6 +169,8 @@ void MathUtil::subtractMatrix(const float *m1, const float *m2, float *dst) {
     MathUtilNeon::subtractMatrix(m1, m2, dst);
 #elif defined(USE_NEON64)
     MathUtilNeon64::subtractMatrix(m1, m2, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::subtractMatrix(m1, m2, dst);
 #elif defined(INCLUDE_NEON32)
     if (isNeon32Enabled())
         MathUtilNeon::subtractMatrix(m1, m2, dst);
@@ -179,6 +186,8 @@ void MathUtil::multiplyMatrix(const float *m, float scalar, float *dst) {
     MathUtilNeon::multiplyMatrix(m, scalar, dst);
 #elif defined(USE_NEON64)
     MathUtilNeon64::multiplyMatrix(m, scalar, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::multiplyMatrix(m, scalar, dst);
 #elif defined(INCLUDE_NEON32)
     if (isNeon32Enabled())
         MathUtilNeon::multiplyMatrix(m, scalar, dst);
@@ -194,6 +203,8 @@ void MathUtil::multiplyMatrix(const float *m1, const float *m2, float *dst) {
     MathUtilNeon::multiplyMatrix(m1, m2, dst);
 #elif defined(USE_NEON64)
     MathUtilNeon64::multiplyMatrix(m1, m2, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::multiplyMatrix(m1, m2, dst);
 #elif defined(INCLUDE_NEON32)
     if (isNeon32Enabled())
         MathUtilNeon::multiplyMatrix(m1, m2, dst);
@@ -209,6 +220,8 @@ void MathUtil::negateMatrix(const float *m, float *dst) {
     MathUtilNeon::negateMatrix(m, dst);
 #elif defined(USE_NEON64)
     MathUtilNeon64::negateMatrix(m, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::negateMatrix(m, dst);
 #elif defined(INCLUDE_NEON32)
     if (isNeon32Enabled())
         MathUtilNeon::negateMatrix(m, dst);
@@ -224,6 +237,8 @@ void MathUtil::transposeMatrix(const float *m, float *dst) {
     MathUtilNeon::transposeMatrix(m, dst);
 #elif defined(USE_NEON64)
     MathUtilNeon64::transposeMatrix(m, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::transposeMatrix(m, dst);
 #elif defined(INCLUDE_NEON32)
     if (isNeon32Enabled())
         MathUtilNeon::transposeMatrix(m, dst);
@@ -234,11 +249,33 @@ void MathUtil::transposeMatrix(const float *m, float *dst) {
 #endif
 }
 
+bool MathUtil::inverseMatrix(const float *m, float *dst) {
+#if defined(USE_NEON64) && USE_MATH_SIMD
+    return MathUtilNeon64::inverseMatrix(m, dst);
+#elif defined(USE_SSE)
+    return MathUtilSSE::inverseMatrix(m, dst);
+#else
+    return MathUtilC::inverseMatrix(m, dst);
+#endif
+}
+
+void MathUtil::inverseTransposeMatrix(const float *m, float *dst) {
+#if defined(USE_NEON64) && USE_MATH_SIMD
+    MathUtilNeon64::inverseTransposeMatrix(m, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::inverseTransposeMatrix(m, dst);
+#else
+    MathUtilC::inverseTransposeMatrix(m, dst);
+#endif
+}
+
 void MathUtil::transformVec4(const float *m, float x, float y, float z, float w, float *dst) {
 #ifdef USE_NEON32
     MathUtilNeon::transformVec4(m, x, y, z, w, dst);
 #elif defined(USE_NEON64)
     MathUtilNeon64::transformVec4(m, x, y, z, w, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::transformVec4(m, x, y, z, w, dst);
 #elif defined(INCLUDE_NEON32)
     if (isNeon32Enabled())
         MathUtilNeon::transformVec4(m, x, y, z, w, dst);
@@ -254,6 +291,8 @@ void MathUtil::transformVec4(const float *m, const float *v, float *dst) {
     MathUtilNeon::transformVec4(m, v, dst);
 #elif defined(USE_NEON64)
     MathUtilNeon64::transformVec4(m, v, dst);
+#elif defined(USE_SSE)
+    MathUtilSSE::transformVec4(m, v, dst);
 #elif defined(INCLUDE_NEON32)
     if (isNeon32Enabled())
         MathUtilNeon::transformVec4(m, v, dst);
@@ -23,10 +23,6 @@
 #ifndef MATHUTIL_H_
 #define MATHUTIL_H_
 
-#ifdef __SSE__
-    #include <xmmintrin.h>
-#endif
-
 #include "math/MathBase.h"
 
 /**
@@ -101,23 +97,6 @@ private:
     static bool isNeon64Enabled();
 
 private:
-#ifdef __SSE__
-    static void addMatrix(const __m128 m[4], float scalar, __m128 dst[4]);
-
-    static void addMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst[4]);
-
-    static void subtractMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst[4]);
-
-    static void multiplyMatrix(const __m128 m[4], float scalar, __m128 dst[4]);
-
-    static void multiplyMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst[4]);
-
-    static void negateMatrix(const __m128 m[4], __m128 dst[4]);
-
-    static void transposeMatrix(const __m128 m[4], __m128 dst[4]);
-
-    static void transformVec4(const __m128 m[4], const __m128 &v, __m128 &dst);
-#endif
     static void addMatrix(const float *m, float scalar, float *dst);
 
     static void addMatrix(const float *m1, const float *m2, float *dst);
@@ -132,6 +111,12 @@ private:
 
     static void transposeMatrix(const float *m, float *dst);
 
+    // Returns false and leaves dst untouched if m is not invertible.
+    static bool inverseMatrix(const float *m, float *dst);
+
+    // Writes the inverse transpose of the upper 3x3 part of m, dst is left untouched if m is singular.
+    static void inverseTransposeMatrix(const float *m, float *dst);
+
     static void transformVec4(const float *m, float x, float y, float z, float w, float *dst);
 
     static void transformVec4(const float *m, const float *v, float *dst);
@@ -37,6 +37,10 @@ public:
     
     inline static void transposeMatrix(const float* m, float* dst);
     
+    inline static bool inverseMatrix(const float* m, float* dst);
+    
+    inline static void inverseTransposeMatrix(const float* m, float* dst);
+    
     inline static void transformVec4(const float* m, float x, float y, float z, float w, float* dst);
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
@@ -183,6 +187,103 @@ inline void MathUtilC::transposeMatrix(const float* m, float* dst)
     memcpy(dst, t, MATRIX_SIZE);
 }
 
+inline bool MathUtilC::inverseMatrix(const float* m, float* dst)
+{
+    float a0 = m[0] * m[5] - m[1] * m[4];
+    float a1 = m[0] * m[6] - m[2] * m[4];
+    float a2 = m[0] * m[7] - m[3] * m[4];
+    float a3 = m[1] * m[6] - m[2] * m[5];
+    float a4 = m[1] * m[7] - m[3] * m[5];
+    float a5 = m[2] * m[7] - m[3] * m[6];
+    float b0 = m[8] * m[13] - m[9] * m[12];
+    float b1 = m[8] * m[14] - m[10] * m[12];
+    float b2 = m[8] * m[15] - m[11] * m[12];
+    float b3 = m[9] * m[14] - m[10] * m[13];
+    float b4 = m[9] * m[15] - m[11] * m[13];
+    float b5 = m[10] * m[15] - m[11] * m[14];
+
+    // Calculate the determinant.
+    float det = a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0;
+
+    // Close to zero, can't invert.
+    if (std::abs(det) <= MATH_TOLERANCE)
+        return false;
+
+    // Support the case where m == dst.
+    float inverse[16] = {
+        m[5] * b5 - m[6] * b4 + m[7] * b3,
+        -m[1] * b5 + m[2] * b4 - m[3] * b3,
+        m[13] * a5 - m[14] * a4 + m[15] * a3,
+        -m[9] * a5 + m[10] * a4 - m[11] * a3,
+
+        -m[4] * b5 + m[6] * b2 - m[7] * b1,
+        m[0] * b5 - m[2] * b2 + m[3] * b1,
+        -m[12] * a5 + m[14] * a2 - m[15] * a1,
+        m[8] * a5 - m[10] * a2 + m[11] * a1,
+
+        m[4] * b4 - m[5] * b2 + m[7] * b0,
+        -m[0] * b4 + m[1] * b2 - m[3] * b0,
+        m[12] * a4 - m[13] * a2 + m[15] * a0,
+        -m[8] * a4 + m[9] * a2 - m[11] * a0,
+
+        -m[4] * b3 + m[5] * b1 - m[6] * b0,
+        m[0] * b3 - m[1] * b1 + m[2] * b0,
+        -m[12] * a3 + m[13] * a1 - m[14] * a0,
+        m[8] * a3 - m[9] * a1 + m[10] * a0
+    };
+
+    multiplyMatrix(inverse, 1.0F / det, dst);
+    return true;
+}
+
+inline void MathUtilC::inverseTransposeMatrix(const float* m, float* dst)
+{
+    float a00 = m[0]; float a01 = m[1]; float a02 = m[2]; float a03 = m[3];
+    float a10 = m[4]; float a11 = m[5]; float a12 = m[6]; float a13 = m[7];
+    float a20 = m[8]; float a21 = m[9]; float a22 = m[10]; float a23 = m[11];
+    float a30 = m[12]; float a31 = m[13]; float a32 = m[14]; float a33 = m[15];
+
+    float b00 = a00 * a11 - a01 * a10;
+    float b01 = a00 * a12 - a02 * a10;
+    float b02 = a00 * a13 - a03 * a10;
+    float b03 = a01 * a12 - a02 * a11;
+    float b04 = a01 * a13 - a03 * a11;
+    float b05 = a02 * a13 - a03 * a12;
+    float b06 = a20 * a31 - a21 * a30;
+    float b07 = a20 * a32 - a22 * a30;
+    float b08 = a20 * a33 - a23 * a30;
+    float b09 = a21 * a32 - a22 * a31;
+    float b10 = a21 * a33 - a23 * a31;
+    float b11 = a22 * a33 - a23 * a32;
+
+    // Calculate the determinant
+    float det = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
+
+    if (det == 0.0)
+        return;
+    det = 1 / det;
+
+    dst[0] = (a11 * b11 - a12 * b10 + a13 * b09) * det;
+    dst[1] = (a12 * b08 - a10 * b11 - a13 * b07) * det;
+    dst[2] = (a10 * b10 - a11 * b08 + a13 * b06) * det;
+    dst[3] = 0;
+
+    dst[4] = (a02 * b10 - a01 * b11 - a03 * b09) * det;
+    dst[5] = (a00 * b11 - a02 * b08 + a03 * b07) * det;
+    dst[6] = (a01 * b08 - a00 * b10 - a03 * b06) * det;
+    dst[7] = 0;
+
+    dst[8] = (a31 * b05 - a32 * b04 + a33 * b03) * det;
+    dst[9] = (a32 * b02 - a30 * b05 - a33 * b01) * det;
+    dst[10] = (a30 * b04 - a31 * b02 + a33 * b00) * det;
+    dst[11] = 0;
+
+    dst[12] = 0;
+    dst[13] = 0;
+    dst[14] = 0;
+    dst[15] = 1;
+}
+
 inline void MathUtilC::transformVec4(const float* m, float x, float y, float z, float w, float* dst)
 {
     dst[0] = x * m[0] + y * m[4] + z * m[8] + w * m[12];
@@ -18,6 +18,8 @@
  This file was modified to fit the cocos2d-x project
  */
 
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon64
@@ -37,11 +39,27 @@ public:
     
     inline static void transposeMatrix(const float* m, float* dst);
     
+    inline static bool inverseMatrix(const float* m, float* dst);
+    
+    inline static void inverseTransposeMatrix(const float* m, float* dst);
+    
     inline static void transformVec4(const float* m, float x, float y, float z, float w, float* dst);
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+private:
+    // (v[X], v[Y], v[Z], v[W])
+    template <int X, int Y, int Z, int W>
+    inline static float32x4_t swizzle(float32x4_t v);
+    
+    // (a[X], a[Y], b[Z], b[W])
+    template <int X, int Y, int Z, int W>
+    inline static float32x4_t shuffle(float32x4_t a, float32x4_t b);
+    
+    // Computes the adjugate of m as rows (the columns of the inverse) and returns the determinant.
+    inline static float adjugateMatrix(const float* m, float32x4_t adj[4]);
 };
 
 inline void MathUtilNeon64::addMatrix(const float* m, float scalar, float* dst)
@@ -180,6 +198,121 @@ inline void MathUtilNeon64::transposeMatrix(const float* m, float* dst)
     );
 }
 
+template <int X, int Y, int Z, int W>
+inline float32x4_t MathUtilNeon64::swizzle(float32x4_t v)
+{
+    const uint8_t indices[16] = {
+        X * 4, X * 4 + 1, X * 4 + 2, X * 4 + 3,
+        Y * 4, Y * 4 + 1, Y * 4 + 2, Y * 4 + 3,
+        Z * 4, Z * 4 + 1, Z * 4 + 2, Z * 4 + 3,
+        W * 4, W * 4 + 1, W * 4 + 2, W * 4 + 3
+    };
+    return vreinterpretq_f32_u8(vqtbl1q_u8(vreinterpretq_u8_f32(v), vld1q_u8(indices)));
+}
+
+template <int X, int Y, int Z, int W>
+inline float32x4_t MathUtilNeon64::shuffle(float32x4_t a, float32x4_t b)
+{
+    const uint8_t indices[16] = {
+        X * 4, X * 4 + 1, X * 4 + 2, X * 4 + 3,
+        Y * 4, Y * 4 + 1, Y * 4 + 2, Y * 4 + 3,
+        16 + Z * 4, 16 + Z * 4 + 1, 16 + Z * 4 + 2, 16 + Z * 4 + 3,
+        16 + W * 4, 16 + W * 4 + 1, 16 + W * 4 + 2, 16 + W * 4 + 3
+    };
+    uint8x16x2_t table = {{vreinterpretq_u8_f32(a), vreinterpretq_u8_f32(b)}};
+    return vreinterpretq_f32_u8(vqtbl2q_u8(table, vld1q_u8(indices)));
+}
+
+inline float MathUtilNeon64::adjugateMatrix(const float* m, float32x4_t adj[4])
+{
+    // Block-wise inversion on 2x2 sub matrices, each held as (m00, m01, m10, m11),
+    // the same scheme as MathUtilSSE::adjugateMatrix.
+    float32x4_t c0 = vld1q_f32(m);
+    float32x4_t c1 = vld1q_f32(m + 4);
+    float32x4_t c2 = vld1q_f32(m + 8);
+    float32x4_t c3 = vld1q_f32(m + 12);
+
+    float32x4_t a = vcombine_f32(vget_low_f32(c0), vget_low_f32(c1));
+    float32x4_t b = vcombine_f32(vget_high_f32(c0), vget_high_f32(c1));
+    float32x4_t c = vcombine_f32(vget_low_f32(c2), vget_low_f32(c3));
+    float32x4_t d = vcombine_f32(vget_high_f32(c2), vget_high_f32(c3));
+
+    // (|A|, |B|, |C|, |D|)
+    float32x4_t detSub = vsubq_f32(
+        vmulq_f32(vuzp1q_f32(c0, c2), vuzp2q_f32(c1, c3)),
+        vmulq_f32(vuzp2q_f32(c0, c2), vuzp1q_f32(c1, c3)));
+    float32x4_t detA = vdupq_laneq_f32(detSub, 0);
+    float32x4_t detB = vdupq_laneq_f32(detSub, 1);
+    float32x4_t detC = vdupq_laneq_f32(detSub, 2);
+    float32x4_t detD = vdupq_laneq_f32(detSub, 3);
+
+    // adj(D) * C and adj(A) * B
+    float32x4_t dc = vsubq_f32(vmulq_f32(swizzle<3, 3, 0, 0>(d), c), vmulq_f32(swizzle<1, 1, 2, 2>(d), vextq_f32(c, c, 2)));
+    float32x4_t ab = vsubq_f32(vmulq_f32(swizzle<3, 3, 0, 0>(a), b), vmulq_f32(swizzle<1, 1, 2, 2>(a), vextq_f32(b, b, 2)));
+
+    // X = |D| A - B (adj(D) C), W = |A| D - C (adj(A) B)
+    float32x4_t x = vsubq_f32(vmulq_f32(detD, a), vaddq_f32(vmulq_f32(b, swizzle<0, 3, 0, 3>(dc)), vmulq_f32(vrev64q_f32(b), swizzle<2, 1, 2, 1>(dc))));
+    float32x4_t w = vsubq_f32(vmulq_f32(detA, d), vaddq_f32(vmulq_f32(c, swizzle<0, 3, 0, 3>(ab)), vmulq_f32(vrev64q_f32(c), swizzle<2, 1, 2, 1>(ab))));
+    // Y = |B| C - D adj(adj(A) B), Z = |C| B - A adj(adj(D) C)
+    float32x4_t y = vsubq_f32(vmulq_f32(detB, c), vsubq_f32(vmulq_f32(d, swizzle<3, 0, 3, 0>(ab)), vmulq_f32(vrev64q_f32(d), swizzle<2, 1, 2, 1>(ab))));
+    float32x4_t z = vsubq_f32(vmulq_f32(detC, b), vsubq_f32(vmulq_f32(a, swizzle<3, 0, 3, 0>(dc)), vmulq_f32(vrev64q_f32(a), swizzle<2, 1, 2, 1>(dc))));
+
+    // |M| = |A| |D| + |B| |C| - tr(adj(A) B adj(D) C)
+    float tr = vaddvq_f32(vmulq_f32(ab, swizzle<0, 2, 1, 3>(dc)));
+    float det = vgetq_lane_f32(detSub, 0) * vgetq_lane_f32(detSub, 3) + vgetq_lane_f32(detSub, 1) * vgetq_lane_f32(detSub, 2) - tr;
+
+    // Apply the 2x2 adjugate signs and transpose back while assembling the columns.
+    const float signs[4] = {1.0F, -1.0F, -1.0F, 1.0F};
+    float32x4_t sign = vld1q_f32(signs);
+    x = vmulq_f32(x, sign);
+    y = vmulq_f32(y, sign);
+    z = vmulq_f32(z, sign);
+    w = vmulq_f32(w, sign);
+    adj[0] = shuffle<3, 1, 3, 1>(x, y);
+    adj[1] = shuffle<2, 0, 2, 0>(x, y);
+    adj[2] = shuffle<3, 1, 3, 1>(z, w);
+    adj[3] = shuffle<2, 0, 2, 0>(z, w);
+    return det;
+}
+
+inline bool MathUtilNeon64::inverseMatrix(const float* m, float* dst)
+{
+    float32x4_t adj[4];
+    float det = adjugateMatrix(m, adj);
+    if (std::abs(det) <= MATH_TOLERANCE)
+        return false;
+
+    float invDet = 1.0F / det;
+    vst1q_f32(dst, vmulq_n_f32(adj[0], invDet));
+    vst1q_f32(dst + 4, vmulq_n_f32(adj[1], invDet));
+    vst1q_f32(dst + 8, vmulq_n_f32(adj[2], invDet));
+    vst1q_f32(dst + 12, vmulq_n_f32(adj[3], invDet));
+    return true;
+}
+
+inline void MathUtilNeon64::inverseTransposeMatrix(const float* m, float* dst)
+{
+    float32x4_t adj[4];
+    float det = adjugateMatrix(m, adj);
+    if (det == 0.0F)
+        return;
+
+    float invDet = 1.0F / det;
+    float inverse[16];
+    vst1q_f32(inverse, vmulq_n_f32(adj[0], invDet));
+    vst1q_f32(inverse + 4, vmulq_n_f32(adj[1], invDet));
+    vst1q_f32(inverse + 8, vmulq_n_f32(adj[2], invDet));
+    vst1q_f32(inverse + 12, vmulq_n_f32(adj[3], invDet));
+
+    // De-interleaving load transposes, keep the 3x3 part only, as a normal matrix.
+    float32x4x4_t rows = vld4q_f32(inverse);
+    vst1q_f32(dst, vsetq_lane_f32(0.0F, rows.val[0], 3));
+    vst1q_f32(dst + 4, vsetq_lane_f32(0.0F, rows.val[1], 3));
+    vst1q_f32(dst + 8, vsetq_lane_f32(0.0F, rows.val[2], 3));
+    const float last[4] = {0.0F, 0.0F, 0.0F, 1.0F};
+    vst1q_f32(dst + 12, vld1q_f32(last));
+}
+
 inline void MathUtilNeon64::transformVec4(const float* m, float x, float y, float z, float w, float* dst)
 {
     asm volatile(
@@ -1,157 +1,277 @@
+#include <emmintrin.h>
+#ifdef __AVX__
+    #include <immintrin.h>
+#endif
+
 NS_CC_MATH_BEGIN
 
-#ifdef __SSE__
+// All kernels use unaligned loads and stores: Mat4 and Vec4 are not aligned, and matrices
+// embedded in JS shared layouts (e.g. NodeLayout) keep the packed JS offsets.
+class MathUtilSSE
+{
+public:
+    inline static void addMatrix(const float* m, float scalar, float* dst);
+    
+    inline static void addMatrix(const float* m1, const float* m2, float* dst);
+    
+    inline static void subtractMatrix(const float* m1, const float* m2, float* dst);
+    
+    inline static void multiplyMatrix(const float* m, float scalar, float* dst);
+    
+    inline static void multiplyMatrix(const float* m1, const float* m2, float* dst);
+    
+    inline static void negateMatrix(const float* m, float* dst);
+    
+    inline static void transposeMatrix(const float* m, float* dst);
+    
+    inline static bool inverseMatrix(const float* m, float* dst);
+    
+    inline static void inverseTransposeMatrix(const float* m, float* dst);
+    
+    inline static void transformVec4(const float* m, float x, float y, float z, float w, float* dst);
+    
+    inline static void transformVec4(const float* m, const float* v, float* dst);
+
+private:
+    // Computes the adjugate of m as rows (the columns of the inverse) and the determinant in every lane.
+    inline static __m128 adjugateMatrix(const float* m, __m128 adj[4]);
+};
+
+#define CC_SSE_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(w, z, y, x))
+#define CC_SSE_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps((a), (b), _MM_SHUFFLE(w, z, y, x))
 
-void MathUtil::addMatrix(const __m128 m[4], float scalar, __m128 dst[4])
+inline void MathUtilSSE::addMatrix(const float* m, float scalar, float* dst)
 {
     __m128 s = _mm_set1_ps(scalar);
-    dst[0] = _mm_add_ps(m[0], s);
-    dst[1] = _mm_add_ps(m[1], s);
-    dst[2] = _mm_add_ps(m[2], s);
-    dst[3] = _mm_add_ps(m[3], s);
+    __m128 c0 = _mm_add_ps(_mm_loadu_ps(m), s);
+    __m128 c1 = _mm_add_ps(_mm_loadu_ps(m + 4), s);
+    __m128 c2 = _mm_add_ps(_mm_loadu_ps(m + 8), s);
+    __m128 c3 = _mm_add_ps(_mm_loadu_ps(m + 12), s);
+    _mm_storeu_ps(dst, c0);
+    _mm_storeu_ps(dst + 4, c1);
+    _mm_storeu_ps(dst + 8, c2);
+    _mm_storeu_ps(dst + 12, c3);
 }
 
-void MathUtil::addMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst[4])
+inline void MathUtilSSE::addMatrix(const float* m1, const float* m2, float* dst)
 {
-    dst[0] = _mm_add_ps(m1[0], m2[0]);
-    dst[1] = _mm_add_ps(m1[1], m2[1]);
-    dst[2] = _mm_add_ps(m1[2], m2[2]);
-    dst[3] = _mm_add_ps(m1[3], m2[3]);
+    __m128 c0 = _mm_add_ps(_mm_loadu_ps(m1), _mm_loadu_ps(m2));
+    __m128 c1 = _mm_add_ps(_mm_loadu_ps(m1 + 4), _mm_loadu_ps(m2 + 4));
+    __m128 c2 = _mm_add_ps(_mm_loadu_ps(m1 + 8), _mm_loadu_ps(m2 + 8));
+    __m128 c3 = _mm_add_ps(_mm_loadu_ps(m1 + 12), _mm_loadu_ps(m2 + 12));
+    _mm_storeu_ps(dst, c0);
+    _mm_storeu_ps(dst + 4, c1);
+    _mm_storeu_ps(dst + 8, c2);
+    _mm_storeu_ps(dst + 12, c3);
 }
 
-void MathUtil::subtractMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst[4])
+inline void MathUtilSSE::subtractMatrix(const float* m1, const float* m2, float* dst)
 {
-    dst[0] = _mm_sub_ps(m1[0], m2[0]);
-    dst[1] = _mm_sub_ps(m1[1], m2[1]);
-    dst[2] = _mm_sub_ps(m1[2], m2[2]);
-    dst[3] = _mm_sub_ps(m1[3], m2[3]);
+    __m128 c0 = _mm_sub_ps(_mm_loadu_ps(m1), _mm_loadu_ps(m2));
+    __m128 c1 = _mm_sub_ps(_mm_loadu_ps(m1 + 4), _mm_loadu_ps(m2 + 4));
+    __m128 c2 = _mm_sub_ps(_mm_loadu_ps(m1 + 8), _mm_loadu_ps(m2 + 8));
+    __m128 c3 = _mm_sub_ps(_mm_loadu_ps(m1 + 12), _mm_loadu_ps(m2 + 12));
+    _mm_storeu_ps(dst, c0);
+    _mm_storeu_ps(dst + 4, c1);
+    _mm_storeu_ps(dst + 8, c2);
+    _mm_storeu_ps(dst + 12, c3);
 }
 
-void MathUtil::multiplyMatrix(const __m128 m[4], float scalar, __m128 dst[4])
+inline void MathUtilSSE::multiplyMatrix(const float* m, float scalar, float* dst)
 {
     __m128 s = _mm_set1_ps(scalar);
-    dst[0] = _mm_mul_ps(m[0], s);
-    dst[1] = _mm_mul_ps(m[1], s);
-    dst[2] = _mm_mul_ps(m[2], s);
-    dst[3] = _mm_mul_ps(m[3], s);
+    __m128 c0 = _mm_mul_ps(_mm_loadu_ps(m), s);
+    __m128 c1 = _mm_mul_ps(_mm_loadu_ps(m + 4), s);
+    __m128 c2 = _mm_mul_ps(_mm_loadu_ps(m + 8), s);
+    __m128 c3 = _mm_mul_ps(_mm_loadu_ps(m + 12), s);
+    _mm_storeu_ps(dst, c0);
+    _mm_storeu_ps(dst + 4, c1);
+    _mm_storeu_ps(dst + 8, c2);
+    _mm_storeu_ps(dst + 12, c3);
 }
 
-void MathUtil::multiplyMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst[4])
+inline void MathUtilSSE::multiplyMatrix(const float* m1, const float* m2, float* dst)
 {
-    __m128 dst0, dst1, dst2, dst3;
-	{
-		__m128 e0 = _mm_shuffle_ps(m2[0], m2[0], _MM_SHUFFLE(0, 0, 0, 0));
-		__m128 e1 = _mm_shuffle_ps(m2[0], m2[0], _MM_SHUFFLE(1, 1, 1, 1));
-		__m128 e2 = _mm_shuffle_ps(m2[0], m2[0], _MM_SHUFFLE(2, 2, 2, 2));
-		__m128 e3 = _mm_shuffle_ps(m2[0], m2[0], _MM_SHUFFLE(3, 3, 3, 3));
-        
-		__m128 v0 = _mm_mul_ps(m1[0], e0);
-		__m128 v1 = _mm_mul_ps(m1[1], e1);
-		__m128 v2 = _mm_mul_ps(m1[2], e2);
-		__m128 v3 = _mm_mul_ps(m1[3], e3);
-        
-		__m128 a0 = _mm_add_ps(v0, v1);
-		__m128 a1 = _mm_add_ps(v2, v3);
-		__m128 a2 = _mm_add_ps(a0, a1);
-        
-		dst0 = a2;
-	}
-    
-	{
-		__m128 e0 = _mm_shuffle_ps(m2[1], m2[1], _MM_SHUFFLE(0, 0, 0, 0));
-		__m128 e1 = _mm_shuffle_ps(m2[1], m2[1], _MM_SHUFFLE(1, 1, 1, 1));
-		__m128 e2 = _mm_shuffle_ps(m2[1], m2[1], _MM_SHUFFLE(2, 2, 2, 2));
-		__m128 e3 = _mm_shuffle_ps(m2[1], m2[1], _MM_SHUFFLE(3, 3, 3, 3));
-        
-		__m128 v0 = _mm_mul_ps(m1[0], e0);
-		__m128 v1 = _mm_mul_ps(m1[1], e1);
-		__m128 v2 = _mm_mul_ps(m1[2], e2);
-		__m128 v3 = _mm_mul_ps(m1[3], e3);
-        
-		__m128 a0 = _mm_add_ps(v0, v1);
-		__m128 a1 = _mm_add_ps(v2, v3);
-		__m128 a2 = _mm_add_ps(a0, a1);
-        
-		dst1 = a2;
-	}
-    
-	{
-		__m128 e0 = _mm_shuffle_ps(m2[2], m2[2], _MM_SHUFFLE(0, 0, 0, 0));
-		__m128 e1 = _mm_shuffle_ps(m2[2], m2[2], _MM_SHUFFLE(1, 1, 1, 1));
-		__m128 e2 = _mm_shuffle_ps(m2[2], m2[2], _MM_SHUFFLE(2, 2, 2, 2));
-		__m128 e3 = _mm_shuffle_ps(m2[2], m2[2], _MM_SHUFFLE(3, 3, 3, 3));
-        
-		__m128 v0 = _mm_mul_ps(m1[0], e0);
-		__m128 v1 = _mm_mul_ps(m1[1], e1);
-		__m128 v2 = _mm_mul_ps(m1[2], e2);
-		__m128 v3 = _mm_mul_ps(m1[3], e3);
-        
-		__m128 a0 = _mm_add_ps(v0, v1);
-		__m128 a1 = _mm_add_ps(v2, v3);
-		__m128 a2 = _mm_add_ps(a0, a1);
-        
-		dst2 = a2;
-	}
-    
-	{
-		__m128 e0 = _mm_shuffle_ps(m2[3], m2[3], _MM_SHUFFLE(0, 0, 0, 0));
-		__m128 e1 = _mm_shuffle_ps(m2[3], m2[3], _MM_SHUFFLE(1, 1, 1, 1));
-		__m128 e2 = _mm_shuffle_ps(m2[3], m2[3], _MM_SHUFFLE(2, 2, 2, 2));
-		__m128 e3 = _mm_shuffle_ps(m2[3], m2[3], _MM_SHUFFLE(3, 3, 3, 3));
-        
-		__m128 v0 = _mm_mul_ps(m1[0], e0);
-		__m128 v1 = _mm_mul_ps(m1[1], e1);
-		__m128 v2 = _mm_mul_ps(m1[2], e2);
-		__m128 v3 = _mm_mul_ps(m1[3], e3);
-        
-		__m128 a0 = _mm_add_ps(v0, v1);
-		__m128 a1 = _mm_add_ps(v2, v3);
-		__m128 a2 = _mm_add_ps(a0, a1);
-        
-		dst3 = a2;
-	}
-    dst[0] = dst0;
-    dst[1] = dst1;
-    dst[2] = dst2;
-    dst[3] = dst3;
+#ifdef __AVX__
+    // Two destination columns per 256 bit register.
+    __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1));
+    __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 4));
+    __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 8));
+    __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 12));
+    __m256 b01 = _mm256_loadu_ps(m2);
+    __m256 b23 = _mm256_loadu_ps(m2 + 8);
+
+    __m256 c01 = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(a0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0))),
+                      _mm256_mul_ps(a1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1)))),
+        _mm256_add_ps(_mm256_mul_ps(a2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2))),
+                      _mm256_mul_ps(a3, _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3)))));
+    __m256 c23 = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(a0, _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0))),
+                      _mm256_mul_ps(a1, _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1)))),
+        _mm256_add_ps(_mm256_mul_ps(a2, _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2))),
+                      _mm256_mul_ps(a3, _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3)))));
+
+    _mm256_storeu_ps(dst, c01);
+    _mm256_storeu_ps(dst + 8, c23);
+#else
+    __m128 a0 = _mm_loadu_ps(m1);
+    __m128 a1 = _mm_loadu_ps(m1 + 4);
+    __m128 a2 = _mm_loadu_ps(m1 + 8);
+    __m128 a3 = _mm_loadu_ps(m1 + 12);
+    __m128 c[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        __m128 b = _mm_loadu_ps(m2 + i * 4);
+        c[i] = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(a0, CC_SSE_SWIZZLE(b, 0, 0, 0, 0)), _mm_mul_ps(a1, CC_SSE_SWIZZLE(b, 1, 1, 1, 1))),
+            _mm_add_ps(_mm_mul_ps(a2, CC_SSE_SWIZZLE(b, 2, 2, 2, 2)), _mm_mul_ps(a3, CC_SSE_SWIZZLE(b, 3, 3, 3, 3))));
+    }
+    // Store after all columns of m2 have been read, dst may alias m2.
+    _mm_storeu_ps(dst, c[0]);
+    _mm_storeu_ps(dst + 4, c[1]);
+    _mm_storeu_ps(dst + 8, c[2]);
+    _mm_storeu_ps(dst + 12, c[3]);
+#endif
 }
 
-void MathUtil::negateMatrix(const __m128 m[4], __m128 dst[4])
+inline void MathUtilSSE::negateMatrix(const float* m, float* dst)
 {
     __m128 z = _mm_setzero_ps();
-    dst[0] = _mm_sub_ps(z, m[0]);
-    dst[1] = _mm_sub_ps(z, m[1]);
-    dst[2] = _mm_sub_ps(z, m[2]);
-    dst[3] = _mm_sub_ps(z, m[3]);
+    __m128 c0 = _mm_sub_ps(z, _mm_loadu_ps(m));
+    __m128 c1 = _mm_sub_ps(z, _mm_loadu_ps(m + 4));
+    __m128 c2 = _mm_sub_ps(z, _mm_loadu_ps(m + 8));
+    __m128 c3 = _mm_sub_ps(z, _mm_loadu_ps(m + 12));
+    _mm_storeu_ps(dst, c0);
+    _mm_storeu_ps(dst + 4, c1);
+    _mm_storeu_ps(dst + 8, c2);
+    _mm_storeu_ps(dst + 12, c3);
 }
 
-void MathUtil::transposeMatrix(const __m128 m[4], __m128 dst[4])
+inline void MathUtilSSE::transposeMatrix(const float* m, float* dst)
 {
-    __m128 tmp0 = _mm_shuffle_ps(m[0], m[1], 0x44);
-    __m128 tmp2 = _mm_shuffle_ps(m[0], m[1], 0xEE);
-    __m128 tmp1 = _mm_shuffle_ps(m[2], m[3], 0x44);
-    __m128 tmp3 = _mm_shuffle_ps(m[2], m[3], 0xEE);
-    
-    dst[0] = _mm_shuffle_ps(tmp0, tmp1, 0x88);
-    dst[1] = _mm_shuffle_ps(tmp0, tmp1, 0xDD);
-    dst[2] = _mm_shuffle_ps(tmp2, tmp3, 0x88);
-    dst[3] = _mm_shuffle_ps(tmp2, tmp3, 0xDD);
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_storeu_ps(dst, c0);
+    _mm_storeu_ps(dst + 4, c1);
+    _mm_storeu_ps(dst + 8, c2);
+    _mm_storeu_ps(dst + 12, c3);
 }
 
-void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
+inline __m128 MathUtilSSE::adjugateMatrix(const float* m, __m128 adj[4])
 {
-    __m128 col1 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
-    __m128 col2 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
-    __m128 col3 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
-    __m128 col4 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
-    
-    dst = _mm_add_ps(
-                     _mm_add_ps(_mm_mul_ps(m[0], col1), _mm_mul_ps(m[1], col2)),
-                     _mm_add_ps(_mm_mul_ps(m[2], col3), _mm_mul_ps(m[3], col4))
-                     );
+    // Block-wise inversion on 2x2 sub matrices, each held as (m00, m01, m10, m11).
+    // The columns are treated as rows, the result is transposed back by the final shuffles.
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+
+    __m128 a = _mm_movelh_ps(c0, c1);
+    __m128 b = _mm_movehl_ps(c1, c0);
+    __m128 c = _mm_movelh_ps(c2, c3);
+    __m128 d = _mm_movehl_ps(c3, c2);
+
+    // (|A|, |B|, |C|, |D|)
+    __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(CC_SSE_SHUFFLE(c0, c2, 0, 2, 0, 2), CC_SSE_SHUFFLE(c1, c3, 1, 3, 1, 3)),
+        _mm_mul_ps(CC_SSE_SHUFFLE(c0, c2, 1, 3, 1, 3), CC_SSE_SHUFFLE(c1, c3, 0, 2, 0, 2)));
+    __m128 detA = CC_SSE_SWIZZLE(detSub, 0, 0, 0, 0);
+    __m128 detB = CC_SSE_SWIZZLE(detSub, 1, 1, 1, 1);
+    __m128 detC = CC_SSE_SWIZZLE(detSub, 2, 2, 2, 2);
+    __m128 detD = CC_SSE_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    // adj(D) * C and adj(A) * B
+    __m128 dc = _mm_sub_ps(_mm_mul_ps(CC_SSE_SWIZZLE(d, 3, 3, 0, 0), c), _mm_mul_ps(CC_SSE_SWIZZLE(d, 1, 1, 2, 2), CC_SSE_SWIZZLE(c, 2, 3, 0, 1)));
+    __m128 ab = _mm_sub_ps(_mm_mul_ps(CC_SSE_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(CC_SSE_SWIZZLE(a, 1, 1, 2, 2), CC_SSE_SWIZZLE(b, 2, 3, 0, 1)));
+
+    // X = |D| A - B (adj(D) C), W = |A| D - C (adj(A) B)
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), _mm_add_ps(_mm_mul_ps(b, CC_SSE_SWIZZLE(dc, 0, 3, 0, 3)), _mm_mul_ps(CC_SSE_SWIZZLE(b, 1, 0, 3, 2), CC_SSE_SWIZZLE(dc, 2, 1, 2, 1))));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), _mm_add_ps(_mm_mul_ps(c, CC_SSE_SWIZZLE(ab, 0, 3, 0, 3)), _mm_mul_ps(CC_SSE_SWIZZLE(c, 1, 0, 3, 2), CC_SSE_SWIZZLE(ab, 2, 1, 2, 1))));
+    // Y = |B| C - D adj(adj(A) B), Z = |C| B - A adj(adj(D) C)
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), _mm_sub_ps(_mm_mul_ps(d, CC_SSE_SWIZZLE(ab, 3, 0, 3, 0)), _mm_mul_ps(CC_SSE_SWIZZLE(d, 1, 0, 3, 2), CC_SSE_SWIZZLE(ab, 2, 1, 2, 1))));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), _mm_sub_ps(_mm_mul_ps(a, CC_SSE_SWIZZLE(dc, 3, 0, 3, 0)), _mm_mul_ps(CC_SSE_SWIZZLE(a, 1, 0, 3, 2), CC_SSE_SWIZZLE(dc, 2, 1, 2, 1))));
+
+    // |M| = |A| |D| + |B| |C| - tr(adj(A) B adj(D) C)
+    __m128 tr = _mm_mul_ps(ab, CC_SSE_SWIZZLE(dc, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, CC_SSE_SWIZZLE(tr, 2, 3, 0, 1));
+    tr = _mm_add_ps(tr, CC_SSE_SWIZZLE(tr, 1, 0, 3, 2));
+    __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+    // Apply the 2x2 adjugate signs and transpose back while assembling the columns.
+    __m128 sign = _mm_setr_ps(1.0F, -1.0F, -1.0F, 1.0F);
+    x = _mm_mul_ps(x, sign);
+    y = _mm_mul_ps(y, sign);
+    z = _mm_mul_ps(z, sign);
+    w = _mm_mul_ps(w, sign);
+    adj[0] = CC_SSE_SHUFFLE(x, y, 3, 1, 3, 1);
+    adj[1] = CC_SSE_SHUFFLE(x, y, 2, 0, 2, 0);
+    adj[2] = CC_SSE_SHUFFLE(z, w, 3, 1, 3, 1);
+    adj[3] = CC_SSE_SHUFFLE(z, w, 2, 0, 2, 0);
+    return det;
 }
 
-#endif
+inline bool MathUtilSSE::inverseMatrix(const float* m, float* dst)
+{
+    __m128 adj[4];
+    __m128 det = adjugateMatrix(m, adj);
+    if (std::abs(_mm_cvtss_f32(det)) <= MATH_TOLERANCE)
+        return false;
+
+    __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0F), det);
+    _mm_storeu_ps(dst, _mm_mul_ps(adj[0], invDet));
+    _mm_storeu_ps(dst + 4, _mm_mul_ps(adj[1], invDet));
+    _mm_storeu_ps(dst + 8, _mm_mul_ps(adj[2], invDet));
+    _mm_storeu_ps(dst + 12, _mm_mul_ps(adj[3], invDet));
+    return true;
+}
+
+inline void MathUtilSSE::inverseTransposeMatrix(const float* m, float* dst)
+{
+    __m128 adj[4];
+    __m128 det = adjugateMatrix(m, adj);
+    if (_mm_cvtss_f32(det) == 0.0F)
+        return;
+
+    __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0F), det);
+    __m128 c0 = _mm_mul_ps(adj[0], invDet);
+    __m128 c1 = _mm_mul_ps(adj[1], invDet);
+    __m128 c2 = _mm_mul_ps(adj[2], invDet);
+    __m128 c3 = _mm_mul_ps(adj[3], invDet);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    // Keep the 3x3 part only, as a normal matrix.
+    __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    _mm_storeu_ps(dst, _mm_and_ps(c0, mask));
+    _mm_storeu_ps(dst + 4, _mm_and_ps(c1, mask));
+    _mm_storeu_ps(dst + 8, _mm_and_ps(c2, mask));
+    _mm_storeu_ps(dst + 12, _mm_setr_ps(0.0F, 0.0F, 0.0F, 1.0F));
+}
+
+inline void MathUtilSSE::transformVec4(const float* m, float x, float y, float z, float w, float* dst)
+{
+    __m128 r = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m), _mm_set1_ps(x)), _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(y))),
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(z)), _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(w))));
+
+    // dst only holds three floats here.
+    _mm_storel_pi(reinterpret_cast<__m64*>(dst), r);
+    _mm_store_ss(dst + 2, _mm_movehl_ps(r, r));
+}
+
+inline void MathUtilSSE::transformVec4(const float* m, const float* v, float* dst)
+{
+    __m128 vec = _mm_loadu_ps(v);
+    __m128 r = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m), CC_SSE_SWIZZLE(vec, 0, 0, 0, 0)), _mm_mul_ps(_mm_loadu_ps(m + 4), CC_SSE_SWIZZLE(vec, 1, 1, 1, 1))),
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m + 8), CC_SSE_SWIZZLE(vec, 2, 2, 2, 2)), _mm_mul_ps(_mm_loadu_ps(m + 12), CC_SSE_SWIZZLE(vec, 3, 3, 3, 3))));
+    _mm_storeu_ps(dst, r);
+}
 
+#undef CC_SSE_SWIZZLE
+#undef CC_SSE_SHUFFLE
 
 NS_CC_MATH_END
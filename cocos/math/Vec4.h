@@ -23,11 +23,6 @@
 #ifndef MATH_VEC4_H
 #define MATH_VEC4_H
 
-#undef __SSE__
-#ifdef __SSE__
-    #include <xmmintrin.h>
-#endif
-
 #include "math/MathBase.h"
 
 /**
@@ -44,17 +39,6 @@ class Mat4;
  */
 class CC_DLL Vec4 {
 public:
-#ifdef __SSE__
-    union {
-        struct {
-            float x;
-            float y;
-            float z;
-            float w;
-        };
-        __m128 v;
-    };
-#else
     /**
      * The x-coordinate.
      */
@@ -74,7 +58,6 @@ public:
      * The w-coordinate.
      */
     float w;
-#endif
     /**
      * Constructs a new vector initialized to all zeros.
      */
@@ -0,0 +1,87 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "physics/physx/PhysXCpuDispatcher.h"
+
+namespace cc {
+namespace physics {
+
+PhysXCpuDispatcher::TaskJob::TaskJob() : graph(JobSystem::getInstance()) {
+    graph.createJob([this]() {
+        task->run();
+        task->release();
+    });
+}
+
+PhysXCpuDispatcher::~PhysXCpuDispatcher() {
+    collect();
+}
+
+void PhysXCpuDispatcher::submitTask(physx::PxBaseTask &task) {
+    if (JobSystem::getInstance()->threadCount() < 2U) {
+        task.run();
+        task.release();
+        return;
+    }
+
+    // tasks are submitted one by one, from the simulating thread or from other tasks, each takes
+    // a job that is kept until the simulation results are fetched. The pool only grows until it
+    // holds the tasks of the largest step.
+    TaskJob *job = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_freeJobs.empty()) {
+            _jobs.emplace_back(new TaskJob());
+            _freeJobs.push_back(_jobs.back().get());
+        }
+        job = _freeJobs.back();
+        _freeJobs.pop_back();
+        _runningJobs.push_back(job);
+    }
+    job->task = &task;
+    job->graph.run();
+}
+
+physx::PxU32 PhysXCpuDispatcher::getWorkerCount() const {
+    return JobSystem::getInstance()->threadCount();
+}
+
+void PhysXCpuDispatcher::collect() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _collectedJobs.swap(_runningJobs);
+    }
+    for (auto *job : _collectedJobs) {
+        // the last task of a step is released before its job returns
+        job->graph.waitForAll();
+        job->task = nullptr;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _freeJobs.insert(_freeJobs.end(), _collectedJobs.begin(), _collectedJobs.end());
+    _collectedJobs.clear();
+}
+
+} // namespace physics
+} // namespace cc
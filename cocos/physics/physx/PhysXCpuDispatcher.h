@@ -0,0 +1,72 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "base/CoreStd.h"
+#include "base/job-system/JobSystem.h"
+#include "physics/physx/PhysXInc.h"
+
+namespace cc {
+namespace physics {
+
+/**
+ * Runs the tasks of the PhysX simulation on the engine JobSystem, so the simulation shares the
+ * job threads with culling and command recording instead of competing with its own thread pool.
+ * With a single job thread the tasks run on the thread submitting them. Each task runs in a job
+ * graph taken from a pool, the graphs return to the pool when the results are fetched.
+ */
+class PhysXCpuDispatcher final : public physx::PxCpuDispatcher {
+public:
+    PhysXCpuDispatcher() = default;
+    ~PhysXCpuDispatcher() override;
+
+    void         submitTask(physx::PxBaseTask &task) override;
+    physx::PxU32 getWorkerCount() const override;
+
+    // Returns the jobs of the tasks submitted so far to the pool, once the simulation they belong to has completed.
+    void collect();
+
+private:
+    // a graph of a single job running the task it is given, graphs can be run again once they are done
+    struct TaskJob {
+        TaskJob();
+
+        JobGraph           graph;
+        physx::PxBaseTask *task{nullptr};
+    };
+
+    std::mutex                            _mutex;
+    std::vector<std::unique_ptr<TaskJob>> _jobs;
+    std::vector<TaskJob *>                _freeJobs;
+    std::vector<TaskJob *>                _runningJobs;
+    std::vector<TaskJob *>                _collectedJobs;
+};
+
+} // namespace physics
+} // namespace cc
@@ -40,29 +40,41 @@ namespace physics {
 PhysXRigidBody::PhysXRigidBody() : _mEnabled(false),
                                    _mGroup(1) {}
 
+PhysXRigidBody::~PhysXRigidBody() {
+    PhysXWorld::cancelWrites(getImpl());
+}
+
 void PhysXRigidBody::initialize(scene::Node *node, ERigidBodyType t, uint32_t g) {
-    _mGroup         = g;
-    PhysXWorld &ins = PhysXWorld::getInstance();
-    _mSharedBody    = ins.getSharedBody(node, this);
-    getSharedBody().reference(true);
-    getSharedBody().setType(t);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mGroup         = g;
+        PhysXWorld &ins = PhysXWorld::getInstance();
+        _mSharedBody    = ins.getSharedBody(node, this);
+        getSharedBody().reference(true);
+        getSharedBody().setType(t);
+    });
 }
 
 void PhysXRigidBody::onEnable() {
-    _mEnabled = true;
-    getSharedBody().enabled(true);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mEnabled = true;
+        getSharedBody().enabled(true);
+    });
 }
 
 void PhysXRigidBody::onDisable() {
-    _mEnabled = false;
-    getSharedBody().enabled(false);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mEnabled = false;
+        getSharedBody().enabled(false);
+    });
 }
 
 void PhysXRigidBody::onDestroy() {
+    PhysXWorld::getInstance().fetchResults();
     getSharedBody().reference(false);
 }
 
 bool PhysXRigidBody::isAwake() {
+    PhysXWorld::getInstance().fetchResults();
     if (!getSharedBody().isInWorld() || getSharedBody().isStatic()) return false;
     return !getSharedBody().getImpl().rigidDynamic->isSleeping();
 }
@@ -72,94 +84,127 @@ bool PhysXRigidBody::isSleepy() {
 }
 
 bool PhysXRigidBody::isSleeping() {
+    PhysXWorld::getInstance().fetchResults();
     if (!getSharedBody().isInWorld() || getSharedBody().isStatic()) return true;
     return getSharedBody().getImpl().rigidDynamic->isSleeping();
 }
 
 void PhysXRigidBody::setType(ERigidBodyType v) {
-    getSharedBody().setType(v);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        getSharedBody().setType(v);
+    });
 }
 
 void PhysXRigidBody::setMass(float v) {
-    getSharedBody().setMass(v);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        getSharedBody().setMass(v);
+    });
 }
 
 void PhysXRigidBody::setLinearDamping(float v) {
-    if (getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->setLinearDamping(v);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->setLinearDamping(v);
+    });
 }
 
 void PhysXRigidBody::setAngularDamping(float v) {
-    if (getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->setAngularDamping(v);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->setAngularDamping(v);
+    });
 }
 
 void PhysXRigidBody::useGravity(bool v) {
-    if (getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, !v);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, !v);
+    });
 }
 
 void PhysXRigidBody::useCCD(bool v) {
-    if (getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->setRigidBodyFlag(physx::PxRigidBodyFlag::eENABLE_CCD, v);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->setRigidBodyFlag(physx::PxRigidBodyFlag::eENABLE_CCD, v);
+    });
 }
 
 void PhysXRigidBody::setLinearFactor(float x, float y, float z) {
-    if (getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_X, x == 0.);
-    getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_Y, y == 0.);
-    getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_Z, z == 0.);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_X, x == 0.);
+        getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_Y, y == 0.);
+        getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_Z, z == 0.);
+    });
 }
 
 void PhysXRigidBody::setAngularFactor(float x, float y, float z) {
-    if (getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_X, x == 0.);
-    getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_Y, y == 0.);
-    getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_Z, z == 0.);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_X, x == 0.);
+        getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_Y, y == 0.);
+        getSharedBody().getImpl().rigidDynamic->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_Z, z == 0.);
+    });
 }
 
 void PhysXRigidBody::setAllowSleep(bool v) {
-    if (!getSharedBody().isDynamic()) return;
-    PxReal st = getSharedBody().getImpl().rigidDynamic->getSleepThreshold();
-    PxReal wc = v ? std::max(0.F, st - 0.001F) : FLT_MAX;
-    getSharedBody().getImpl().rigidDynamic->setWakeCounter(wc);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isDynamic()) return;
+        PxReal st = getSharedBody().getImpl().rigidDynamic->getSleepThreshold();
+        PxReal wc = v ? std::max(0.F, st - 0.001F) : FLT_MAX;
+        getSharedBody().getImpl().rigidDynamic->setWakeCounter(wc);
+    });
 }
 
 void PhysXRigidBody::wakeUp() {
-    if (!getSharedBody().isInWorld() || getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->wakeUp();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld() || getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->wakeUp();
+    });
 }
 
 void PhysXRigidBody::sleep() {
-    if (!getSharedBody().isInWorld() || getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->putToSleep();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld() || getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->putToSleep();
+    });
 }
 
 void PhysXRigidBody::clearState() {
-    if (!getSharedBody().isInWorld()) return;
-    clearForces();
-    clearVelocity();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld()) return;
+        clearForces();
+        clearVelocity();
+    });
 }
 
 void PhysXRigidBody::clearForces() {
-    if (!getSharedBody().isInWorld()) return;
-    getSharedBody().clearForces();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld()) return;
+        getSharedBody().clearForces();
+    });
 }
 
 void PhysXRigidBody::clearVelocity() {
-    getSharedBody().clearVelocity();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        getSharedBody().clearVelocity();
+    });
 }
 
 void PhysXRigidBody::setSleepThreshold(float v) {
-    if (getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->setSleepThreshold(v);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->setSleepThreshold(v);
+    });
 }
 
 float PhysXRigidBody::getSleepThreshold() {
+    PhysXWorld::getInstance().fetchResults();
     return getSharedBody().getImpl().rigidDynamic->getSleepThreshold();
 }
 
 cc::Vec3 PhysXRigidBody::getLinearVelocity() {
+    PhysXWorld::getInstance().fetchResults();
     if (getSharedBody().isStatic()) return cc::Vec3::ZERO;
     cc::Vec3 cv;
     pxSetVec3Ext(cv, getSharedBody().getImpl().rigidDynamic->getLinearVelocity());
@@ -167,11 +212,14 @@ cc::Vec3 PhysXRigidBody::getLinearVelocity() {
 }
 
 void PhysXRigidBody::setLinearVelocity(float x, float y, float z) {
-    if (getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->setLinearVelocity(PxVec3{x, y, z});
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->setLinearVelocity(PxVec3{x, y, z});
+    });
 }
 
 cc::Vec3 PhysXRigidBody::getAngularVelocity() {
+    PhysXWorld::getInstance().fetchResults();
     if (getSharedBody().isStatic()) return cc::Vec3::ZERO;
     cc::Vec3 cv;
     pxSetVec3Ext(cv, getSharedBody().getImpl().rigidDynamic->getAngularVelocity());
@@ -179,86 +227,106 @@ cc::Vec3 PhysXRigidBody::getAngularVelocity() {
 }
 
 void PhysXRigidBody::setAngularVelocity(float x, float y, float z) {
-    if (getSharedBody().isStatic()) return;
-    getSharedBody().getImpl().rigidDynamic->setAngularVelocity(PxVec3{x, y, z});
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (getSharedBody().isStatic()) return;
+        getSharedBody().getImpl().rigidDynamic->setAngularVelocity(PxVec3{x, y, z});
+    });
 }
 
 void PhysXRigidBody::applyForce(float x, float y, float z, float rx, float ry, float rz) {
-    if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
-    const PxVec3 force{x, y, z};
-    if (force.isZero()) return;
-    auto *body = getSharedBody().getImpl().rigidDynamic;
-    body->addForce(force, PxForceMode::eFORCE, true);
-    const PxVec3 torque = (PxVec3{rx, ry, rz}).cross(force);
-    if (!torque.isZero()) body->addTorque(torque, PxForceMode::eFORCE, true);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
+        const PxVec3 force{x, y, z};
+        if (force.isZero()) return;
+        auto *body = getSharedBody().getImpl().rigidDynamic;
+        body->addForce(force, PxForceMode::eFORCE, true);
+        const PxVec3 torque = (PxVec3{rx, ry, rz}).cross(force);
+        if (!torque.isZero()) body->addTorque(torque, PxForceMode::eFORCE, true);
+    });
 }
 
 void PhysXRigidBody::applyLocalForce(float x, float y, float z, float rx, float ry, float rz) {
-    if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
-    const PxVec3 force{x, y, z};
-    if (force.isZero()) return;
-    auto *            body       = getSharedBody().getImpl().rigidDynamic;
-    const PxTransform bodyPose   = body->getGlobalPose();
-    const PxVec3      worldForce = bodyPose.rotate(force);
-    const PxVec3      worldPos   = bodyPose.rotate(PxVec3{rx, ry, rz});
-    body->addForce(worldForce, PxForceMode::eFORCE, true);
-    const PxVec3 torque = worldPos.cross(worldForce);
-    if (!torque.isZero()) body->addTorque(torque, PxForceMode::eFORCE, true);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
+        const PxVec3 force{x, y, z};
+        if (force.isZero()) return;
+        auto *            body       = getSharedBody().getImpl().rigidDynamic;
+        const PxTransform bodyPose   = body->getGlobalPose();
+        const PxVec3      worldForce = bodyPose.rotate(force);
+        const PxVec3      worldPos   = bodyPose.rotate(PxVec3{rx, ry, rz});
+        body->addForce(worldForce, PxForceMode::eFORCE, true);
+        const PxVec3 torque = worldPos.cross(worldForce);
+        if (!torque.isZero()) body->addTorque(torque, PxForceMode::eFORCE, true);
+    });
 }
 
 void PhysXRigidBody::applyImpulse(float x, float y, float z, float rx, float ry, float rz) {
-    if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
-    const PxVec3 impulse{x, y, z};
-    if (impulse.isZero()) return;
-    auto *       body   = getSharedBody().getImpl().rigidDynamic;
-    const PxVec3 torque = (PxVec3{rx, ry, rz}).cross(impulse);
-    body->addForce(impulse, PxForceMode::eIMPULSE, true);
-    if (!torque.isZero()) body->addTorque(torque, PxForceMode::eIMPULSE, true);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
+        const PxVec3 impulse{x, y, z};
+        if (impulse.isZero()) return;
+        auto *       body   = getSharedBody().getImpl().rigidDynamic;
+        const PxVec3 torque = (PxVec3{rx, ry, rz}).cross(impulse);
+        body->addForce(impulse, PxForceMode::eIMPULSE, true);
+        if (!torque.isZero()) body->addTorque(torque, PxForceMode::eIMPULSE, true);
+    });
 }
 
 void PhysXRigidBody::applyLocalImpulse(float x, float y, float z, float rx, float ry, float rz) {
-    if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
-    const PxVec3 impulse{x, y, z};
-    if (impulse.isZero()) return;
-    auto *            body         = getSharedBody().getImpl().rigidDynamic;
-    const PxTransform bodyPose     = body->getGlobalPose();
-    const PxVec3      worldImpulse = bodyPose.rotate(impulse);
-    const PxVec3      worldPos     = bodyPose.rotate(PxVec3{rx, ry, rz});
-    body->addForce(worldImpulse, PxForceMode::eIMPULSE, true);
-    const PxVec3 torque = worldPos.cross(worldImpulse);
-    if (!torque.isZero()) body->addTorque(torque, PxForceMode::eIMPULSE, true);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
+        const PxVec3 impulse{x, y, z};
+        if (impulse.isZero()) return;
+        auto *            body         = getSharedBody().getImpl().rigidDynamic;
+        const PxTransform bodyPose     = body->getGlobalPose();
+        const PxVec3      worldImpulse = bodyPose.rotate(impulse);
+        const PxVec3      worldPos     = bodyPose.rotate(PxVec3{rx, ry, rz});
+        body->addForce(worldImpulse, PxForceMode::eIMPULSE, true);
+        const PxVec3 torque = worldPos.cross(worldImpulse);
+        if (!torque.isZero()) body->addTorque(torque, PxForceMode::eIMPULSE, true);
+    });
 }
 
 void PhysXRigidBody::applyTorque(float x, float y, float z) {
-    if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
-    PxVec3 torque{x, y, z};
-    if (torque.isZero()) return;
-    getSharedBody().getImpl().rigidDynamic->addTorque(torque, PxForceMode::eFORCE, true);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
+        PxVec3 torque{x, y, z};
+        if (torque.isZero()) return;
+        getSharedBody().getImpl().rigidDynamic->addTorque(torque, PxForceMode::eFORCE, true);
+    });
 }
 
 void PhysXRigidBody::applyLocalTorque(float x, float y, float z) {
-    if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
-    PxVec3 torque{x, y, z};
-    if (torque.isZero()) return;
-    auto *            body     = getSharedBody().getImpl().rigidDynamic;
-    const PxTransform bodyPose = body->getGlobalPose();
-    body->addTorque(bodyPose.rotate(PxVec3{x, y, z}), PxForceMode::eFORCE, true);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!getSharedBody().isInWorld() || getSharedBody().isStaticOrKinematic()) return;
+        PxVec3 torque{x, y, z};
+        if (torque.isZero()) return;
+        auto *            body     = getSharedBody().getImpl().rigidDynamic;
+        const PxTransform bodyPose = body->getGlobalPose();
+        body->addTorque(bodyPose.rotate(PxVec3{x, y, z}), PxForceMode::eFORCE, true);
+    });
 }
 
 uint32_t PhysXRigidBody::getGroup() {
+    PhysXWorld::getInstance().fetchResults();
     return getSharedBody().getGroup();
 }
 
 void PhysXRigidBody::setGroup(uint32_t g) {
-    getSharedBody().setGroup(g);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        getSharedBody().setGroup(g);
+    });
 }
 
 uint32_t PhysXRigidBody::getMask() {
+    PhysXWorld::getInstance().fetchResults();
     return getSharedBody().getMask();
 }
 
 void PhysXRigidBody::setMask(uint32_t m) {
-    getSharedBody().setMask(m);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        getSharedBody().setMask(m);
+    });
 }
 
 } // namespace physics
@@ -177,8 +177,9 @@ void PhysXSharedBody::initStaticActor() {
         pxSetQuatExt(transform.q, getNode()->getWorldRotation());
         if (!transform.p.isFinite()) transform.p = PxVec3{PxIdentity};
         if (!transform.q.isUnit()) transform.q = PxQuat{PxIdentity};
-        PxPhysics &phy = PxGetPhysics();
-        _mStaticActor  = phy.createRigidStatic(transform);
+        PxPhysics &phy          = PxGetPhysics();
+        _mStaticActor           = phy.createRigidStatic(transform);
+        _mStaticActor->userData = this;
     }
 }
 
@@ -190,8 +191,9 @@ void PhysXSharedBody::initDynamicActor() {
         pxSetQuatExt(transform.q, getNode()->getWorldRotation());
         if (!transform.p.isFinite()) transform.p = PxVec3{PxIdentity};
         if (!transform.q.isUnit()) transform.q = PxQuat{PxIdentity};
-        PxPhysics &phy = PxGetPhysics();
-        _mDynamicActor = phy.createRigidDynamic(transform);
+        PxPhysics &phy           = PxGetPhysics();
+        _mDynamicActor           = phy.createRigidDynamic(transform);
+        _mDynamicActor->userData = this;
         _mDynamicActor->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, isKinematic());
     }
 }
@@ -263,7 +265,6 @@ void PhysXSharedBody::syncSceneWithCheck() {
 
 void PhysXSharedBody::syncPhysicsToScene() {
     if (isStaticOrKinematic()) return;
-    if (_mDynamicActor->isSleeping()) return;
     const PxTransform &wp = getImpl().rigidActor->getGlobalPose();
     getNode()->setWorldPosition(wp.p.x, wp.p.y, wp.p.z);
     getNode()->setWorldRotation(wp.q.x, wp.q.y, wp.q.z, wp.q.w);
@@ -65,7 +65,7 @@ PhysXWorld::PhysXWorld() {
 #endif
     _mPhysics = PxCreatePhysics(PX_PHYSICS_VERSION, *_mFoundation, scale, true, pvd);
     PxInitExtensions(*_mPhysics, pvd);
-    _mDispatcher = physx::PxDefaultCpuDispatcherCreate(0);
+    _mDispatcher = new PhysXCpuDispatcher();
 
     _mEventMgr = new PhysXEventManager();
 
@@ -75,6 +75,8 @@ PhysXWorld::PhysXWorld() {
     sceneDesc.kineKineFilteringMode   = physx::PxPairFilteringMode::eKEEP;
     sceneDesc.staticKineFilteringMode = physx::PxPairFilteringMode::eKEEP;
     sceneDesc.flags |= physx::PxSceneFlag::eENABLE_CCD;
+    // report the actors moved by the simulation, kinematic ones follow their nodes and are never synced back
+    sceneDesc.flags |= physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS | physx::PxSceneFlag::eEXCLUDE_KINEMATICS_FROM_ACTIVE_ACTORS;
     sceneDesc.filterShader            = simpleFilterShader;
     sceneDesc.simulationEventCallback = &_mEventMgr->getEventCallback();
     _mScene                           = _mPhysics->createScene(sceneDesc);
@@ -85,9 +87,10 @@ PhysXWorld::PhysXWorld() {
 }
 
 PhysXWorld::~PhysXWorld() {
+    if (_mSimulating) _mScene->fetchResults(true);
     delete _mEventMgr;
     PX_RELEASE(_mScene);
-    PX_RELEASE(_mDispatcher);
+    delete _mDispatcher;
     PX_RELEASE(_mPhysics);
 #ifdef CC_DEBUG
     physx::PxPvdTransport *transport = _mPvd->getTransport();
@@ -96,15 +99,37 @@ PhysXWorld::~PhysXWorld() {
 #endif
     PxCloseExtensions();
     PX_RELEASE(_mFoundation);
+    instance = nullptr;
 }
 
 void PhysXWorld::step(float fixedTimeStep) {
+    stepAsync(fixedTimeStep);
+    fetchResults();
+}
+
+void PhysXWorld::stepAsync(float fixedTimeStep) {
+    fetchResults();
     _mScene->simulate(fixedTimeStep);
+    _mSimulating = true;
+    _mWrites.begin();
+}
+
+void PhysXWorld::fetchResults() {
+    if (!_mSimulating) return;
     _mScene->fetchResults(true);
-    syncPhysicsToScene();
+    _mSimulating = false;
+    _mDispatcher->collect();
+    syncActiveActors();
+    // the changes made during the step apply on top of its results
+    _mWrites.apply();
+}
+
+void PhysXWorld::cancelWrites(uintptr_t owner) {
+    if (instance) instance->_mWrites.cancel(owner);
 }
 
 void PhysXWorld::setGravity(float x, float y, float z) {
+    fetchResults();
     _mScene->setGravity(physx::PxVec3(x, y, z));
 }
 
@@ -168,6 +193,7 @@ uintptr_t PhysXWorld::createHeightField(HeightFieldDesc &desc) {
 
 uintptr_t PhysXWorld::createMaterial(uint16_t id, float f, float df, float r,
                                      uint8_t m0, uint8_t m1) {
+    fetchResults();
     physx::PxMaterial *mat;
     auto &             m = getPxMaterialMap();
     if (m.find(id) == m.end()) {
@@ -187,12 +213,14 @@ uintptr_t PhysXWorld::createMaterial(uint16_t id, float f, float df, float r,
 }
 
 void PhysXWorld::emitEvents() {
+    fetchResults();
     _mEventMgr->refreshPairs();
 }
 
 void PhysXWorld::syncSceneToPhysics() {
+    fetchResults();
     for (auto const &sb : _mSharedBodies) {
-        sb->syncSceneToPhysics();
+        if (sb->getNode()->getFlagsChanged()) sb->syncSceneToPhysics();
     }
 }
 
@@ -202,14 +230,30 @@ uint32_t PhysXWorld::getMaskByIndex(uint32_t i) {
 }
 
 void PhysXWorld::syncPhysicsToScene() {
-    for (auto const &sb : _mSharedBodies) {
-        sb->syncPhysicsToScene();
+    // a running step is synced once, when its results are fetched
+    if (_mSimulating) {
+        fetchResults();
+        return;
+    }
+    syncActiveActors();
+}
+
+void PhysXWorld::syncActiveActors() {
+    // only the actors moved by the last simulation, static and sleeping ones are not reported
+    physx::PxU32     count  = 0;
+    physx::PxActor **actors = _mScene->getActiveActors(count);
+    for (physx::PxU32 i = 0; i < count; i++) {
+        auto *sb = static_cast<PhysXSharedBody *>(actors[i]->userData);
+        if (sb) sb->syncPhysicsToScene();
     }
 }
 
 void PhysXWorld::syncSceneWithCheck() {
+    fetchResults();
+    // nodes without changed flags have not moved in this frame. The step sets the flags of the nodes it synced,
+    // so a check right after it visits the active actors once more and finds them unchanged unless events moved them.
     for (auto const &sb : _mSharedBodies) {
-        sb->syncSceneWithCheck();
+        if (sb->getNode()->getFlagsChanged()) sb->syncSceneWithCheck();
     }
 }
 
@@ -217,6 +261,7 @@ void PhysXWorld::setAllowSleep(bool val) {
 }
 
 void PhysXWorld::addActor(const PhysXSharedBody &sb) {
+    fetchResults();
     auto beg  = _mSharedBodies.begin();
     auto end  = _mSharedBodies.end();
     auto iter = find(beg, end, &sb);
@@ -227,6 +272,7 @@ void PhysXWorld::addActor(const PhysXSharedBody &sb) {
 }
 
 void PhysXWorld::removeActor(const PhysXSharedBody &sb) {
+    fetchResults();
     auto beg  = _mSharedBodies.begin();
     auto end  = _mSharedBodies.end();
     auto iter = find(beg, end, &sb);
@@ -237,6 +283,7 @@ void PhysXWorld::removeActor(const PhysXSharedBody &sb) {
 }
 
 bool PhysXWorld::raycast(RaycastOptions &opt) {
+    fetchResults();
     physx::PxQueryCache *cache = nullptr;
     const auto           o     = opt.origin;
     const auto           ud    = opt.unitDir;
@@ -273,6 +320,7 @@ std::vector<RaycastResult> &PhysXWorld::raycastResult() {
 }
 
 bool PhysXWorld::raycastClosest(RaycastOptions &opt) {
+    fetchResults();
     physx::PxRaycastHit  hit;
     physx::PxQueryCache *cache = nullptr;
     const auto           o     = opt.origin;
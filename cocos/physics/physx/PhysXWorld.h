@@ -27,9 +27,11 @@
 
 #include <memory>
 #include "base/Macros.h"
+#include "physics/physx/PhysXCpuDispatcher.h"
 #include "physics/physx/PhysXEventManager.h"
 #include "physics/physx/PhysXFilterShader.h"
 #include "physics/physx/PhysXInc.h"
+#include "physics/physx/PhysXWriteBuffer.h"
 #include "physics/physx/PhysXRigidBody.h"
 #include "physics/physx/PhysXSharedBody.h"
 #include "physics/spec/IWorld.h"
@@ -47,6 +49,8 @@ public:
     PhysXWorld();
     ~PhysXWorld() override;
     void                        step(float fixedTimeStep) override;
+    void                        stepAsync(float fixedTimeStep) override;
+    void                        fetchResults() override;
     void                        setGravity(float x, float y, float z) override;
     void                        setAllowSleep(bool v) override;
     void                        emitEvents() override;
@@ -78,11 +82,21 @@ public:
 
     inline physx::PxScene &getScene() const { return *_mScene; }
     uint32_t                  getMaskByIndex(uint32_t i);
+    // Syncs the actors moved by the last step to their nodes, a running step is fetched first.
     void                      syncPhysicsToScene();
     void                      addActor(const PhysXSharedBody &sb);
     void                      removeActor(const PhysXSharedBody &sb);
 
+    // Changes a body, shape or joint at once, or after the running step is fetched. Reads of simulated
+    // state and destruction still wait for the step.
+    template <typename Function>
+    inline void write(uintptr_t owner, Function &&func) { _mWrites.write(owner, std::forward<Function>(func)); }
+    // Drops the changes of a destroyed body, shape or joint which are waiting for the step.
+    static void cancelWrites(uintptr_t owner);
+
 private:
+    void syncActiveActors();
+
     static PhysXWorld *  instance;
     physx::PxFoundation *_mFoundation;
     physx::PxCooking *   _mCooking;
@@ -90,11 +104,13 @@ private:
 #ifdef CC_DEBUG
     physx::PxPvd *_mPvd;
 #endif
-    physx::PxDefaultCpuDispatcher *_mDispatcher;
+    PhysXCpuDispatcher *           _mDispatcher;
     physx::PxScene *               _mScene;
     PhysXEventManager *            _mEventMgr;
     uint32_t                       _mCollisionMatrix[31];
     std::vector<PhysXSharedBody *> _mSharedBodies;
+    PhysXWriteBuffer               _mWrites;
+    bool                           _mSimulating{false};
 };
 
 } // namespace physics
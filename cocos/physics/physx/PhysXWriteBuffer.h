@@ -0,0 +1,94 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace cc {
+namespace physics {
+
+/**
+ * Changes of bodies, shapes and joints made while the scene simulates.
+ *
+ * PhysX objects must not change during a step, so the changes are kept in the order they are
+ * made and applied once the results of the step are fetched. Outside of a step they run at once.
+ */
+class PhysXWriteBuffer final {
+public:
+    inline bool isBuffering() const { return _buffering; }
+
+    // Buffers the writes made from here until apply.
+    inline void begin() { _buffering = true; }
+
+    template <typename Function>
+    void write(uintptr_t owner, Function &&func);
+
+    // Runs the buffered writes in order, writes they make run at once.
+    void apply();
+
+    // Drops the buffered writes of a destroyed owner.
+    void cancel(uintptr_t owner);
+
+private:
+    struct Write {
+        uintptr_t             owner{0};
+        std::function<void()> func;
+    };
+
+    std::vector<Write> _writes;
+    bool               _buffering{false};
+};
+
+template <typename Function>
+void PhysXWriteBuffer::write(uintptr_t owner, Function &&func) {
+    if (_buffering) {
+        _writes.push_back({owner, std::forward<Function>(func)});
+    } else {
+        func();
+    }
+}
+
+inline void PhysXWriteBuffer::apply() {
+    _buffering = false;
+    // cancelled writes are only cleared, so a write may destroy any owner, including its own
+    for (size_t i = 0; i < _writes.size(); ++i) {
+        auto func = std::move(_writes[i].func);
+        if (func) func();
+    }
+    _writes.clear();
+}
+
+inline void PhysXWriteBuffer::cancel(uintptr_t owner) {
+    for (auto &write : _writes) {
+        if (write.owner == owner) write.func = nullptr;
+    }
+}
+
+} // namespace physics
+} // namespace cc
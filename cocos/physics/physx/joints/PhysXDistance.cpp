@@ -26,6 +26,7 @@
 #include "physics/physx/joints/PhysXDistance.h"
 #include "physics/physx/PhysXSharedBody.h"
 #include "physics/physx/PhysXUtils.h"
+#include "physics/physx/PhysXWorld.h"
 #include "math/Quaternion.h"
 
 namespace cc {
@@ -39,13 +40,17 @@ void PhysXDistance::onComponentSet() {
 }
 
 void PhysXDistance::setPivotA(float x, float y, float z) {
-    _mPivotA = physx::PxVec3{x, y, z};
-    updatePose();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mPivotA = physx::PxVec3{x, y, z};
+        updatePose();
+    });
 }
 
 void PhysXDistance::setPivotB(float x, float y, float z) {
-    _mPivotB = physx::PxVec3{x, y, z};
-    updatePose();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mPivotB = physx::PxVec3{x, y, z};
+        updatePose();
+    });
 }
 
 void PhysXDistance::updateScale0() {
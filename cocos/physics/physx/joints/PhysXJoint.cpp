@@ -31,50 +31,65 @@
 namespace cc {
 namespace physics {
 
+PhysXJoint::~PhysXJoint() {
+    PhysXWorld::cancelWrites(getImpl());
+}
+
 void PhysXJoint::initialize(scene::Node* node) {
-    auto& ins    = PhysXWorld::getInstance();
-    _mSharedBody = ins.getSharedBody(node);
-    _mSharedBody->reference(true);
-    onComponentSet();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        auto& ins    = PhysXWorld::getInstance();
+        _mSharedBody = ins.getSharedBody(node);
+        _mSharedBody->reference(true);
+        onComponentSet();
+    });
 }
 
 void PhysXJoint::onEnable() {
-    _mSharedBody->addJoint(*this, physx::PxJointActorIndex::eACTOR0);
-    if (_mConnectedBody) {
-        _mConnectedBody->addJoint(*this, physx::PxJointActorIndex::eACTOR1);
-        _mJoint->setActors(_mSharedBody->getImpl().rigidActor, _mConnectedBody->getImpl().rigidActor);
-    } else {
-        _mJoint->setActors(_mSharedBody->getImpl().rigidActor, nullptr);
-    }
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mSharedBody->addJoint(*this, physx::PxJointActorIndex::eACTOR0);
+        if (_mConnectedBody) {
+            _mConnectedBody->addJoint(*this, physx::PxJointActorIndex::eACTOR1);
+            _mJoint->setActors(_mSharedBody->getImpl().rigidActor, _mConnectedBody->getImpl().rigidActor);
+        } else {
+            _mJoint->setActors(_mSharedBody->getImpl().rigidActor, nullptr);
+        }
+    });
 }
 
 void PhysXJoint::onDisable() {
-    _mJoint->setActors(&getTempRigidActor(), nullptr);
-    _mSharedBody->removeJoint(*this, physx::PxJointActorIndex::eACTOR0);
-    if (_mConnectedBody) _mConnectedBody->removeJoint(*this, physx::PxJointActorIndex::eACTOR1);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mJoint->setActors(&getTempRigidActor(), nullptr);
+        _mSharedBody->removeJoint(*this, physx::PxJointActorIndex::eACTOR0);
+        if (_mConnectedBody) _mConnectedBody->removeJoint(*this, physx::PxJointActorIndex::eACTOR1);
+    });
 }
 
 void PhysXJoint::onDestroy() {
+    PhysXWorld::getInstance().fetchResults();
     _mSharedBody->reference(false);
 }
 
 void PhysXJoint::setConnectedBody(uintptr_t v) {
-    if (v) {
-        auto& ins       = PhysXWorld::getInstance();
-        _mConnectedBody = ins.getSharedBody(reinterpret_cast<scene::Node*>(v));
-    } else {
-        _mConnectedBody = nullptr;
-    }
-    if (_mJoint) {
-        _mJoint->setActors(_mSharedBody->getImpl().rigidActor, _mConnectedBody ? _mConnectedBody->getImpl().rigidActor : nullptr);
-    }
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (v) {
+            auto& ins       = PhysXWorld::getInstance();
+            _mConnectedBody = ins.getSharedBody(reinterpret_cast<scene::Node*>(v));
+        } else {
+            _mConnectedBody = nullptr;
+        }
+        if (_mJoint) {
+            _mJoint->setActors(_mSharedBody->getImpl().rigidActor, _mConnectedBody ? _mConnectedBody->getImpl().rigidActor : nullptr);
+        }
+    });
 }
 
 void PhysXJoint::setEnableCollision(const bool v) {
-    _mEnableCollision = v;
-    if (_mJoint) {
-        _mJoint->setConstraintFlag(physx::PxConstraintFlag::eCOLLISION_ENABLED, _mEnableCollision);
-    }
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mEnableCollision = v;
+        if (_mJoint) {
+            _mJoint->setConstraintFlag(physx::PxConstraintFlag::eCOLLISION_ENABLED, _mEnableCollision);
+        }
+    });
 }
 
 } // namespace physics
@@ -39,7 +39,7 @@ class PhysXJoint : virtual public IBaseJoint {
     PhysXJoint() = default;
 
 public:
-    ~PhysXJoint() override = default;
+    ~PhysXJoint() override;
     inline uintptr_t getImpl() override { return reinterpret_cast<uintptr_t>(this); }
     void             initialize(scene::Node *node) override;
     void             onEnable() override;
@@ -26,6 +26,7 @@
 #include "physics/physx/joints/PhysXRevolute.h"
 #include "physics/physx/PhysXSharedBody.h"
 #include "physics/physx/PhysXUtils.h"
+#include "physics/physx/PhysXWorld.h"
 #include "math/Quaternion.h"
 
 namespace cc {
@@ -40,18 +41,24 @@ void PhysXRevolute::onComponentSet() {
 }
 
 void PhysXRevolute::setPivotA(float x, float y, float z) {
-    _mPivotA = physx::PxVec3{x, y, z};
-    updatePose();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mPivotA = physx::PxVec3{x, y, z};
+        updatePose();
+    });
 }
 
 void PhysXRevolute::setPivotB(float x, float y, float z) {
-    _mPivotB = physx::PxVec3{x, y, z};
-    updatePose();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mPivotB = physx::PxVec3{x, y, z};
+        updatePose();
+    });
 }
 
 void PhysXRevolute::setAxis(float x, float y, float z) {
-    _mAxis = physx::PxVec3{x, y, z};
-    updatePose();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mAxis = physx::PxVec3{x, y, z};
+        updatePose();
+    });
 }
 
 void PhysXRevolute::updateScale0() {
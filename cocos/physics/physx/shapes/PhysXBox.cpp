@@ -35,9 +35,11 @@ PhysXBox::PhysXBox() : _mHalfExtents(0.5),
                        PhysXShape(){};
 
 void PhysXBox::setSize(float x, float y, float z) {
-    _mHalfExtents = physx::PxVec3{x / 2, y / 2, z / 2};
-    updateGeometry();
-    getShape().setGeometry(getPxGeometry<physx::PxBoxGeometry>());
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mHalfExtents = physx::PxVec3{x / 2, y / 2, z / 2};
+        updateGeometry();
+        getShape().setGeometry(getPxGeometry<physx::PxBoxGeometry>());
+    });
 }
 
 void PhysXBox::onComponentSet() {
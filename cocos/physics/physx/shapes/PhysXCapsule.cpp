@@ -36,21 +36,27 @@ PhysXCapsule::PhysXCapsule() : _mRadius(0.5F),
                                _mDirection(EAxisDirection::Y_AXIS){};
 
 void PhysXCapsule::setRadius(float r) {
-    _mRadius = r;
-    updateGeometry();
-    getShape().setGeometry(getPxGeometry<physx::PxCapsuleGeometry>());
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mRadius = r;
+        updateGeometry();
+        getShape().setGeometry(getPxGeometry<physx::PxCapsuleGeometry>());
+    });
 }
 
 void PhysXCapsule::setCylinderHeight(float v) {
-    _mCylinderHeight = v;
-    updateGeometry();
-    getShape().setGeometry(getPxGeometry<physx::PxCapsuleGeometry>());
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mCylinderHeight = v;
+        updateGeometry();
+        getShape().setGeometry(getPxGeometry<physx::PxCapsuleGeometry>());
+    });
 }
 
 void PhysXCapsule::setDirection(EAxisDirection v) {
-    _mDirection = v;
-    updateGeometry();
-    getShape().setGeometry(getPxGeometry<physx::PxCapsuleGeometry>());
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mDirection = v;
+        updateGeometry();
+        getShape().setGeometry(getPxGeometry<physx::PxCapsuleGeometry>());
+    });
 }
 
 void PhysXCapsule::onComponentSet() {
@@ -36,10 +36,12 @@ namespace physics {
 PhysXCone::PhysXCone() : _mMesh(nullptr){};
 
 void PhysXCone::setConvex(uintptr_t handle) {
-    if (reinterpret_cast<uintptr_t>(_mMesh) == handle) return;
-    _mMesh = reinterpret_cast<physx::PxConvexMesh *>(handle);
-    if (_mShape) {
-    }
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (reinterpret_cast<uintptr_t>(_mMesh) == handle) return;
+        _mMesh = reinterpret_cast<physx::PxConvexMesh *>(handle);
+        if (_mShape) {
+        }
+    });
 }
 
 void PhysXCone::onComponentSet() {
@@ -53,10 +55,12 @@ void PhysXCone::onComponentSet() {
 }
 
 void PhysXCone::setCone(float r, float h, EAxisDirection d) {
-    _mData.radius    = r;
-    _mData.height    = h;
-    _mData.direction = d;
-    updateGeometry();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mData.radius    = r;
+        _mData.height    = h;
+        _mData.direction = d;
+        updateGeometry();
+    });
 }
 
 void PhysXCone::updateGeometry() {
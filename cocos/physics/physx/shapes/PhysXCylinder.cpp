@@ -36,11 +36,13 @@ namespace physics {
 PhysXCylinder::PhysXCylinder() : _mMesh(nullptr){};
 
 void PhysXCylinder::setConvex(uintptr_t handle) {
-    if (reinterpret_cast<uintptr_t>(_mMesh) == handle) return;
-    _mMesh = reinterpret_cast<physx::PxConvexMesh *>(handle);
-    if (_mShape) {
-        // TODO(Administrator): ...
-    }
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (reinterpret_cast<uintptr_t>(_mMesh) == handle) return;
+        _mMesh = reinterpret_cast<physx::PxConvexMesh *>(handle);
+        if (_mShape) {
+            // TODO(Administrator): ...
+        }
+    });
 }
 
 void PhysXCylinder::onComponentSet() {
@@ -54,10 +56,12 @@ void PhysXCylinder::onComponentSet() {
 }
 
 void PhysXCylinder::setCylinder(float r, float h, EAxisDirection d) {
-    _mData.radius    = r;
-    _mData.height    = h;
-    _mData.direction = d;
-    updateGeometry();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mData.radius    = r;
+        _mData.height    = h;
+        _mData.direction = d;
+        updateGeometry();
+    });
 }
 
 void PhysXCylinder::updateGeometry() {
@@ -36,13 +36,17 @@ PhysXPlane::PhysXPlane() : _mConstant(0.F),
                            {};
 
 void PhysXPlane::setConstant(float x) {
-    _mConstant = x;
-    updateCenter();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mConstant = x;
+        updateCenter();
+    });
 }
 
 void PhysXPlane::setNormal(float x, float y, float z) {
-    _mNormal = physx::PxVec3{x, y, z};
-    updateCenter();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mNormal = physx::PxVec3{x, y, z};
+        updateCenter();
+    });
 }
 
 void PhysXPlane::onComponentSet() {
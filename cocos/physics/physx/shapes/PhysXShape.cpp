@@ -32,77 +32,101 @@
 namespace cc {
 namespace physics {
 
+PhysXShape::~PhysXShape() {
+    PhysXWorld::cancelWrites(getImpl());
+}
+
 void PhysXShape::initialize(scene::Node *node) {
-    PhysXWorld &ins = PhysXWorld::getInstance();
-    _mSharedBody    = ins.getSharedBody(node);
-    getSharedBody().reference(true);
-    onComponentSet();
-    insertToShapeMap();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        PhysXWorld &ins = PhysXWorld::getInstance();
+        _mSharedBody    = ins.getSharedBody(node);
+        getSharedBody().reference(true);
+        onComponentSet();
+        insertToShapeMap();
+    });
 }
 
 void PhysXShape::onEnable() {
-    _mEnabled = true;
-    if (_mShape) getSharedBody().addShape(*this);
-    getSharedBody().enabled(true);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mEnabled = true;
+        if (_mShape) getSharedBody().addShape(*this);
+        getSharedBody().enabled(true);
+    });
 }
 
 void PhysXShape::onDisable() {
-    _mEnabled = false;
-    if (_mShape) getSharedBody().removeShape(*this);
-    getSharedBody().enabled(false);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mEnabled = false;
+        if (_mShape) getSharedBody().removeShape(*this);
+        getSharedBody().enabled(false);
+    });
 }
 
 void PhysXShape::onDestroy() {
+    PhysXWorld::getInstance().fetchResults();
     getSharedBody().reference(false);
     eraseFromShapeMap();
 }
 
 void PhysXShape::setMaterial(uint16_t id, float f, float df, float r,
                              uint8_t m0, uint8_t m1) {
-    if (!_mShape) return;
-    auto *mat = reinterpret_cast<physx::PxMaterial *>(getSharedBody().getWorld().createMaterial(id, f, df, r, m0, m1));
-    getShape().setMaterials(&mat, 1);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (!_mShape) return;
+        auto *mat = reinterpret_cast<physx::PxMaterial *>(getSharedBody().getWorld().createMaterial(id, f, df, r, m0, m1));
+        getShape().setMaterials(&mat, 1);
+    });
 }
 
 void PhysXShape::setAsTrigger(bool v) {
-    if (v) {
-        getShape().setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, !v);
-        getShape().setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, v);
-    } else {
-        getShape().setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, v);
-        getShape().setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, !v);
-    }
-    if (_mEnabled) {
-        getSharedBody().removeShape(*this);
-        getSharedBody().addShape(*this);
-    }
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (v) {
+            getShape().setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, !v);
+            getShape().setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, v);
+        } else {
+            getShape().setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, v);
+            getShape().setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, !v);
+        }
+        if (_mEnabled) {
+            getSharedBody().removeShape(*this);
+            getSharedBody().addShape(*this);
+        }
+    });
 }
 
 void PhysXShape::setCenter(float x, float y, float z) {
-    _mCenter = physx::PxVec3{x, y, z};
-    updateCenter();
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mCenter = physx::PxVec3{x, y, z};
+        updateCenter();
+    });
 }
 
 uint32_t PhysXShape::getGroup() {
+    PhysXWorld::getInstance().fetchResults();
     return getSharedBody().getGroup();
 }
 
 void PhysXShape::setGroup(uint32_t g) {
-    getSharedBody().setGroup(g);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        getSharedBody().setGroup(g);
+    });
 }
 
 uint32_t PhysXShape::getMask() {
+    PhysXWorld::getInstance().fetchResults();
     return getSharedBody().getMask();
 }
 
 void PhysXShape::setMask(uint32_t m) {
-    getSharedBody().setMask(m);
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        getSharedBody().setMask(m);
+    });
 }
 
 void PhysXShape::updateEventListener(EShapeFilterFlag flag) {
 }
 
 scene::AABB &PhysXShape::getAABB() {
+    PhysXWorld::getInstance().fetchResults();
     static scene::AABB aabb;
     if (_mShape) {
         auto bounds = physx::PxShapeExt::getWorldBounds(getShape(), *getSharedBody().getImpl().rigidActor);
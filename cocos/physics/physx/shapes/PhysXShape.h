@@ -46,7 +46,7 @@ class PhysXShape : virtual public IBaseShape {
                    _mRotation(physx::PxIdentity){};
 
 public:
-    ~PhysXShape() override = default;
+    ~PhysXShape() override;
     inline uintptr_t        getImpl() override { return reinterpret_cast<uintptr_t>(this); }
     void                    initialize(scene::Node *node) override;
     void                    onEnable() override;
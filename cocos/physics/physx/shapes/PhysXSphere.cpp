@@ -35,9 +35,11 @@ PhysXSphere::PhysXSphere() : _mRadius(0.5F),
                              PhysXShape(){};
 
 void PhysXSphere::setRadius(float r) {
-    _mRadius = r;
-    updateGeometry();
-    getShape().setGeometry(getPxGeometry<physx::PxSphereGeometry>());
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mRadius = r;
+        updateGeometry();
+        getShape().setGeometry(getPxGeometry<physx::PxSphereGeometry>());
+    });
 }
 
 void PhysXSphere::onComponentSet() {
@@ -38,19 +38,21 @@ PhysXTerrain::PhysXTerrain() : _mTerrain(nullptr),
                                _mIsTrigger(false){};
 
 void PhysXTerrain::setTerrain(uintptr_t handle, float rs, float cs, float hs) {
-    if (_mShape) return;
-    if (reinterpret_cast<uintptr_t>(_mTerrain) == handle) return;
-    _mTerrain     = reinterpret_cast<physx::PxHeightField *>(handle);
-    _mRowScale    = rs;
-    _mColScale    = cs;
-    _mHeightScale = hs;
-    if (_mSharedBody && _mTerrain) {
-        onComponentSet();
-        insertToShapeMap();
-        if (_mEnabled) getSharedBody().addShape(*this);
-        setAsTrigger(_mIsTrigger);
-        updateCenter();
-    }
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (_mShape) return;
+        if (reinterpret_cast<uintptr_t>(_mTerrain) == handle) return;
+        _mTerrain     = reinterpret_cast<physx::PxHeightField *>(handle);
+        _mRowScale    = rs;
+        _mColScale    = cs;
+        _mHeightScale = hs;
+        if (_mSharedBody && _mTerrain) {
+            onComponentSet();
+            insertToShapeMap();
+            if (_mEnabled) getSharedBody().addShape(*this);
+            setAsTrigger(_mIsTrigger);
+            updateCenter();
+        }
+    });
 }
 
 void PhysXTerrain::onComponentSet() {
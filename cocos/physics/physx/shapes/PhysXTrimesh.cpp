@@ -36,20 +36,24 @@ PhysXTrimesh::PhysXTrimesh() : _mMeshHandle(0),
                                _mIsTrigger(false){};
 
 void PhysXTrimesh::setMesh(uintptr_t handle) {
-    if (_mShape) return;
-    if (_mMeshHandle == handle) return;
-    _mMeshHandle = handle;
-    if (_mSharedBody && _mMeshHandle) {
-        onComponentSet();
-        insertToShapeMap();
-        if (_mEnabled) getSharedBody().addShape(*this);
-        setAsTrigger(_mIsTrigger);
-        updateCenter();
-    }
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        if (_mShape) return;
+        if (_mMeshHandle == handle) return;
+        _mMeshHandle = handle;
+        if (_mSharedBody && _mMeshHandle) {
+            onComponentSet();
+            insertToShapeMap();
+            if (_mEnabled) getSharedBody().addShape(*this);
+            setAsTrigger(_mIsTrigger);
+            updateCenter();
+        }
+    });
 }
 
 void PhysXTrimesh::useConvex(bool v) {
-    _mConvex = v;
+    PhysXWorld::getInstance().write(getImpl(), [=]() {
+        _mConvex = v;
+    });
 }
 
 void PhysXTrimesh::onComponentSet() {
@@ -46,6 +46,14 @@ void World::step(float fixedTimeStep) {
     _impl->step(fixedTimeStep);
 }
 
+void World::stepAsync(float fixedTimeStep) {
+    _impl->stepAsync(fixedTimeStep);
+}
+
+void World::fetchResults() {
+    _impl->fetchResults();
+}
+
 void World::setAllowSleep(bool v) {
     _impl->setAllowSleep(v);
 }
@@ -38,6 +38,8 @@ public:
     void setGravity(float x, float y, float z) override;
     void setAllowSleep(bool v) override;
     void step(float fixedTimeStep) override;
+    void stepAsync(float fixedTimeStep) override;
+    void fetchResults() override;
     void emitEvents() override;
     void syncSceneToPhysics() override;
     void syncSceneWithCheck() override;
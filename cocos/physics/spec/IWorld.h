@@ -113,6 +113,11 @@ public:
     virtual void                                            setGravity(float x, float y, float z)      = 0;
     virtual void                                            setAllowSleep(bool v)                      = 0;
     virtual void                                            step(float s)                              = 0;
+    // Starts a step without waiting for it, the results are applied by fetchResults. Bodies, shapes and joints
+    // fetch the results before they change, so the scene never changes while it simulates.
+    virtual void                                            stepAsync(float s)                         = 0;
+    // Waits for the step started by stepAsync and syncs its results to the scene, does nothing without one.
+    virtual void                                            fetchResults()                             = 0;
     virtual void                                            emitEvents()                               = 0;
     virtual void                                            syncSceneToPhysics()                       = 0;
     virtual void                                            syncSceneWithCheck()                       = 0;
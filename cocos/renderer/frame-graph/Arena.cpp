@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "Arena.h"
+#include <algorithm>
+#include <cstdlib>
+#include "base/Macros.h"
+
+namespace cc {
+namespace framegraph {
+
+Arena::Arena(size_t const blockSize) noexcept
+: _blockSize(blockSize) {
+    addBlock(blockSize);
+}
+
+Arena::~Arena() {
+    for (Block &block : _blocks) {
+        free(block.data);
+    }
+}
+
+void *Arena::allocate(size_t const size, size_t const alignment) noexcept {
+    while (true) {
+        Block &      block   = _blocks[_current];
+        size_t const address = reinterpret_cast<uintptr_t>(block.data) + block.offset;
+        size_t const padding = (alignment - address % alignment) % alignment;
+
+        if (block.offset + padding + size <= block.size) {
+            block.offset += padding + size;
+            _usedSize += padding + size;
+            if (_current) {
+                ++_overflowAllocationCount;
+            }
+            return block.data + block.offset - size;
+        }
+
+        if (++_current == _blocks.size()) {
+            addBlock(std::max(_blockSize, size + alignment));
+        }
+    }
+}
+
+void Arena::recycle() noexcept {
+    // overflowed last frame, coalesce into one block large enough for the whole frame
+    if (_blocks.size() > 1) {
+        for (Block &block : _blocks) {
+            free(block.data);
+        }
+        _blocks.clear();
+        _blockSize = std::max(_blockSize, _capacity);
+        _capacity  = 0;
+        addBlock(_blockSize);
+    }
+
+    _blocks[0].offset = 0;
+    _current          = 0;
+    _usedSize         = 0;
+}
+
+void Arena::addBlock(size_t const size) noexcept {
+    Block block;
+    block.data = static_cast<uint8_t *>(malloc(size));
+    block.size = size;
+    CCASSERT(block.data, "Out of memory");
+
+    _blocks.push_back(block);
+    _capacity += size;
+    ++_blockAllocationCount;
+}
+
+} // namespace framegraph
+} // namespace cc
@@ -0,0 +1,126 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace cc {
+namespace framegraph {
+
+// Linear allocator for objects living no longer than one frame.
+// Memory is handed out by bumping an offset and reclaimed all at once by recycle(),
+// destructors of the created objects have to be invoked by the owner.
+class Arena final {
+public:
+    explicit Arena(size_t blockSize) noexcept;
+    Arena()              = delete;
+    ~Arena();
+    Arena(const Arena &) = delete;
+    Arena(Arena &&)      = delete;
+    Arena &operator=(const Arena &) = delete;
+    Arena &operator=(Arena &&) = delete;
+
+    void *allocate(size_t size, size_t alignment) noexcept;
+    void  recycle() noexcept;
+
+    template <typename T, typename... Args>
+    T *create(Args &&...args) noexcept;
+
+    inline size_t   getUsedSize() const noexcept { return _usedSize; }
+    inline size_t   getCapacity() const noexcept { return _capacity; }
+    inline uint32_t getBlockAllocationCount() const noexcept { return _blockAllocationCount; }
+    // allocations that did not fit the first block and went to a block taken from the heap mid-frame
+    inline uint32_t getOverflowAllocationCount() const noexcept { return _overflowAllocationCount; }
+
+private:
+    struct Block final {
+        uint8_t *data{nullptr};
+        size_t   size{0};
+        size_t   offset{0};
+    };
+
+    void addBlock(size_t size) noexcept;
+
+    std::vector<Block> _blocks{};
+    size_t             _current{0};
+    size_t             _blockSize{0};
+    size_t             _usedSize{0};
+    size_t             _capacity{0};
+    uint32_t           _blockAllocationCount{0};
+    uint32_t           _overflowAllocationCount{0};
+};
+
+// STL allocator drawing from an arena, falls back to the heap if no arena is bound
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    explicit ArenaAllocator(Arena *arena) noexcept : _arena(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept : _arena(other.getArena()) {} // NOLINT(google-explicit-constructor)
+
+    inline T *allocate(size_t count) {
+        return static_cast<T *>(_arena ? _arena->allocate(count * sizeof(T), alignof(T)) : ::operator new(count * sizeof(T)));
+    }
+
+    inline void deallocate(T *ptr, size_t /*count*/) noexcept {
+        if (!_arena) ::operator delete(ptr);
+    }
+
+    inline Arena *getArena() const noexcept { return _arena; }
+
+private:
+    Arena *_arena{nullptr};
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept {
+    return lhs.getArena() == rhs.getArena();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept {
+    return lhs.getArena() != rhs.getArena();
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename... Args>
+T *Arena::create(Args &&...args) noexcept {
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+}
+
+} // namespace framegraph
+} // namespace cc
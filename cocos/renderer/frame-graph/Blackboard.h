@@ -74,12 +74,16 @@ ValueType Blackboard<KeyType, ValueType, InvalidValue>::get(const KeyType &name)
 
 template <typename KeyType, typename ValueType, ValueType InvalidValue>
 void Blackboard<KeyType, ValueType, InvalidValue>::clear() noexcept {
-    _container.clear();
+    // keep the entries around, the same names are put again next frame
+    for (auto &pair : _container) {
+        pair.second = InvalidValue;
+    }
 }
 
 template <typename KeyType, typename ValueType, ValueType InvalidValue>
 bool Blackboard<KeyType, ValueType, InvalidValue>::has(const KeyType &name) const noexcept {
-    return _container.find(name) != _container.end();
+    const auto it = _container.find(name);
+    return it != _container.end() && it->second != InvalidValue;
 }
 
 } // namespace framegraph
@@ -65,6 +65,41 @@ DevicePass::DevicePass(const FrameGraph &graph, std::vector<PassNode *> const &s
     }
 }
 
+void DevicePass::rebind(const FrameGraph &graph, std::vector<PassNode *> const &subpassNodes) {
+    // the subpass layout and attachments are identical to the ones this pass was compiled with,
+    // only the executables and the (transient) device resources change between frames
+    auto subpassIt = _subpasses.begin();
+
+    for (const PassNode *passNode : subpassNodes) {
+        CC_ASSERT(subpassIt != _subpasses.end());
+        auto logicPassIt = subpassIt->logicPasses.begin();
+
+        do {
+            CC_ASSERT(logicPassIt != subpassIt->logicPasses.end());
+            logicPassIt->pass           = passNode->_pass;
+            logicPassIt->customViewport = passNode->_customViewport;
+            logicPassIt->viewport       = passNode->_viewport;
+            logicPassIt->scissor        = passNode->_scissor;
+
+            ++logicPassIt;
+            passNode = passNode->_next;
+        } while (passNode);
+
+        ++subpassIt;
+    }
+
+    for (auto &attachment : _attachments) {
+        const ResourceNode &resourceNode = graph.getResourceNode(attachment.attachment.textureHandle);
+        CC_ASSERT(resourceNode.virtualResource);
+
+        attachment.renderTarget = static_cast<ResourceEntry<Texture> *>(resourceNode.virtualResource)->getDeviceResource();
+        CC_ASSERT(attachment.renderTarget);
+    }
+
+    // same handles as when the table was extracted, refresh the device resources in place
+    _resourceTable.refresh(graph);
+}
+
 void DevicePass::execute() {
     auto *cmdBuff = gfx::Device::getInstance()->getCommandBuffer();
 
@@ -103,7 +138,7 @@ void DevicePass::append(const FrameGraph &graph, const PassNode *passNode, std::
     do {
         subpass.logicPasses.emplace_back();
         LogicPass &logicPass     = subpass.logicPasses.back();
-        logicPass.pass           = passNode->_pass.get();
+        logicPass.pass           = passNode->_pass;
         logicPass.customViewport = passNode->_customViewport;
         logicPass.viewport       = passNode->_viewport;
         logicPass.scissor        = passNode->_scissor;
@@ -129,7 +164,7 @@ void DevicePass::append(const FrameGraph &graph, const PassNode *passNode, std::
 }
 
 void DevicePass::append(const FrameGraph &graph, const RenderTargetAttachment &attachment,
-                        std::vector<RenderTargetAttachment> *attachments, gfx::SubpassInfo *subpass, const std::vector<Handle> &reads) {
+                        std::vector<RenderTargetAttachment> *attachments, gfx::SubpassInfo *subpass, const ArenaVector<Handle> &reads) {
     RenderTargetAttachment::Usage usage{attachment.desc.usage};
     uint32_t                      slot{attachment.desc.slot};
     if (attachment.desc.usage == RenderTargetAttachment::Usage::COLOR) {
@@ -45,6 +45,7 @@ public:
     DevicePass &operator=(DevicePass &&) = delete;
 
     void execute();
+    void rebind(const FrameGraph &graph, std::vector<PassNode *> const &subpassNodes);
 
 private:
     struct LogicPass final {
@@ -66,7 +67,7 @@ private:
 
     void append(const FrameGraph &graph, const PassNode *passNode, std::vector<RenderTargetAttachment> *attachments);
     void append(const FrameGraph &graph, const RenderTargetAttachment &attachment,
-                std::vector<RenderTargetAttachment> *attachments, gfx::SubpassInfo *subpass, const std::vector<Handle> &reads);
+                std::vector<RenderTargetAttachment> *attachments, gfx::SubpassInfo *subpass, const ArenaVector<Handle> &reads);
     void begin(gfx::CommandBuffer *cmdBuff);
     void next(gfx::CommandBuffer *cmdBuff) noexcept;
     void end(gfx::CommandBuffer *cmdBuff);
@@ -49,7 +49,7 @@ void DevicePassResourceTable::extract(const FrameGraph &                       g
 }
 
 void DevicePassResourceTable::extract(const FrameGraph &                       graph,
-                                      std::vector<Handle> const &              from,
+                                      ArenaVector<Handle> const &              from,
                                       ResourceDictionary &                     to,
                                       bool                                     ignoreRenderTarget,
                                       std::vector<const gfx::Texture *> const &renderTargets) noexcept {
@@ -84,5 +84,14 @@ void DevicePassResourceTable::extract(const FrameGraph &                       g
     });
 }
 
+void DevicePassResourceTable::refresh(const FrameGraph &graph) noexcept {
+    for (auto &pair : _reads) {
+        pair.second = graph.getResourceNode(pair.first).virtualResource->getDeviceResource();
+    }
+    for (auto &pair : _writes) {
+        pair.second = graph.getResourceNode(pair.first).virtualResource->getDeviceResource();
+    }
+}
+
 } // namespace framegraph
 } // namespace cc
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <unordered_map>
+#include "Arena.h"
 #include "Handle.h"
 #include "RenderTargetAttachment.h"
 #include "Resource.h"
@@ -62,7 +63,8 @@ private:
 
     static gfx::GFXObject *get(const ResourceDictionary &from, Handle handle) noexcept;
     void                   extract(const FrameGraph &graph, const PassNode *passNode, std::vector<const gfx::Texture *> const &renderTargets) noexcept;
-    static void            extract(const FrameGraph &graph, std::vector<Handle> const &from, ResourceDictionary &to, bool ignoreRenderTarget, std::vector<const gfx::Texture *> const &renderTargets) noexcept;
+    static void            extract(const FrameGraph &graph, ArenaVector<Handle> const &from, ResourceDictionary &to, bool ignoreRenderTarget, std::vector<const gfx::Texture *> const &renderTargets) noexcept;
+    void                   refresh(const FrameGraph &graph) noexcept;
 
     ResourceDictionary _reads{};
     ResourceDictionary _writes{};
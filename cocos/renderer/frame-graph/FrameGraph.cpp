@@ -26,6 +26,9 @@
 #include "FrameGraph.h"
 
 #include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <set>
 #include "PassNodeBuilder.h"
@@ -116,16 +119,50 @@ void FrameGraph::presentFromBlackboard(const StringHandle &inputName, gfx::Textu
 
 void FrameGraph::compile() {
     if (_passNodes.empty()) return;
+
+    const auto   start       = std::chrono::steady_clock::now();
+    const size_t fingerprint = _compileCache ? computeSignature() : 0;
+    const bool   cached      = _compileCache && matchesCompiledGraph(fingerprint);
+
     sort();
-    cull();
-    computeResourceLifetime();
 
-    if (_merge) {
-        mergePassNodes();
+    if (cached) {
+        restoreCompiledGraph();
+    } else {
+        cull();
+        computeResourceLifetime();
+
+        if (_merge) {
+            mergePassNodes();
+        }
+
+        computeStoreActionAndMemoryless();
+
+        if (_compileCache) {
+            // aliasing merges the usages of a slot into its owner, the cache keeps the declared descriptors
+            saveCompiledDescs();
+        }
     }
 
-    computeStoreActionAndMemoryless();
-    generateDevicePasses();
+    computeResourceAliasing();
+    generateDevicePasses(cached);
+
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (cached) {
+        ++_compileStats.cacheHits;
+        _compileStats.compileTimeSaved += std::max(_compileTime - elapsed, 0.0);
+    } else {
+        ++_compileStats.cacheMisses;
+        _compileTime = elapsed;
+
+        if (_compileCache) {
+            saveCompiledGraph();
+            _compiledSignature   = _signature;
+            _compiledFingerprint = fingerprint;
+            _compiled            = true;
+        }
+    }
 }
 
 void FrameGraph::execute() noexcept {
@@ -135,11 +172,27 @@ void FrameGraph::execute() noexcept {
     }
 }
 
+FrameGraph::~FrameGraph() {
+    reset();
+}
+
 void FrameGraph::reset() noexcept {
+    // nodes live in the frame arena, destroy them in place before recycling it
+    for (PassNode *const passNode : _passNodes) {
+        passNode->~PassNode();
+    }
+    for (VirtualResource *const resource : _virtualResources) {
+        resource->~VirtualResource();
+    }
+
     _passNodes.clear();
     _resourceNodes.clear();
     _virtualResources.clear();
-    _devicePasses.clear();
+    _arena.recycle();
+    // device passes are kept alive for the compiled graph cache, they get rebound on the next compile
+    if (!_compileCache) {
+        _devicePasses.clear();
+    }
     _blackboard.clear();
 }
 
@@ -205,7 +258,7 @@ Handle FrameGraph::create(VirtualResource *const virtualResource) {
 }
 
 PassNode &FrameGraph::createPassNode(const PassInsertPoint insertPoint, const StringHandle &name, Executable *const pass) {
-    _passNodes.emplace_back(new PassNode(insertPoint, name, static_cast<ID>(_passNodes.size()), pass));
+    _passNodes.emplace_back(_arena.create<PassNode>(_arena, insertPoint, name, static_cast<ID>(_passNodes.size()), pass));
     return *_passNodes.back();
 }
 
@@ -220,8 +273,9 @@ Handle FrameGraph::createResourceNode(VirtualResource *const virtualResource) {
 }
 
 void FrameGraph::sort() noexcept {
-    std::stable_sort(_passNodes.begin(), _passNodes.end(), [](const auto &x, const auto &y) {
-        return x->_insertPoint < y->_insertPoint;
+    // ids follow declaration order, so this is stable without the temporary buffer of std::stable_sort
+    std::sort(_passNodes.begin(), _passNodes.end(), [](const PassNode *x, const PassNode *y) {
+        return x->_insertPoint == y->_insertPoint ? x->_id < y->_id : x->_insertPoint < y->_insertPoint;
     });
 }
 
@@ -278,11 +332,11 @@ void FrameGraph::computeResourceLifetime() {
         }
 
         for (const Handle handle : passNode->_reads) {
-            _resourceNodes[handle].virtualResource->updateLifetime(passNode.get());
+            _resourceNodes[handle].virtualResource->updateLifetime(passNode);
         }
 
         for (const Handle handle : passNode->_writes) {
-            _resourceNodes[handle].virtualResource->updateLifetime(passNode.get());
+            _resourceNodes[handle].virtualResource->updateLifetime(passNode);
             ++_resourceNodes[handle].virtualResource->_writerCount;
         }
 
@@ -296,12 +350,12 @@ void FrameGraph::computeResourceLifetime() {
             continue;
         }
 
-        if (resource->_refCount == 0 && !resource->_lastUsePass->getRenderTargetAttachment(*this, resource.get())) {
+        if (resource->_refCount == 0 && !resource->_lastUsePass->getRenderTargetAttachment(*this, resource)) {
             continue;
         }
 
-        resource->_firstUsePass->_resourceRequestArray.push_back(resource.get());
-        resource->_lastUsePass->_resourceReleaseArray.push_back(resource.get());
+        resource->_firstUsePass->_resourceRequestArray.push_back(resource);
+        resource->_lastUsePass->_resourceReleaseArray.push_back(resource);
     }
 }
 
@@ -332,7 +386,7 @@ void FrameGraph::mergePassNodes() noexcept {
         const auto &lastPassNode = _passNodes[lastPassId];
 
         if (lastPassNode->canMerge(*this, *currentPassNode)) {
-            auto *prevPassNode = lastPassNode.get();
+            auto *prevPassNode = lastPassNode;
 
             uint16_t distance = 1;
 
@@ -341,8 +395,8 @@ void FrameGraph::mergePassNodes() noexcept {
                 ++distance;
             }
 
-            prevPassNode->_next              = currentPassNode.get();
-            currentPassNode->_head           = lastPassNode.get();
+            prevPassNode->_next              = currentPassNode;
+            currentPassNode->_head           = lastPassNode;
             currentPassNode->_distanceToHead = distance;
             currentPassNode->_refCount       = 0;
 
@@ -436,13 +490,117 @@ void FrameGraph::computeStoreActionAndMemoryless() {
     }
 }
 
-void FrameGraph::generateDevicePasses() {
+void FrameGraph::computeResourceAliasing() {
+    struct AliasSlot final {
+        VirtualResource *owner{nullptr};
+        ID               lastUse{0};
+        uint64_t         size{0};
+    };
+
+    static std::vector<VirtualResource *> transients;
+    static std::vector<AliasSlot>         slots;
+    static std::vector<uint32_t>          slotIndices;
+    transients.clear();
+
+    // every transient resource is requested exactly once, by the first pass using it
+    for (const auto &passNode : _passNodes) {
+        for (VirtualResource *const resource : passNode->_resourceRequestArray) {
+            if (!resource->isImported()) {
+                transients.push_back(resource);
+            }
+        }
+    }
+
+    std::sort(transients.begin(), transients.end(), [](const VirtualResource *x, const VirtualResource *y) {
+        ID const firstUseX = x->_firstUsePass->_devicePassId;
+        ID const firstUseY = y->_firstUsePass->_devicePassId;
+        return firstUseX == firstUseY ? x->_id < y->_id : firstUseX < firstUseY;
+    });
+
+    // greedy interval colouring over device pass ids: a resource can take over a slot whose
+    // last user has been released before it is requested, best fit by size to limit growth
+    const auto colour = [](bool const aliasing) {
+        slots.clear();
+        slotIndices.clear();
+        uint64_t total = 0;
+
+        for (VirtualResource *const resource : transients) {
+            ID const       firstUse = resource->_firstUsePass->_devicePassId;
+            ID const       lastUse  = resource->_lastUsePass->_devicePassId;
+            uint64_t const size     = resource->getMemorySize();
+
+            AliasSlot *best = nullptr;
+            for (AliasSlot &slot : slots) {
+                if (slot.lastUse >= firstUse) continue;
+
+                bool const compatible = aliasing
+                                            ? slot.owner->canAlias(*resource)
+                                            : slot.owner->getTypeTag() == resource->getTypeTag() && slot.owner->getDescHash() == resource->getDescHash();
+
+                if (compatible && (!best || std::max(slot.size, size) - std::min(slot.size, size) < std::max(best->size, size) - std::min(best->size, size))) {
+                    best = &slot;
+                }
+            }
+
+            if (best) {
+                total += std::max(best->size, size) - best->size;
+                best->size    = std::max(best->size, size);
+                best->lastUse = lastUse;
+                if (aliasing) {
+                    best->owner->alias(*resource);
+                }
+                slotIndices.push_back(static_cast<uint32_t>(best - slots.data()));
+            } else {
+                total += size;
+                slotIndices.push_back(static_cast<uint32_t>(slots.size()));
+                slots.push_back({resource, lastUse, size});
+            }
+        }
+
+        return total;
+    };
+
+    _transientMemoryStats.peakWithoutAliasing = colour(false);
+
+    if (!_aliasing) {
+        _transientMemoryStats.peakWithAliasing = _transientMemoryStats.peakWithoutAliasing;
+        return;
+    }
+
+    _transientMemoryStats.peakWithAliasing = colour(true);
+
+    // the slot owners now hold the merged descriptors, hand them to the other members
+    // so that the allocator serves the whole slot from the same device resource
+    for (size_t i = 0; i < transients.size(); ++i) {
+        const VirtualResource *owner = slots[slotIndices[i]].owner;
+        if (transients[i] != owner) {
+            transients[i]->alias(*owner);
+        }
+    }
+}
+
+void FrameGraph::generateDevicePasses(bool const rebind) {
     Buffer::Allocator::getInstance().tick();
     Framebuffer::Allocator::getInstance().tick();
     RenderPass::Allocator::getInstance().tick();
     Texture::Allocator::getInstance().tick();
 
-    ID passId = 1;
+    if (!rebind) {
+        _devicePasses.clear();
+    }
+
+    ID     passId          = 1;
+    size_t devicePassIndex = 0;
+    auto   emitDevicePass  = [&](std::vector<PassNode *> const &nodes) {
+        if (rebind) {
+            CC_ASSERT(devicePassIndex < _devicePasses.size());
+            _devicePasses[devicePassIndex]->rebind(*this, nodes);
+        } else {
+            _devicePasses.emplace_back(new DevicePass(*this, nodes));
+            ++_devicePassAllocationCount;
+        }
+        ++devicePassIndex;
+    };
 
     static std::vector<PassNode *> subpassNodes;
     subpassNodes.clear();
@@ -453,7 +611,7 @@ void FrameGraph::generateDevicePasses() {
         }
 
         if (passId != passNode->_devicePassId) {
-            _devicePasses.emplace_back(new DevicePass(*this, subpassNodes));
+            emitDevicePass(subpassNodes);
 
             for (PassNode *const p : subpassNodes) {
                 p->releaseTransientResources();
@@ -464,16 +622,254 @@ void FrameGraph::generateDevicePasses() {
         }
 
         passNode->requestTransientResources();
-        subpassNodes.emplace_back(passNode.get());
+        subpassNodes.emplace_back(passNode);
     }
 
     CC_ASSERT(subpassNodes.size() == 1);
 
-    _devicePasses.emplace_back(new DevicePass(*this, subpassNodes));
+    emitDevicePass(subpassNodes);
 
     for (PassNode *const p : subpassNodes) {
         p->releaseTransientResources();
     }
+
+    CC_ASSERT(devicePassIndex == _devicePasses.size());
+}
+
+size_t FrameGraph::computeSignature() {
+    // flattens everything declared during setup that the compile steps depend on,
+    // passes are still in declaration order at this point
+    auto &words = _signature;
+    words.clear();
+    const auto push = [&words](auto value) {
+        words.push_back(static_cast<uint64_t>(value));
+    };
+    const auto pushFloat = [&words](float value) {
+        uint32_t bits{0};
+        memcpy(&bits, &value, sizeof(bits));
+        words.push_back(bits);
+    };
+
+    push(_passNodes.size());
+    push(_merge);
+
+    for (const auto &passNode : _passNodes) {
+        push(passNode->_insertPoint);
+        push(static_cast<uint32_t>(passNode->_name));
+        push(passNode->_sideEffect);
+        push(passNode->_subpass);
+        push(passNode->_subpassEnd);
+        push(passNode->_clearActionIgnorable);
+        push(passNode->_customViewport);
+
+        if (passNode->_customViewport) {
+            const gfx::Viewport &viewport = passNode->_viewport;
+            const gfx::Rect &    scissor  = passNode->_scissor;
+            push(viewport.left);
+            push(viewport.top);
+            push(viewport.width);
+            push(viewport.height);
+            pushFloat(viewport.minDepth);
+            pushFloat(viewport.maxDepth);
+            push(scissor.x);
+            push(scissor.y);
+            push(scissor.width);
+            push(scissor.height);
+        }
+
+        push(passNode->_reads.size());
+        for (const Handle handle : passNode->_reads) {
+            push(static_cast<Handle::IndexType>(handle));
+        }
+
+        push(passNode->_writes.size());
+        for (const Handle handle : passNode->_writes) {
+            push(static_cast<Handle::IndexType>(handle));
+        }
+
+        push(passNode->_attachments.size());
+        for (const RenderTargetAttachment &attachment : passNode->_attachments) {
+            const RenderTargetAttachment::Descriptor &desc = attachment.desc;
+            push(static_cast<Handle::IndexType>(attachment.textureHandle));
+            push(desc.usage);
+            push(desc.slot);
+            push(desc.writeMask);
+            push(desc.loadOp);
+            pushFloat(desc.clearColor.x);
+            pushFloat(desc.clearColor.y);
+            pushFloat(desc.clearColor.z);
+            pushFloat(desc.clearColor.w);
+            pushFloat(desc.clearDepth);
+            push(desc.clearStencil);
+            push(desc.beginAccesses.size());
+            for (const auto access : desc.beginAccesses) {
+                push(access);
+            }
+            push(desc.endAccesses.size());
+            for (const auto access : desc.endAccesses) {
+                push(access);
+            }
+            push(attachment.level);
+            push(attachment.layer);
+            push(attachment.index);
+        }
+    }
+
+    push(_resourceNodes.size());
+    for (const ResourceNode &resourceNode : _resourceNodes) {
+        push(resourceNode.virtualResource->_id);
+        push(resourceNode.version);
+        push(resourceNode.writer ? resourceNode.writer->_id : INVALID_ID);
+    }
+
+    // descriptors are compared on their own in matchesCompiledGraph, their hashes only speed up rejection
+    push(_virtualResources.size());
+    for (const auto &resource : _virtualResources) {
+        push(static_cast<uint32_t>(resource->_name));
+        push(resource->isImported());
+        push(reinterpret_cast<uintptr_t>(resource->getTypeTag()));
+        push(resource->getDescHash());
+    }
+
+    return boost::hash_range(words.begin(), words.end());
+}
+
+bool FrameGraph::matchesCompiledGraph(size_t fingerprint) const {
+    // the fingerprint only rejects quickly, a hit is confirmed against the structural copy of the compiled graph
+    if (!_compiled || fingerprint != _compiledFingerprint || _signature != _compiledSignature) {
+        return false;
+    }
+
+    CC_ASSERT(_compiledDescs.size() == _virtualResources.size());
+    for (size_t i = 0; i < _virtualResources.size(); ++i) {
+        // type tags are part of the signature, the descriptor types match
+        if (!_virtualResources[i]->descEquals(_compiledDescs[i].get())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrameGraph::saveCompiledGraph() {
+    const auto indexOf = [this](const PassNode *passNode) {
+        if (!passNode) return INVALID_ID;
+        const auto it = std::find_if(_passNodes.begin(), _passNodes.end(), [passNode](const auto &p) {
+            return p == passNode;
+        });
+        CC_ASSERT(it != _passNodes.end());
+        return static_cast<ID>(it - _passNodes.begin());
+    };
+
+    _compiledPassNodes.resize(_passNodes.size());
+
+    for (size_t i = 0; i < _passNodes.size(); ++i) {
+        const PassNode &  passNode = *_passNodes[i];
+        CompiledPassNode &compiled = _compiledPassNodes[i];
+
+        compiled.attachments.clear();
+        for (const RenderTargetAttachment &attachment : passNode._attachments) {
+            compiled.attachments.push_back({attachment.desc.loadOp, attachment.storeOp});
+        }
+        compiled.resourceRequestArray.clear();
+        compiled.resourceReleaseArray.clear();
+        for (const VirtualResource *resource : passNode._resourceRequestArray) {
+            compiled.resourceRequestArray.push_back(resource->_id);
+        }
+        for (const VirtualResource *resource : passNode._resourceReleaseArray) {
+            compiled.resourceReleaseArray.push_back(resource->_id);
+        }
+        compiled.refCount       = passNode._refCount;
+        compiled.head           = indexOf(passNode._head);
+        compiled.next           = indexOf(passNode._next);
+        compiled.distanceToHead = passNode._distanceToHead;
+        compiled.devicePassId   = passNode._devicePassId;
+    }
+
+    _compiledVirtualResources.resize(_virtualResources.size());
+
+    for (size_t i = 0; i < _virtualResources.size(); ++i) {
+        const VirtualResource &  resource = *_virtualResources[i];
+        CompiledVirtualResource &compiled = _compiledVirtualResources[i];
+
+        compiled.refCount       = resource._refCount;
+        compiled.writerCount    = resource._writerCount;
+        compiled.firstUsePass   = indexOf(resource._firstUsePass);
+        compiled.lastUsePass    = indexOf(resource._lastUsePass);
+        compiled.neverLoaded    = resource._neverLoaded;
+        compiled.neverStored    = resource._neverStored;
+        compiled.memoryless     = resource._memoryless;
+        compiled.memorylessMSAA = resource._memorylessMSAA;
+    }
+
+    _compiledReaderCounts.resize(_resourceNodes.size());
+
+    for (size_t i = 0; i < _resourceNodes.size(); ++i) {
+        _compiledReaderCounts[i] = _resourceNodes[i].readerCount;
+    }
+}
+
+void FrameGraph::saveCompiledDescs() {
+    _compiledDescs.resize(_virtualResources.size());
+
+    for (size_t i = 0; i < _virtualResources.size(); ++i) {
+        _compiledDescs[i] = _virtualResources[i]->copyDesc();
+    }
+}
+
+void FrameGraph::restoreCompiledGraph() {
+    CC_ASSERT(_compiledPassNodes.size() == _passNodes.size());
+    CC_ASSERT(_compiledVirtualResources.size() == _virtualResources.size());
+    CC_ASSERT(_compiledReaderCounts.size() == _resourceNodes.size());
+
+    const auto passAt = [this](ID const index) {
+        return index == INVALID_ID ? nullptr : _passNodes[index];
+    };
+
+    for (size_t i = 0; i < _passNodes.size(); ++i) {
+        PassNode &              passNode = *_passNodes[i];
+        const CompiledPassNode &compiled = _compiledPassNodes[i];
+
+        // attachment order is fully determined by usage and slot, only the resolved actions differ
+        CC_ASSERT(compiled.attachments.size() == passNode._attachments.size());
+        std::sort(passNode._attachments.begin(), passNode._attachments.end(), RenderTargetAttachment::Sorter());
+        for (size_t j = 0; j < compiled.attachments.size(); ++j) {
+            passNode._attachments[j].desc.loadOp = compiled.attachments[j].loadOp;
+            passNode._attachments[j].storeOp     = compiled.attachments[j].storeOp;
+        }
+        passNode._resourceRequestArray.reserve(compiled.resourceRequestArray.size());
+        passNode._resourceReleaseArray.reserve(compiled.resourceReleaseArray.size());
+        passNode._resourceRequestArray.clear();
+        passNode._resourceReleaseArray.clear();
+        for (ID const id : compiled.resourceRequestArray) {
+            passNode._resourceRequestArray.push_back(_virtualResources[id]);
+        }
+        for (ID const id : compiled.resourceReleaseArray) {
+            passNode._resourceReleaseArray.push_back(_virtualResources[id]);
+        }
+        passNode._refCount       = compiled.refCount;
+        passNode._head           = passAt(compiled.head);
+        passNode._next           = passAt(compiled.next);
+        passNode._distanceToHead = compiled.distanceToHead;
+        passNode._devicePassId   = compiled.devicePassId;
+    }
+
+    for (size_t i = 0; i < _virtualResources.size(); ++i) {
+        VirtualResource &              resource = *_virtualResources[i];
+        const CompiledVirtualResource &compiled = _compiledVirtualResources[i];
+
+        resource._refCount       = compiled.refCount;
+        resource._writerCount    = compiled.writerCount;
+        resource._firstUsePass   = passAt(compiled.firstUsePass);
+        resource._lastUsePass    = passAt(compiled.lastUsePass);
+        resource._neverLoaded    = compiled.neverLoaded;
+        resource._neverStored    = compiled.neverStored;
+        resource._memoryless     = compiled.memoryless;
+        resource._memorylessMSAA = compiled.memorylessMSAA;
+    }
+
+    for (size_t i = 0; i < _resourceNodes.size(); ++i) {
+        _resourceNodes[i].readerCount = _compiledReaderCounts[i];
+    }
 }
 
 // https://dreampuf.github.io/GraphvizOnline/
@@ -497,7 +893,7 @@ void FrameGraph::exportGraphViz(const std::string &path) {
 
         out << "\"P" << node->_id << "\" [label=\"" << node->_name.str();
 
-        const PassNode *currPassNode = node.get();
+        const PassNode *currPassNode = node;
 
         if (currPassNode->_head) {
             out << "\\n(merged by pass " << currPassNode->_head->_name.str() << ")";
@@ -26,8 +26,10 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
+#include "Arena.h"
 #include "Blackboard.h"
 #include "CallbackPass.h"
 #include "DevicePass.h"
@@ -43,8 +45,20 @@ class FrameGraph final {
 public:
     using ResourceHandleBlackboard = Blackboard<StringHandle, Handle::IndexType, Handle::UNINITIALIZED>;
 
+    struct CompileStats final {
+        uint32_t cacheHits{0};
+        uint32_t cacheMisses{0};
+        double   compileTimeSaved{0.0}; // in milliseconds
+    };
+
+    // estimated peak memory of the transient resources of the last compiled graph, in bytes
+    struct TransientMemoryStats final {
+        uint64_t peakWithoutAliasing{0};
+        uint64_t peakWithAliasing{0};
+    };
+
     FrameGraph()                       = default;
-    ~FrameGraph()                      = default;
+    ~FrameGraph();
     FrameGraph(const FrameGraph &)     = delete;
     FrameGraph(FrameGraph &&) noexcept = delete;
     FrameGraph &operator=(const FrameGraph &) = delete;
@@ -74,11 +88,51 @@ public:
     inline const ResourceNode &      getResourceNode(const Handle handle) const noexcept { return _resourceNodes[handle]; }
     inline ResourceHandleBlackboard &getBlackboard() noexcept { return _blackboard; }
 
-    void        exportGraphViz(const std::string &path);
-    inline void enableMerge(bool enable) noexcept;
-    bool        hasPass(StringHandle handle);
+    void                               exportGraphViz(const std::string &path);
+    inline void                        enableMerge(bool enable) noexcept;
+    inline void                        enableCompileCache(bool enable) noexcept;
+    inline void                        enableAliasing(bool enable) noexcept;
+    inline const CompileStats &        getCompileStats() const noexcept { return _compileStats; }
+    inline const TransientMemoryStats &getTransientMemoryStats() const noexcept { return _transientMemoryStats; }
+    // node storage blocks and device passes created so far, other heap allocations (pass callbacks,
+    // attachment access lists, allocator pools) are not tracked here
+    inline uint32_t                    getArenaBlockAllocationCount() const noexcept { return _arena.getBlockAllocationCount(); }
+    inline uint32_t                    getArenaOverflowAllocationCount() const noexcept { return _arena.getOverflowAllocationCount(); }
+    inline uint32_t                    getDevicePassAllocationCount() const noexcept { return _devicePassAllocationCount; }
+    bool                               hasPass(StringHandle handle);
 
 private:
+    static constexpr ID INVALID_ID{0xffff};
+
+    static constexpr size_t ARENA_BLOCK_SIZE{64 * 1024};
+
+    struct CompiledAttachment final {
+        gfx::LoadOp  loadOp{gfx::LoadOp::DISCARD};
+        gfx::StoreOp storeOp{gfx::StoreOp::DISCARD};
+    };
+
+    struct CompiledPassNode final {
+        std::vector<CompiledAttachment> attachments{};
+        std::vector<ID>                 resourceRequestArray{};
+        std::vector<ID>                 resourceReleaseArray{};
+        uint32_t                        refCount{0};
+        ID                              head{INVALID_ID};
+        ID                              next{INVALID_ID};
+        uint16_t                        distanceToHead{0};
+        ID                              devicePassId{0};
+    };
+
+    struct CompiledVirtualResource final {
+        uint32_t refCount{0};
+        uint16_t writerCount{0};
+        ID       firstUsePass{INVALID_ID};
+        ID       lastUsePass{INVALID_ID};
+        bool     neverLoaded{true};
+        bool     neverStored{true};
+        bool     memoryless{false};
+        bool     memorylessMSAA{false};
+    };
+
     Handle        create(VirtualResource *virtualResource);
     PassNode &    createPassNode(PassInsertPoint insertPoint, const StringHandle &name, Executable *pass);
     Handle        createResourceNode(VirtualResource *virtualResource);
@@ -87,15 +141,39 @@ private:
     void          computeResourceLifetime();
     void          mergePassNodes() noexcept;
     void          computeStoreActionAndMemoryless();
-    void          generateDevicePasses();
+    void          computeResourceAliasing();
+    void          generateDevicePasses(bool rebind);
+    size_t        computeSignature();
+    bool          matchesCompiledGraph(size_t fingerprint) const;
+    void          saveCompiledGraph();
+    void          saveCompiledDescs();
+    void          restoreCompiledGraph();
     ResourceNode *getResourceNode(const VirtualResource *virtualResource, uint8_t version) noexcept;
 
-    std::vector<std::unique_ptr<PassNode>>        _passNodes{};
+    // per-frame nodes are placed in the arena, recycled on reset
+    Arena                                         _arena{ARENA_BLOCK_SIZE};
+    std::vector<PassNode *>                       _passNodes{};
     std::vector<ResourceNode>                     _resourceNodes{};
-    std::vector<std::unique_ptr<VirtualResource>> _virtualResources{};
+    std::vector<VirtualResource *>                _virtualResources{};
     std::vector<std::unique_ptr<DevicePass>>      _devicePasses{};
+    uint32_t                                      _devicePassAllocationCount{0};
     ResourceHandleBlackboard                      _blackboard;
     bool                                          _merge{true};
+    bool                                          _aliasing{false};
+    TransientMemoryStats                          _transientMemoryStats;
+
+    // compiled graph cache, reused as long as the declared passes and resources don't change
+    std::vector<CompiledPassNode>        _compiledPassNodes{};
+    std::vector<CompiledVirtualResource> _compiledVirtualResources{};
+    std::vector<uint32_t>                _compiledReaderCounts{};
+    std::vector<std::shared_ptr<void>>   _compiledDescs{};
+    std::vector<uint64_t>                _compiledSignature{};
+    std::vector<uint64_t>                _signature{};
+    size_t                               _compiledFingerprint{0};
+    double                               _compileTime{0.0};
+    CompileStats                         _compileStats;
+    bool                                 _compiled{false};
+    bool                                 _compileCache{true};
 
     friend class PassNode;
     friend class PassNodeBuilder;
@@ -106,7 +184,7 @@ private:
 template <typename Data, typename SetupMethod, typename ExecuteMethod>
 const CallbackPass<Data, ExecuteMethod> &FrameGraph::addPass(const PassInsertPoint insertPoint, const StringHandle &name, SetupMethod setup, ExecuteMethod &&execute) noexcept {
     static_assert(sizeof(ExecuteMethod) < 1024, "Execute() lambda is capturing too much data.");
-    auto *const     pass     = new CallbackPass<Data, ExecuteMethod>(std::forward<ExecuteMethod>(execute));
+    auto *const     pass     = _arena.create<CallbackPass<Data, ExecuteMethod>>(std::forward<ExecuteMethod>(execute));
     PassNode &      passNode = createPassNode(insertPoint, name, pass);
     PassNodeBuilder builder(*this, passNode);
     setup(builder, pass->getData());
@@ -115,14 +193,14 @@ const CallbackPass<Data, ExecuteMethod> &FrameGraph::addPass(const PassInsertPoi
 
 template <typename DescriptorType, typename ResourceType>
 TypedHandle<ResourceType> FrameGraph::create(const StringHandle &name, const DescriptorType &desc) noexcept {
-    auto *const virtualResource = new ResourceEntry<ResourceType>(name, static_cast<ID>(_virtualResources.size()), desc);
+    auto *const virtualResource = _arena.create<ResourceEntry<ResourceType>>(name, static_cast<ID>(_virtualResources.size()), desc);
     return TypedHandle<ResourceType>(create(virtualResource));
 }
 
 template <typename ResourceType>
 TypedHandle<ResourceType> FrameGraph::importExternal(const StringHandle &name, ResourceType &resource) noexcept {
     CC_ASSERT(resource.get());
-    auto *const virtualResource = new ResourceEntry<ResourceType>(name, static_cast<ID>(_virtualResources.size()), resource);
+    auto *const virtualResource = _arena.create<ResourceEntry<ResourceType>>(name, static_cast<ID>(_virtualResources.size()), resource);
     return TypedHandle<ResourceType>(create(virtualResource));
 }
 
@@ -130,6 +208,15 @@ void FrameGraph::enableMerge(bool const enable) noexcept {
     _merge = enable;
 }
 
+void FrameGraph::enableAliasing(bool const enable) noexcept {
+    _aliasing = enable;
+}
+
+void FrameGraph::enableCompileCache(bool const enable) noexcept {
+    _compileCache = enable;
+    _compiled     = false;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 template <typename DescriptorType, typename ResourceType>
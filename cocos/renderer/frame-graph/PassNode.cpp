@@ -31,14 +31,23 @@
 namespace cc {
 namespace framegraph {
 
-PassNode::PassNode(const PassInsertPoint inserPoint, const StringHandle name, const ID &id, Executable *pass)
+PassNode::PassNode(Arena &arena, const PassInsertPoint inserPoint, const StringHandle name, const ID &id, Executable *pass)
 : _pass(pass),
+  _reads(ArenaAllocator<Handle>(&arena)),
+  _writes(ArenaAllocator<Handle>(&arena)),
+  _attachments(ArenaAllocator<RenderTargetAttachment>(&arena)),
+  _resourceRequestArray(ArenaAllocator<VirtualResource *>(&arena)),
+  _resourceReleaseArray(ArenaAllocator<VirtualResource *>(&arena)),
   _name(name),
   _id(id),
   _insertPoint(inserPoint) {
     CC_ASSERT(_name.isValid());
 }
 
+PassNode::~PassNode() {
+    _pass->~Executable();
+}
+
 Handle PassNode::read(FrameGraph & /*graph*/, const Handle &input) {
     const auto it = std::find_if(_reads.begin(), _reads.end(), [input](const Handle handle) {
         return input == handle;
@@ -92,8 +101,8 @@ void PassNode::createRenderTargetAttachment(RenderTargetAttachment &&attachment)
     CC_ASSERT((_usedRenderTargetSlotMask & (1 << attachment.desc.slot)) == 0);
     _usedRenderTargetSlotMask |= (1 << attachment.desc.slot);
 
-    _attachments.emplace_back(attachment);
     _hasClearedAttachment = _hasClearedAttachment || (attachment.desc.loadOp == gfx::LoadOp::CLEAR);
+    _attachments.emplace_back(std::move(attachment));
 }
 
 bool PassNode::canMerge(const FrameGraph &graph, const PassNode &passNode) const {
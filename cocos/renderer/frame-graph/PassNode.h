@@ -25,7 +25,7 @@
 
 #pragma once
 
-#include <memory>
+#include "Arena.h"
 #include "CallbackPass.h"
 #include "Handle.h"
 #include "PassInsertPointManager.h"
@@ -40,9 +40,9 @@ class FrameGraph;
 
 class PassNode final {
 public:
-    PassNode(PassInsertPoint inserPoint, StringHandle name, const ID &id, Executable *pass);
-    ~PassNode()                    = default;
-    PassNode(PassNode &&) noexcept = default;
+    PassNode(Arena &arena, PassInsertPoint inserPoint, StringHandle name, const ID &id, Executable *pass);
+    ~PassNode();
+    PassNode(PassNode &&) noexcept = delete;
     PassNode(const PassNode &)     = delete;
     PassNode &operator=(const PassNode &) = delete;
     PassNode &operator=(PassNode &&) noexcept = delete;
@@ -63,12 +63,13 @@ private:
     void                    setDevicePassId(ID id);
     Handle                  getWriteResourceNodeHandle(const FrameGraph &graph, const VirtualResource *resource) const;
 
-    std::unique_ptr<Executable>         _pass{nullptr};
-    std::vector<Handle>                 _reads{};
-    std::vector<Handle>                 _writes{};
-    std::vector<RenderTargetAttachment> _attachments{};
-    std::vector<VirtualResource *>      _resourceRequestArray{};
-    std::vector<VirtualResource *>      _resourceReleaseArray{};
+    // the executable and all containers live in the frame arena
+    Executable *                        _pass{nullptr};
+    ArenaVector<Handle>                 _reads;
+    ArenaVector<Handle>                 _writes;
+    ArenaVector<RenderTargetAttachment> _attachments;
+    ArenaVector<VirtualResource *>      _resourceRequestArray;
+    ArenaVector<VirtualResource *>      _resourceReleaseArray;
     const StringHandle                  _name;
     uint32_t                            _refCount{0};
     PassNode *                          _head{nullptr};
@@ -151,5 +151,59 @@ DEFINE_GFX_RESOURCE(Framebuffer)
 DEFINE_GFX_RESOURCE(RenderPass)
 DEFINE_GFX_RESOURCE(Texture)
 
+//////////////////////////////////////////////////////////////////////////
+
+// Transient resources with disjoint lifetimes and compatible descriptors
+// can be served by the same device resource, created from the merged descriptor.
+template <typename DescriptorType>
+struct ResourceAliasing final {
+    static inline uint64_t memorySize(const DescriptorType & /*desc*/) { return 0; }
+    static inline bool     compatible(const DescriptorType & /*lhs*/, const DescriptorType & /*rhs*/) { return false; }
+    static inline void     merge(DescriptorType & /*dst*/, const DescriptorType & /*src*/) {}
+};
+
+template <>
+struct ResourceAliasing<gfx::TextureInfo> final {
+    // multisampled storage is not accounted for
+    static inline uint64_t memorySize(const gfx::TextureInfo &desc) {
+        uint64_t size = 0;
+        for (uint32_t level = 0; level < desc.levelCount; ++level) {
+            size += gfx::formatSize(desc.format, std::max(desc.width >> level, 1U), std::max(desc.height >> level, 1U), std::max(desc.depth >> level, 1U));
+        }
+        return size * desc.layerCount;
+    }
+
+    // usages may differ, as long as both textures are either attachment only (lazily allocated) or not
+    static inline bool compatible(const gfx::TextureInfo &lhs, const gfx::TextureInfo &rhs) {
+        return lhs.type == rhs.type && lhs.format == rhs.format && lhs.width == rhs.width && lhs.height == rhs.height &&
+               lhs.depth == rhs.depth && lhs.layerCount == rhs.layerCount && lhs.levelCount == rhs.levelCount &&
+               lhs.samples == rhs.samples && lhs.flags == rhs.flags && !lhs.externalRes && !rhs.externalRes &&
+               isAttachmentOnly(lhs.usage) == isAttachmentOnly(rhs.usage);
+    }
+
+    static inline void merge(gfx::TextureInfo &dst, const gfx::TextureInfo &src) {
+        dst.usage |= src.usage;
+    }
+
+private:
+    static inline bool isAttachmentOnly(gfx::TextureUsage usage) {
+        return (usage & ~gfx::TEXTURE_USAGE_TRANSIENT) == gfx::TextureUsageBit::NONE;
+    }
+};
+
+template <>
+struct ResourceAliasing<gfx::BufferInfo> final {
+    static inline uint64_t memorySize(const gfx::BufferInfo &desc) { return desc.size; }
+
+    // sizes may differ, the shared buffer is created with the largest one
+    static inline bool compatible(const gfx::BufferInfo &lhs, const gfx::BufferInfo &rhs) {
+        return lhs.usage == rhs.usage && lhs.memUsage == rhs.memUsage && lhs.stride == rhs.stride && lhs.flags == rhs.flags;
+    }
+
+    static inline void merge(gfx::BufferInfo &dst, const gfx::BufferInfo &src) {
+        dst.size = std::max(dst.size, src.size);
+    }
+};
+
 } // namespace framegraph
 } // namespace cc
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "Resource.h"
 #include "VirtualResource.h"
 
 namespace cc {
@@ -45,6 +46,13 @@ public:
     void                                   request() noexcept override;
     void                                   release() noexcept override;
     typename ResourceType::DeviceResource *getDeviceResource() const noexcept override;
+    size_t                                 getDescHash() const noexcept override;
+    const void *                           getTypeTag() const noexcept override;
+    uint64_t                               getMemorySize() const noexcept override;
+    bool                                   canAlias(const VirtualResource &other) const noexcept override;
+    std::shared_ptr<void>                  copyDesc() const override;
+    bool                                   descEquals(const void *desc) const noexcept override;
+    void                                   alias(const VirtualResource &other) noexcept override;
 
     inline const ResourceType &get() const noexcept { return _resource; }
 
@@ -81,5 +89,50 @@ typename ResourceType::DeviceResource *ResourceEntry<ResourceType, Enable>::getD
     return _resource.get();
 }
 
+template <typename ResourceType, typename Enable>
+size_t ResourceEntry<ResourceType, Enable>::getDescHash() const noexcept {
+    return gfx::Hasher<typename ResourceType::Descriptor>()(_resource.getDesc());
+}
+
+template <typename ResourceType, typename Enable>
+const void *ResourceEntry<ResourceType, Enable>::getTypeTag() const noexcept {
+    static const char tag{0};
+    return &tag;
+}
+
+template <typename ResourceType, typename Enable>
+uint64_t ResourceEntry<ResourceType, Enable>::getMemorySize() const noexcept {
+    return ResourceAliasing<typename ResourceType::Descriptor>::memorySize(_resource.getDesc());
+}
+
+template <typename ResourceType, typename Enable>
+bool ResourceEntry<ResourceType, Enable>::canAlias(const VirtualResource &other) const noexcept {
+    if (isImported() || other.isImported() || getTypeTag() != other.getTypeTag()) {
+        return false;
+    }
+
+    const auto &otherDesc = static_cast<const ResourceEntry &>(other)._resource.getDesc();
+    return ResourceAliasing<typename ResourceType::Descriptor>::compatible(_resource.getDesc(), otherDesc);
+}
+
+template <typename ResourceType, typename Enable>
+std::shared_ptr<void> ResourceEntry<ResourceType, Enable>::copyDesc() const {
+    return std::make_shared<typename ResourceType::Descriptor>(_resource.getDesc());
+}
+
+template <typename ResourceType, typename Enable>
+bool ResourceEntry<ResourceType, Enable>::descEquals(const void *desc) const noexcept {
+    return _resource.getDesc() == *static_cast<const typename ResourceType::Descriptor *>(desc);
+}
+
+template <typename ResourceType, typename Enable>
+void ResourceEntry<ResourceType, Enable>::alias(const VirtualResource &other) noexcept {
+    CC_ASSERT(canAlias(other) && !_resource.get());
+
+    typename ResourceType::Descriptor desc = _resource.getDesc();
+    ResourceAliasing<typename ResourceType::Descriptor>::merge(desc, static_cast<const ResourceEntry &>(other)._resource.getDesc());
+    _resource = ResourceType(desc);
+}
+
 } // namespace framegraph
 } // namespace cc
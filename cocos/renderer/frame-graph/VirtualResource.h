@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <memory>
 #include "Handle.h"
 #include "renderer/gfx-base/GFXObject.h"
 
@@ -51,7 +52,16 @@ public:
     void         updateLifetime(PassNode *passNode) noexcept;
     void         newVersion() noexcept { ++_version; }
 
-    virtual gfx::GFXObject *getDeviceResource() const noexcept = 0;
+    virtual gfx::GFXObject *getDeviceResource() const noexcept                     = 0;
+    virtual size_t          getDescHash() const noexcept                           = 0;
+    virtual const void *    getTypeTag() const noexcept                            = 0;
+    virtual uint64_t        getMemorySize() const noexcept                         = 0;
+    virtual bool            canAlias(const VirtualResource &other) const noexcept = 0;
+    virtual void            alias(const VirtualResource &other) noexcept          = 0;
+
+    // type erased descriptor copy, kept by the compiled graph cache to compare descriptors instead of their hashes
+    virtual std::shared_ptr<void> copyDesc() const                            = 0;
+    virtual bool                  descEquals(const void *desc) const noexcept = 0;
 
 private:
     PassNode *         _firstUsePass{nullptr};
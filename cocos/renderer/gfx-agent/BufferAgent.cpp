@@ -51,7 +51,7 @@ BufferAgent::~BufferAgent() {
 void BufferAgent::doInit(const BufferInfo &info) {
     uint32_t size = getSize();
     if (size > STAGING_BUFFER_THRESHOLD && hasFlag(_memUsage, MemoryUsageBit::HOST)) {
-        for (size_t i = 0; i < DeviceAgent::MAX_FRAME_INDEX; ++i) {
+        for (uint32_t i = 0; i < DeviceAgent::getInstance()->getFrameIndexCount(); ++i) {
             _stagingBuffers.push_back(reinterpret_cast<uint8_t *>(malloc(size)));
         }
     }
@@ -86,23 +86,25 @@ void BufferAgent::doResize(uint32_t size, uint32_t /*count*/) {
     auto *mq = DeviceAgent::getInstance()->getMessageQueue();
 
     if (!_stagingBuffers.empty()) {
-        auto *oldStagingBuffers = mq->allocate<uint8_t *>(DeviceAgent::MAX_FRAME_INDEX);
-        for (size_t i = 0; i < DeviceAgent::MAX_FRAME_INDEX; ++i) {
+        auto  stagingBufferCount = static_cast<uint32_t>(_stagingBuffers.size());
+        auto *oldStagingBuffers  = mq->allocate<uint8_t *>(stagingBufferCount);
+        for (uint32_t i = 0; i < stagingBufferCount; ++i) {
             oldStagingBuffers[i] = _stagingBuffers[i];
         }
         _stagingBuffers.clear();
-        ENQUEUE_MESSAGE_1(
+        ENQUEUE_MESSAGE_2(
             mq, BufferFreeStagingBuffer,
             stagingBuffers, oldStagingBuffers,
+            count, stagingBufferCount,
             {
-                for (size_t i = 0; i < DeviceAgent::MAX_FRAME_INDEX; ++i) {
+                for (uint32_t i = 0; i < count; ++i) {
                     free(stagingBuffers[i]);
                 }
             });
     }
 
     if (size > STAGING_BUFFER_THRESHOLD && hasFlag(_memUsage, MemoryUsageBit::HOST)) {
-        for (size_t i = 0; i < DeviceAgent::MAX_FRAME_INDEX; ++i) {
+        for (uint32_t i = 0; i < DeviceAgent::getInstance()->getFrameIndexCount(); ++i) {
             _stagingBuffers.push_back(reinterpret_cast<uint8_t *>(malloc(size)));
         }
     }
@@ -119,24 +121,24 @@ void BufferAgent::doResize(uint32_t size, uint32_t /*count*/) {
 void BufferAgent::doDestroy() {
     auto *    mq = DeviceAgent::getInstance()->getMessageQueue();
     uint8_t **oldStagingBuffers{nullptr};
-    if (!_stagingBuffers.empty()) {
-        oldStagingBuffers = mq->allocate<uint8_t *>(DeviceAgent::MAX_FRAME_INDEX);
-        for (size_t i = 0; i < DeviceAgent::MAX_FRAME_INDEX; ++i) {
+    auto      stagingBufferCount = static_cast<uint32_t>(_stagingBuffers.size());
+    if (stagingBufferCount) {
+        oldStagingBuffers = mq->allocate<uint8_t *>(stagingBufferCount);
+        for (uint32_t i = 0; i < stagingBufferCount; ++i) {
             oldStagingBuffers[i] = _stagingBuffers[i];
         }
         _stagingBuffers.clear();
     }
 
-    ENQUEUE_MESSAGE_2(
+    ENQUEUE_MESSAGE_3(
         mq, BufferDestroy,
         actor, getActor(),
         stagingBuffers, oldStagingBuffers,
+        count, stagingBufferCount,
         {
             actor->destroy();
-            if (stagingBuffers) {
-                for (size_t i = 0; i < DeviceAgent::MAX_FRAME_INDEX; ++i) {
-                    free(stagingBuffers[i]);
-                }
+            for (uint32_t i = 0; i < count; ++i) {
+                free(stagingBuffers[i]);
             }
         });
 }
@@ -161,10 +163,53 @@ void BufferAgent::update(const void *buffer, uint32_t size) {
         });
 }
 
-void BufferAgent::getActorBuffer(const BufferAgent *buffer, MessageQueue *mq, uint32_t size, uint8_t **pActorBuffer, bool *pNeedFreeing) {
-    if (!buffer->_stagingBuffers.empty()) { // for frequent updates on big buffers
-        uint32_t frameIndex = DeviceAgent::getInstance()->getCurrentIndex();
-        *pActorBuffer       = buffer->_stagingBuffers[frameIndex];
+uint8_t *BufferAgent::beginUpdate(uint32_t size) {
+    CC_ASSERT(!_mappedData && size <= _size);
+
+    _mappedData        = acquireStagingBuffer();
+    _mappedNeedFreeing = false;
+    if (!_mappedData) {
+        // unlike message queue memory this stays valid while other messages are enqueued
+        _mappedData = DeviceAgent::getInstance()->allocateUploadMemory(size, &_mappedNeedFreeing);
+    }
+    _mappedSize = size;
+
+    return _mappedData;
+}
+
+void BufferAgent::endUpdate() {
+    CC_ASSERT(_mappedData);
+
+    ENQUEUE_MESSAGE_4(
+        DeviceAgent::getInstance()->getMessageQueue(), BufferUpdate,
+        actor, getActor(),
+        buffer, _mappedData,
+        size, _mappedSize,
+        needFreeing, _mappedNeedFreeing,
+        {
+            actor->update(buffer, size);
+            if (needFreeing) free(buffer);
+        });
+
+    _mappedData        = nullptr;
+    _mappedSize        = 0U;
+    _mappedNeedFreeing = false;
+}
+
+uint8_t *BufferAgent::acquireStagingBuffer() {
+    // the device thread reads the staging buffer of a frame later on,
+    // so it can only take the first update of each frame
+    const auto *device = DeviceAgent::getInstance();
+    if (_stagingBuffers.empty() || _stagingBufferFrame == device->getCurrentFrame()) {
+        return nullptr;
+    }
+    _stagingBufferFrame = device->getCurrentFrame();
+    return _stagingBuffers[device->getCurrentIndex()];
+}
+
+void BufferAgent::getActorBuffer(BufferAgent *buffer, MessageQueue *mq, uint32_t size, uint8_t **pActorBuffer, bool *pNeedFreeing) {
+    if (uint8_t *stagingBuffer = buffer->acquireStagingBuffer()) { // for frequent updates on big buffers
+        *pActorBuffer = stagingBuffer;
     } else if (size > STAGING_BUFFER_THRESHOLD) { // less frequent updates on big buffers
         *pActorBuffer = reinterpret_cast<uint8_t *>(malloc(size));
         *pNeedFreeing = true;
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <limits>
 #include "base/Agent.h"
 #include "base/threading/MessageQueue.h"
 #include "gfx-base/GFXBuffer.h"
@@ -40,9 +41,11 @@ public:
     explicit BufferAgent(Buffer *actor);
     ~BufferAgent() override;
 
-    void update(const void *buffer, uint32_t size) override;
+    void     update(const void *buffer, uint32_t size) override;
+    uint8_t *beginUpdate(uint32_t size) override;
+    void     endUpdate() override;
 
-    static void getActorBuffer(const BufferAgent *buffer, MessageQueue *mq, uint32_t size, uint8_t **pActorBuffer, bool *pNeedFreeing);
+    static void getActorBuffer(BufferAgent *buffer, MessageQueue *mq, uint32_t size, uint8_t **pActorBuffer, bool *pNeedFreeing);
 
 private:
     void doInit(const BufferInfo &info) override;
@@ -50,9 +53,13 @@ private:
     void doResize(uint32_t size, uint32_t count) override;
     void doDestroy() override;
 
+    uint8_t *acquireStagingBuffer();
+
     static constexpr uint32_t STAGING_BUFFER_THRESHOLD = MessageQueue::MEMORY_CHUNK_SIZE / 2;
 
     vector<uint8_t *> _stagingBuffers;
+    uint32_t          _stagingBufferFrame{std::numeric_limits<uint32_t>::max()};
+    bool              _mappedNeedFreeing{false};
 };
 
 } // namespace gfx
@@ -201,17 +201,33 @@ void CommandBufferAgent::endRenderPass() {
 void CommandBufferAgent::execute(CommandBuffer *const *cmdBuffs, uint32_t count) {
     if (!count) return;
 
-    auto **actorCmdBuffs = _messageQueue->allocate<CommandBuffer *>(count);
+    // secondary command buffers may have been recorded on other threads, each by a single producer,
+    // their messages are consumed right before the primary executes them, in the order given
+    bool   flushSecondaries = DeviceAgent::getInstance()->_multithreaded;
+    auto **actorCmdBuffs    = _messageQueue->allocate<CommandBuffer *>(count);
+    auto **agentCmdBuffs    = flushSecondaries ? _messageQueue->allocate<CommandBufferAgent *>(count) : nullptr;
     for (uint32_t i = 0; i < count; ++i) {
-        actorCmdBuffs[i] = static_cast<CommandBufferAgent *>(cmdBuffs[i])->getActor();
+        auto *cmdBuff    = static_cast<CommandBufferAgent *>(cmdBuffs[i]);
+        actorCmdBuffs[i] = cmdBuff->getActor();
+        if (flushSecondaries) {
+            agentCmdBuffs[i] = cmdBuff;
+            MessageQueue::freeChunksInFreeQueue(cmdBuff->_messageQueue);
+            cmdBuff->_messageQueue->finishWriting();
+        }
     }
 
-    ENQUEUE_MESSAGE_3(
+    ENQUEUE_MESSAGE_4(
         _messageQueue, CommandBufferExecute,
         actor, getActor(),
         cmdBuffs, actorCmdBuffs,
+        secondaries, agentCmdBuffs,
         count, count,
         {
+            if (secondaries) {
+                for (uint32_t i = 0U; i < count; ++i) {
+                    secondaries[i]->getMessageQueue()->flushMessages();
+                }
+            }
             actor->execute(cmdBuffs, count);
         });
 }
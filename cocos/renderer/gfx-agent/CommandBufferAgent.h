@@ -39,6 +39,8 @@ public:
     explicit CommandBufferAgent(CommandBuffer *actor);
     ~CommandBufferAgent() override;
 
+    // Secondary command buffers are flushed by the primary that executes them,
+    // they should not be passed here or to Device::flushCommands.
     static void flushCommands(uint32_t count, CommandBufferAgent *const *cmdBuffs, bool multiThreaded);
 
     void begin(RenderPass *renderPass, uint32_t subpass, Framebuffer *frameBuffer) override;
@@ -23,10 +23,13 @@
  THE SOFTWARE.
 ****************************************************************************/
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstring>
 #include "base/CoreStd.h"
 #include "base/threading/MessageQueue.h"
+#include "base/threading/MessageQueueProfiler.h"
 
 #include "BufferAgent.h"
 #include "CommandBufferAgent.h"
@@ -50,7 +53,16 @@
 namespace cc {
 namespace gfx {
 
+namespace {
+inline void markProfilerFrame() {
+#if CC_MESSAGE_QUEUE_PROFILING
+    MessageQueueProfiler::getInstance().markFrame();
+#endif
+}
+} // namespace
+
 DeviceAgent *DeviceAgent::instance = nullptr;
+constexpr uint32_t DeviceAgent::MAX_CPU_FRAME_AHEAD;
 
 DeviceAgent *DeviceAgent::getInstance() {
     return DeviceAgent::instance;
@@ -70,6 +82,11 @@ bool DeviceAgent::doInit(const DeviceInfo &info) {
         return false;
     }
 
+    uint32_t framesInFlight = std::max(1U, std::min(info.framesInFlight, MAX_CPU_FRAME_AHEAD));
+    _frameIndexCount        = framesInFlight + 1;
+    _currentIndex           = 0U;
+    _frameBoundarySemaphore.signal(static_cast<int>(framesInFlight));
+
     _api        = _actor->getGfxAPI();
     _deviceName = _actor->getDeviceName();
     _queue      = CC_NEW(QueueAgent(_actor->getQueue()));
@@ -84,6 +101,10 @@ bool DeviceAgent::doInit(const DeviceInfo &info) {
     // TODO(PatriceJiang): replace with: _mainMessageQueue = CC_NEW(MessageQueue);
     _mainMessageQueue = _CC_NEW_T_ALIGN(MessageQueue, alignof(MessageQueue)); //NOLINT
 
+    for (uint32_t i = 0U; i < _frameIndexCount; ++i) {
+        _uploadRings[i] = _CC_NEW_T_ALIGN_ARGS(ThreadSafeLinearAllocator, alignof(ThreadSafeLinearAllocator), UPLOAD_RING_INITIAL_SIZE);
+    }
+
     static_cast<CommandBufferAgent *>(_cmdBuff)->_queue = _queue;
     static_cast<CommandBufferAgent *>(_cmdBuff)->initAgent();
 
@@ -123,6 +144,14 @@ void DeviceAgent::doDestroy() {
     // TODO(PatriceJiang): replace with: CC_SAFE_DELETE(_mainMessageQueue);
     _CC_DELETE_T_ALIGN(_mainMessageQueue, MessageQueue, alignof(MessageQueue)); // NOLINT
     _mainMessageQueue = nullptr;
+
+    for (uint32_t i = 0U; i < MAX_FRAME_INDEX; ++i) {
+        if (_uploadRings[i]) {
+            _CC_DELETE_T_ALIGN(_uploadRings[i], ThreadSafeLinearAllocator, alignof(ThreadSafeLinearAllocator));
+            _uploadRings[i] = nullptr;
+        }
+        _uploadRingOverflows[i] = 0U;
+    }
 }
 
 void DeviceAgent::acquire(Swapchain *const *swapchains, uint32_t count) {
@@ -150,13 +179,42 @@ void DeviceAgent::present() {
         frameBoundarySemaphore, &_frameBoundarySemaphore,
         {
             actor->present();
+            markProfilerFrame();
             frameBoundarySemaphore->signal();
         });
 
     MessageQueue::freeChunksInFreeQueue(_mainMessageQueue);
     _mainMessageQueue->finishWriting();
-    _currentIndex = (_currentIndex + 1) % MAX_FRAME_INDEX;
+    _currentIndex = (_currentIndex + 1) % _frameIndexCount;
+    ++_currentFrame;
+
+    auto waitStart = std::chrono::steady_clock::now();
     _frameBoundarySemaphore.wait();
+    _frameBoundaryWaitTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - waitStart).count();
+
+    // the frame which last used this ring has retired by now
+    auto *&ring = _uploadRings[_currentIndex];
+    if (_uploadRingOverflows[_currentIndex]) {
+        uint32_t size = std::max(ring->getCapacity() * 2, ring->getUsedSize() + _uploadRingOverflows[_currentIndex]);
+        _CC_DELETE_T_ALIGN(ring, ThreadSafeLinearAllocator, alignof(ThreadSafeLinearAllocator));
+        ring = _CC_NEW_T_ALIGN_ARGS(ThreadSafeLinearAllocator, alignof(ThreadSafeLinearAllocator), size);
+
+        _uploadRingOverflows[_currentIndex] = 0U;
+    } else {
+        ring->recycle();
+    }
+}
+
+uint8_t *DeviceAgent::allocateUploadMemory(uint32_t size, bool *pNeedFreeing) {
+    auto *buffer = _uploadRings[_currentIndex]->allocate<uint8_t>(size, 16);
+    if (buffer) {
+        *pNeedFreeing = false;
+        return buffer;
+    }
+
+    _uploadRingOverflows[_currentIndex] += size;
+    *pNeedFreeing = true;
+    return reinterpret_cast<uint8_t *>(malloc(size));
 }
 
 void DeviceAgent::setMultithreaded(bool multithreaded) {
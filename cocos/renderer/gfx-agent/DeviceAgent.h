@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <atomic>
 #include "base/Agent.h"
 #include "base/threading/Semaphore.h"
 #include "gfx-base/GFXDevice.h"
@@ -32,6 +33,7 @@
 namespace cc {
 
 class MessageQueue;
+class ThreadSafeLinearAllocator;
 
 namespace gfx {
 
@@ -41,7 +43,7 @@ class CommandBufferAgent;
 class CC_DLL DeviceAgent final : public Agent<Device> {
 public:
     static DeviceAgent *      getInstance();
-    static constexpr uint32_t MAX_CPU_FRAME_AHEAD = 1;
+    static constexpr uint32_t MAX_CPU_FRAME_AHEAD = 3; // upper bound of DeviceInfo::framesInFlight
     static constexpr uint32_t MAX_FRAME_INDEX     = MAX_CPU_FRAME_AHEAD + 1;
 
     ~DeviceAgent() override;
@@ -96,10 +98,20 @@ public:
     uint32_t      getNumTris() const override { return _actor->getNumTris(); }
 
     uint32_t getCurrentIndex() const { return _currentIndex; }
+    uint32_t getCurrentFrame() const { return _currentFrame; }
+    uint32_t getFrameIndexCount() const { return _frameIndexCount; }
     void     setMultithreaded(bool multithreaded);
 
+    // time the logic thread spent blocked on the device thread in the last present, in microseconds
+    uint64_t getFrameBoundaryWaitTime() const { return _frameBoundaryWaitTime; }
+
     inline MessageQueue *getMessageQueue() const { return _mainMessageQueue; }
 
+    // Scratch memory for the current frame, consumed by the device thread and
+    // recycled once the frame has retired. Falls back to the heap when the ring
+    // is exhausted, in which case the consumer is responsible for freeing it.
+    uint8_t *allocateUploadMemory(uint32_t size, bool *pNeedFreeing);
+
 protected:
     static DeviceAgent *instance;
 
@@ -114,8 +126,17 @@ protected:
     bool          _multithreaded{false};
     MessageQueue *_mainMessageQueue{nullptr};
 
-    uint32_t  _currentIndex = 0U;
-    Semaphore _frameBoundarySemaphore{MAX_CPU_FRAME_AHEAD};
+    uint32_t  _currentIndex    = 0U;
+    uint32_t  _currentFrame    = 0U;
+    uint32_t  _frameIndexCount = 2U;
+    uint64_t  _frameBoundaryWaitTime{0U};
+    Semaphore _frameBoundarySemaphore{0};
+
+    static constexpr uint32_t UPLOAD_RING_INITIAL_SIZE = 4U * 1024U * 1024U;
+
+    ThreadSafeLinearAllocator *_uploadRings[MAX_FRAME_INDEX]{};
+    // upload memory may be requested from several recording threads at once
+    std::atomic<uint32_t>      _uploadRingOverflows[MAX_FRAME_INDEX]{};
 
     unordered_set<CommandBufferAgent *> _cmdBuffRefs;
 };
@@ -68,6 +68,28 @@ void Buffer::destroy() {
     doDestroy();
 
     _offset = _size = _stride = _count = 0U;
+
+    _mappedData = nullptr;
+    _mappedSize = 0U;
+    _mappedStaging.clear();
+    _mappedStaging.shrink_to_fit();
+}
+
+uint8_t *Buffer::beginUpdate(uint32_t size) {
+    CC_ASSERT(!_mappedData && size <= _size);
+
+    _mappedStaging.resize(size);
+    _mappedData = _mappedStaging.data();
+    _mappedSize = size;
+    return _mappedData;
+}
+
+void Buffer::endUpdate() {
+    CC_ASSERT(_mappedData);
+
+    update(_mappedData, _mappedSize);
+    _mappedData = nullptr;
+    _mappedSize = 0U;
 }
 
 void Buffer::resize(uint32_t size) {
@@ -46,6 +46,13 @@ public:
 
     inline void update(const void *buffer) { update(buffer, _size); }
 
+    // Map-style update: fill in `size` bytes of new content through the returned pointer,
+    // then call endUpdate to submit them. Backends without a dedicated path fall back to update.
+    virtual uint8_t *beginUpdate(uint32_t size);
+    virtual void     endUpdate();
+
+    inline uint8_t *beginUpdate() { return beginUpdate(_size); }
+
     inline BufferUsage getUsage() const { return _usage; }
     inline MemoryUsage getMemUsage() const { return _memUsage; }
     inline uint32_t    getStride() const { return _stride; }
@@ -68,6 +75,10 @@ protected:
     uint32_t    _offset       = 0U;
     BufferFlags _flags        = BufferFlagBit::NONE;
     bool        _isBufferView = false;
+
+    uint8_t *       _mappedData = nullptr;
+    uint32_t        _mappedSize = 0U;
+    vector<uint8_t> _mappedStaging;
 };
 
 } // namespace gfx
@@ -902,6 +902,7 @@ struct SwapchainInfo {
 
 struct DeviceInfo {
     BindingMappingInfo bindingMappingInfo;
+    uint32_t           framesInFlight{1U}; // how many frames the logic thread may run ahead of the device thread, [1, 3]
 };
 
 struct ALIGNAS(8) BufferInfo {
@@ -0,0 +1,80 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "GFXPipelineCacheFile.h"
+#include <cstring>
+
+namespace cc {
+namespace gfx {
+
+namespace {
+// FNV-1a
+uint64_t pipelineCacheChecksum(const uint8_t *data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0U; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+} // namespace
+
+void writePipelineCacheHeader(const PipelineCacheDeviceInfo &device, uint8_t *file, size_t blobSize) {
+    PipelineCacheFileHeader header;
+    header.vendorID      = device.vendorID;
+    header.deviceID      = device.deviceID;
+    header.driverVersion = device.driverVersion;
+    header.dataSize      = static_cast<uint32_t>(blobSize);
+    header.checksum      = pipelineCacheChecksum(file + sizeof(header), blobSize);
+    memcpy(header.uuid, device.uuid, PIPELINE_CACHE_UUID_SIZE);
+    memcpy(file, &header, sizeof(header));
+}
+
+const uint8_t *readPipelineCacheBlob(const PipelineCacheDeviceInfo &device, const uint8_t *file, size_t fileSize, size_t *blobSize) {
+    PipelineCacheFileHeader header;
+    if (!file || fileSize < sizeof(header)) {
+        return nullptr;
+    }
+    memcpy(&header, file, sizeof(header));
+    const uint8_t *blob = file + sizeof(header);
+
+    // a blob from another device or driver, or a truncated file, is discarded
+    if (header.magic != PIPELINE_CACHE_MAGIC ||
+        header.version != PIPELINE_CACHE_VERSION ||
+        header.vendorID != device.vendorID ||
+        header.deviceID != device.deviceID ||
+        header.driverVersion != device.driverVersion ||
+        memcmp(header.uuid, device.uuid, PIPELINE_CACHE_UUID_SIZE) != 0 ||
+        header.dataSize != fileSize - sizeof(header) ||
+        header.checksum != pipelineCacheChecksum(blob, header.dataSize)) {
+        return nullptr;
+    }
+
+    *blobSize = header.dataSize;
+    return blob;
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,67 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "base/Macros.h"
+
+namespace cc {
+namespace gfx {
+
+constexpr uint32_t PIPELINE_CACHE_MAGIC     = 0x43504343U; // "CCPC"
+constexpr uint32_t PIPELINE_CACHE_VERSION   = 1U;
+constexpr size_t   PIPELINE_CACHE_UUID_SIZE = 16U;
+
+// identifies the device and driver a pipeline cache blob was created by
+struct PipelineCacheDeviceInfo {
+    uint32_t vendorID{0U};
+    uint32_t deviceID{0U};
+    uint32_t driverVersion{0U};
+    uint8_t  uuid[PIPELINE_CACHE_UUID_SIZE]{};
+};
+
+// prepended to the driver's pipeline cache blob on disk
+struct PipelineCacheFileHeader {
+    uint32_t magic{PIPELINE_CACHE_MAGIC};
+    uint32_t version{PIPELINE_CACHE_VERSION};
+    uint32_t vendorID{0U};
+    uint32_t deviceID{0U};
+    uint32_t driverVersion{0U};
+    uint32_t dataSize{0U};
+    uint64_t checksum{0U};
+    uint8_t  uuid[PIPELINE_CACHE_UUID_SIZE]{};
+};
+
+// Fills the header at the front of file, the blob of blobSize bytes has to follow it.
+CC_DLL void writePipelineCacheHeader(const PipelineCacheDeviceInfo &device, uint8_t *file, size_t blobSize);
+
+// Returns the blob of a cache file written for the same device, driver and file version.
+// Truncated, corrupted and incompatible files return nullptr.
+CC_DLL const uint8_t *readPipelineCacheBlob(const PipelineCacheDeviceInfo &device, const uint8_t *file, size_t fileSize, size_t *blobSize);
+
+} // namespace gfx
+} // namespace cc
@@ -38,10 +38,24 @@ void EmptyBuffer::doResize(uint32_t size, uint32_t count) {
 }
 
 void EmptyBuffer::doDestroy() {
+    _mappedStaging.clear();
+    _mappedStaging.shrink_to_fit();
 }
 
 void EmptyBuffer::update(const void *buffer, uint32_t size) {
 }
 
+uint8_t *EmptyBuffer::beginUpdate(uint32_t size) {
+    if (_mappedStaging.size() < size) _mappedStaging.resize(size);
+    _mappedData = _mappedStaging.data();
+    _mappedSize = size;
+    return _mappedData;
+}
+
+void EmptyBuffer::endUpdate() {
+    _mappedData = nullptr;
+    _mappedSize = 0U;
+}
+
 } // namespace gfx
 } // namespace cc
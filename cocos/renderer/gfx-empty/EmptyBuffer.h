@@ -32,7 +32,9 @@ namespace gfx {
 
 class CC_DLL EmptyBuffer final : public Buffer {
 public:
-    void update(const void *buffer, uint32_t size) override;
+    void     update(const void *buffer, uint32_t size) override;
+    uint8_t *beginUpdate(uint32_t size) override;
+    void     endUpdate() override;
 
 protected:
     void doInit(const BufferInfo &info) override;
@@ -125,7 +125,52 @@ void BufferValidator::update(const void *buffer, uint32_t size) {
     CCASSERT(!_isBufferView, "cannot update through buffer views");
     CCASSERT(size && size <= _size, "invalid size");
     CCASSERT(buffer, "invalid buffer data");
+    CCASSERT(!_mappedData, "updating between beginUpdate and endUpdate?");
 
+    checkIndirectDrawInfos(buffer, size);
+
+    sanityCheck(buffer, size);
+    ++_totalUpdateTimes; // only count direct updates
+
+    /////////// execute ///////////
+
+    _actor->update(buffer, size);
+}
+
+uint8_t *BufferValidator::beginUpdate(uint32_t size) {
+    CCASSERT(isInited(), "alread destroyed?");
+
+    CCASSERT(!_isBufferView, "cannot update through buffer views");
+    CCASSERT(size && size <= _size, "invalid size");
+    CCASSERT(!_mappedData, "beginUpdate called twice without endUpdate?");
+
+    /////////// execute ///////////
+
+    _mappedData = _actor->beginUpdate(size);
+    _mappedSize = size;
+
+    return _mappedData;
+}
+
+void BufferValidator::endUpdate() {
+    CCASSERT(isInited(), "alread destroyed?");
+
+    CCASSERT(_mappedData, "endUpdate called without beginUpdate?");
+
+    checkIndirectDrawInfos(_mappedData, _mappedSize);
+
+    sanityCheck(_mappedData, _mappedSize);
+    ++_totalUpdateTimes;
+
+    _mappedData = nullptr;
+    _mappedSize = 0U;
+
+    /////////// execute ///////////
+
+    _actor->endUpdate();
+}
+
+void BufferValidator::checkIndirectDrawInfos(const void *buffer, uint32_t size) const {
     if (hasFlag(_usage, BufferUsageBit::INDIRECT)) {
         const auto * drawInfo      = static_cast<const DrawInfo *>(buffer);
         const size_t drawInfoCount = size / sizeof(DrawInfo);
@@ -136,13 +181,6 @@ void BufferValidator::update(const void *buffer, uint32_t size) {
             }
         }
     }
-
-    sanityCheck(buffer, size);
-    ++_totalUpdateTimes; // only count direct updates
-
-    /////////// execute ///////////
-
-    _actor->update(buffer, size);
 }
 
 void BufferValidator::sanityCheck(const void *buffer, uint32_t size) {
@@ -36,9 +36,12 @@ public:
     explicit BufferValidator(Buffer *actor);
     ~BufferValidator() override;
 
-    void update(const void *buffer, uint32_t size) override;
+    void     update(const void *buffer, uint32_t size) override;
+    uint8_t *beginUpdate(uint32_t size) override;
+    void     endUpdate() override;
 
     void sanityCheck(const void *buffer, uint32_t size);
+    void checkIndirectDrawInfos(const void *buffer, uint32_t size) const;
 
     inline bool isInited() const { return _inited; }
 
@@ -384,7 +384,11 @@ void CommandBufferValidator::updateBuffer(Buffer *buff, const void *data, uint32
     CCASSERT(_type == CommandBufferType::PRIMARY, "Command 'updateBuffer' must be recorded in primary command buffers.");
     CCASSERT(!_insideRenderPass, "Command 'updateBuffer' must be recorded outside render passes.");
 
+    CCASSERT(size && size <= buff->getSize(), "invalid size");
+    CCASSERT(data, "invalid buffer data");
+
     auto *bufferValidator = static_cast<BufferValidator *>(buff);
+    bufferValidator->checkIndirectDrawInfos(data, size);
     bufferValidator->sanityCheck(data, size);
 
     /////////// execute ///////////
@@ -442,13 +446,17 @@ void CommandBufferValidator::dispatch(const DispatchInfo &info) {
     CCASSERT(isInited(), "alread destroyed?");
 
     CCASSERT(!_insideRenderPass, "Command 'dispatch' must be recorded outside render passes.");
+    if (info.indirectBuffer) {
+        CCASSERT(static_cast<BufferValidator *>(info.indirectBuffer)->isInited(), "already destroyed?");
+        CCASSERT(hasFlag(info.indirectBuffer->getUsage(), BufferUsageBit::INDIRECT), "Input is not an indirect buffer");
+    }
 
     /////////// execute ///////////
 
     DispatchInfo actorInfo = info;
     if (info.indirectBuffer) actorInfo.indirectBuffer = static_cast<BufferValidator *>(info.indirectBuffer)->getActor();
 
-    _actor->dispatch(info);
+    _actor->dispatch(actorInfo);
 }
 
 void CommandBufferValidator::pipelineBarrier(const GlobalBarrier *barrier, const TextureBarrier *const *textureBarriers, const Texture *const *textures, uint32_t textureBarrierCount) {
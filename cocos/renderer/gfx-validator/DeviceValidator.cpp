@@ -65,6 +65,10 @@ DeviceValidator::~DeviceValidator() {
 }
 
 bool DeviceValidator::doInit(const DeviceInfo &info) {
+    CCASSERT(info.framesInFlight >= 1 && info.framesInFlight <= 3, "frames in flight out of range [1, 3]");
+
+    /////////// execute ///////////
+
     if (!_actor->initialize(info)) {
         return false;
     }
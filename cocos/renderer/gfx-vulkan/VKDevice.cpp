@@ -41,8 +41,11 @@
 #include "VKSwapchain.h"
 #include "VKTexture.h"
 #include "VKUtils.h"
+#include "gfx-base/GFXPipelineCacheFile.h"
 #include "gfx-base/SPIRVUtils.h"
+#include "base/Data.h"
 #include "gfx-vulkan/VKGPUObjects.h"
+#include "platform/FileUtils.h"
 #include "states/VKGlobalBarrier.h"
 #include "states/VKSampler.h"
 #include "states/VKTextureBarrier.h"
@@ -66,6 +69,20 @@ static VkResult VKAPI_PTR vkCreateRenderPass2KHRFallback(
     const VkAllocationCallbacks *  pAllocator,
     VkRenderPass *                 pRenderPass);
 
+namespace {
+constexpr const char *PIPELINE_CACHE_FILE_NAME = "vulkan_pipeline_cache.bin";
+static_assert(VK_UUID_SIZE == PIPELINE_CACHE_UUID_SIZE, "pipeline cache UUID size mismatch");
+
+PipelineCacheDeviceInfo getPipelineCacheDeviceInfo(const VkPhysicalDeviceProperties &properties) {
+    PipelineCacheDeviceInfo info;
+    info.vendorID      = properties.vendorID;
+    info.deviceID      = properties.deviceID;
+    info.driverVersion = properties.driverVersion;
+    memcpy(info.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    return info;
+}
+} // namespace
+
 CCVKDevice *CCVKDevice::instance = nullptr;
 
 CCVKDevice *CCVKDevice::getInstance() {
@@ -413,8 +430,7 @@ bool CCVKDevice::doInit(const DeviceInfo & /*info*/) {
     _gpuDevice->defaultBuffer.count                                   = 1U;
     cmdFuncCCVKCreateBuffer(this, &_gpuDevice->defaultBuffer);
 
-    VkPipelineCacheCreateInfo pipelineCacheInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
-    VK_CHECK(vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_gpuDevice->vkPipelineCache));
+    initPipelineCache();
 
     ///////////////////// Print Debug Info /////////////////////
 
@@ -490,6 +506,7 @@ void CCVKDevice::doDestroy() {
 
     if (_gpuDevice) {
         if (_gpuDevice->vkPipelineCache) {
+            savePipelineCache();
             vkDestroyPipelineCache(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, nullptr);
             _gpuDevice->vkPipelineCache = VK_NULL_HANDLE;
         }
@@ -668,6 +685,66 @@ CCVKGPUFencePool *        CCVKDevice::gpuFencePool() { return _gpuFencePools[_gp
 CCVKGPURecycleBin *       CCVKDevice::gpuRecycleBin() { return _gpuRecycleBins[_gpuDevice->curBackBufferIndex]; }
 CCVKGPUStagingBufferPool *CCVKDevice::gpuStagingBufferPool() { return _gpuStagingBufferPools[_gpuDevice->curBackBufferIndex]; }
 
+void CCVKDevice::initPipelineCache() {
+    const auto writablePath = FileUtils::getInstance()->getWritablePath();
+    if (!writablePath.empty()) {
+        _pipelineCachePath = writablePath + PIPELINE_CACHE_FILE_NAME;
+    }
+
+    Data cacheData;
+    if (!_pipelineCachePath.empty() && FileUtils::getInstance()->isFileExist(_pipelineCachePath)) {
+        cacheData = FileUtils::getInstance()->getDataFromFile(_pipelineCachePath);
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    if (!cacheData.isNull()) {
+        const auto     device   = getPipelineCacheDeviceInfo(_gpuContext->physicalDeviceProperties);
+        size_t         blobSize = 0U;
+        const uint8_t *blob     = readPipelineCacheBlob(device, cacheData.getBytes(), static_cast<size_t>(cacheData.getSize()), &blobSize);
+        if (blob) {
+            pipelineCacheInfo.initialDataSize = blobSize;
+            pipelineCacheInfo.pInitialData    = blob;
+            _pipelineCacheSavedSize           = blobSize;
+        } else {
+            CC_LOG_INFO("Discarding incompatible pipeline cache: %s", _pipelineCachePath.c_str());
+        }
+    }
+
+    VkResult res = vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_gpuDevice->vkPipelineCache);
+    if (res != VK_SUCCESS && pipelineCacheInfo.pInitialData) {
+        pipelineCacheInfo.initialDataSize = 0U;
+        pipelineCacheInfo.pInitialData    = nullptr;
+        _pipelineCacheSavedSize           = 0U;
+        res                               = vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_gpuDevice->vkPipelineCache);
+    }
+    VK_CHECK(res);
+
+    if (pipelineCacheInfo.pInitialData) {
+        CC_LOG_INFO("Pipeline cache loaded: %u bytes.", static_cast<uint32_t>(pipelineCacheInfo.initialDataSize));
+    }
+}
+
+void CCVKDevice::savePipelineCache() {
+    if (_pipelineCachePath.empty() || !_gpuDevice->vkPipelineCache) return;
+
+    size_t dataSize = 0U;
+    if (vkGetPipelineCacheData(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, &dataSize, nullptr) != VK_SUCCESS) return;
+    // the cache only grows, an unchanged size means nothing new to save
+    if (!dataSize || dataSize == _pipelineCacheSavedSize) return;
+
+    Data fileData;
+    fileData.resize(static_cast<ssize_t>(sizeof(PipelineCacheFileHeader) + dataSize));
+    uint8_t *blob = fileData.getBytes() + sizeof(PipelineCacheFileHeader);
+    if (vkGetPipelineCacheData(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, &dataSize, blob) != VK_SUCCESS) return;
+
+    fileData.resize(static_cast<ssize_t>(sizeof(PipelineCacheFileHeader) + dataSize));
+    writePipelineCacheHeader(getPipelineCacheDeviceInfo(_gpuContext->physicalDeviceProperties), fileData.getBytes(), dataSize);
+
+    if (FileUtils::getInstance()->writeDataToFile(fileData, _pipelineCachePath)) {
+        _pipelineCacheSavedSize = dataSize;
+    }
+}
+
 void CCVKDevice::waitAllFences() {
     static vector<VkFence> fences;
     fences.clear();
@@ -98,6 +98,8 @@ public:
     CCVKGPURecycleBin *       gpuRecycleBin();
     CCVKGPUStagingBufferPool *gpuStagingBufferPool();
     void                      waitAllFences();
+    // writes the pipeline cache to disk if it grew, on destroy and when the surface is destroyed (the app is paused)
+    void                      savePipelineCache();
 
 protected:
     static CCVKDevice *instance;
@@ -134,6 +136,8 @@ protected:
     void destroySwapchain();
     bool checkSwapchainStatus();
 
+    void initPipelineCache();
+
     CCVKGPUDevice *       _gpuDevice  = nullptr;
     CCVKGPUContext *      _gpuContext = nullptr;
     vector<CCVKTexture *> _depthStencilTextures;
@@ -152,6 +156,9 @@ protected:
 
     vector<const char *> _layers;
     vector<const char *> _extensions;
+
+    String _pipelineCachePath;
+    size_t _pipelineCacheSavedSize{0U};
 };
 
 } // namespace gfx
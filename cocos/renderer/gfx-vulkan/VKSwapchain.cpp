@@ -383,6 +383,9 @@ void CCVKSwapchain::doDestroySurface() {
     destroySwapchain(gpuDevice);
     _gpuSwapchain->lastPresentResult = VK_NOT_READY;
 
+    // the app may be killed while in background, keep the pipelines compiled so far
+    CCVKDevice::getInstance()->savePipelineCache();
+
     vkDestroySurfaceKHR(gpuContext->vkInstance, _gpuSwapchain->vkSurface, nullptr);
     _gpuSwapchain->vkSurface = VK_NULL_HANDLE;
 }
@@ -24,40 +24,50 @@
 ****************************************************************************/
 
 #include "BatchedBuffer.h"
+#include <algorithm>
+#include <boost/functional/hash.hpp>
 #include "gfx-base/GFXBuffer.h"
+#include "gfx-base/GFXCommandBuffer.h"
 #include "gfx-base/GFXDescriptorSet.h"
 #include "gfx-base/GFXDevice.h"
 #include "gfx-base/GFXInputAssembler.h"
 
 namespace cc {
 namespace pipeline {
-map<scene::Pass *, map<uint, BatchedBuffer *>> BatchedBuffer::buffers;
-BatchedBuffer *                                BatchedBuffer::get(scene::Pass *pass) {
+size_t BatchedBucketKeyHasher::operator()(const BatchedBucketKey &key) const {
+    size_t seed = 4;
+    boost::hash_combine(seed, key.pass);
+    boost::hash_combine(seed, key.shader);
+    boost::hash_combine(seed, key.bufferCount);
+    boost::hash_combine(seed, key.stridesHash);
+    return seed;
+}
+
+FlatHashMap<PassBufferKey, BatchedBuffer *, PassBufferKeyHasher> BatchedBuffer::buffers;
+bool                                                             BatchedBuffer::persistentBatching{true};
+BatchedUploadStats                                               BatchedBuffer::uploadStats;
+BatchedBuffer *                                                  BatchedBuffer::get(scene::Pass *pass) {
     return BatchedBuffer::get(pass, 0);
 }
 BatchedBuffer *BatchedBuffer::get(scene::Pass *pass, uint extraKey) {
-    auto &record = BatchedBuffer::buffers[pass];
-    auto &buffer = record[extraKey];
+    auto &buffer = BatchedBuffer::buffers[{pass, extraKey}];
     if (buffer == nullptr) buffer = CC_NEW(BatchedBuffer(pass));
     return buffer;
 }
 
 void BatchedBuffer::destroyBatchedBuffer() {
-    for (auto &pair : BatchedBuffer::buffers) {
-        const map<uint, BatchedBuffer *> &bufferItem = pair.second;
-        for (const auto &item : bufferItem) {
-            BatchedBuffer *batchedBuffer = item.second;
-            if (batchedBuffer) {
-                batchedBuffer->destroy();
-            }
+    BatchedBuffer::buffers.forEach([](const PassBufferKey & /*key*/, BatchedBuffer *batchedBuffer) {
+        if (batchedBuffer) {
+            batchedBuffer->destroy();
         }
-    }
+    });
     BatchedBuffer::buffers.clear();
 }
 
 BatchedBuffer::BatchedBuffer(const scene::Pass *pass)
 : _pass(pass),
-  _device(gfx::Device::getInstance()) {
+  _device(gfx::Device::getInstance()),
+  _persistent(persistentBatching) {
 }
 
 BatchedBuffer::~BatchedBuffer() = default;
@@ -79,6 +89,8 @@ void BatchedBuffer::destroy() {
         CC_FREE(batch.indexData);
     }
     _batches.clear();
+    _buckets.clear();
+    _slotBatches.clear();
 }
 
 void BatchedBuffer::merge(const scene::SubModel *subModel, uint passIdx, const scene::Model *model) {
@@ -89,89 +101,124 @@ void BatchedBuffer::merge(const scene::SubModel *subModel, uint passIdx, const s
         return;
     }
 
-    const auto &      flatBuffer    = flatBuffers[0];
+    if (_persistent) {
+        mergePersistent(subModel, passIdx, model);
+        return;
+    }
+
+    bool  isNew = false;
+    auto &batch = _batches[acquireBatch(subModel, passIdx, model, &isNew)];
+    if (isNew) {
+        return;
+    }
+
     uint              vbSize        = 0;
     uint              indexSize     = 0;
-    const auto        vbCount       = flatBuffer.count;
+    const auto        vbCount       = flatBuffers[0].count;
     const auto *const pass          = subModel->getPass(passIdx);
     auto *const       shader        = subModel->getShader(passIdx);
     auto *const       descriptorSet = subModel->getDescriptorSet();
-    bool              isBatchExist  = false;
 
-    for (auto &batch : _batches) {
-        if (batch.vbs.size() == flatBuffersCount && batch.mergeCount < UBOLocalBatched::BATCHING_COUNT) {
-            isBatchExist = true;
-            for (uint j = 0; j < flatBuffersCount; ++j) {
-                auto *const vb = batch.vbs[j];
-                if (vb->getStride() != flatBuffers[j].stride) {
-                    isBatchExist = false;
-                    break;
-                }
-            }
+    for (uint j = 0; j < flatBuffersCount; ++j) {
+        const auto &flatBuffer   = flatBuffers[j];
+        auto *      batchVB      = batch.vbs[j];
+        auto *      vbData       = batch.vbDatas[j];
+        const uint  vbBufSizeOld = batchVB->getSize();
+        vbSize                   = (vbCount + batch.vbCount) * flatBuffer.stride;
+        if (vbSize > vbBufSizeOld) {
+            auto *vbDataNew = static_cast<uint8_t *>(CC_MALLOC(vbSize));
+            memcpy(vbDataNew, vbData, vbBufSizeOld);
+            batchVB->resize(vbSize);
+            CC_FREE(vbData);
+            batch.vbDatas[j] = vbDataNew;
+            vbData           = vbDataNew;
+        }
 
-            if (isBatchExist) {
-                for (uint j = 0; j < flatBuffersCount; ++j) {
-                    const auto &flatBuffer   = flatBuffers[j];
-                    auto *      batchVB      = batch.vbs[j];
-                    auto *      vbData       = batch.vbDatas[j];
-                    const uint  vbBufSizeOld = batchVB->getSize();
-                    vbSize                   = (vbCount + batch.vbCount) * flatBuffer.stride;
-                    if (vbSize > vbBufSizeOld) {
-                        auto *vbDataNew = static_cast<uint8_t *>(CC_MALLOC(vbSize));
-                        memcpy(vbDataNew, vbData, vbBufSizeOld);
-                        batchVB->resize(vbSize);
-                        CC_FREE(vbData);
-                        batch.vbDatas[j] = vbDataNew;
-                        vbData           = vbDataNew;
-                    }
-
-                    auto offset = batch.vbCount * flatBuffer.stride;
-                    memcpy(vbData + offset, flatBuffer.data, flatBuffer.size);
-                }
+        auto offset = batch.vbCount * flatBuffer.stride;
+        memcpy(vbData + offset, flatBuffer.data, flatBuffer.size);
+    }
 
-                auto *indexData = batch.indexData;
-                indexSize       = (vbCount + batch.vbCount) * sizeof(float);
-                if (indexSize > batch.indexBuffer->getSize()) {
-                    auto *newIndexData = static_cast<float *>(CC_MALLOC(indexSize));
-                    memcpy(newIndexData, indexData, batch.indexBuffer->getSize());
-                    CC_FREE(indexData);
-                    batch.indexData = newIndexData;
-                    indexData       = batch.indexData;
-                    batch.indexBuffer->resize(indexSize);
-                }
+    auto *indexData = batch.indexData;
+    indexSize       = (vbCount + batch.vbCount) * sizeof(float);
+    if (indexSize > batch.indexBuffer->getSize()) {
+        auto *newIndexData = static_cast<float *>(CC_MALLOC(indexSize));
+        memcpy(newIndexData, indexData, batch.indexBuffer->getSize());
+        CC_FREE(indexData);
+        batch.indexData = newIndexData;
+        indexData       = batch.indexData;
+        batch.indexBuffer->resize(indexSize);
+    }
 
-                const auto start      = batch.vbCount;
-                const auto end        = start + vbCount;
-                const auto mergeCount = batch.mergeCount;
-                if (indexData[start] != mergeCount || indexData[end - 1] != mergeCount) {
-                    for (auto j = start; j < end; j++) {
-                        indexData[j] = mergeCount + 0.1F; // guard against underflow
-                    }
-                }
+    const auto start      = batch.vbCount;
+    const auto end        = start + vbCount;
+    const auto mergeCount = batch.mergeCount;
+    if (indexData[start] != mergeCount || indexData[end - 1] != mergeCount) {
+        for (auto j = start; j < end; j++) {
+            indexData[j] = mergeCount + 0.1F; // guard against underflow
+        }
+    }
 
-                // update world matrix
-                const auto  offset      = UBOLocalBatched::MAT_WORLDS_OFFSET + batch.mergeCount * 16;
-                const auto &worldMatrix = model->getTransform()->getWorldMatrix();
-                memcpy(batch.uboData.data() + offset, worldMatrix.m, sizeof(worldMatrix));
-
-                if (!batch.mergeCount) {
-                    descriptorSet->bindBuffer(UBOLocalBatched::BINDING, batch.ubo);
-                    descriptorSet->update();
-                    batch.pass          = pass;
-                    batch.shader        = shader;
-                    batch.descriptorSet = descriptorSet;
-                }
+    // update world matrix
+    const auto  offset      = UBOLocalBatched::MAT_WORLDS_OFFSET + batch.mergeCount * 16;
+    const auto &worldMatrix = model->getTransform()->getWorldMatrix();
+    memcpy(batch.uboData.data() + offset, worldMatrix.m, sizeof(worldMatrix));
+
+    if (!batch.mergeCount) {
+        descriptorSet->bindBuffer(UBOLocalBatched::BINDING, batch.ubo);
+        descriptorSet->update();
+        batch.pass          = pass;
+        batch.shader        = shader;
+        batch.descriptorSet = descriptorSet;
+    }
 
-                ++batch.mergeCount;
-                batch.vbCount += vbCount;
-                auto prevCount = batch.ia->getDrawInfo().vertexCount;
-                batch.ia->setVertexCount(prevCount + vbCount);
-                return;
+    ++batch.mergeCount;
+    batch.vbCount += vbCount;
+    auto prevCount = batch.ia->getDrawInfo().vertexCount;
+    batch.ia->setVertexCount(prevCount + vbCount);
+}
+
+uint BatchedBuffer::acquireBatch(const scene::SubModel *subModel, uint passIdx, const scene::Model *model, bool *isNew) {
+    const auto &     flatBuffers      = subModel->getSubMesh()->flatBuffers;
+    const auto       flatBuffersCount = static_cast<uint32_t>(flatBuffers.size());
+    BatchedBucketKey key{subModel->getPass(passIdx), subModel->getShader(passIdx), flatBuffersCount, 0};
+    for (const auto &flatBuffer : flatBuffers) {
+        boost::hash_combine(key.stridesHash, flatBuffer.stride);
+    }
+
+    // batches of a bucket are chained, strides are still compared as their hashes may collide
+    uint *item = _buckets.insert(key, BatchedItem::NO_ITEM).first;
+    while (*item != BatchedItem::NO_ITEM) {
+        auto &batch = _batches[*item];
+        if (batch.mergeCount < UBOLocalBatched::BATCHING_COUNT && batch.vbs.size() == flatBuffersCount) {
+            bool isCompatible = true;
+            for (uint j = 0; j < flatBuffersCount; ++j) {
+                if (batch.vbs[j]->getStride() != flatBuffers[j].stride) {
+                    isCompatible = false;
+                    break;
+                }
+            }
+            if (isCompatible) {
+                *isNew = false;
+                return *item;
             }
         }
+        item = &batch.next;
     }
 
-    // Create a new batch
+    *isNew = true;
+    *item  = static_cast<uint>(_batches.size());
+    createBatch(subModel, passIdx, model);
+    return static_cast<uint>(_batches.size() - 1);
+}
+
+BatchedItem &BatchedBuffer::createBatch(const scene::SubModel *subModel, uint passIdx, const scene::Model *model) {
+    const auto &      flatBuffers      = subModel->getSubMesh()->flatBuffers;
+    const auto        flatBuffersCount = static_cast<uint32_t>(flatBuffers.size());
+    const auto        vbCount          = flatBuffers[0].count;
+    const auto *const pass             = subModel->getPass(passIdx);
+    auto *const       shader           = subModel->getShader(passIdx);
+    auto *const       descriptorSet    = subModel->getDescriptorSet();
+
     vector<gfx::Buffer *> vbs(flatBuffersCount, nullptr);
     vector<uint8_t *>     vbDatas(flatBuffersCount, nullptr);
     vector<gfx::Buffer *> totalVBs(flatBuffersCount + 1, nullptr);
@@ -190,7 +237,9 @@ void BatchedBuffer::merge(const scene::SubModel *subModel, uint passIdx, const s
         vbs[i]     = newVB;
         vbDatas[i] = static_cast<uint8_t *>(CC_MALLOC(newVB->getSize()));
         memset(vbDatas[i], 0, newVB->getSize());
+        memcpy(vbDatas[i], flatBuffer.data, std::min(flatBuffer.size, newVB->getSize()));
         totalVBs[i] = newVB;
+        uploadStats.vertexBytes += flatBuffer.size;
     }
 
     const auto indexBufferSize = vbCount * sizeof(float);
@@ -203,6 +252,7 @@ void BatchedBuffer::merge(const scene::SubModel *subModel, uint passIdx, const s
     auto *     indexData       = static_cast<float *>(CC_MALLOC(indexBufferSize));
     memset(indexData, 0, indexBufferSize);
     indexBuffer->update(indexData, static_cast<uint>(indexBufferSize));
+    uploadStats.indexBytes += static_cast<uint>(indexBufferSize);
     totalVBs[flatBuffersCount] = indexBuffer;
 
     vector<gfx::Attribute> attributes = subModel->getInputAssembler()->getAttributes();
@@ -244,9 +294,153 @@ void BatchedBuffer::merge(const scene::SubModel *subModel, uint passIdx, const s
         shader,                          //shader
     };
     _batches.emplace_back(std::move(item));
+    return _batches.back();
+}
+
+void BatchedBuffer::mergePersistent(const scene::SubModel *subModel, uint passIdx, const scene::Model *model) {
+    const auto &      flatBuffer = subModel->getSubMesh()->flatBuffers[0];
+    const auto *const pass       = subModel->getPass(passIdx);
+    auto *const       shader     = subModel->getShader(passIdx);
+
+    auto iter = _slotBatches.find(subModel);
+    if (iter != _slotBatches.end()) {
+        auto &batch = _batches[iter->second];
+        for (uint i = 0; i < batch.slots.size(); ++i) {
+            auto &slot = batch.slots[i];
+            if (slot.subModel != subModel) continue;
+
+            if (slot.flatData == flatBuffer.data && slot.vertexCount == flatBuffer.count && slot.descriptorSet == subModel->getDescriptorSet() &&
+                batch.pass == pass && batch.shader == shader) {
+                slot.stamp = _stamp;
+                // only a moved member rewrites its world matrix slot
+                auto *      matrix      = batch.uboData.data() + UBOLocalBatched::MAT_WORLDS_OFFSET + i * 16;
+                const auto &worldMatrix = model->getTransform()->getWorldMatrix();
+                if (memcmp(matrix, worldMatrix.m, sizeof(worldMatrix)) != 0) {
+                    memcpy(matrix, worldMatrix.m, sizeof(worldMatrix));
+                    batch.dirtyMatrixCount = std::max(batch.dirtyMatrixCount, i + 1);
+                }
+                return;
+            }
+
+            // the mesh, the shader or the sub model itself changed, merge it again
+            removeSlot(batch, i);
+            break;
+        }
+    }
+
+    bool       isNew    = false;
+    const uint batchIdx = acquireBatch(subModel, passIdx, model, &isNew);
+    auto &     batch    = _batches[batchIdx];
+    if (!isNew) {
+        appendSlot(batch, batchIdx, subModel, passIdx, model);
+        return;
+    }
+
+    // the vertex and index buffers of a new batch are uploaded on creation
+    batch.slots.push_back({subModel, flatBuffer.data, subModel->getDescriptorSet(), 0, flatBuffer.count, _stamp});
+    batch.dirtyMatrixCount = 1;
+    _slotBatches[subModel] = batchIdx;
+}
+
+void BatchedBuffer::appendSlot(BatchedItem &batch, uint batchIdx, const scene::SubModel *subModel, uint passIdx, const scene::Model *model) {
+    const auto &flatBuffers      = subModel->getSubMesh()->flatBuffers;
+    const auto  flatBuffersCount = static_cast<uint32_t>(flatBuffers.size());
+    const auto  slotIdx          = static_cast<uint>(batch.slots.size());
+    const auto  start            = batch.vbCount;
+    const auto  end              = start + flatBuffers[0].count;
+
+    for (uint j = 0; j < flatBuffersCount; ++j) {
+        const auto &flatBuffer   = flatBuffers[j];
+        auto *      batchVB      = batch.vbs[j];
+        auto *      vbData       = batch.vbDatas[j];
+        const uint  vbBufSizeOld = batchVB->getSize();
+        const uint  vbSize       = end * flatBuffer.stride;
+        if (vbSize > vbBufSizeOld) {
+            auto *vbDataNew = static_cast<uint8_t *>(CC_MALLOC(vbSize));
+            memcpy(vbDataNew, vbData, vbBufSizeOld);
+            batchVB->resize(vbSize);
+            CC_FREE(vbData);
+            batch.vbDatas[j] = vbDataNew;
+            vbData           = vbDataNew;
+        }
+        memcpy(vbData + start * flatBuffer.stride, flatBuffer.data, flatBuffer.size);
+    }
+
+    const uint indexSize = end * sizeof(float);
+    if (indexSize > batch.indexBuffer->getSize()) {
+        auto *newIndexData = static_cast<float *>(CC_MALLOC(indexSize));
+        memcpy(newIndexData, batch.indexData, batch.indexBuffer->getSize());
+        CC_FREE(batch.indexData);
+        batch.indexData = newIndexData;
+        batch.indexBuffer->resize(indexSize);
+    }
+    for (auto i = start; i < end; ++i) {
+        batch.indexData[i] = slotIdx + 0.1F; // guard against underflow
+    }
+
+    const auto &worldMatrix = model->getTransform()->getWorldMatrix();
+    memcpy(batch.uboData.data() + UBOLocalBatched::MAT_WORLDS_OFFSET + slotIdx * 16, worldMatrix.m, sizeof(worldMatrix));
+
+    if (!slotIdx) {
+        auto *descriptorSet = subModel->getDescriptorSet();
+        descriptorSet->bindBuffer(UBOLocalBatched::BINDING, batch.ubo);
+        descriptorSet->update();
+        batch.pass          = subModel->getPass(passIdx);
+        batch.shader        = subModel->getShader(passIdx);
+        batch.descriptorSet = descriptorSet;
+    }
+
+    batch.slots.push_back({subModel, flatBuffers[0].data, subModel->getDescriptorSet(), start, flatBuffers[0].count, _stamp});
+    batch.vbCount          = end;
+    batch.mergeCount       = static_cast<uint>(batch.slots.size());
+    batch.dirtyVertexCount = end;
+    batch.dirtyMatrixCount = std::max(batch.dirtyMatrixCount, slotIdx + 1);
+    batch.ia->setVertexCount(end);
+    _slotBatches[subModel] = batchIdx;
+}
+
+void BatchedBuffer::removeSlot(BatchedItem &batch, uint slotIdx) {
+    const BatchedSlot removed   = batch.slots[slotIdx];
+    const auto        tailStart = removed.vertexOffset + removed.vertexCount;
+    const auto        tailCount = batch.vbCount - tailStart;
+
+    // move the members after the removed one down, in place, O(vertices after it)
+    for (uint j = 0; j < batch.vbs.size(); ++j) {
+        const auto stride = batch.vbs[j]->getStride();
+        memmove(batch.vbDatas[j] + removed.vertexOffset * stride, batch.vbDatas[j] + tailStart * stride, tailCount * stride);
+    }
+    _slotBatches.erase(removed.subModel);
+    batch.slots.erase(batch.slots.begin() + slotIdx);
+
+    auto *     matrices  = batch.uboData.data() + UBOLocalBatched::MAT_WORLDS_OFFSET;
+    const auto slotCount = static_cast<uint>(batch.slots.size());
+    for (auto i = slotIdx; i < slotCount; ++i) {
+        auto &slot = batch.slots[i];
+        slot.vertexOffset -= removed.vertexCount;
+        for (auto v = slot.vertexOffset; v < slot.vertexOffset + slot.vertexCount; ++v) {
+            batch.indexData[v] = i + 0.1F; // guard against underflow
+        }
+        memcpy(matrices + i * 16, matrices + (i + 1) * 16, 16 * sizeof(float));
+    }
+
+    batch.vbCount -= removed.vertexCount;
+    batch.mergeCount       = slotCount;
+    batch.dirtyVertexCount = tailCount ? batch.vbCount : std::min(batch.dirtyVertexCount, batch.vbCount);
+    batch.dirtyMatrixCount = slotIdx < slotCount ? slotCount : std::min(batch.dirtyMatrixCount, slotCount);
+    batch.ia->setVertexCount(batch.vbCount);
+
+    // the next member may be stale as well, its descriptor set is bound on upload
+    if (!slotIdx) {
+        batch.descriptorSet = nullptr;
+    }
 }
 
 void BatchedBuffer::clear() {
+    if (_persistent) {
+        ++_stamp;
+        return;
+    }
+
     for (auto &batch : _batches) {
         batch.vbCount    = 0;
         batch.mergeCount = 0;
@@ -254,6 +448,57 @@ void BatchedBuffer::clear() {
     }
 }
 
+void BatchedBuffer::uploadBuffers(gfx::CommandBuffer *cmdBuff) {
+    for (auto &batch : _batches) {
+        if (!_persistent) {
+            if (!batch.mergeCount) continue;
+
+            auto i = 0U;
+            for (auto *vb : batch.vbs) {
+                cmdBuff->updateBuffer(vb, batch.vbDatas[i++], vb->getSize());
+                uploadStats.vertexBytes += vb->getSize();
+            }
+            cmdBuff->updateBuffer(batch.indexBuffer, batch.indexData, batch.indexBuffer->getSize());
+            cmdBuff->updateBuffer(batch.ubo, batch.uboData.data(), batch.ubo->getSize());
+            uploadStats.indexBytes += batch.indexBuffer->getSize();
+            uploadStats.uboBytes += batch.ubo->getSize();
+            continue;
+        }
+
+        // members not merged since the last clear left the batch
+        for (auto i = static_cast<uint>(batch.slots.size()); i-- > 0;) {
+            if (batch.slots[i].stamp != _stamp) {
+                removeSlot(batch, i);
+            }
+        }
+
+        if (!batch.descriptorSet && !batch.slots.empty()) {
+            batch.descriptorSet = batch.slots[0].descriptorSet;
+            batch.descriptorSet->bindBuffer(UBOLocalBatched::BINDING, batch.ubo);
+            batch.descriptorSet->update();
+        }
+
+        // buffers are updated from their start, so the dirty parts are prefixes
+        if (batch.dirtyVertexCount) {
+            for (uint i = 0; i < batch.vbs.size(); ++i) {
+                const uint size = batch.dirtyVertexCount * batch.vbs[i]->getStride();
+                cmdBuff->updateBuffer(batch.vbs[i], batch.vbDatas[i], size);
+                uploadStats.vertexBytes += size;
+            }
+            const uint indexSize = batch.dirtyVertexCount * sizeof(float);
+            cmdBuff->updateBuffer(batch.indexBuffer, batch.indexData, indexSize);
+            uploadStats.indexBytes += indexSize;
+            batch.dirtyVertexCount = 0;
+        }
+        if (batch.dirtyMatrixCount) {
+            const uint size = (UBOLocalBatched::MAT_WORLDS_OFFSET + batch.dirtyMatrixCount * 16) * sizeof(float);
+            cmdBuff->updateBuffer(batch.ubo, batch.uboData.data(), size);
+            uploadStats.uboBytes += size;
+            batch.dirtyMatrixCount = 0;
+        }
+    }
+}
+
 void BatchedBuffer::setDynamicOffset(uint idx, uint value) {
     _dynamicOffsets[idx] = value;
 }
@@ -27,6 +27,7 @@
 
 #include <array>
 #include "Define.h"
+#include "base/FlatHashMap.h"
 #include "scene/Model.h"
 #include "scene/Pass.h"
 #include "scene/SubModel.h"
@@ -34,7 +35,19 @@
 namespace cc {
 namespace pipeline {
 
+// A member of a persistent batch, its vertices start at vertexOffset in every vertex buffer.
+struct CC_DLL BatchedSlot {
+    const scene::SubModel *subModel      = nullptr;
+    const uint8_t *        flatData      = nullptr;
+    gfx::DescriptorSet *   descriptorSet = nullptr;
+    uint                   vertexOffset  = 0;
+    uint                   vertexCount   = 0;
+    uint                   stamp         = 0;
+};
+
 struct CC_DLL BatchedItem {
+    static constexpr uint NO_ITEM = ~0U;
+
     gfx::BufferList                           vbs;
     vector<uint8_t *>                         vbDatas;
     gfx::Buffer *                             indexBuffer = nullptr;
@@ -47,22 +60,70 @@ struct CC_DLL BatchedItem {
     gfx::DescriptorSet *                      descriptorSet = nullptr;
     const scene::Pass *                       pass          = nullptr;
     gfx::Shader *                             shader        = nullptr;
+    // persistent batching only: members in vertex order, and the leading vertices
+    // and world matrices which differ from the GPU copies
+    vector<BatchedSlot> slots;
+    uint                dirtyVertexCount = 0;
+    uint                dirtyMatrixCount = 0;
+    // the next batch of the same bucket, used once this one is full
+    uint next = NO_ITEM;
 };
 using BatchedItemList   = vector<BatchedItem>;
 using DynamicOffsetList = vector<uint>;
 
+// Sub models can share a batch if they have the same pass, shader and vertex buffer strides.
+struct CC_DLL BatchedBucketKey {
+    const scene::Pass *pass        = nullptr;
+    const gfx::Shader *shader      = nullptr;
+    uint               bufferCount = 0;
+    size_t             stridesHash = 0;
+
+    bool operator==(const BatchedBucketKey &rhs) const {
+        return pass == rhs.pass && shader == rhs.shader && bufferCount == rhs.bufferCount && stridesHash == rhs.stridesHash;
+    }
+};
+
+struct CC_DLL BatchedBucketKeyHasher {
+    size_t operator()(const BatchedBucketKey &key) const;
+};
+
+struct CC_DLL BatchedUploadStats {
+    uint vertexBytes = 0;
+    uint indexBytes  = 0;
+    uint uboBytes    = 0;
+
+    inline uint getTotalBytes() const { return vertexBytes + indexBytes + uboBytes; }
+};
+
 class CC_DLL BatchedBuffer : public Object {
 public:
     static BatchedBuffer *get(scene::Pass *pass);
     static BatchedBuffer *get(scene::Pass *pass, uint extraKey);
     static void           destroyBatchedBuffer();
 
+    /**
+     * Persistent batching keeps batches and their members across frames: only new, moved or
+     * removed members are written, and only the changed part of the buffers is uploaded.
+     * Applies to buffers created after the call.
+     *
+     * Removing a member moves the vertices of the members after it down and uploads the batch
+     * from there, which costs O(vertices of the batch) per removal. Members are stamped per
+     * clear and a buffer is shared by every camera rendering its pass, so cameras that see
+     * different members of a batch remove and merge them again on every camera switch.
+     */
+    static inline void setPersistentBatching(bool value) { persistentBatching = value; }
+    static inline bool isPersistentBatching() { return persistentBatching; }
+    // bytes uploaded by all batched buffers since the last reset, reset by the pipeline every frame
+    static inline const BatchedUploadStats &getUploadStats() { return uploadStats; }
+    static inline void                      resetUploadStats() { uploadStats = {}; }
+
     explicit BatchedBuffer(const scene::Pass *pass);
     ~BatchedBuffer() override;
 
     void destroy();
     void merge(const scene::SubModel *, uint passIdx, const scene::Model *);
     void clear();
+    void uploadBuffers(gfx::CommandBuffer *cmdBuff);
     void setDynamicOffset(uint idx, uint value);
 
     inline const BatchedItemList &getBatches() const { return _batches; }
@@ -70,11 +131,25 @@ public:
     inline const DynamicOffsetList &getDynamicOffset() const { return _dynamicOffsets; }
 
 private:
-    static map<scene::Pass *, map<uint, BatchedBuffer *>> buffers;
-    DynamicOffsetList                                     _dynamicOffsets;
-    BatchedItemList                                       _batches;
-    const scene::Pass *                                   _pass   = nullptr;
-    gfx::Device *                                         _device = nullptr;
+    uint         acquireBatch(const scene::SubModel *, uint passIdx, const scene::Model *, bool *isNew);
+    BatchedItem &createBatch(const scene::SubModel *, uint passIdx, const scene::Model *);
+    void         mergePersistent(const scene::SubModel *, uint passIdx, const scene::Model *);
+    void         appendSlot(BatchedItem &batch, uint batchIdx, const scene::SubModel *, uint passIdx, const scene::Model *);
+    void         removeSlot(BatchedItem &batch, uint slotIdx);
+
+    static FlatHashMap<PassBufferKey, BatchedBuffer *, PassBufferKeyHasher> buffers;
+    static bool                                                             persistentBatching;
+    static BatchedUploadStats                                               uploadStats;
+    DynamicOffsetList                                                       _dynamicOffsets;
+    BatchedItemList                                                         _batches;
+    // the first batch of each bucket
+    FlatHashMap<BatchedBucketKey, uint, BatchedBucketKeyHasher> _buckets;
+    const scene::Pass *                                         _pass       = nullptr;
+    gfx::Device *                                               _device     = nullptr;
+    bool                                                        _persistent = false;
+    // bumped by clear, members not merged again before the upload are removed
+    uint                                         _stamp = 0;
+    unordered_map<const scene::SubModel *, uint> _slotBatches;
 };
 
 } // namespace pipeline
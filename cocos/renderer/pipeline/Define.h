@@ -35,6 +35,9 @@
 #include "scene/Model.h"
 
 namespace cc {
+namespace scene {
+class Pass;
+}
 namespace pipeline {
 
 class RenderStage;
@@ -50,12 +53,29 @@ constexpr int JOINT_UNIFORM_CAPACITY = 30;
 constexpr float SHADOW_CAMERA_MAX_FAR    = 2000.0F;
 const float     COEFFICIENT_OF_EXPANSION = 2.0F * sqrtf(3.0F);
 
+// Default model count from which scene culling is split across the job system workers.
+constexpr uint PARALLEL_CULLING_THRESHOLD = 2048U;
+
 struct CC_DLL RenderObject {
     float               depth = 0;
     const scene::Model *model = nullptr;
 };
 using RenderObjectList = vector<struct RenderObject>;
 
+// Key of the per pass InstancedBuffer and BatchedBuffer singletons, extraKey tells lights apart.
+struct CC_DLL PassBufferKey {
+    const scene::Pass *pass     = nullptr;
+    uint               extraKey = 0;
+
+    bool operator==(const PassBufferKey &rhs) const { return pass == rhs.pass && extraKey == rhs.extraKey; }
+};
+
+struct CC_DLL PassBufferKeyHasher {
+    size_t operator()(const PassBufferKey &key) const {
+        return std::hash<const scene::Pass *>()(key.pass) ^ (static_cast<size_t>(key.extraKey) * 0x9E3779B9U);
+    }
+};
+
 struct CC_DLL RenderTargetInfo {
     uint width  = 0;
     uint height = 0;
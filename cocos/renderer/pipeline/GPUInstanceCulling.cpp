@@ -0,0 +1,308 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "GPUInstanceCulling.h"
+#include "InstancedBuffer.h"
+#include "base/StringUtil.h"
+#include "gfx-base/GFXBuffer.h"
+#include "gfx-base/GFXCommandBuffer.h"
+#include "gfx-base/GFXDescriptorSet.h"
+#include "gfx-base/GFXInputAssembler.h"
+
+namespace cc {
+namespace pipeline {
+
+GPUInstanceCulling::~GPUInstanceCulling() {
+    CC_SAFE_DESTROY(_resetShader);
+    CC_SAFE_DESTROY(_resetDescriptorSetLayout);
+    CC_SAFE_DESTROY(_resetPipelineLayout);
+    CC_SAFE_DESTROY(_resetPipelineState);
+
+    CC_SAFE_DESTROY(_cullingShader);
+    CC_SAFE_DESTROY(_cullingDescriptorSetLayout);
+    CC_SAFE_DESTROY(_cullingPipelineLayout);
+    CC_SAFE_DESTROY(_cullingPipelineState);
+}
+
+bool GPUInstanceCulling::isSupported(gfx::Device* dev) {
+    return dev->getGfxAPI() == gfx::API::VULKAN && dev->hasFeature(gfx::Feature::COMPUTE_SHADER) &&
+           dev->getCapabilities().maxComputeWorkGroupInvocations >= WORK_GROUP_SIZE;
+}
+
+void GPUInstanceCulling::initialize(gfx::Device* dev) {
+    _device = dev;
+    if (!isSupported(_device)) return;
+
+    _resetDispatchInfo = {1, 1, 1};
+
+    _readBarrier = _device->getGlobalBarrier({
+        {
+            gfx::AccessType::COMPUTE_SHADER_READ_UNIFORM_BUFFER,
+            gfx::AccessType::COMPUTE_SHADER_READ_OTHER,
+            gfx::AccessType::INDIRECT_BUFFER,
+            gfx::AccessType::VERTEX_BUFFER,
+        },
+        {
+            gfx::AccessType::TRANSFER_WRITE,
+        }});
+    _uploadBarrier = _device->getGlobalBarrier({
+        {
+            gfx::AccessType::TRANSFER_WRITE,
+        },
+        {
+            gfx::AccessType::COMPUTE_SHADER_READ_UNIFORM_BUFFER,
+            gfx::AccessType::COMPUTE_SHADER_READ_OTHER,
+        }});
+    _resetBarrier = _device->getGlobalBarrier({
+        {
+            gfx::AccessType::COMPUTE_SHADER_WRITE,
+        },
+        {
+            gfx::AccessType::COMPUTE_SHADER_READ_OTHER,
+        }});
+    _drawBarrier = _device->getGlobalBarrier({
+        {
+            gfx::AccessType::COMPUTE_SHADER_WRITE,
+        },
+        {
+            gfx::AccessType::INDIRECT_BUFFER,
+            gfx::AccessType::VERTEX_BUFFER,
+        }});
+
+    initResetStage();
+    initCullingStage();
+
+    _initialized = true;
+}
+
+void GPUInstanceCulling::initResetStage() {
+    String source = R"(
+        layout(set=0, binding=0, std430) buffer b_drawArgsBuffer { uint b_drawArgs[]; };
+        layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+        void main()
+        {
+            // instanceCount of both the indexed and non indexed argument layouts
+            b_drawArgs[1] = 0u;
+        })";
+
+    gfx::ShaderInfo shaderInfo;
+    shaderInfo.name    = "Compute ";
+    shaderInfo.stages  = {{gfx::ShaderStageFlagBit::COMPUTE, source}};
+    shaderInfo.buffers = {{0, 0, "b_drawArgsBuffer", 1, gfx::MemoryAccessBit::WRITE_ONLY}};
+    _resetShader       = _device->createShader(shaderInfo);
+
+    gfx::DescriptorSetLayoutInfo dslInfo;
+    dslInfo.bindings.push_back({0, gfx::DescriptorType::STORAGE_BUFFER, 1, gfx::ShaderStageFlagBit::COMPUTE});
+
+    _resetDescriptorSetLayout = _device->createDescriptorSetLayout(dslInfo);
+    _resetPipelineLayout      = _device->createPipelineLayout({{_resetDescriptorSetLayout}});
+
+    gfx::PipelineStateInfo pipelineInfo;
+    pipelineInfo.shader         = _resetShader;
+    pipelineInfo.pipelineLayout = _resetPipelineLayout;
+    pipelineInfo.bindPoint      = gfx::PipelineBindPoint::COMPUTE;
+
+    _resetPipelineState = _device->createPipelineState(pipelineInfo);
+}
+
+void GPUInstanceCulling::initCullingStage() {
+    String source = StringUtil::format(
+        R"(
+        layout(set=0, binding=0, std140) uniform CCInstanceCulling {
+            vec4 cc_frustumPlanes[6];
+            uvec4 cc_cullingParams; // instance count, stride in words
+        };
+        layout(set=0, binding=1, std430) readonly buffer b_boundsBuffer { vec4 b_bounds[]; };
+        layout(set=0, binding=2, std430) readonly buffer b_instancesBuffer { uint b_instances[]; };
+        layout(set=0, binding=3, std430) writeonly buffer b_visibleBuffer { uint b_visible[]; };
+        layout(set=0, binding=4, std430) buffer b_drawArgsBuffer { uint b_drawArgs[]; };
+        layout(local_size_x = %d, local_size_y = 1, local_size_z = 1) in;
+        void main()
+        {
+            uint index = gl_GlobalInvocationID.x;
+            if (index >= cc_cullingParams.x) {
+                return;
+            }
+            vec3 center = b_bounds[2u * index + 0u].xyz;
+            vec3 halfExtents = b_bounds[2u * index + 1u].xyz;
+            // same test as AABB::aabbFrustum, plane normals point to the inside
+            for (int i = 0; i < 6; i++) {
+                vec4 plane = cc_frustumPlanes[i];
+                if (dot(plane.xyz, center) + dot(halfExtents, abs(plane.xyz)) < plane.w) {
+                    return;
+                }
+            }
+            uint stride = cc_cullingParams.y;
+            uint src = index * stride;
+            uint dst = atomicAdd(b_drawArgs[1], 1u) * stride;
+            for (uint i = 0u; i < stride; i++) {
+                b_visible[dst + i] = b_instances[src + i];
+            }
+        })",
+        WORK_GROUP_SIZE);
+
+    gfx::ShaderInfo shaderInfo;
+    shaderInfo.name   = "Compute ";
+    shaderInfo.stages = {{gfx::ShaderStageFlagBit::COMPUTE, source}};
+    shaderInfo.blocks = {
+        {0, 0, "CCInstanceCulling", {{"cc_frustumPlanes", gfx::Type::FLOAT4, 6}, {"cc_cullingParams", gfx::Type::UINT4, 1}}, 1},
+    };
+    shaderInfo.buffers = {{0, 1, "b_boundsBuffer", 1, gfx::MemoryAccessBit::READ_ONLY},
+                          {0, 2, "b_instancesBuffer", 1, gfx::MemoryAccessBit::READ_ONLY},
+                          {0, 3, "b_visibleBuffer", 1, gfx::MemoryAccessBit::WRITE_ONLY},
+                          {0, 4, "b_drawArgsBuffer", 1, gfx::MemoryAccessBit::READ_WRITE}};
+    _cullingShader     = _device->createShader(shaderInfo);
+
+    gfx::DescriptorSetLayoutInfo dslInfo;
+    dslInfo.bindings.push_back({0, gfx::DescriptorType::UNIFORM_BUFFER, 1, gfx::ShaderStageFlagBit::COMPUTE});
+    dslInfo.bindings.push_back({1, gfx::DescriptorType::STORAGE_BUFFER, 1, gfx::ShaderStageFlagBit::COMPUTE});
+    dslInfo.bindings.push_back({2, gfx::DescriptorType::STORAGE_BUFFER, 1, gfx::ShaderStageFlagBit::COMPUTE});
+    dslInfo.bindings.push_back({3, gfx::DescriptorType::STORAGE_BUFFER, 1, gfx::ShaderStageFlagBit::COMPUTE});
+    dslInfo.bindings.push_back({4, gfx::DescriptorType::STORAGE_BUFFER, 1, gfx::ShaderStageFlagBit::COMPUTE});
+
+    _cullingDescriptorSetLayout = _device->createDescriptorSetLayout(dslInfo);
+    _cullingPipelineLayout      = _device->createPipelineLayout({{_cullingDescriptorSetLayout}});
+
+    gfx::PipelineStateInfo pipelineInfo;
+    pipelineInfo.shader         = _cullingShader;
+    pipelineInfo.pipelineLayout = _cullingPipelineLayout;
+    pipelineInfo.bindPoint      = gfx::PipelineBindPoint::COMPUTE;
+
+    _cullingPipelineState = _device->createPipelineState(pipelineInfo);
+}
+
+InstancedCullingData* GPUInstanceCulling::createCullingData(const gfx::InputAssemblerInfo& iaInfo, const gfx::DrawInfo& drawInfo, uint stride, uint capacity) {
+    auto* data   = CC_NEW(InstancedCullingData);
+    data->bounds = static_cast<float*>(CC_MALLOC(sizeof(float) * BOUNDS_FLOATS * capacity));
+    memset(data->bounds, 0, sizeof(float) * BOUNDS_FLOATS * capacity);
+
+    data->boundsBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::STORAGE | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::DEVICE,
+        static_cast<uint>(sizeof(float) * BOUNDS_FLOATS * capacity),
+        static_cast<uint>(sizeof(float) * BOUNDS_FLOATS),
+    });
+    data->visibleBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::STORAGE,
+        gfx::MemoryUsageBit::DEVICE,
+        stride * capacity,
+        stride,
+    });
+    data->constantsBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::UNIFORM | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::DEVICE,
+        static_cast<uint>(sizeof(_constants)),
+        static_cast<uint>(sizeof(_constants)),
+    });
+    // one draw, its instance count is written by the culling
+    data->drawArgsBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::INDIRECT | gfx::BufferUsageBit::STORAGE | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::DEVICE,
+        sizeof(gfx::DrawInfo),
+        sizeof(gfx::DrawInfo),
+    });
+    gfx::DrawInfo drawArgs = drawInfo;
+    drawArgs.firstInstance = 0;
+    data->drawArgsBuffer->update(&drawArgs, sizeof(drawArgs));
+
+    data->resetDescriptorSet = _device->createDescriptorSet({_resetDescriptorSetLayout});
+    data->resetDescriptorSet->bindBuffer(0, data->drawArgsBuffer);
+    data->resetDescriptorSet->update();
+
+    data->cullingDescriptorSet = _device->createDescriptorSet({_cullingDescriptorSetLayout});
+    data->cullingDescriptorSet->bindBuffer(0, data->constantsBuffer);
+    data->cullingDescriptorSet->bindBuffer(1, data->boundsBuffer);
+    data->cullingDescriptorSet->bindBuffer(2, iaInfo.vertexBuffers.back());
+    data->cullingDescriptorSet->bindBuffer(3, data->visibleBuffer);
+    data->cullingDescriptorSet->bindBuffer(4, data->drawArgsBuffer);
+    data->cullingDescriptorSet->update();
+
+    gfx::InputAssemblerInfo culledInfo = iaInfo;
+    culledInfo.vertexBuffers.back()    = data->visibleBuffer;
+    culledInfo.indirectBuffer          = data->drawArgsBuffer;
+    data->ia                           = _device->createInputAssembler(culledInfo);
+
+    return data;
+}
+
+void GPUInstanceCulling::destroyCullingData(InstancedCullingData* data) {
+    if (!data) return;
+
+    CC_SAFE_DESTROY(data->ia);
+    CC_SAFE_DESTROY(data->resetDescriptorSet);
+    CC_SAFE_DESTROY(data->cullingDescriptorSet);
+    CC_SAFE_DESTROY(data->boundsBuffer);
+    CC_SAFE_DESTROY(data->visibleBuffer);
+    CC_SAFE_DESTROY(data->drawArgsBuffer);
+    CC_SAFE_DESTROY(data->constantsBuffer);
+    CC_FREE(data->bounds);
+    CC_DELETE(data);
+}
+
+void GPUInstanceCulling::recordReadBarrier(gfx::CommandBuffer* cmdBuff) const {
+    cmdBuff->pipelineBarrier(_readBarrier);
+}
+
+void GPUInstanceCulling::cull(gfx::CommandBuffer* cmdBuff, const scene::Frustum& frustum, InstancedItem* const* items, uint count) {
+    if (!_initialized || !count) return;
+
+    for (uint i = 0; i < frustum.planes.size(); ++i) {
+        const auto& plane                     = frustum.planes[i];
+        _constants[PLANES_OFFSET + 4 * i + 0] = plane.n.x;
+        _constants[PLANES_OFFSET + 4 * i + 1] = plane.n.y;
+        _constants[PLANES_OFFSET + 4 * i + 2] = plane.n.z;
+        _constants[PLANES_OFFSET + 4 * i + 3] = plane.d;
+    }
+
+    recordReadBarrier(cmdBuff);
+    for (uint i = 0; i < count; ++i) {
+        const auto* item      = items[i];
+        const uint  params[4] = {item->count, item->stride / static_cast<uint>(sizeof(uint32_t)), 0, 0};
+        memcpy(_constants.data() + PARAMS_OFFSET, params, sizeof(params));
+        cmdBuff->updateBuffer(item->culling->constantsBuffer, _constants.data(), static_cast<uint>(sizeof(_constants)));
+    }
+    cmdBuff->pipelineBarrier(_uploadBarrier);
+
+    // reset the instance counts
+    cmdBuff->bindPipelineState(_resetPipelineState);
+    for (uint i = 0; i < count; ++i) {
+        cmdBuff->bindDescriptorSet(0, items[i]->culling->resetDescriptorSet);
+        cmdBuff->dispatch(_resetDispatchInfo);
+    }
+    cmdBuff->pipelineBarrier(_resetBarrier);
+
+    // cull and compact the instances
+    cmdBuff->bindPipelineState(_cullingPipelineState);
+    for (uint i = 0; i < count; ++i) {
+        auto* item = items[i];
+        cmdBuff->bindDescriptorSet(0, item->culling->cullingDescriptorSet);
+        cmdBuff->dispatch({(item->count + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE, 1, 1});
+        item->culling->culled = true;
+    }
+    cmdBuff->pipelineBarrier(_drawBarrier);
+}
+
+} // namespace pipeline
+} // namespace cc
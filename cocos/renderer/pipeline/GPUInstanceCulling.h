@@ -0,0 +1,115 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include "cocos/math/Vec4.h"
+#include "cocos/renderer/gfx-base/GFXDef.h"
+#include "cocos/renderer/gfx-base/GFXDevice.h"
+#include "cocos/renderer/pipeline/Define.h"
+#include "cocos/scene/Frustum.h"
+
+namespace cc {
+namespace pipeline {
+struct InstancedItem;
+struct InstancedCullingData;
+
+/**
+ * Frustum culling of instanced items on the GPU.
+ *
+ * The attributes and world bounds of the instances stay in device buffers which are only
+ * uploaded when they change. Each frame a compute pass tests the bounds against the camera
+ * frustum, copies the attributes of the visible instances to the instance stream of the
+ * item and counts them in the indirect draw arguments, the item is then drawn indirectly.
+ *
+ * Only the Vulkan backend reads indirect arguments written on the GPU, GLES backends
+ * replay a CPU copy of them, so the culling is not supported anywhere else and the
+ * shaders are only written in GLSL 4.
+ */
+class GPUInstanceCulling {
+public:
+    GPUInstanceCulling() = default;
+    ~GPUInstanceCulling();
+
+    static constexpr uint WORK_GROUP_SIZE = 64;
+    // floats of the world bounds of an instance: center and half extents, padded to vec4s
+    static constexpr uint BOUNDS_FLOATS = 8;
+
+    static bool isSupported(gfx::Device* dev);
+
+    void initialize(gfx::Device* dev);
+
+    /**
+     * Creates the buffers and descriptor sets to cull up to `capacity` instances of `stride` bytes.
+     * The last vertex buffer of iaInfo is the instance stream holding all instances, the culled
+     * input assembler reads the visible ones instead.
+     */
+    InstancedCullingData* createCullingData(const gfx::InputAssemblerInfo& iaInfo, const gfx::DrawInfo& drawInfo, uint stride, uint capacity);
+    static void           destroyCullingData(InstancedCullingData* data);
+
+    // Orders transfers to the culling buffers after the culling and draws recorded before.
+    void recordReadBarrier(gfx::CommandBuffer* cmdBuff) const;
+
+    // Records the culling of the items against the frustum, must be recorded outside render passes.
+    void cull(gfx::CommandBuffer* cmdBuff, const scene::Frustum& frustum, InstancedItem* const* items, uint count);
+
+    inline bool isInitialized() const { return _initialized; }
+
+private:
+    void initResetStage();
+
+    void initCullingStage();
+
+    gfx::Device* _device{nullptr};
+
+    gfx::Shader*              _resetShader{nullptr};
+    gfx::DescriptorSetLayout* _resetDescriptorSetLayout{nullptr};
+    gfx::PipelineLayout*      _resetPipelineLayout{nullptr};
+    gfx::PipelineState*       _resetPipelineState{nullptr};
+
+    gfx::Shader*              _cullingShader{nullptr};
+    gfx::DescriptorSetLayout* _cullingDescriptorSetLayout{nullptr};
+    gfx::PipelineLayout*      _cullingPipelineLayout{nullptr};
+    gfx::PipelineState*       _cullingPipelineState{nullptr};
+
+    static constexpr uint PLANES_OFFSET = 0;
+    static constexpr uint PARAMS_OFFSET = 24;
+
+    // 6 frustum planes, then the instance count and the stride in words
+    std::array<float, (7 * sizeof(Vec4)) / sizeof(float)> _constants{};
+
+    gfx::GlobalBarrier* _readBarrier{nullptr};
+    gfx::GlobalBarrier* _uploadBarrier{nullptr};
+    gfx::GlobalBarrier* _resetBarrier{nullptr};
+    gfx::GlobalBarrier* _drawBarrier{nullptr};
+
+    gfx::DispatchInfo _resetDispatchInfo;
+
+    bool _initialized{false};
+};
+
+} // namespace pipeline
+} // namespace cc
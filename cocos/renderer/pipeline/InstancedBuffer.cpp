@@ -24,7 +24,10 @@
 ****************************************************************************/
 
 #include "InstancedBuffer.h"
+#include <boost/functional/hash.hpp>
 #include "Define.h"
+#include "GPUInstanceCulling.h"
+#include "RenderPipeline.h"
 #include "gfx-base/GFXBuffer.h"
 #include "gfx-base/GFXCommandBuffer.h"
 #include "gfx-base/GFXDescriptorSet.h"
@@ -33,28 +36,63 @@
 
 namespace cc {
 namespace pipeline {
-map<scene::Pass *, map<uint, InstancedBuffer *>> InstancedBuffer::buffers;
-InstancedBuffer *                                InstancedBuffer::get(scene::Pass *pass) {
+namespace {
+// half extents of instances without world bounds, large enough to be never culled
+constexpr float UNBOUNDED_EXTENT = 1e30F;
+
+GPUInstanceCulling *getInstanceCulling() {
+    auto *pipeline = RenderPipeline::getInstance();
+    return pipeline ? pipeline->getInstanceCulling() : nullptr;
+}
+
+// Writes the world bounds of the model as the bounds of an instance, returns whether they changed.
+bool setInstanceBounds(float *dst, const scene::Model *model) {
+    float       bounds[GPUInstanceCulling::BOUNDS_FLOATS]{};
+    const auto *worldBounds = model->getWorldBounds();
+    if (worldBounds) {
+        const auto &center      = worldBounds->getCenter();
+        const auto &halfExtents = worldBounds->getHalfExtents();
+        bounds[0]               = center.x;
+        bounds[1]               = center.y;
+        bounds[2]               = center.z;
+        bounds[4]               = halfExtents.x;
+        bounds[5]               = halfExtents.y;
+        bounds[6]               = halfExtents.z;
+    } else {
+        bounds[4] = bounds[5] = bounds[6] = UNBOUNDED_EXTENT;
+    }
+    if (!memcmp(dst, bounds, sizeof(bounds))) return false;
+    memcpy(dst, bounds, sizeof(bounds));
+    return true;
+}
+} // namespace
+
+size_t InstancedBucketKeyHasher::operator()(const InstancedBucketKey &key) const {
+    size_t seed = 4;
+    boost::hash_combine(seed, key.indexBuffer);
+    boost::hash_combine(seed, key.lightingMap);
+    boost::hash_combine(seed, key.shader);
+    boost::hash_combine(seed, key.stride);
+    return seed;
+}
+
+FlatHashMap<PassBufferKey, InstancedBuffer *, PassBufferKeyHasher> InstancedBuffer::buffers;
+InstancedBuffer *                                                  InstancedBuffer::get(scene::Pass *pass) {
     return InstancedBuffer::get(pass, 0);
 }
 InstancedBuffer *InstancedBuffer::get(scene::Pass *pass, uint extraKey) {
-    auto &record = buffers[pass];
-    auto &buffer = record[extraKey];
+    auto &buffer = buffers[{pass, extraKey}];
     if (buffer == nullptr) buffer = CC_NEW(InstancedBuffer(pass));
 
     return buffer;
 }
 
 void InstancedBuffer::destroyInstancedBuffer() {
-    for (auto &pair : InstancedBuffer::buffers) {
-        const map<uint, InstancedBuffer *> &instanceItem = pair.second;
-        for (const auto &item : instanceItem) {
-            InstancedBuffer *instanceBuffer = item.second;
-            if (instanceBuffer) {
-                instanceBuffer->destroy();
-            }
+    InstancedBuffer::buffers.forEach([](const PassBufferKey & /*key*/, InstancedBuffer *instanceBuffer) {
+        if (instanceBuffer) {
+            instanceBuffer->destroy();
         }
-    }
+    });
     InstancedBuffer::buffers.clear();
 }
 
@@ -70,8 +108,11 @@ void InstancedBuffer::destroy() {
         CC_SAFE_DESTROY(instance.vb);
         CC_SAFE_DESTROY(instance.ia);
         CC_FREE(instance.data);
+        GPUInstanceCulling::destroyCullingData(instance.culling);
+        instance.culling = nullptr;
     }
     _instances.clear();
+    _buckets.clear();
 }
 
 void InstancedBuffer::merge(const scene::Model *model, const scene::SubModel *subModel, uint passIdx) {
@@ -91,40 +132,46 @@ void InstancedBuffer::merge(const scene::Model *model, const scene::SubModel *su
         shader = subModel->getShader(passIdx);
     }
 
-    for (auto &instance : _instances) {
-        if (instance.ia->getIndexBuffer() != sourceIA->getIndexBuffer() || instance.count >= MAX_CAPACITY) {
+    // items of a bucket are chained, the first one which is not full takes the instance
+    uint *item = _buckets.insert({sourceIA->getIndexBuffer(), lightingMap, shader, stride}, InstancedItem::NO_ITEM).first;
+    while (*item != InstancedItem::NO_ITEM) {
+        auto &instance = _instances[*item];
+        if (instance.count >= MAX_CAPACITY) {
+            item = &instance.next;
             continue;
         }
 
-        // check same binding
-        if (instance.lightingMap != lightingMap) {
-            continue;
-        }
-
-        if (instance.stride != stride) {
-            continue;
-        }
         if (instance.count >= instance.capacity) { // resize buffers
             instance.capacity <<= 1;
             const auto newSize = instance.stride * instance.capacity;
             instance.data      = static_cast<uint8_t *>(CC_REALLOC(instance.data, newSize));
             instance.vb->resize(newSize);
         }
-        if (instance.shader != shader) {
-            instance.shader = shader;
-        }
         if (instance.descriptorSet != descriptorSet) {
             instance.descriptorSet = descriptorSet;
         }
-        memcpy(instance.data + instance.stride * instance.count++, instancedBuffer, stride);
+        auto *dst = instance.data + instance.stride * instance.count;
+        if (instance.culling) {
+            // culled items keep their instances on the device, only changes are uploaded
+            auto *culling   = instance.culling;
+            bool  changed   = setInstanceBounds(culling->bounds + GPUInstanceCulling::BOUNDS_FLOATS * instance.count, model);
+            culling->dirty |= changed || instance.count >= culling->uploadedCount || memcmp(dst, instancedBuffer, stride);
+        }
+        memcpy(dst, instancedBuffer, stride);
+        ++instance.count;
         _hasPendingModels = true;
         return;
     }
 
-    // Create a new instance
-    auto  newSize = stride * INITIAL_CAPACITY;
+    // Create a new instance, items culled on the GPU are allocated at full capacity
+    auto *     culling   = getInstanceCulling();
+    const bool gpuCulled = culling && stride % sizeof(uint32_t) == 0;
+    const uint capacity  = gpuCulled ? MAX_CAPACITY : INITIAL_CAPACITY;
+    auto       usage     = gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST;
+    if (gpuCulled) usage |= gfx::BufferUsageBit::STORAGE;
+    auto  newSize = stride * capacity;
     auto *vb      = _device->createBuffer({
-        gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+        usage,
         gfx::MemoryUsageBit::DEVICE,
         static_cast<uint>(newSize),
         static_cast<uint>(stride),
@@ -148,18 +195,39 @@ void InstancedBuffer::merge(const scene::Model *model, const scene::SubModel *su
     auto *data = static_cast<uint8_t *>(CC_MALLOC(newSize));
     memcpy(data, instancedBuffer, stride);
     vertexBuffers.emplace_back(vb);
-    gfx::InputAssemblerInfo iaInfo = {attributes, vertexBuffers, indexBuffer};
-    auto *                  ia     = _device->createInputAssembler(iaInfo);
-    InstancedItem           item   = {1, INITIAL_CAPACITY, vb, data, ia, stride, shader, descriptorSet, lightingMap};
-    _instances.emplace_back(item);
+    gfx::InputAssemblerInfo iaInfo  = {attributes, vertexBuffers, indexBuffer};
+    auto *                  ia      = _device->createInputAssembler(iaInfo);
+    InstancedItem           newItem = {1, capacity, vb, data, ia, stride, shader, descriptorSet, lightingMap};
+    if (gpuCulled) {
+        newItem.culling = culling->createCullingData(iaInfo, sourceIA->getDrawInfo(), stride, capacity);
+        setInstanceBounds(newItem.culling->bounds, model);
+        newItem.culling->dirty = true;
+    }
+    *item = static_cast<uint>(_instances.size());
+    _instances.emplace_back(newItem);
     _hasPendingModels = true;
 }
 
 void InstancedBuffer::uploadBuffers(gfx::CommandBuffer *cmdBuff) {
+    bool readBarrierRecorded = false;
     for (auto &instance : _instances) {
         if (!instance.count) continue;
 
-        cmdBuff->updateBuffer(instance.vb, instance.data, instance.vb->getSize());
+        auto *culling = instance.culling;
+        if (!culling) {
+            cmdBuff->updateBuffer(instance.vb, instance.data, instance.vb->getSize());
+        } else if (culling->dirty) {
+            auto *gpuCulling = getInstanceCulling();
+            if (gpuCulling && !readBarrierRecorded) {
+                // the buffers may still be read by the culling of a previous camera
+                gpuCulling->recordReadBarrier(cmdBuff);
+                readBarrierRecorded = true;
+            }
+            cmdBuff->updateBuffer(instance.vb, instance.data, instance.stride * instance.count);
+            cmdBuff->updateBuffer(culling->boundsBuffer, culling->bounds, sizeof(float) * GPUInstanceCulling::BOUNDS_FLOATS * instance.count);
+            culling->uploadedCount = instance.count;
+            culling->dirty         = false;
+        }
         instance.ia->setInstanceCount(instance.count);
     }
 }
@@ -167,6 +235,7 @@ void InstancedBuffer::uploadBuffers(gfx::CommandBuffer *cmdBuff) {
 void InstancedBuffer::clear() {
     for (auto &instance : _instances) {
         instance.count = 0;
+        if (instance.culling) instance.culling->culled = false;
     }
     _hasPendingModels = false;
 }
@@ -26,6 +26,7 @@
 #pragma once
 
 #include "Define.h"
+#include "base/FlatHashMap.h"
 #include "scene/Model.h"
 #include "scene/Pass.h"
 #include "scene/SubModel.h"
@@ -41,7 +42,28 @@ struct PSOInfo;
     #undef INITIAL_CAPACITY
 #endif
 
+// Device side state of an item culled by GPUInstanceCulling.
+struct CC_DLL InstancedCullingData {
+    gfx::Buffer *        boundsBuffer         = nullptr;
+    gfx::Buffer *        visibleBuffer        = nullptr;
+    gfx::Buffer *        drawArgsBuffer       = nullptr;
+    gfx::Buffer *        constantsBuffer      = nullptr;
+    gfx::DescriptorSet * resetDescriptorSet   = nullptr;
+    gfx::DescriptorSet * cullingDescriptorSet = nullptr;
+    // draws the visible instances with the arguments written by the culling
+    gfx::InputAssembler *ia = nullptr;
+    // world bounds of the instances, GPUInstanceCulling::BOUNDS_FLOATS per instance
+    float *bounds = nullptr;
+    // instances in the device buffers, they are only uploaded again when they change
+    uint uploadedCount = 0;
+    bool dirty         = false;
+    // whether the item has been culled since it was last cleared
+    bool culled = false;
+};
+
 struct CC_DLL InstancedItem {
+    static constexpr uint NO_ITEM = ~0U;
+
     uint                 count         = 0;
     uint                 capacity      = 0;
     gfx::Buffer *        vb            = nullptr;
@@ -51,10 +73,30 @@ struct CC_DLL InstancedItem {
     gfx::Shader *        shader        = nullptr;
     gfx::DescriptorSet * descriptorSet = nullptr;
     gfx::Texture *       lightingMap   = nullptr;
+    // the next item of the same bucket, used once this one is full
+    uint next = NO_ITEM;
+    // set if the item is culled on the GPU, vb then holds all the instances
+    InstancedCullingData *culling = nullptr;
 };
 using InstancedItemList = vector<InstancedItem>;
 using DynamicOffsetList = vector<uint>;
 
+// Instances can share an item if they have the same geometry, lightmap, attributes and shader.
+struct CC_DLL InstancedBucketKey {
+    const gfx::Buffer * indexBuffer = nullptr;
+    const gfx::Texture *lightingMap = nullptr;
+    const gfx::Shader * shader      = nullptr;
+    uint                stride      = 0;
+
+    bool operator==(const InstancedBucketKey &rhs) const {
+        return indexBuffer == rhs.indexBuffer && lightingMap == rhs.lightingMap && shader == rhs.shader && stride == rhs.stride;
+    }
+};
+
+struct CC_DLL InstancedBucketKeyHasher {
+    size_t operator()(const InstancedBucketKey &key) const;
+};
+
 class InstancedBuffer : public Object {
 public:
     static constexpr uint   INITIAL_CAPACITY = 32;
@@ -74,17 +116,20 @@ public:
     void setDynamicOffset(uint idx, uint value);
 
     inline const InstancedItemList &getInstances() const { return _instances; }
+    inline InstancedItemList &      getInstances() { return _instances; }
     inline const scene::Pass *      getPass() const { return _pass; }
     inline bool                     hasPendingModels() const { return _hasPendingModels; }
     inline const DynamicOffsetList &dynamicOffsets() const { return _dynamicOffsets; }
 
 private:
-    static map<scene::Pass *, map<uint, InstancedBuffer *>> buffers;
-    InstancedItemList                                       _instances;
-    const scene::Pass *                                     _pass             = nullptr;
-    bool                                                    _hasPendingModels = false;
-    DynamicOffsetList                                       _dynamicOffsets;
-    gfx::Device *                                           _device = nullptr;
+    static FlatHashMap<PassBufferKey, InstancedBuffer *, PassBufferKeyHasher> buffers;
+    InstancedItemList                                                         _instances;
+    // the first item of each bucket
+    FlatHashMap<InstancedBucketKey, uint, InstancedBucketKeyHasher> _buckets;
+    const scene::Pass *                                             _pass             = nullptr;
+    bool                                                            _hasPendingModels = false;
+    DynamicOffsetList                                               _dynamicOffsets;
+    gfx::Device *                                                   _device = nullptr;
 };
 
 } // namespace pipeline
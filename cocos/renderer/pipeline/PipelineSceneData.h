@@ -57,6 +57,8 @@ public:
     inline void                                                                setDirShadowObjects(RenderObjectList &&ro) { _dirShadowObjects = std::forward<RenderObjectList>(ro); }
     inline const RenderObjectList &                                            getCastShadowObjects() const { return _castShadowObjects; }
     inline void                                                                setCastShadowObjects(RenderObjectList &&ro) { _castShadowObjects = std::forward<RenderObjectList>(ro); }
+    inline const RenderObjectList &                                            getGPUCulledObjects() const { return _gpuCulledObjects; }
+    inline void                                                                setGPUCulledObjects(RenderObjectList &&ro) { _gpuCulledObjects = std::forward<RenderObjectList>(ro); }
     inline const vector<const scene::Light*> &                                 getValidPunctualLights() const { return _validPunctualLights; }
     inline void                                                                setValidPunctualLights(vector<const scene::Light*> &&validPunctualLights) { _validPunctualLights = std::forward<vector<const scene::Light*>>(validPunctualLights); }
     inline float                                                               getShadowCameraFar() const { return _shadowCameraFar; }
@@ -67,11 +69,15 @@ public:
     inline void                                                                setMatShadowProj(const Mat4 &matShadowProj) { _matShadowProj = matShadowProj; }
     inline Mat4                                                                getMatShadowViewProj() const { return _matShadowViewProj; }
     inline void                                                                setMatShadowViewProj(const Mat4 &matShadowViewProj) { _matShadowViewProj = matShadowViewProj; }
+    inline uint                                                                getParallelCullingThreshold() const { return _parallelCullingThreshold; }
+    inline void                                                                setParallelCullingThreshold(uint threshold) { _parallelCullingThreshold = threshold; }
 
 private:
     RenderObjectList     _renderObjects;
     RenderObjectList     _dirShadowObjects;
     RenderObjectList     _castShadowObjects;
+    // instanced models outside the camera frustum, merged only into the GPU culled instanced queues
+    RenderObjectList     _gpuCulledObjects;
     vector<const scene::Light*> _validPunctualLights;
 
     scene::PipelineSharedSceneData *_sharedSceneData      = nullptr;
@@ -81,6 +87,8 @@ private:
     Mat4                            _matShadowView;
     Mat4                            _matShadowProj;
     Mat4                            _matShadowViewProj;
+    // Scenes with at least this many models are culled on the job system, 0 disables parallel culling.
+    uint _parallelCullingThreshold{PARALLEL_CULLING_THRESHOLD};
 
     std::unordered_map<const scene::Light *, gfx::Framebuffer *> _shadowFrameBufferMap;
 };
@@ -24,55 +24,129 @@
 ****************************************************************************/
 
 #include "PipelineStateManager.h"
+#include <boost/functional/hash.hpp>
 #include "gfx-base/GFXDef-common.h"
 #include "gfx-base/GFXDevice.h"
 
 namespace cc {
 namespace pipeline {
 
-unordered_map<size_t, gfx::PipelineState *> PipelineStateManager::psoHashMap;
+size_t PipelineStateKeyHasher::operator()(const PipelineStateKey &key) const {
+    size_t seed = 5;
+    boost::hash_combine(seed, key.passHash);
+    boost::hash_combine(seed, key.shaderID);
+    boost::hash_combine(seed, key.renderPassHash);
+    boost::hash_combine(seed, key.attributesHash);
+    boost::hash_combine(seed, key.subpass);
+    return seed;
+}
+
+PipelineStateManager::EntryList                                                                    PipelineStateManager::psoLRU;
+unordered_map<PipelineStateKey, PipelineStateManager::EntryList::iterator, PipelineStateKeyHasher> PipelineStateManager::psoHashMap;
+PipelineStateStats                                                                                 PipelineStateManager::stats;
+uint64_t                                                                                           PipelineStateManager::frameAge{0};
+uint32_t                                                                                           PipelineStateManager::psoCapacity{0};
+std::mutex                                                                                         PipelineStateManager::psoMutex;
+
+PipelineStateKey PipelineStateManager::getKey(const scene::Pass *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler, gfx::RenderPass *renderPass, uint subpass) {
+    return {pass->getHash(), shader->getTypedID(), renderPass->getHash(), inputAssembler->getAttributesHash(), subpass};
+}
+
+gfx::PipelineState *PipelineStateManager::createPipelineState(const scene::Pass *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler, gfx::RenderPass *renderPass, uint subpass) {
+    auto *pipelineLayout = pass->getPipelineLayout();
+
+    return gfx::Device::getInstance()->createPipelineState({shader,
+                                                            pipelineLayout,
+                                                            renderPass,
+                                                            {inputAssembler->getAttributes()},
+                                                            *(pass->getRasterizerState()),
+                                                            *(pass->getDepthStencilState()),
+                                                            *(pass->getBlendState()),
+                                                            pass->getPrimitive(),
+                                                            pass->getDynamicState(),
+                                                            gfx::PipelineBindPoint::GRAPHICS,
+                                                            subpass});
+}
 
 gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(const scene::Pass *  pass,
                                                                    gfx::Shader *        shader,
                                                                    gfx::InputAssembler *inputAssembler,
                                                                    gfx::RenderPass *    renderPass,
                                                                    uint                 subpass) {
-    const auto passHash       = pass->getHash();
-    const auto renderPassHash = renderPass->getHash();
-    const auto iaHash         = inputAssembler->getAttributesHash();
-    const auto shaderID       = shader->getTypedID();
-    auto       hash           = passHash ^ renderPassHash ^ iaHash ^ shaderID;
-    if (subpass != 0) {
-        hash = hash << subpass;
-    }
+    const auto key = getKey(pass, shader, inputAssembler, renderPass, subpass);
 
-    auto *pso = psoHashMap[hash];
-    if (!pso) {
-        auto *pipelineLayout = pass->getPipelineLayout();
-
-        pso = gfx::Device::getInstance()->createPipelineState({shader,
-                                                               pipelineLayout,
-                                                               renderPass,
-                                                               {inputAssembler->getAttributes()},
-                                                               *(pass->getRasterizerState()),
-                                                               *(pass->getDepthStencilState()),
-                                                               *(pass->getBlendState()),
-                                                               pass->getPrimitive(),
-                                                               pass->getDynamicState(),
-                                                               gfx::PipelineBindPoint::GRAPHICS,
-                                                               subpass});
-
-        psoHashMap[hash] = pso;
+    // also serializes the device calls of createPipelineState among recording threads
+    std::lock_guard<std::mutex> lock(psoMutex);
+    const auto                  iter = psoHashMap.find(key);
+    if (iter != psoHashMap.end()) {
+        ++stats.hits;
+        iter->second->lastUsedFrame = frameAge;
+        psoLRU.splice(psoLRU.begin(), psoLRU, iter->second);
+        return iter->second->pso;
     }
 
+    ++stats.misses;
+    auto *pso = createPipelineState(pass, shader, inputAssembler, renderPass, subpass);
+    psoLRU.push_front({key, pso, frameAge});
+    psoHashMap.emplace(key, psoLRU.begin());
+    stats.count = static_cast<uint32_t>(psoLRU.size());
+
     return pso;
 }
 
+void PipelineStateManager::warmUp(const vector<PipelineStateWarmUpInfo> &infos) {
+    std::lock_guard<std::mutex> lock(psoMutex);
+    for (const auto &info : infos) {
+        const auto key = getKey(info.pass, info.shader, info.inputAssembler, info.renderPass, info.subpass);
+        if (psoHashMap.count(key)) {
+            continue;
+        }
+
+        ++stats.warmedUp;
+        auto *pso = createPipelineState(info.pass, info.shader, info.inputAssembler, info.renderPass, info.subpass);
+        psoLRU.push_front({key, pso, frameAge});
+        psoHashMap.emplace(key, psoLRU.begin());
+    }
+    stats.count = static_cast<uint32_t>(psoLRU.size());
+}
+
+bool PipelineStateManager::isEvictable(const Entry &entry) {
+    // states used in the current frame are referenced by the command buffers being recorded,
+    // states used in the frames before may still be in flight.
+    return entry.lastUsedFrame != frameAge && frameAge - entry.lastUsedFrame >= EVICTION_MIN_UNUSED_FRAMES;
+}
+
+void PipelineStateManager::tick() {
+    std::lock_guard<std::mutex> lock(psoMutex);
+    if (psoCapacity) {
+        // the tail is the least recently used, stop at the first state that may still be in use
+        while (psoLRU.size() > psoCapacity && isEvictable(psoLRU.back())) {
+            auto &entry = psoLRU.back();
+            psoHashMap.erase(entry.key);
+            CC_SAFE_DESTROY(entry.pso);
+            psoLRU.pop_back();
+            ++stats.evictions;
+        }
+        stats.count = static_cast<uint32_t>(psoLRU.size());
+    }
+    // the current frame ends here
+    ++frameAge;
+}
+
+void PipelineStateManager::resetStats() {
+    std::lock_guard<std::mutex> lock(psoMutex);
+    stats       = {};
+    stats.count = static_cast<uint32_t>(psoLRU.size());
+}
+
 void PipelineStateManager::destroyAll() {
-    for (auto &pair : psoHashMap) {
-        CC_SAFE_DESTROY(pair.second);
+    std::lock_guard<std::mutex> lock(psoMutex);
+    for (auto &entry : psoLRU) {
+        CC_SAFE_DESTROY(entry.pso);
     }
+    psoLRU.clear();
     psoHashMap.clear();
+    stats.count = 0;
 }
 
 } // namespace pipeline
@@ -25,23 +25,94 @@
 
 #pragma once
 
+#include <mutex>
 #include "gfx-base/GFXDef.h"
 #include "scene/Pass.h"
 
 namespace cc {
 namespace pipeline {
 
+// Every component is kept and compared on its own, so states can only alias
+// if all of their component hashes match.
+struct CC_DLL PipelineStateKey {
+    uint32_t passHash{0};
+    uint32_t shaderID{0};
+    size_t   renderPassHash{0};
+    size_t   attributesHash{0};
+    uint     subpass{0};
+
+    bool operator==(const PipelineStateKey &rhs) const {
+        return passHash == rhs.passHash &&
+               shaderID == rhs.shaderID &&
+               renderPassHash == rhs.renderPassHash &&
+               attributesHash == rhs.attributesHash &&
+               subpass == rhs.subpass;
+    }
+};
+
+struct CC_DLL PipelineStateKeyHasher {
+    size_t operator()(const PipelineStateKey &key) const;
+};
+
+struct PipelineStateWarmUpInfo {
+    const scene::Pass *  pass{nullptr};
+    gfx::Shader *        shader{nullptr};
+    gfx::InputAssembler *inputAssembler{nullptr};
+    gfx::RenderPass *    renderPass{nullptr};
+    uint                 subpass{0};
+};
+
+struct PipelineStateStats {
+    uint32_t hits{0};
+    uint32_t misses{0};
+    uint32_t warmedUp{0};
+    uint32_t evictions{0};
+    uint32_t count{0};
+};
+
 class CC_DLL PipelineStateManager {
 public:
+    // Safe to call from render queues recorded into secondary command buffers on several threads.
     static gfx::PipelineState *getOrCreatePipelineState(const scene::Pass *  pass,
                                                         gfx::Shader *        shader,
                                                         gfx::InputAssembler *inputAssembler,
                                                         gfx::RenderPass *    renderPass,
                                                         uint                 subpass = 0);
+    // Pre-creates the pipeline states at load time to avoid first-frame hitches.
+    static void                warmUp(const vector<PipelineStateWarmUpInfo> &infos);
+    // Ends the current frame: evicts the least recently used states above capacity, then advances the frame age.
+    // Call it once per frame after all the render queues are recorded.
+    static void                tick();
     static void                destroyAll();
 
+    // Also exposed to JS as nr.PipelineStateManager.setCapacity/getCapacity.
+    // 0 means unlimited, states used in the current frame or within the last EVICTION_MIN_UNUSED_FRAMES frames are never evicted.
+    static inline void                      setCapacity(uint32_t capacity) { psoCapacity = capacity; }
+    static inline uint32_t                  getCapacity() { return psoCapacity; }
+    static inline const PipelineStateStats &getStats() { return stats; }
+    static void                             resetStats();
+
+    static constexpr uint32_t EVICTION_MIN_UNUSED_FRAMES = 60;
+
 private:
-    static unordered_map<size_t, gfx::PipelineState *> psoHashMap;
+    struct Entry {
+        PipelineStateKey    key;
+        gfx::PipelineState *pso{nullptr};
+        uint64_t            lastUsedFrame{0};
+    };
+    using EntryList = list<Entry>;
+
+    static bool                isEvictable(const Entry &entry);
+    static PipelineStateKey    getKey(const scene::Pass *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler, gfx::RenderPass *renderPass, uint subpass);
+    static gfx::PipelineState *createPipelineState(const scene::Pass *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler, gfx::RenderPass *renderPass, uint subpass);
+
+    // most recently used first
+    static EntryList                                                                    psoLRU;
+    static unordered_map<PipelineStateKey, EntryList::iterator, PipelineStateKeyHasher> psoHashMap;
+    static PipelineStateStats                                                           stats;
+    static uint64_t                                                                     frameAge;
+    static uint32_t                                                                     psoCapacity;
+    static std::mutex                                                                   psoMutex;
 };
 
 } // namespace pipeline
@@ -42,17 +42,7 @@ void RenderBatchedQueue::clear() {
 
 void RenderBatchedQueue::uploadBuffers(gfx::CommandBuffer *cmdBuffer) {
     for (auto *batchedBuffer : _queues) {
-        const auto &batches = batchedBuffer->getBatches();
-        for (const auto &batch : batches) {
-            if (!batch.mergeCount) continue;
-
-            auto i = 0U;
-            for (auto *vb : batch.vbs) {
-                cmdBuffer->updateBuffer(vb, batch.vbDatas[i++], vb->getSize());
-            }
-            cmdBuffer->updateBuffer(batch.indexBuffer, batch.indexData, batch.indexBuffer->getSize());
-            cmdBuffer->updateBuffer(batch.ubo, batch.uboData.data(), batch.ubo->getSize());
-        }
+        batchedBuffer->uploadBuffers(cmdBuffer);
     }
 }
 
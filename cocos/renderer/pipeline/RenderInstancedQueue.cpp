@@ -24,9 +24,11 @@
 ****************************************************************************/
 
 #include "RenderInstancedQueue.h"
+#include "GPUInstanceCulling.h"
 #include "InstancedBuffer.h"
 #include "PipelineStateManager.h"
 #include "gfx-base/GFXCommandBuffer.h"
+#include "scene/Camera.h"
 
 namespace cc {
 namespace pipeline {
@@ -46,6 +48,22 @@ void RenderInstancedQueue::uploadBuffers(gfx::CommandBuffer *cmdBuffer) {
     }
 }
 
+void RenderInstancedQueue::cullInstances(GPUInstanceCulling *culling, const scene::Camera *camera, gfx::CommandBuffer *cmdBuffer) {
+    if (!culling) return;
+
+    _culledItems.clear();
+    for (auto *instanceBuffer : _queues) {
+        if (!instanceBuffer->hasPendingModels()) continue;
+
+        for (auto &instance : instanceBuffer->getInstances()) {
+            if (instance.count && instance.culling) {
+                _culledItems.emplace_back(&instance);
+            }
+        }
+    }
+    culling->cull(cmdBuffer, camera->frustum, _culledItems.data(), static_cast<uint>(_culledItems.size()));
+}
+
 void RenderInstancedQueue::recordCommandBuffer(gfx::Device * /*device*/, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) {
     for (auto *instanceBuffer : _queues) {
         if (!instanceBuffer->hasPendingModels()) continue;
@@ -63,9 +81,11 @@ void RenderInstancedQueue::recordCommandBuffer(gfx::Device * /*device*/, gfx::Re
                 cmdBuffer->bindPipelineState(pso);
                 lastPSO = pso;
             }
+            // culled items draw the visible instances with the arguments written by the culling
+            auto *ia = instance.culling && instance.culling->culled ? instance.culling->ia : instance.ia;
             cmdBuffer->bindDescriptorSet(localSet, instance.descriptorSet, instanceBuffer->dynamicOffsets());
-            cmdBuffer->bindInputAssembler(instance.ia);
-            cmdBuffer->draw(instance.ia);
+            cmdBuffer->bindInputAssembler(ia);
+            cmdBuffer->draw(ia);
         }
     }
 }
@@ -35,9 +35,15 @@ class RenderPass;
 class CommandBuffer;
 } // namespace gfx
 
+namespace scene {
+struct Camera;
+} // namespace scene
+
 namespace pipeline {
 
+class GPUInstanceCulling;
 class InstancedBuffer;
+struct InstancedItem;
 
 class CC_DLL RenderInstancedQueue : public Object {
 public:
@@ -47,11 +53,14 @@ public:
     void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer);
     void add(InstancedBuffer *instancedBuffer);
     void uploadBuffers(gfx::CommandBuffer *cmdBuffer);
+    // Culls the items which support it against the camera on the GPU, after their buffers are uploaded.
+    void cullInstances(GPUInstanceCulling *culling, const scene::Camera *camera, gfx::CommandBuffer *cmdBuffer);
     void clear();
     bool empty() { return _queues.empty(); }
 
 private:
     unordered_set<InstancedBuffer *> _queues;
+    vector<InstancedItem *>          _culledItems;
 };
 
 } // namespace pipeline
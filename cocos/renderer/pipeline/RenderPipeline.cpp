@@ -27,6 +27,7 @@
 
 #include "InstancedBuffer.h"
 #include "BatchedBuffer.h"
+#include "GPUInstanceCulling.h"
 #include "PipelineStateManager.h"
 #include "RenderFlow.h"
 #include "RenderPipeline.h"
@@ -81,6 +82,11 @@ bool RenderPipeline::activate(gfx::Swapchain * /*swapchain*/) {
     _pipelineUBO->activate(_device, this);
     _pipelineSceneData->activate(_device, this);
 
+    if (GPUInstanceCulling::isSupported(_device)) {
+        _instanceCulling = CC_NEW(GPUInstanceCulling);
+        _instanceCulling->initialize(_device);
+    }
+
     // generate macros here rather than construct func because _clusterEnabled
     // switch may be changed in root.ts setRenderPipeline() function which is after
     // pipeline construct.
@@ -141,6 +147,7 @@ void RenderPipeline::destroy() {
     PipelineStateManager::destroyAll();
     BatchedBuffer::destroyBatchedBuffer();
     InstancedBuffer::destroyInstancedBuffer();
+    CC_SAFE_DELETE(_instanceCulling);
     framegraph::FrameGraph::gc(0);
 }
 
@@ -329,6 +336,8 @@ bool RenderPipeline::isOccluded(const scene::Camera *camera, const scene::SubMod
 }
 
 void RenderPipeline::framegraphGC() {
+    PipelineStateManager::tick();
+
     static uint64_t frameCount{0U};
     static constexpr uint32_t INTERVAL_IN_SECONDS = 30;
     if (++frameCount % (INTERVAL_IN_SECONDS * 60) == 0) {
@@ -49,6 +49,7 @@ class SubModel;
 namespace pipeline {
 class DefineMap;
 class GlobalDSManager;
+class GPUInstanceCulling;
 class RenderStage;
 
 struct CC_DLL RenderPipelineInfo {
@@ -116,6 +117,11 @@ public:
     inline bool getBloomEnabled() const { return _bloomEnabled; }
     inline void setBloomEnabled(bool enable) { _bloomEnabled = enable; }
 
+    inline bool getGPUCullingEnabled() const { return _gpuCullingEnabled; }
+    inline void setGPUCullingEnabled(bool enable) { _gpuCullingEnabled = enable; }
+    // Returns nullptr unless the GPU culling of instances is enabled and supported by the device.
+    inline GPUInstanceCulling *getInstanceCulling() const { return _gpuCullingEnabled ? _instanceCulling : nullptr; }
+
 protected:
     static RenderPipeline *instance;
 
@@ -138,6 +144,7 @@ protected:
     PipelineUBO *       _pipelineUBO{nullptr};
     scene::Model *      _profiler{nullptr};
     PipelineSceneData * _pipelineSceneData{nullptr};
+    GPUInstanceCulling *_instanceCulling{nullptr};
     // has not initBuiltinRes,
     // create temporary default Texture to binding sampler2d
     uint                                                          _width{0};
@@ -153,6 +160,8 @@ protected:
     bool _clusterEnabled{false};
     bool _bloomEnabled{false};
     bool _occlusionQueryEnabled{false};
+    // cull instanced items on the GPU or not
+    bool _gpuCullingEnabled{false};
 };
 
 } // namespace pipeline
@@ -25,6 +25,8 @@
 
 #include "RenderStage.h"
 #include "RenderQueue.h"
+#include "base/job-system/JobSystem.h"
+#include "gfx-base/GFXCommandBuffer.h"
 #include "gfx-base/GFXDevice.h"
 namespace cc {
 namespace pipeline {
@@ -55,6 +57,52 @@ void RenderStage::destroy() {
     }
     _renderQueues.clear();
     _renderQueueDescriptors.clear();
+
+    for (auto *cmdBuff : _secondaryCommandBuffers) {
+        CC_SAFE_DESTROY(cmdBuff);
+    }
+    _secondaryCommandBuffers.clear();
+}
+
+void RenderStage::recordRenderQueues(gfx::CommandBuffer *cmdBuff, gfx::RenderPass *renderPass, gfx::Framebuffer *framebuffer, const gfx::Rect &renderArea,
+                                     const gfx::Color *clearColors, float clearDepth, uint32_t clearStencil, uint32_t queueCount, const RecordQueueFunc &recordQueue) {
+    if (queueCount < 2U || JobSystem::getInstance()->threadCount() < 2U) {
+        cmdBuff->beginRenderPass(renderPass, framebuffer, renderArea, clearColors, clearDepth, clearStencil);
+        for (uint32_t i = 0; i < queueCount; ++i) {
+            recordQueue(i, cmdBuff);
+        }
+        cmdBuff->endRenderPass();
+        return;
+    }
+
+    // command buffers are created on the calling thread, the workers only ever record into them
+    while (_secondaryCommandBuffers.size() < queueCount) {
+        _secondaryCommandBuffers.emplace_back(_device->createCommandBuffer({_device->getQueue(), gfx::CommandBufferType::SECONDARY}));
+    }
+    auto *const secondaryCBs = _secondaryCommandBuffers.data();
+
+    // some backends bind the secondaries to the render pass when it begins, so it has to begin before they are recorded
+    cmdBuff->beginRenderPass(renderPass, framebuffer, renderArea, clearColors, clearDepth, clearStencil, secondaryCBs, queueCount);
+
+    const gfx::Viewport viewport{renderArea.x, renderArea.y, renderArea.width, renderArea.height};
+    auto                recordSecondary = [&](uint32_t i) {
+        auto *secondaryCB = secondaryCBs[i];
+        secondaryCB->begin(renderPass, 0, framebuffer);
+        secondaryCB->setViewport(viewport);
+        secondaryCB->setScissor(renderArea);
+        recordQueue(i, secondaryCB);
+        secondaryCB->end();
+    };
+
+    // the calling thread records the first queue while the workers handle the rest
+    JobGraph g(JobSystem::getInstance());
+    g.createForEachIndexJob(1U, queueCount, 1U, recordSecondary);
+    g.run();
+    recordSecondary(0U);
+    g.waitForAll();
+
+    cmdBuff->execute(secondaryCBs, queueCount);
+    cmdBuff->endRenderPass();
 }
 } // namespace pipeline
 } // namespace cc
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <functional>
 #include "Define.h"
 #include "scene/Camera.h"
 
@@ -64,6 +65,15 @@ public:
     inline RenderFlow *  getFlow() const { return _flow; }
 
 protected:
+    using RecordQueueFunc = std::function<void(uint32_t queueIndex, gfx::CommandBuffer *cmdBuff)>;
+
+    // Runs a render pass whose queues are recorded concurrently on the job system, each into a secondary
+    // command buffer of its own with the viewport and scissor set to the render area. recordQueue binds
+    // what the queue needs and records it, it is called from worker threads. With a single queue or
+    // without workers the queues are recorded inline into cmdBuff.
+    void recordRenderQueues(gfx::CommandBuffer *cmdBuff, gfx::RenderPass *renderPass, gfx::Framebuffer *framebuffer, const gfx::Rect &renderArea,
+                            const gfx::Color *clearColors, float clearDepth, uint32_t clearStencil, uint32_t queueCount, const RecordQueueFunc &recordQueue);
+
     gfx::Rect             _renderArea;
     // Generate quad ia, cannot be updated inside renderpass
     gfx::InputAssembler * _inputAssembler{nullptr};
@@ -76,6 +86,8 @@ protected:
     uint                  _priority    = 0;
     uint                  _tag         = 0;
     gfx::ColorList        _clearColors = {{0.0F, 0.0F, 0.0F, 0.0F}, {0.0F, 0.0F, 0.0F, 0.0F}, {0.0F, 0.0F, 0.0F, 0.0F}, {0.0F, 0.0F, 0.0F, 0.0F}};
+    // one for each queue of recordRenderQueues, only ever recorded by one thread at a time
+    gfx::CommandBufferList _secondaryCommandBuffers;
 };
 
 } // namespace pipeline
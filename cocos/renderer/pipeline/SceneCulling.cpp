@@ -23,21 +23,25 @@
  THE SOFTWARE.
 ****************************************************************************/
 
+#include <algorithm>
 #include <array>
 #include <vector>
 
 #include "Define.h"
 #include "RenderPipeline.h"
 #include "SceneCulling.h"
+#include "base/job-system/JobSystem.h"
 #include "gfx-base/GFXDevice.h"
 #include "math/Quaternion.h"
 #include "scene/AABB.h"
 #include "scene/Frustum.h"
 #include "scene/Light.h"
 #include "scene/Octree.h"
+#include "scene/Pass.h"
 #include "scene/RenderScene.h"
 #include "scene/Sphere.h"
 #include "scene/SpotLight.h"
+#include "scene/SubModel.h"
 
 namespace cc {
 namespace pipeline {
@@ -297,6 +301,197 @@ void quantizeDirLightShadowCamera(RenderPipeline *pipeline, const scene::Camera
     sceneData->setMatShadowProj(matShadowProj);
     sceneData->setMatShadowViewProj(matShadowViewProj);
 }
+namespace {
+bool isLayerVisible(const scene::Model *model, uint32_t visibility) {
+    const auto *const node = model->getNode();
+    return (node && ((visibility & node->getLayer()) == node->getLayer())) ||
+           (visibility & model->getVisFlags());
+}
+
+// Models only drawn instanced can be culled with their instances on the GPU when GPUInstanceCulling is enabled.
+bool isGPUCulled(const scene::Model *model) {
+    const auto stride = model->getInstancedBufferSize();
+    if (!stride || stride % sizeof(uint32_t) || model->getSubModels().empty()) {
+        return false;
+    }
+    for (const auto *subModel : model->getSubModels()) {
+        for (const auto *pass : subModel->getPasses()) {
+            if (pass->getBatchingScheme() != scene::BatchingSchemes::INSTANCING) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Models are frustum tested AABB_BATCH_SIZE at a time with AABB::aabbFrustumBatch, results keep the model order.
+void cullModelBatch(const SceneCullingInfo &ctx, const scene::Model *const *begin, const scene::Model *const *end, SceneCullingResult *out) {
+    const scene::Camera *camera        = ctx.camera;
+    const scene::Shadow *shadowInfo    = ctx.shadowInfo;
+    const auto           visibility    = camera->visibility;
+    const bool           testDirShadow = ctx.isShadowMap && !shadowInfo->fixedArea;
+
+    scene::AABBBatchBuffer<scene::AABB_BATCH_SIZE>    bounds;
+    std::array<uint32_t, scene::AABB_BATCH_SIZE / 32> cameraVisible{};
+    std::array<uint32_t, scene::AABB_BATCH_SIZE / 32> dirShadowVisible{};
+    for (const auto *const *iter = begin; iter != end; ++iter) {
+        const auto *model = *iter;
+        if (model->getEnabled() && model->getWorldBounds() && isLayerVisible(model, visibility)) {
+            bounds.push(*model->getWorldBounds());
+        }
+    }
+    scene::AABB::aabbFrustumBatch(bounds.batch(), camera->frustum, cameraVisible.data());
+    if (testDirShadow) {
+        scene::AABB::aabbFrustumBatch(bounds.batch(), *ctx.dirLightFrustum, dirShadowVisible.data());
+    }
+
+    scene::AABB ab;
+    uint32_t    boundsIndex = 0;
+    for (const auto *const *iter = begin; iter != end; ++iter) {
+        const auto *model = *iter;
+        // filter model by view visibility
+        if (!model->getEnabled()) {
+            continue;
+        }
+
+        // cast shadow render Object
+        if (model->getCastShadow()) {
+            out->castShadowObjects.emplace_back(genRenderObject(model, camera));
+        }
+
+        if (!isLayerVisible(model, visibility)) {
+            continue;
+        }
+
+        const auto *modelWorldBounds = model->getWorldBounds();
+        if (!modelWorldBounds) {
+            out->renderObjects.emplace_back(genRenderObject(model, camera));
+            continue;
+        }
+
+        const uint32_t index = boundsIndex++;
+
+        // dir shadow render Object
+        if (ctx.isShadowMap && model->getCastShadow()) {
+            if (shadowInfo->fixedArea) {
+                modelWorldBounds->transform(shadowInfo->matLight, &ab);
+                if (ab.aabbFrustum(camera->frustum)) {
+                    out->dirShadowObjects.emplace_back(genRenderObject(model, camera));
+                }
+            } else if (scene::getVisibilityBit(dirShadowVisible.data(), index)) {
+                out->dirShadowObjects.emplace_back(genRenderObject(model, camera));
+            }
+        }
+
+        // frustum culling, queues which do not cull on the GPU only see the visible models
+        if (scene::getVisibilityBit(cameraVisible.data(), index)) {
+            out->renderObjects.emplace_back(genRenderObject(model, camera));
+        } else if (ctx.gpuInstanceCulling && isGPUCulled(model)) {
+            out->gpuCulledObjects.emplace_back(genRenderObject(model, camera));
+        }
+    }
+}
+
+// Culls models in [begin, end). Only reads the scene, so disjoint ranges can be processed concurrently.
+void cullModels(const SceneCullingInfo &ctx, const scene::Model *const *begin, const scene::Model *const *end, SceneCullingResult *out) {
+    if (!ctx.useOctree) {
+        for (const auto *const *iter = begin; iter != end;) {
+            const auto *const *batchEnd = iter + std::min<std::ptrdiff_t>(end - iter, scene::AABB_BATCH_SIZE);
+            cullModelBatch(ctx, iter, batchEnd, out);
+            iter = batchEnd;
+        }
+        return;
+    }
+
+    const scene::Camera *camera     = ctx.camera;
+    const auto           visibility = camera->visibility;
+    for (const auto *const *iter = begin; iter != end; ++iter) {
+        const auto *model = *iter;
+        // filter model by view visibility
+        if (!model->getEnabled()) {
+            continue;
+        }
+
+        // cast shadow render Object
+        if (model->getCastShadow()) {
+            out->castShadowObjects.emplace_back(genRenderObject(model, camera));
+        }
+
+        // models with bounds are collected by the octree query
+        if (isLayerVisible(model, visibility) && !model->getWorldBounds() && ctx.skyBox->model != model) {
+            out->renderObjects.emplace_back(genRenderObject(model, camera));
+        }
+    }
+}
+
+template <typename T>
+void appendList(vector<T> *dst, const vector<T> &src) {
+    dst->insert(dst->end(), src.begin(), src.end());
+}
+
+// Per-chunk results, kept across frames so steady state culling does not reallocate.
+vector<SceneCullingResult> chunkResults;
+
+void cullModelsParallel(const SceneCullingInfo &ctx, const std::vector<scene::Model *> &models, uint chunkCount, SceneCullingResult *out) {
+    const auto  modelCount = static_cast<uint>(models.size());
+    const uint  chunkSize  = (modelCount - 1) / chunkCount + 1; // ceil(modelCount / chunkCount)
+    const auto *first      = models.data();
+
+    if (chunkResults.size() < chunkCount) {
+        chunkResults.resize(chunkCount);
+    }
+
+    auto cullChunk = [&](uint chunk) {
+        const uint begin = chunk * chunkSize;
+        const uint end   = std::min(begin + chunkSize, modelCount);
+        chunkResults[chunk].clear();
+        if (begin < end) {
+            cullModels(ctx, first + begin, first + end, &chunkResults[chunk]);
+        }
+    };
+
+    // the calling thread culls the first chunk while the workers handle the rest
+    JobGraph g(JobSystem::getInstance());
+    g.createForEachIndexJob(1U, chunkCount, 1U, cullChunk);
+    g.run();
+    cullChunk(0U);
+    g.waitForAll();
+
+    // merge in chunk order, which yields exactly the same order as the serial path
+    for (uint i = 0; i < chunkCount; ++i) {
+        const auto &chunk = chunkResults[i];
+        appendList(&out->renderObjects, chunk.renderObjects);
+        appendList(&out->castShadowObjects, chunk.castShadowObjects);
+        appendList(&out->dirShadowObjects, chunk.dirShadowObjects);
+        appendList(&out->gpuCulledObjects, chunk.gpuCulledObjects);
+    }
+}
+
+uint getCullingChunkCount(const PipelineSceneData *sceneData, size_t modelCount) {
+    const uint threshold = sceneData->getParallelCullingThreshold();
+    if (!threshold || modelCount < threshold) {
+        return 1U;
+    }
+
+    const uint threadCount = JobSystem::getInstance()->threadCount();
+    if (threadCount < 2U) {
+        return 1U;
+    }
+
+    // one chunk for each worker plus one for the calling thread, but never less than a threshold worth of models per chunk
+    const auto maxChunks = static_cast<uint>(modelCount / threshold) + 1U;
+    return std::min(threadCount + 1U, maxChunks);
+}
+} // namespace
+
+void cullSceneModels(const SceneCullingInfo &info, const std::vector<scene::Model *> &models, uint chunkCount, SceneCullingResult *out) {
+    if (chunkCount > 1U && !models.empty()) {
+        cullModelsParallel(info, models, chunkCount, out);
+    } else {
+        cullModels(info, models.data(), models.data() + models.size(), out);
+    }
+}
+
 void sceneCulling(RenderPipeline *pipeline, scene::Camera *camera) {
     PipelineSceneData *const              sceneData  = pipeline->getPipelineSceneData();
     const scene::PipelineSharedSceneData *sharedData = sceneData->getSharedData();
@@ -306,8 +501,7 @@ void sceneCulling(RenderPipeline *pipeline, scene::Camera *camera) {
     const scene::DirectionalLight *       mainLight  = scene->getMainLight();
     scene::Frustum                        dirLightFrustum;
 
-    RenderObjectList dirShadowObjects;
-    bool             isShadowMap = false;
+    bool isShadowMap = false;
     if (shadowInfo->enabled && shadowInfo->shadowType == scene::ShadowType::SHADOWMAP) {
         isShadowMap = true;
 
@@ -322,104 +516,57 @@ void sceneCulling(RenderPipeline *pipeline, scene::Camera *camera) {
         }
     }
 
-    RenderObjectList renderObjects;
-    RenderObjectList castShadowObject;
+    SceneCullingResult result;
 
     if (skyBox->enabled && skyBox->model && (camera->clearFlag & skyboxFlag)) {
-        renderObjects.emplace_back(genRenderObject(skyBox->model, camera));
+        result.renderObjects.emplace_back(genRenderObject(skyBox->model, camera));
     }
 
-    const scene::Octree *octree = scene->getOctree();
-    if (octree) {
-        for (const auto *model : scene->getModels()) {
-            // filter model by view visibility
-            if (model->getEnabled()) {
-                if (model->getCastShadow()) {
-                    castShadowObject.emplace_back(genRenderObject(model, camera));
-                }
+    const scene::IOctree *octree = scene->getOctree();
+    const auto &          models = scene->getModels();
 
-                const auto        visibility = camera->visibility;
-                const auto *const node       = model->getNode();
+    SceneCullingInfo ctx;
+    ctx.camera          = camera;
+    ctx.shadowInfo      = shadowInfo;
+    ctx.skyBox          = skyBox;
+    ctx.dirLightFrustum = &dirLightFrustum;
+    ctx.isShadowMap     = isShadowMap;
+    ctx.useOctree       = octree != nullptr;
 
-                if ((model->getNode() && ((visibility & node->getLayer()) == node->getLayer())) ||
-                    (visibility & model->getVisFlags())) {
-                    const auto *modelWorldBounds = model->getWorldBounds();
-                    if (!modelWorldBounds && skyBox->model != model) {
-                        renderObjects.emplace_back(genRenderObject(model, camera));
-                    }
-                }
-            }
-        }
+    // the octree query culls bounded models by itself
+    ctx.gpuInstanceCulling = !ctx.useOctree && pipeline->getInstanceCulling() != nullptr;
+
+    cullSceneModels(ctx, models, getCullingChunkCount(sceneData, models.size()), &result);
 
+    if (octree) {
         if (isShadowMap) {
             std::vector<scene::Model *> casters;
-            casters.reserve(scene->getModels().size() / 4);
+            casters.reserve(models.size() / 4);
             if (shadowInfo->fixedArea) {
                 octree->queryVisibility(camera, camera->frustum, true, casters);
             } else {
                 octree->queryVisibility(camera, dirLightFrustum, true, casters);
             }
             for (const auto *model : casters) {
-                dirShadowObjects.emplace_back(genRenderObject(model, camera));
+                result.dirShadowObjects.emplace_back(genRenderObject(model, camera));
             }
         }
 
-        std::vector<scene::Model *> models;
-        models.reserve(scene->getModels().size() / 4);
-        octree->queryVisibility(camera, camera->frustum, false, models);
-        for (const auto *model : models) {
-            renderObjects.emplace_back(genRenderObject(model, camera));
-        }
-    } else {
-        scene::AABB ab;
-        for (const auto *model : scene->getModels()) {
-            // filter model by view visibility
-            if (model->getEnabled()) {
-                const auto        visibility = camera->visibility;
-                const auto *const node       = model->getNode();
-
-                // cast shadow render Object
-                if (model->getCastShadow()) {
-                    castShadowObject.emplace_back(genRenderObject(model, camera));
-                }
-
-                if ((model->getNode() && ((visibility & node->getLayer()) == node->getLayer())) ||
-                    (visibility & model->getVisFlags())) {
-                    const auto *modelWorldBounds = model->getWorldBounds();
-                    if (!modelWorldBounds) {
-                        renderObjects.emplace_back(genRenderObject(model, camera));
-                        continue;
-                    }
-
-                    // dir shadow render Object
-                    if (isShadowMap && model->getCastShadow()) {
-                        if (shadowInfo->fixedArea) {
-                            model->getWorldBounds()->transform(shadowInfo->matLight, &ab);
-                            if (ab.aabbFrustum(camera->frustum)) {
-                                dirShadowObjects.emplace_back(genRenderObject(model, camera));
-                            }
-                        } else {
-                            if (modelWorldBounds->aabbFrustum(dirLightFrustum)) {
-                                dirShadowObjects.emplace_back(genRenderObject(model, camera));
-                            }
-                        }
-                    }
-
-                    // frustum culling
-                    if (modelWorldBounds->aabbFrustum(camera->frustum)) {
-                        renderObjects.emplace_back(genRenderObject(model, camera));
-                    }
-                }
-            }
+        std::vector<scene::Model *> visibleModels;
+        visibleModels.reserve(models.size() / 4);
+        octree->queryVisibility(camera, camera->frustum, false, visibleModels);
+        for (const auto *model : visibleModels) {
+            result.renderObjects.emplace_back(genRenderObject(model, camera));
         }
     }
 
     if (isShadowMap) {
-        sceneData->setDirShadowObjects(std::move(dirShadowObjects));
-        sceneData->setCastShadowObjects(std::move(castShadowObject));
+        sceneData->setDirShadowObjects(std::move(result.dirShadowObjects));
+        sceneData->setCastShadowObjects(std::move(result.castShadowObjects));
     }
 
-    sceneData->setRenderObjects(std::move(renderObjects));
+    sceneData->setRenderObjects(std::move(result.renderObjects));
+    sceneData->setGPUCulledObjects(std::move(result.gpuCulledObjects));
 }
 
 } // namespace pipeline
@@ -40,10 +40,38 @@ namespace pipeline {
 struct RenderObject;
 class RenderPipeline;
 
+struct SceneCullingInfo {
+    const scene::Camera * camera{nullptr};
+    const scene::Shadow * shadowInfo{nullptr};
+    const scene::Skybox * skyBox{nullptr};
+    const scene::Frustum *dirLightFrustum{nullptr};
+    bool                  isShadowMap{false};
+    bool                  useOctree{false};
+    bool                  gpuInstanceCulling{false};
+};
+
+struct SceneCullingResult {
+    RenderObjectList renderObjects;
+    RenderObjectList castShadowObjects;
+    RenderObjectList dirShadowObjects;
+    // instanced models outside the camera frustum, only merged by the queues culling instances on the GPU
+    RenderObjectList gpuCulledObjects;
+
+    void clear() {
+        renderObjects.clear();
+        castShadowObjects.clear();
+        dirShadowObjects.clear();
+        gpuCulledObjects.clear();
+    }
+};
+
 RenderObject genRenderObject(const scene::Model *, const scene::Camera *);
 void         quantizeDirLightShadowCamera(RenderPipeline *pipeline, const scene::Camera *camera, scene::Frustum *out);
 void         validPunctualLightsCulling(RenderPipeline *pipeline, scene::Camera *camera);
 void         sceneCulling(RenderPipeline *, scene::Camera *);
+// Culls the models of a scene, in chunkCount ranges culled on the job system when chunkCount > 1.
+// The lists are the same, in the same order, for any chunk count.
+void         cullSceneModels(const SceneCullingInfo &info, const std::vector<scene::Model *> &models, uint chunkCount, SceneCullingResult *out);
 void         updateSphereLight(scene::Shadow *shadows, const scene::Light *light, std::array<float, UBOShadow::COUNT> *);
 void         updateDirLight(scene::Shadow *shadows, const scene::Light *light, std::array<float, UBOShadow::COUNT> *);
 void         getShadowWorldMatrix(const scene::Sphere *sphere, const cc::Quaternion &rotation, const cc::Vec3 &dir, cc::Mat4 *shadowWorldMat, cc::Vec3 *out);
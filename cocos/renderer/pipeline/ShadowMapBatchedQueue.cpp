@@ -24,6 +24,7 @@
 ****************************************************************************/
 
 #include "ShadowMapBatchedQueue.h"
+#include <algorithm>
 #include "BatchedBuffer.h"
 #include "Define.h"
 #include "InstancedBuffer.h"
@@ -40,6 +41,11 @@
 
 namespace cc {
 namespace pipeline {
+namespace {
+// enough draws per part to outweigh the cost of a secondary command buffer
+constexpr size_t SUB_MODELS_PER_PART = 64;
+} // namespace
+
 ShadowMapBatchedQueue::ShadowMapBatchedQueue(RenderPipeline *pipeline)
 : _phaseID(getPhaseID("shadow-caster")) {
     _pipeline       = pipeline;
@@ -96,6 +102,10 @@ void ShadowMapBatchedQueue::gatherLightPasses(const scene::Camera *camera, const
             } break;
         }
     }
+
+    // upload once all models are merged, persistent batches drop the members not merged
+    _instancedQueue->uploadBuffers(cmdBuffer);
+    _batchedQueue->uploadBuffers(cmdBuffer);
 }
 
 void ShadowMapBatchedQueue::clear() {
@@ -106,7 +116,7 @@ void ShadowMapBatchedQueue::clear() {
     if (_batchedQueue) _batchedQueue->clear();
 }
 
-void ShadowMapBatchedQueue::add(const scene::Model *model, gfx::CommandBuffer *cmdBuffer) {
+void ShadowMapBatchedQueue::add(const scene::Model *model, gfx::CommandBuffer * /*cmdBuffer*/) {
     // this assumes light pass index is the same for all subModels
     const auto shadowPassIdx = getShadowPassIndex(model);
     if (shadowPassIdx == -1) {
@@ -131,16 +141,22 @@ void ShadowMapBatchedQueue::add(const scene::Model *model, gfx::CommandBuffer *c
             _passes.emplace_back(pass);
         }
     }
+}
 
-    _instancedQueue->uploadBuffers(cmdBuffer);
-    _batchedQueue->uploadBuffers(cmdBuffer);
+uint ShadowMapBatchedQueue::getRecordPartCount() const {
+    return 1 + static_cast<uint>((_subModels.size() + SUB_MODELS_PER_PART - 1) / SUB_MODELS_PER_PART);
 }
 
-void ShadowMapBatchedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) const {
-    _instancedQueue->recordCommandBuffer(device, renderPass, cmdBuffer);
-    _batchedQueue->recordCommandBuffer(device, renderPass, cmdBuffer);
+void ShadowMapBatchedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer, uint part) const {
+    if (part == 0) {
+        _instancedQueue->recordCommandBuffer(device, renderPass, cmdBuffer);
+        _batchedQueue->recordCommandBuffer(device, renderPass, cmdBuffer);
+        return;
+    }
 
-    for (size_t i = 0; i < _subModels.size(); i++) {
+    const size_t begin = (part - 1) * SUB_MODELS_PER_PART;
+    const size_t end   = std::min(begin + SUB_MODELS_PER_PART, _subModels.size());
+    for (size_t i = begin; i < end; i++) {
         const auto *const subModel = _subModels[i];
         auto *const       shader   = _shaders[i];
         const auto *      pass     = _passes[i];
@@ -49,7 +49,10 @@ public:
     void clear();
     void gatherLightPasses(const scene::Camera *, const scene::Light *, gfx::CommandBuffer *);
     void add(const scene::Model *, gfx::CommandBuffer *);
-    void recordCommandBuffer(gfx::Device *, gfx::RenderPass *, gfx::CommandBuffer *) const;
+    // Draws are recorded in parts that may go to separate command buffers: the instanced and batched
+    // queues first, then the other sub-models in fixed size chunks.
+    uint getRecordPartCount() const;
+    void recordCommandBuffer(gfx::Device *, gfx::RenderPass *, gfx::CommandBuffer *, uint part) const;
 
 private:
     int getShadowPassIndex(const scene::Model *model) const;
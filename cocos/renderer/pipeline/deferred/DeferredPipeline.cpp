@@ -24,6 +24,7 @@
 ****************************************************************************/
 
 #include "DeferredPipeline.h"
+#include "../BatchedBuffer.h"
 #include "../SceneCulling.h"
 #include "../shadow/ShadowFlow.h"
 #include "MainFlow.h"
@@ -87,10 +88,15 @@ bool DeferredPipeline::activate(gfx::Swapchain *swapchain) {
         return false;
     }
 
+    // the G-buffer and post-processing targets have short, mostly disjoint lifetimes
+    _fg.enableAliasing(true);
+
     return true;
 }
 
 void DeferredPipeline::render(const vector<scene::Camera *> &cameras) {
+    BatchedBuffer::resetUploadStats();
+
     auto *device               = gfx::Device::getInstance();
     bool  enableOcclusionQuery = getOcclusionQueryEnabled();
     if (enableOcclusionQuery) {
@@ -123,6 +123,20 @@ void GbufferStage::dispenseRenderObject2Queues() {
         }
     }
 
+    // instanced models outside the frustum keep their place in the GPU culled items
+    for (const auto &ro : _pipeline->getPipelineSceneData()->getGPUCulledObjects()) {
+        const auto *const model = ro.model;
+        for (const auto &subModel : model->getSubModels()) {
+            const auto &passes = subModel->getPasses();
+            for (uint passIdx = 0; passIdx < passes.size(); ++passIdx) {
+                if (passes[passIdx]->getPhase() != _phaseID) continue;
+                auto *instancedBuffer = InstancedBuffer::get(passes[passIdx]);
+                instancedBuffer->merge(model, subModel, passIdx);
+                _instancedQueue->add(instancedBuffer);
+            }
+        }
+    }
+
     for (auto *queue : _renderQueues) {
         queue->sort();
     }
@@ -228,6 +242,7 @@ void GbufferStage::render(scene::Camera *camera) {
     dispenseRenderObject2Queues();
     auto *cmdBuff = pipeline->getCommandBuffers()[0];
     _instancedQueue->uploadBuffers(cmdBuff);
+    _instancedQueue->cullInstances(_pipeline->getInstanceCulling(), camera, cmdBuff);
     _batchedQueue->uploadBuffers(cmdBuff);
 
     // if empty == true, gbuffer and lightig passes will be ignored
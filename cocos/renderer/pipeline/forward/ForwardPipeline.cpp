@@ -24,6 +24,7 @@
 ****************************************************************************/
 
 #include "ForwardPipeline.h"
+#include "../BatchedBuffer.h"
 #include "../SceneCulling.h"
 #include "../shadow/ShadowFlow.h"
 #include "ForwardFlow.h"
@@ -82,6 +83,8 @@ bool ForwardPipeline::activate(gfx::Swapchain *swapchain) {
 }
 
 void ForwardPipeline::render(const vector<scene::Camera *> &cameras) {
+    BatchedBuffer::resetUploadStats();
+
     auto *     device               = gfx::Device::getInstance();
     const bool enableOcclusionQuery = getOcclusionQueryEnabled();
     if (enableOcclusionQuery) {
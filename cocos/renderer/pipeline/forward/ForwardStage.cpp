@@ -127,6 +127,20 @@ void ForwardStage::dispenseRenderObject2Queues() {
         }
     }
 
+    // instanced models outside the frustum keep their place in the GPU culled items
+    for (const auto &ro : sceneData->getGPUCulledObjects()) {
+        const auto *const model = ro.model;
+        for (const auto &subModel : model->getSubModels()) {
+            const auto &passes = subModel->getPasses();
+            for (uint passIdx = 0; passIdx < passes.size(); ++passIdx) {
+                if (passes[passIdx]->getPhase() != _phaseID) continue;
+                auto *instancedBuffer = InstancedBuffer::get(passes[passIdx]);
+                instancedBuffer->merge(model, subModel, passIdx);
+                _instancedQueue->add(instancedBuffer);
+            }
+        }
+    }
+
     for (auto *queue : _renderQueues) {
         queue->sort();
     }
@@ -149,6 +163,7 @@ void ForwardStage::render(scene::Camera *camera) {
     pipeline->getPipelineUBO()->updateShadowUBO(camera);
 
     _instancedQueue->uploadBuffers(cmdBuff);
+    _instancedQueue->cullInstances(_pipeline->getInstanceCulling(), camera, cmdBuff);
     _batchedQueue->uploadBuffers(cmdBuff);
     _additiveLightQueue->gatherLightPasses(camera, cmdBuff);
     _planarShadowQueue->gatherShadowPasses(camera, cmdBuff);
@@ -78,14 +78,13 @@ void ShadowStage::render(scene::Camera *camera) {
     _clearColors[0]  = {1.0F, 1.0F, 1.0F, 1.0F};
     auto *renderPass = _framebuffer->getRenderPass();
 
-    cmdBuffer->beginRenderPass(renderPass, _framebuffer, _renderArea,
-                               _clearColors, camera->clearDepth, camera->clearStencil);
-
     const std::array<uint, 1> globalOffsets = {_pipeline->getPipelineUBO()->getCurrentCameraUBOOffset()};
-    cmdBuffer->bindDescriptorSet(globalSet, _globalDS, utils::toUint(globalOffsets.size()), globalOffsets.data());
-    _additiveShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuffer);
-
-    cmdBuffer->endRenderPass();
+    auto recordPart = [&](uint32_t part, gfx::CommandBuffer *cmdBuff) {
+        cmdBuff->bindDescriptorSet(globalSet, _globalDS, utils::toUint(globalOffsets.size()), globalOffsets.data());
+        _additiveShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuff, part);
+    };
+    recordRenderQueues(cmdBuffer, renderPass, _framebuffer, _renderArea, _clearColors.data(), camera->clearDepth, camera->clearStencil,
+                       _additiveShadowQueue->getRecordPartCount(), recordPart);
 }
 
 void ShadowStage::destroy() {
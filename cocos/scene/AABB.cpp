@@ -27,8 +27,191 @@
 
 #include "base/TypeDef.h"
 
+#if defined(__AVX__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
 namespace cc {
 namespace scene {
+
+namespace {
+// Same math as AABB::aabbPlane, -1 is returned when dot + r < plane.d
+inline bool isOutside(const AABBBatch &boxes, uint32_t i, const Plane &plane) {
+    const float r   = boxes.extentX[i] * std::abs(plane.n.x) + boxes.extentY[i] * std::abs(plane.n.y) + boxes.extentZ[i] * std::abs(plane.n.z);
+    const float dot = plane.n.x * boxes.centerX[i] + plane.n.y * boxes.centerY[i] + plane.n.z * boxes.centerZ[i];
+    return dot + r < plane.d;
+}
+
+inline uint32_t countBits(uint32_t mask) {
+    uint32_t count = 0;
+    for (; mask; mask &= mask - 1) {
+        ++count;
+    }
+    return count;
+}
+
+// Tests boxes [begin, count) one by one, returns visible count
+uint32_t aabbFrustumScalar(const AABBBatch &boxes, const Frustum &frustum, uint32_t begin, uint32_t *visibility) {
+    uint32_t visibleCount = 0;
+    for (uint32_t i = begin; i < boxes.count; ++i) {
+        const bool outside = std::any_of(frustum.planes.begin(), frustum.planes.end(),
+                                         [&](const Plane &plane) { return isOutside(boxes, i, plane); });
+        if (!outside) {
+            visibility[i / 32] |= 1U << (i % 32);
+            ++visibleCount;
+        }
+    }
+    return visibleCount;
+}
+
+#if defined(__AVX__)
+constexpr uint32_t BATCH_WIDTH = 8;
+
+uint32_t aabbFrustumSIMD(const AABBBatch &boxes, const Frustum &frustum, uint32_t *visibility) {
+    __m256 nx[6];
+    __m256 ny[6];
+    __m256 nz[6];
+    __m256 ax[6];
+    __m256 ay[6];
+    __m256 az[6];
+    __m256 d[6];
+    for (uint32_t p = 0; p < 6; ++p) {
+        const Plane &plane = frustum.planes[p];
+        nx[p]              = _mm256_set1_ps(plane.n.x);
+        ny[p]              = _mm256_set1_ps(plane.n.y);
+        nz[p]              = _mm256_set1_ps(plane.n.z);
+        ax[p]              = _mm256_set1_ps(std::abs(plane.n.x));
+        ay[p]              = _mm256_set1_ps(std::abs(plane.n.y));
+        az[p]              = _mm256_set1_ps(std::abs(plane.n.z));
+        d[p]               = _mm256_set1_ps(plane.d);
+    }
+
+    uint32_t       visibleCount = 0;
+    const uint32_t end          = boxes.count - boxes.count % BATCH_WIDTH;
+    for (uint32_t i = 0; i < end; i += BATCH_WIDTH) {
+        const __m256 cx      = _mm256_loadu_ps(boxes.centerX + i);
+        const __m256 cy      = _mm256_loadu_ps(boxes.centerY + i);
+        const __m256 cz      = _mm256_loadu_ps(boxes.centerZ + i);
+        const __m256 ex      = _mm256_loadu_ps(boxes.extentX + i);
+        const __m256 ey      = _mm256_loadu_ps(boxes.extentY + i);
+        const __m256 ez      = _mm256_loadu_ps(boxes.extentZ + i);
+        __m256       outside = _mm256_setzero_ps();
+        for (uint32_t p = 0; p < 6; ++p) {
+            const __m256 r   = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, ax[p]), _mm256_mul_ps(ey, ay[p])), _mm256_mul_ps(ez, az[p]));
+            const __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)), _mm256_mul_ps(nz[p], cz));
+            outside          = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(dot, r), d[p], _CMP_LT_OQ));
+        }
+        const auto mask = static_cast<uint32_t>(~_mm256_movemask_ps(outside)) & 0xFFU;
+        visibility[i / 32] |= mask << (i % 32);
+        visibleCount += countBits(mask);
+    }
+    return visibleCount + aabbFrustumScalar(boxes, frustum, end, visibility);
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+constexpr uint32_t BATCH_WIDTH = 4;
+
+uint32_t aabbFrustumSIMD(const AABBBatch &boxes, const Frustum &frustum, uint32_t *visibility) {
+    __m128 nx[6];
+    __m128 ny[6];
+    __m128 nz[6];
+    __m128 ax[6];
+    __m128 ay[6];
+    __m128 az[6];
+    __m128 d[6];
+    for (uint32_t p = 0; p < 6; ++p) {
+        const Plane &plane = frustum.planes[p];
+        nx[p]              = _mm_set1_ps(plane.n.x);
+        ny[p]              = _mm_set1_ps(plane.n.y);
+        nz[p]              = _mm_set1_ps(plane.n.z);
+        ax[p]              = _mm_set1_ps(std::abs(plane.n.x));
+        ay[p]              = _mm_set1_ps(std::abs(plane.n.y));
+        az[p]              = _mm_set1_ps(std::abs(plane.n.z));
+        d[p]               = _mm_set1_ps(plane.d);
+    }
+
+    uint32_t       visibleCount = 0;
+    const uint32_t end          = boxes.count - boxes.count % BATCH_WIDTH;
+    for (uint32_t i = 0; i < end; i += BATCH_WIDTH) {
+        const __m128 cx      = _mm_loadu_ps(boxes.centerX + i);
+        const __m128 cy      = _mm_loadu_ps(boxes.centerY + i);
+        const __m128 cz      = _mm_loadu_ps(boxes.centerZ + i);
+        const __m128 ex      = _mm_loadu_ps(boxes.extentX + i);
+        const __m128 ey      = _mm_loadu_ps(boxes.extentY + i);
+        const __m128 ez      = _mm_loadu_ps(boxes.extentZ + i);
+        __m128       outside = _mm_setzero_ps();
+        for (uint32_t p = 0; p < 6; ++p) {
+            const __m128 r   = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, ax[p]), _mm_mul_ps(ey, ay[p])), _mm_mul_ps(ez, az[p]));
+            const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)), _mm_mul_ps(nz[p], cz));
+            outside          = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dot, r), d[p]));
+        }
+        const auto mask = static_cast<uint32_t>(~_mm_movemask_ps(outside)) & 0xFU;
+        visibility[i / 32] |= mask << (i % 32);
+        visibleCount += countBits(mask);
+    }
+    return visibleCount + aabbFrustumScalar(boxes, frustum, end, visibility);
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+constexpr uint32_t BATCH_WIDTH = 4;
+
+uint32_t aabbFrustumSIMD(const AABBBatch &boxes, const Frustum &frustum, uint32_t *visibility) {
+    float32x4_t nx[6];
+    float32x4_t ny[6];
+    float32x4_t nz[6];
+    float32x4_t ax[6];
+    float32x4_t ay[6];
+    float32x4_t az[6];
+    float32x4_t d[6];
+    for (uint32_t p = 0; p < 6; ++p) {
+        const Plane &plane = frustum.planes[p];
+        nx[p]              = vdupq_n_f32(plane.n.x);
+        ny[p]              = vdupq_n_f32(plane.n.y);
+        nz[p]              = vdupq_n_f32(plane.n.z);
+        ax[p]              = vdupq_n_f32(std::abs(plane.n.x));
+        ay[p]              = vdupq_n_f32(std::abs(plane.n.y));
+        az[p]              = vdupq_n_f32(std::abs(plane.n.z));
+        d[p]               = vdupq_n_f32(plane.d);
+    }
+
+    const uint32_t   laneBits[4]  = {1U, 2U, 4U, 8U};
+    const uint32x4_t lanes        = vld1q_u32(laneBits);
+    uint32_t         visibleCount = 0;
+    const uint32_t   end          = boxes.count - boxes.count % BATCH_WIDTH;
+    for (uint32_t i = 0; i < end; i += BATCH_WIDTH) {
+        const float32x4_t cx      = vld1q_f32(boxes.centerX + i);
+        const float32x4_t cy      = vld1q_f32(boxes.centerY + i);
+        const float32x4_t cz      = vld1q_f32(boxes.centerZ + i);
+        const float32x4_t ex      = vld1q_f32(boxes.extentX + i);
+        const float32x4_t ey      = vld1q_f32(boxes.extentY + i);
+        const float32x4_t ez      = vld1q_f32(boxes.extentZ + i);
+        uint32x4_t        outside = vdupq_n_u32(0);
+        for (uint32_t p = 0; p < 6; ++p) {
+            const float32x4_t r   = vaddq_f32(vaddq_f32(vmulq_f32(ex, ax[p]), vmulq_f32(ey, ay[p])), vmulq_f32(ez, az[p]));
+            const float32x4_t dot = vaddq_f32(vaddq_f32(vmulq_f32(nx[p], cx), vmulq_f32(ny[p], cy)), vmulq_f32(nz[p], cz));
+            outside               = vorrq_u32(outside, vcltq_f32(vaddq_f32(dot, r), d[p]));
+        }
+        const uint32x4_t bits = vandq_u32(vmvnq_u32(outside), lanes);
+        const uint32x2_t sum  = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+        const uint32_t   mask = vget_lane_u32(vpadd_u32(sum, sum), 0);
+        visibility[i / 32] |= mask << (i % 32);
+        visibleCount += countBits(mask);
+    }
+    return visibleCount + aabbFrustumScalar(boxes, frustum, end, visibility);
+}
+#else
+uint32_t aabbFrustumSIMD(const AABBBatch &boxes, const Frustum &frustum, uint32_t *visibility) {
+    return aabbFrustumScalar(boxes, frustum, 0, visibility);
+}
+#endif
+} // namespace
+
+uint32_t AABB::aabbFrustumBatch(const AABBBatch &boxes, const Frustum &frustum, uint32_t *visibility) {
+    std::fill(visibility, visibility + (boxes.count + 31) / 32, 0U);
+    return aabbFrustumSIMD(boxes, frustum, visibility);
+}
 bool AABB::aabbAabb(AABB *aabb) const {
     Vec3 aMin;
     Vec3 aMax;
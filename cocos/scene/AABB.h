@@ -38,10 +38,34 @@ struct AABBLayout {
     cc::Vec3 center;
     cc::Vec3 halfExtents{1, 1, 1};
 };
+
+// A batch of boxes in structure of arrays
+struct AABBBatch {
+    const float *centerX{nullptr};
+    const float *centerY{nullptr};
+    const float *centerZ{nullptr};
+    const float *extentX{nullptr};
+    const float *extentY{nullptr};
+    const float *extentZ{nullptr};
+    uint32_t     count{0};
+};
+
+constexpr uint32_t AABB_BATCH_SIZE = 64; // boxes gathered on the stack for one aabbFrustumBatch call
+
+inline bool getVisibilityBit(const uint32_t *visibility, uint32_t index) {
+    return (visibility[index / 32] >> (index % 32)) & 1U;
+}
 class AABB final {
 public:
     static void fromPoints(const Vec3 &minPos, const Vec3 &maxPos, AABB *dst);
     static void transformExtentM4(Vec3 *out, const Vec3 &extent, const Mat4 &m4);
+    /**
+     * Batched version of aabbFrustum, using SSE/AVX or NEON when available.
+     * Bit (i % 32) of visibility[i / 32] is set if box i is (partially) inside,
+     * visibility must hold (count + 31) / 32 words.
+     * @return the number of visible boxes.
+     */
+    static uint32_t aabbFrustumBatch(const AABBBatch &boxes, const Frustum &frustum, uint32_t *visibility);
     AABB();
     AABB(const AABB &) = delete;
     AABB(AABB &&)      = delete;
@@ -82,5 +106,31 @@ private:
     bool        _isValid{true};
 };
 
+// Fixed capacity AABBBatch storage, to gather bounds without heap allocations
+template <uint32_t N>
+struct AABBBatchBuffer {
+    float    centerX[N];
+    float    centerY[N];
+    float    centerZ[N];
+    float    extentX[N];
+    float    extentY[N];
+    float    extentZ[N];
+    uint32_t count{0};
+
+    inline void push(const AABB &aabb) {
+        const Vec3 &center      = aabb.getCenter();
+        const Vec3 &halfExtents = aabb.getHalfExtents();
+        centerX[count]          = center.x;
+        centerY[count]          = center.y;
+        centerZ[count]          = center.z;
+        extentX[count]          = halfExtents.x;
+        extentY[count]          = halfExtents.y;
+        extentZ[count]          = halfExtents.z;
+        ++count;
+    }
+
+    inline AABBBatch batch() const { return {centerX, centerY, centerZ, extentX, extentY, extentZ, count}; }
+};
+
 } // namespace scene
 } // namespace cc
@@ -47,7 +47,7 @@ struct BakedJointInfo {
 };
 class BakedSkinningModel : public Model {
 public:
-    BakedSkinningModel()                           = default;
+    BakedSkinningModel() { _type = ModelType::BAKED_SKINNING; }
     BakedSkinningModel(const BakedSkinningModel &) = delete;
     BakedSkinningModel(BakedSkinningModel &&)      = delete;
     ~BakedSkinningModel() override                 = default;
@@ -74,7 +74,6 @@ public:
     }
 
 private:
-    ModelType      _type{ModelType::BAKED_SKINNING};
     BakedJointInfo _jointMedium;
     bool           _isUploadAnim{false};
     int32_t        _instAnimInfoIdx{-1};
@@ -0,0 +1,80 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "scene/CommandStream.h"
+#include "base/Log.h"
+#include "base/Macros.h"
+
+namespace cc {
+namespace scene {
+
+void CommandStream::registerCommand(uint16_t id, Handler handler, uint32_t elementSize) {
+    CC_ASSERT(id < MAX_COMMANDS && elementSize % sizeof(uint32_t) == 0);
+    _entries[id].handler     = handler;
+    _entries[id].elementSize = elementSize;
+}
+
+void CommandStream::resetBuffer(uint8_t *buffer) {
+    auto *header         = reinterpret_cast<StreamHeader *>(buffer);
+    header->version      = VERSION;
+    header->size         = sizeof(StreamHeader);
+    header->commandCount = 0;
+    header->reserved     = 0;
+}
+
+bool CommandStream::execute(uint8_t *buffer, uint32_t capacity) const {
+    auto *header = reinterpret_cast<StreamHeader *>(buffer);
+    if (header->commandCount == 0) return true;
+
+    bool valid = header->version == VERSION && header->size >= sizeof(StreamHeader) && header->size <= capacity;
+    if (!valid) {
+        CC_LOG_ERROR("CommandStream: rejected a buffer of version %u and %u bytes", header->version, header->size);
+    }
+
+    uint32_t offset = sizeof(StreamHeader);
+    for (uint32_t i = 0; valid && i < header->commandCount; ++i) {
+        if (header->size - offset < sizeof(CommandHeader)) {
+            CC_LOG_ERROR("CommandStream: command %u is past the end of the stream", i);
+            valid = false;
+            break;
+        }
+        const auto *command = reinterpret_cast<const CommandHeader *>(buffer + offset);
+        const auto  payload = static_cast<uint64_t>(command->count) * (command->id < MAX_COMMANDS ? _entries[command->id].elementSize : 0);
+        if (command->id >= MAX_COMMANDS || !_entries[command->id].handler || command->size % sizeof(uint32_t) != 0 ||
+            command->size > header->size - offset || payload + sizeof(CommandHeader) != command->size) {
+            CC_LOG_ERROR("CommandStream: malformed command %u of id %u", i, command->id);
+            valid = false;
+            break;
+        }
+        _entries[command->id].handler(command + 1, command->count);
+        offset += command->size;
+    }
+
+    resetBuffer(buffer);
+    return valid;
+}
+
+} // namespace scene
+} // namespace cc
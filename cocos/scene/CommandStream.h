@@ -0,0 +1,231 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace cc {
+namespace scene {
+
+class Node;
+class Model;
+struct Camera;
+class Light;
+class SphereLight;
+class SpotLight;
+class DirectionalLight;
+
+// A native pointer written by JS as 8 bytes at 4 byte alignment.
+template <class T>
+struct alignas(uint32_t) AlignedPtr {
+    char _data[8];
+    T *  get() const {
+        uint64_t address;
+        memcpy(&address, _data, sizeof(address));
+        return reinterpret_cast<T *>(static_cast<uintptr_t>(address));
+    }
+};
+
+/**
+ * Command ids of the scene command stream. Ids are part of the protocol shared with JS,
+ * new commands take new ids and changing a layout requires a new CommandStream::VERSION.
+ */
+enum class SceneCommand : uint16_t {
+    NODE_LOCAL_TRS = 1,
+    NODE_WORLD_MATRIX,
+    NODE_LAYER,
+    MODEL_ENABLED,
+    MODEL_SHADOWS,
+    MODEL_INST_MAT_WORLD_IDX,
+    MODEL_TRANSFORM,
+    CAMERA_VIEW,
+    CAMERA_MATRICES,
+    LIGHT_COLOR,
+    SPHERE_LIGHT,
+    SPOT_LIGHT,
+    DIRECTIONAL_LIGHT,
+    COUNT,
+};
+
+// Element layouts of the commands above, a command carries `count` of them back to back.
+namespace command {
+struct NodeLocalTRS {
+    AlignedPtr<Node> node;
+    float            position[3];
+    float            rotation[4];
+    float            scale[3];
+};
+struct NodeWorldMatrix {
+    AlignedPtr<Node> node;
+    float            matrix[16];
+};
+struct NodeLayer {
+    AlignedPtr<Node> node;
+    uint32_t         layer;
+};
+struct ModelEnabled {
+    AlignedPtr<Model> model;
+    uint32_t          enabled;
+};
+struct ModelShadows {
+    AlignedPtr<Model> model;
+    uint32_t          castShadow;
+    uint32_t          receiveShadow;
+};
+struct ModelInstMatWorldIdx {
+    AlignedPtr<Model> model;
+    int32_t           index;
+};
+struct ModelTransform {
+    AlignedPtr<Model> model;
+    AlignedPtr<Node>  node;
+    AlignedPtr<Node>  transform;
+};
+struct CameraView {
+    AlignedPtr<Camera> camera;
+    uint32_t           width;
+    uint32_t           height;
+    uint32_t           nearClip;
+    uint32_t           farClip;
+    uint32_t           clearFlag;
+    uint32_t           clearStencil;
+    uint32_t           visibility;
+    float              exposure;
+    float              clearDepth;
+    float              fov;
+    float              aspect;
+    float              viewPort[4];
+    float              clearColor[4];
+    float              forward[3];
+    float              position[3];
+};
+struct CameraMatrices {
+    AlignedPtr<Camera> camera;
+    float              matView[16];
+    float              matViewProj[16];
+    float              matViewProjInv[16];
+    float              matProj[16];
+    float              matProjInv[16];
+};
+struct LightColor {
+    AlignedPtr<Light> light;
+    float             color[3];
+    float             colorTemperatureRGB[3];
+    uint32_t          useColorTemperature;
+    uint32_t          baked;
+};
+struct SphereLightState {
+    AlignedPtr<SphereLight> light;
+    float                   position[3];
+    float                   size;
+    float                   range;
+    float                   luminanceHDR;
+    float                   luminanceLDR;
+};
+struct SpotLightState {
+    AlignedPtr<SpotLight> light;
+    float                 position[3];
+    float                 direction[3];
+    float                 size;
+    float                 range;
+    float                 angle;
+    float                 aspect;
+    float                 luminanceHDR;
+    float                 luminanceLDR;
+};
+struct DirectionalLightState {
+    AlignedPtr<DirectionalLight> light;
+    float                        direction[3];
+    float                        illuminanceHDR;
+    float                        illuminanceLDR;
+};
+static_assert(sizeof(NodeLocalTRS) == 48 && sizeof(CameraView) == 108 && sizeof(CameraMatrices) == 328, "command layouts are shared with JS");
+} // namespace command
+
+/**
+ * Runs commands written by JS into a shared buffer, in the order they were written.
+ *
+ * A buffer starts with a StreamHeader, followed by commands made of a CommandHeader and
+ * `count` elements of the layout registered for the id. Sizes are in bytes and 4 byte
+ * aligned. Handlers receive whole element arrays, so bulk updates cost one dispatch.
+ */
+class CommandStream final {
+public:
+    static constexpr uint32_t VERSION      = 1;
+    static constexpr uint32_t MAX_COMMANDS = 64;
+
+    struct StreamHeader {
+        uint32_t version;
+        // bytes in use, including this header
+        uint32_t size;
+        uint32_t commandCount;
+        uint32_t reserved;
+    };
+
+    struct CommandHeader {
+        uint16_t id;
+        uint16_t reserved;
+        uint32_t count;
+        // bytes of the command, including this header
+        uint32_t size;
+    };
+
+    using Handler = void (*)(const void *elements, uint32_t count);
+
+    void registerCommand(uint16_t id, Handler handler, uint32_t elementSize);
+
+    template <typename Element, void (*Fn)(const Element *, uint32_t)>
+    inline void registerCommand(SceneCommand id) {
+        registerCommand(static_cast<uint16_t>(id), &invoke<Element, Fn>, sizeof(Element));
+    }
+
+    // Writes an empty stream header to a buffer.
+    static void resetBuffer(uint8_t *buffer);
+
+    /**
+     * Runs the commands of the buffer and resets it.
+     * A buffer of another version or with a malformed command is rejected from that point,
+     * the commands before it have already run.
+     */
+    bool execute(uint8_t *buffer, uint32_t capacity) const;
+
+private:
+    template <typename Element, void (*Fn)(const Element *, uint32_t)>
+    static void invoke(const void *elements, uint32_t count) {
+        Fn(static_cast<const Element *>(elements), count);
+    }
+
+    struct Entry {
+        Handler  handler{nullptr};
+        uint32_t elementSize{0};
+    };
+    Entry _entries[MAX_COMMANDS];
+};
+
+} // namespace scene
+} // namespace cc
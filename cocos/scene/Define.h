@@ -114,6 +114,7 @@ struct OctreeInfo {
     Vec3     minPos;
     Vec3     maxPos;
     uint32_t depth{0};
+    bool     linear{false}; // use the pointer free LinearOctree backend
 };
 
 struct PipelineSharedSceneData {
@@ -0,0 +1,469 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos.com
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+ 
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "LinearOctree.h"
+#include <algorithm>
+#include "base/Log.h"
+#include "scene/Camera.h"
+#include "scene/Model.h"
+
+namespace cc {
+namespace scene {
+
+constexpr uint32_t LinearOctree::INVALID_INDEX;
+constexpr uint32_t LinearOctree::ROOT_CODE;
+constexpr uint32_t LinearOctree::ROOT_INDEX;
+constexpr uint32_t LinearOctree::PAGE_BITS;
+constexpr uint32_t LinearOctree::PAGE_SIZE;
+
+bool LinearOctree::Cell::hasChildren() const {
+    return std::any_of(children.begin(), children.end(), [](uint32_t child) { return child != INVALID_INDEX; });
+}
+
+LinearOctree::LinearOctree(const Vec3& minPos, const Vec3& maxPos, uint32_t maxDepth) {
+    reset(minPos, maxPos, maxDepth);
+}
+
+LinearOctree::~LinearOctree() = default;
+
+void LinearOctree::reset(const Vec3& minPos, const Vec3& maxPos, uint32_t maxDepth) {
+    _cells.clear();
+    _freeCells.clear();
+    _slots.clear();
+    _freeSlots.clear();
+    if (maxDepth > LINEAR_OCTREE_MAX_DEPTH) {
+        CC_LOG_WARNING("LinearOctree: depth %u is clamped to %u, use the pointer based Octree for deeper trees.", maxDepth, LINEAR_OCTREE_MAX_DEPTH);
+    }
+    _maxDepth = clampDepth(maxDepth);
+
+    // cells of depth 0 to _maxDepth - 1 take (8 ^ _maxDepth - 1) / 7 codes
+    const uint32_t codeCount = ((1U << (3 * _maxDepth)) - 1) / 7;
+    _cellPages.clear();
+    _cellPages.resize((codeCount + PAGE_SIZE - 1) >> PAGE_BITS);
+
+    const Vec3     expand{OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE};
+    const uint32_t root = allocCell();
+    Cell&          cell = _cells[root];
+    cell.code           = ROOT_CODE;
+    cell.min            = minPos - expand;
+    cell.max            = maxPos;
+    setCell(ROOT_CODE, 0, root);
+}
+
+void LinearOctree::resize(const Vec3& minPos, const Vec3& maxPos, uint32_t maxDepth) {
+    const Vec3  expand{OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE};
+    const Cell& root = _cells[ROOT_INDEX];
+    if ((minPos - expand) == root.min && maxPos == root.max && clampDepth(maxDepth) == _maxDepth) {
+        return;
+    }
+
+    std::vector<Model*> models;
+    for (const auto& cell : _cells) {
+        models.insert(models.end(), cell.models.begin(), cell.models.end());
+    }
+
+    reset(minPos, maxPos, maxDepth);
+
+    for (auto* model : models) {
+        model->setOctreeHandle(IndexHandle<uint32_t>());
+        insert(model);
+    }
+}
+
+void LinearOctree::insert(Model* model) {
+    CCASSERT(model, "Octree insert: model is nullptr.");
+
+    const AABB* bounds = model->getWorldBounds();
+    if (!bounds) {
+        return;
+    }
+
+    const auto handle = model->getOctreeHandle();
+    if (!isInside(model)) {
+        CC_LOG_WARNING("Octree insert: model is outside of the scene bounding box, please modify DEFAULT_WORLD_MIN_POS and DEFAULT_WORLD_MAX_POS.");
+        // the model stays in its last cell, but is still tested with its latest bounds
+        if (handle.isValid()) {
+            writeBounds(_slots[handle], *bounds);
+        }
+        return;
+    }
+
+    uint32_t       depth = 0;
+    const uint32_t code  = findTargetCode(BBox(*bounds), &depth);
+
+    if (!handle.isValid()) {
+        const uint32_t slot = allocSlot();
+        model->setOctreeHandle(IndexHandle<uint32_t>(slot));
+        addToCell(getOrCreateCell(code, depth), model, slot);
+        return;
+    }
+
+    if (_cells[_slots[handle].cell].code == code) {
+        writeBounds(_slots[handle], *bounds);
+        return;
+    }
+
+    // add before removing, so that cells shared by both paths are not pruned and recreated
+    const Slot     last      = _slots[handle];
+    const uint32_t cellIndex = getOrCreateCell(code, depth);
+    addToCell(cellIndex, model, handle);
+    removeFromCell(last);
+    pruneCell(last.cell);
+}
+
+void LinearOctree::remove(Model* model) {
+    CCASSERT(model, "Octree remove: model is nullptr.");
+
+    const auto handle = model->getOctreeHandle();
+    if (!handle.isValid()) {
+        return;
+    }
+
+    const Slot slot = _slots[handle];
+    removeFromCell(slot);
+    pruneCell(slot.cell);
+
+    _slots[handle] = Slot();
+    _freeSlots.push_back(handle);
+    model->setOctreeHandle(IndexHandle<uint32_t>());
+}
+
+void LinearOctree::update(Model* model) {
+    const auto  handle = model->getOctreeHandle();
+    const AABB* bounds = model->getWorldBounds();
+    if (!handle.isValid() || !bounds) {
+        insert(model);
+        return;
+    }
+
+    // O(1) path: the model still fits its cell and does not fit the child it would descend into
+    const Slot& slot = _slots[handle];
+    const Cell& cell = _cells[slot.cell];
+    const BBox  modelBox(*bounds);
+    if (BBox(cell.min, cell.max).contain(modelBox)) {
+        bool stays = cell.depth + 1 >= _maxDepth;
+        if (!stays) {
+            const cc::Vec3 modelCenter = modelBox.getCenter();
+            const cc::Vec3 cellCenter  = (cell.min + cell.max) * 0.5F;
+
+            uint32_t index = modelCenter.x < cellCenter.x ? 0 : 1;
+            index += modelCenter.y < cellCenter.y ? 0 : 2;
+            index += modelCenter.z < cellCenter.z ? 0 : 4;
+
+            stays = !getChildBox(cell.min, cell.max, index).contain(modelBox);
+        }
+
+        if (stays) {
+            writeBounds(slot, *bounds);
+            return;
+        }
+    }
+
+    insert(model);
+}
+
+void LinearOctree::queryVisibility(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const {
+    AABB box;
+    _cellStack.clear();
+    _cellStack.push_back(ROOT_INDEX);
+
+    while (!_cellStack.empty()) {
+        const Cell& cell = _cells[_cellStack.back()];
+        _cellStack.pop_back();
+
+        AABB::fromPoints(cell.min, cell.max, &box);
+        if (!box.aabbFrustum(frustum)) {
+            continue;
+        }
+
+        queryCell(cell, camera, frustum, isShadow, results);
+
+        // push in reverse, so children are visited in the same order as Octree
+        for (auto iter = cell.children.rbegin(); iter != cell.children.rend(); ++iter) {
+            if (*iter != INVALID_INDEX) {
+                _cellStack.push_back(*iter);
+            }
+        }
+    }
+}
+
+void LinearOctree::queryCell(const Cell& cell, const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const {
+    const size_t count = cell.models.size();
+    if (!count) {
+        return;
+    }
+
+    const AABBBatch boxes{cell.centerX.data(), cell.centerY.data(), cell.centerZ.data(),
+                          cell.extentX.data(), cell.extentY.data(), cell.extentZ.data(), static_cast<uint32_t>(count)};
+    _visible.resize((count + 31) / 32);
+    if (!AABB::aabbFrustumBatch(boxes, frustum, _visible.data())) {
+        return;
+    }
+
+    const auto visibility = camera->visibility;
+    for (size_t i = 0; i < count; ++i) {
+        if (!getVisibilityBit(_visible.data(), static_cast<uint32_t>(i))) {
+            continue;
+        }
+
+        Model* model = cell.models[i];
+        if (!model->getEnabled()) {
+            continue;
+        }
+
+        const auto* node = model->getNode();
+        if ((node && ((visibility & node->getLayer()) == node->getLayer())) ||
+            (visibility & model->getVisFlags())) {
+            if (!isShadow || model->getCastShadow()) {
+                results.push_back(model);
+            }
+        }
+    }
+}
+
+bool LinearOctree::isInside(Model* model) const {
+    const Cell& root = _cells[ROOT_INDEX];
+    return BBox(root.min, root.max).contain(BBox(*model->getWorldBounds()));
+}
+
+uint32_t LinearOctree::findTargetCode(const BBox& modelBox, uint32_t* depth) const {
+    const Cell&    root        = _cells[ROOT_INDEX];
+    const cc::Vec3 modelCenter = modelBox.getCenter();
+    cc::Vec3       min         = root.min;
+    cc::Vec3       max         = root.max;
+    uint32_t       code        = ROOT_CODE;
+
+    // descend exactly like OctreeNode::insert
+    *depth = 0;
+    while (*depth + 1 < _maxDepth) {
+        const cc::Vec3 cellCenter = (min + max) * 0.5F;
+
+        uint32_t index = modelCenter.x < cellCenter.x ? 0 : 1;
+        index += modelCenter.y < cellCenter.y ? 0 : 2;
+        index += modelCenter.z < cellCenter.z ? 0 : 4;
+
+        const BBox childBox = getChildBox(min, max, index);
+        if (!childBox.contain(modelBox)) {
+            break;
+        }
+
+        code = (code << 3) | index;
+        min  = childBox.min;
+        max  = childBox.max;
+        ++(*depth);
+    }
+
+    return code;
+}
+
+uint32_t LinearOctree::getOrCreateCell(uint32_t code, uint32_t depth) {
+    const uint32_t found = findCell(code, depth);
+    if (found != INVALID_INDEX) {
+        return found;
+    }
+
+    // create the missing cells along the path from the root
+    uint32_t current = ROOT_INDEX;
+    for (uint32_t level = 1; level <= depth; ++level) {
+        const uint32_t index = (code >> (3 * (depth - level))) & 0x7;
+        uint32_t       child = _cells[current].children[index];
+        if (child == INVALID_INDEX) {
+            child = allocCell(); // may reallocate _cells
+
+            const Cell& parent   = _cells[current];
+            const BBox  childBox = getChildBox(parent.min, parent.max, index);
+            Cell&       cell     = _cells[child];
+            cell.code            = (parent.code << 3) | index;
+            cell.depth           = level;
+            cell.parent          = current;
+            cell.min             = childBox.min;
+            cell.max             = childBox.max;
+
+            _cells[current].children[index] = child;
+            setCell(cell.code, level, child);
+        }
+        current = child;
+    }
+
+    return current;
+}
+
+uint32_t LinearOctree::findCell(uint32_t code, uint32_t depth) const {
+    const uint32_t offset = getCodeOffset(code, depth);
+    const auto&    page   = _cellPages[offset >> PAGE_BITS];
+    return page.empty() ? INVALID_INDEX : page[offset & (PAGE_SIZE - 1)];
+}
+
+void LinearOctree::setCell(uint32_t code, uint32_t depth, uint32_t cellIndex) {
+    const uint32_t offset = getCodeOffset(code, depth);
+    auto&          page   = _cellPages[offset >> PAGE_BITS];
+    if (page.empty()) {
+        if (cellIndex == INVALID_INDEX) {
+            return;
+        }
+        page.resize(PAGE_SIZE, INVALID_INDEX);
+    }
+    page[offset & (PAGE_SIZE - 1)] = cellIndex;
+}
+
+uint32_t LinearOctree::allocCell() {
+    uint32_t index = 0;
+    if (_freeCells.empty()) {
+        index = static_cast<uint32_t>(_cells.size());
+        _cells.emplace_back();
+    } else {
+        index = _freeCells.back();
+        _freeCells.pop_back();
+    }
+
+    _cells[index].children.fill(INVALID_INDEX);
+    return index;
+}
+
+uint32_t LinearOctree::allocSlot() {
+    if (_freeSlots.empty()) {
+        _slots.emplace_back();
+        return static_cast<uint32_t>(_slots.size() - 1);
+    }
+
+    const uint32_t index = _freeSlots.back();
+    _freeSlots.pop_back();
+    return index;
+}
+
+void LinearOctree::addToCell(uint32_t cellIndex, Model* model, uint32_t handle) {
+    Cell& cell     = _cells[cellIndex];
+    _slots[handle] = {cellIndex, static_cast<uint32_t>(cell.models.size())};
+
+    cell.centerX.emplace_back();
+    cell.centerY.emplace_back();
+    cell.centerZ.emplace_back();
+    cell.extentX.emplace_back();
+    cell.extentY.emplace_back();
+    cell.extentZ.emplace_back();
+    cell.models.push_back(model);
+    cell.handles.push_back(handle);
+
+    writeBounds(_slots[handle], *model->getWorldBounds());
+}
+
+void LinearOctree::removeFromCell(const Slot& slot) {
+    Cell&        cell = _cells[slot.cell];
+    const size_t last = cell.models.size() - 1;
+
+    // swap with the last model, keeping the arrays dense
+    if (slot.index != last) {
+        cell.centerX[slot.index] = cell.centerX[last];
+        cell.centerY[slot.index] = cell.centerY[last];
+        cell.centerZ[slot.index] = cell.centerZ[last];
+        cell.extentX[slot.index] = cell.extentX[last];
+        cell.extentY[slot.index] = cell.extentY[last];
+        cell.extentZ[slot.index] = cell.extentZ[last];
+        cell.models[slot.index]  = cell.models[last];
+        cell.handles[slot.index] = cell.handles[last];
+
+        _slots[cell.handles[slot.index]].index = slot.index;
+    }
+
+    cell.centerX.pop_back();
+    cell.centerY.pop_back();
+    cell.centerZ.pop_back();
+    cell.extentX.pop_back();
+    cell.extentY.pop_back();
+    cell.extentZ.pop_back();
+    cell.models.pop_back();
+    cell.handles.pop_back();
+}
+
+void LinearOctree::writeBounds(const Slot& slot, const AABB& bounds) {
+    Cell&       cell        = _cells[slot.cell];
+    const Vec3& center      = bounds.getCenter();
+    const Vec3& halfExtents = bounds.getHalfExtents();
+
+    cell.centerX[slot.index] = center.x;
+    cell.centerY[slot.index] = center.y;
+    cell.centerZ[slot.index] = center.z;
+    cell.extentX[slot.index] = halfExtents.x;
+    cell.extentY[slot.index] = halfExtents.y;
+    cell.extentZ[slot.index] = halfExtents.z;
+}
+
+void LinearOctree::pruneCell(uint32_t cellIndex) {
+    // delete empty cells recursively, the root is always kept
+    while (cellIndex != ROOT_INDEX) {
+        Cell& cell = _cells[cellIndex];
+        if (!cell.models.empty() || cell.hasChildren()) {
+            return;
+        }
+
+        const uint32_t parent = cell.parent;
+        _cells[parent].children[cell.code & 0x7] = INVALID_INDEX;
+        setCell(cell.code, cell.depth, INVALID_INDEX);
+        cell.parent = INVALID_INDEX;
+        _freeCells.push_back(cellIndex);
+
+        cellIndex = parent;
+    }
+}
+
+BBox LinearOctree::getChildBox(const Vec3& min, const Vec3& max, uint32_t index) {
+    cc::Vec3       childMin = min;
+    cc::Vec3       childMax = max;
+    const cc::Vec3 center   = (min + max) * 0.5F;
+
+    if (index & 0x1) {
+        childMin.x = center.x;
+    } else {
+        childMax.x = center.x;
+    }
+
+    if (index & 0x2) {
+        childMin.y = center.y;
+    } else {
+        childMax.y = center.y;
+    }
+
+    if (index & 0x4) {
+        childMin.z = center.z;
+    } else {
+        childMax.z = center.z;
+    }
+
+    return {childMin, childMax};
+}
+
+uint32_t LinearOctree::clampDepth(uint32_t maxDepth) {
+    return std::min(std::max(maxDepth, 1U), LINEAR_OCTREE_MAX_DEPTH);
+}
+
+uint32_t LinearOctree::getCodeOffset(uint32_t code, uint32_t depth) {
+    // levels are stored one after another: (8 ^ depth - 1) / 7 codes come before this level,
+    // and dropping the leading 1 leaves the Morton index inside the level
+    const uint32_t levelStart = 1U << (3 * depth);
+    return (levelStart - 1) / 7 + (code ^ levelStart);
+}
+
+} // namespace scene
+} // namespace cc
@@ -0,0 +1,123 @@
+/****************************************************************************
+ Copyright (c) 2020-2021 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos.com
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+ 
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "scene/Octree.h"
+
+namespace cc {
+namespace scene {
+
+// locational codes take 1 + 3 * depth bits and have to fit in 32 bits,
+// so deeper trees are clamped to this depth and getMaxDepth() returns the clamped value.
+constexpr uint32_t LINEAR_OCTREE_MAX_DEPTH = 10;
+
+/**
+ * LinearOctree class
+ *
+ * Pointer free octree: cells live in a flat array and are addressed by their locational code,
+ * a leading 1 followed by the 3 bit Morton index of every level, so parent and children codes
+ * are computed by shifting. Codes map to cells through a Morton indexed table, levels stored one
+ * after another, split into pages that are only allocated once a cell in them exists. Model bounds are kept per cell in structure of arrays for AABB::aabbFrustumBatch.
+ * Models are placed exactly like in Octree, so both produce the same visibility results.
+ */
+class CC_DLL LinearOctree final : public IOctree {
+public:
+    explicit LinearOctree(const Vec3& minPos = DEFAULT_WORLD_MIN_POS, const Vec3& maxPos = DEFAULT_WORLD_MAX_POS, uint32_t maxDepth = DEFAULT_OCTREE_DEPTH);
+    ~LinearOctree() override;
+
+    void            resize(const Vec3& minPos, const Vec3& maxPos, uint32_t maxDepth) override;
+    void            insert(Model* model) override;
+    void            remove(Model* model) override;
+    void            update(Model* model) override;
+    inline uint32_t getMaxDepth() const override { return _maxDepth; }
+    void            queryVisibility(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const override;
+
+private:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+    static constexpr uint32_t ROOT_CODE     = 1U;
+    static constexpr uint32_t ROOT_INDEX    = 0U;
+    static constexpr uint32_t PAGE_BITS     = 12U; // 4096 codes, four full levels per page
+    static constexpr uint32_t PAGE_SIZE     = 1U << PAGE_BITS;
+
+    struct Cell {
+        uint32_t                                  code{0};
+        uint32_t                                  depth{0};
+        uint32_t                                  parent{INVALID_INDEX};
+        std::array<uint32_t, OCTREE_CHILDREN_NUM> children{};
+        Vec3                                      min;
+        Vec3                                      max;
+
+        // model bounds in structure of arrays
+        std::vector<float>    centerX;
+        std::vector<float>    centerY;
+        std::vector<float>    centerZ;
+        std::vector<float>    extentX;
+        std::vector<float>    extentY;
+        std::vector<float>    extentZ;
+        std::vector<Model*>   models;
+        std::vector<uint32_t> handles;
+
+        bool hasChildren() const;
+    };
+
+    struct Slot {
+        uint32_t cell{INVALID_INDEX};
+        uint32_t index{0};
+    };
+
+    void     reset(const Vec3& minPos, const Vec3& maxPos, uint32_t maxDepth);
+    uint32_t findCell(uint32_t code, uint32_t depth) const;
+    void     setCell(uint32_t code, uint32_t depth, uint32_t cellIndex);
+    bool     isInside(Model* model) const;
+    uint32_t findTargetCode(const BBox& modelBox, uint32_t* depth) const;
+    uint32_t getOrCreateCell(uint32_t code, uint32_t depth);
+    uint32_t allocCell();
+    uint32_t allocSlot();
+    void     addToCell(uint32_t cellIndex, Model* model, uint32_t handle);
+    void     removeFromCell(const Slot& slot);
+    void     writeBounds(const Slot& slot, const AABB& bounds);
+    void     pruneCell(uint32_t cellIndex);
+    void     queryCell(const Cell& cell, const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const;
+
+    static BBox     getChildBox(const Vec3& min, const Vec3& max, uint32_t index);
+    static uint32_t clampDepth(uint32_t maxDepth);
+    static uint32_t getCodeOffset(uint32_t code, uint32_t depth);
+
+    std::vector<Cell>                  _cells;
+    std::vector<uint32_t>              _freeCells;
+    std::vector<std::vector<uint32_t>> _cellPages; // Morton offset to cell index, empty pages are not allocated
+    std::vector<Slot>                  _slots;
+    std::vector<uint32_t>              _freeSlots;
+    uint32_t                           _maxDepth{DEFAULT_OCTREE_DEPTH};
+
+    // scratch buffers reused by queries
+    mutable std::vector<uint32_t> _cellStack;
+    mutable std::vector<uint32_t> _visible;
+};
+
+} // namespace scene
+} // namespace cc
@@ -40,12 +40,10 @@ void Model::uploadMat4AsVec4x3(const Mat4 &mat, float *v1, float *v2, float *v3)
 }
 
 void Model::updateTransform(uint32_t /*stamp*/) {
-    Node *node = _transform;
-    if (node->getFlagsChanged() || node->getDirtyFlag()) {
-        node->updateWorldTransform();
-        _transformUpdated = true;
+    if (updateNodeTransform()) {
+        _worldBoundsDirty = false;
         if (_modelBounds.getValid() && _worldBounds) {
-            _modelBounds.transform(node->getWorldMatrix(), _worldBounds);
+            _modelBounds.transform(_transform->getWorldMatrix(), _worldBounds);
         }
 
         if (_scene) {
@@ -54,6 +52,18 @@ void Model::updateTransform(uint32_t /*stamp*/) {
     }
 }
 
+bool Model::updateNodeTransform() {
+    Node *node = _transform;
+    if (!node->getFlagsChanged() && !node->getDirtyFlag()) {
+        return false;
+    }
+
+    node->updateWorldTransform();
+    _transformUpdated = true;
+    _worldBoundsDirty = true;
+    return true;
+}
+
 void Model::updateUBOs(uint32_t stamp) {
     for (SubModel *subModel : _subModels) {
         subModel->update();
@@ -64,35 +74,82 @@ void Model::updateUBOs(uint32_t stamp) {
     }
     _transformUpdated = false;
     getTransform()->updateWorldTransform();
-    const auto &                                 worldMatrix = getTransform()->getWorldMatrix();
-    int                                          idx         = _instMatWorldIdx;
-    Mat4                                         mat4;
-    std::array<float, pipeline::UBOLocal::COUNT> bufferView;
+    int idx = _instMatWorldIdx;
     if (idx >= 0) {
-        const std::vector<uint8_t *> &attrs = getInstancedAttributeBlock()->views;
+        const auto &                  worldMatrix = getTransform()->getWorldMatrix();
+        const std::vector<uint8_t *> &attrs       = getInstancedAttributeBlock()->views;
         uploadMat4AsVec4x3(worldMatrix,
                            reinterpret_cast<float *>(attrs[idx]),
                            reinterpret_cast<float *>(attrs[idx + 1]),
                            reinterpret_cast<float *>(attrs[idx + 2]));
     } else if (_localBuffer) {
-        memcpy(bufferView.data() + pipeline::UBOLocal::MAT_WORLD_OFFSET, worldMatrix.m, sizeof(Mat4));
-        Mat4::inverseTranspose(worldMatrix, &mat4);
-        memcpy(bufferView.data() + pipeline::UBOLocal::MAT_WORLD_IT_OFFSET, mat4.m, sizeof(Mat4));
+        std::array<float, pipeline::UBOLocal::COUNT> bufferView;
+        fillLocalUBO(bufferView.data());
         _localBuffer->update(bufferView.data(), pipeline::UBOLocal::SIZE);
 
         updateWorldBoundUBOs();
     }
 }
 
+void Model::stageUBOs(std::vector<gfx::Buffer *> *mappedBuffers) {
+    if (_worldBoundsDirty) {
+        _worldBoundsDirty = false;
+        if (_modelBounds.getValid() && _worldBounds) {
+            _modelBounds.transform(_transform->getWorldMatrix(), _worldBounds);
+        }
+    }
+
+    if (!_transformUpdated) {
+        return;
+    }
+    _transformUpdated = false;
+    int idx           = _instMatWorldIdx;
+    if (idx >= 0) {
+        const auto &                  worldMatrix = getTransform()->getWorldMatrix();
+        const std::vector<uint8_t *> &attrs       = getInstancedAttributeBlock()->views;
+        uploadMat4AsVec4x3(worldMatrix,
+                           reinterpret_cast<float *>(attrs[idx]),
+                           reinterpret_cast<float *>(attrs[idx + 1]),
+                           reinterpret_cast<float *>(attrs[idx + 2]));
+    } else if (_localBuffer) {
+        fillLocalUBO(reinterpret_cast<float *>(_localBuffer->beginUpdate(pipeline::UBOLocal::SIZE)));
+        mappedBuffers->push_back(_localBuffer);
+
+        if (_worldBoundBuffer) {
+            fillWorldBoundUBO(reinterpret_cast<float *>(_worldBoundBuffer->beginUpdate(pipeline::UBOWorldBound::SIZE)));
+            mappedBuffers->push_back(_worldBoundBuffer);
+        }
+    }
+}
+
+void Model::updateSubModels(uint32_t stamp) {
+    for (SubModel *subModel : _subModels) {
+        subModel->update();
+    }
+    _updateStamp = stamp;
+}
+
+void Model::fillLocalUBO(float *data) const {
+    const auto &worldMatrix = _transform->getWorldMatrix();
+    Mat4        mat4;
+    memcpy(data + pipeline::UBOLocal::MAT_WORLD_OFFSET, worldMatrix.m, sizeof(Mat4));
+    Mat4::inverseTranspose(worldMatrix, &mat4);
+    memcpy(data + pipeline::UBOLocal::MAT_WORLD_IT_OFFSET, mat4.m, sizeof(Mat4));
+}
+
+void Model::fillWorldBoundUBO(float *data) const {
+    const Vec3 &center      = _worldBounds ? _worldBounds->getCenter() : Vec3{0.0F, 0.0F, 0.0F};
+    const Vec3 &halfExtents = _worldBounds ? _worldBounds->getHalfExtents() : Vec3{1.0F, 1.0F, 1.0F};
+    const Vec4  worldBoundCenter{center.x, center.y, center.z, 0.0F};
+    const Vec4  worldBoundHalfExtents{halfExtents.x, halfExtents.y, halfExtents.z, 1.0F};
+    memcpy(data + pipeline::UBOWorldBound::WORLD_BOUND_CENTER, &worldBoundCenter.x, sizeof(Vec4));
+    memcpy(data + pipeline::UBOWorldBound::WORLD_BOUND_HALF_EXTENTS, &worldBoundHalfExtents.x, sizeof(Vec4));
+}
+
 void Model::updateWorldBoundUBOs() {
     if (_worldBoundBuffer) {
         std::array<float, pipeline::UBOWorldBound::COUNT> worldBoundBufferView;
-        const Vec3 &                                           center      = _worldBounds ? _worldBounds->getCenter() : Vec3{0.0F, 0.0F, 0.0F};
-        const Vec3 &                                           halfExtents = _worldBounds ? _worldBounds->getHalfExtents() : Vec3{1.0F, 1.0F, 1.0F};
-        const Vec4                                             worldBoundCenter{center.x, center.y, center.z, 0.0F};
-        const Vec4                                             worldBoundHalfExtents{halfExtents.x, halfExtents.y, halfExtents.z, 1.0F};
-        memcpy(worldBoundBufferView.data() + pipeline::UBOWorldBound::WORLD_BOUND_CENTER, &worldBoundCenter.x, sizeof(Vec4));
-        memcpy(worldBoundBufferView.data() + pipeline::UBOWorldBound::WORLD_BOUND_HALF_EXTENTS, &worldBoundHalfExtents.x, sizeof(Vec4));
+        fillWorldBoundUBO(worldBoundBufferView.data());
         _worldBoundBuffer->update(worldBoundBufferView.data(), pipeline::UBOWorldBound::SIZE);
     }
 }
@@ -27,6 +27,7 @@
 
 #include <tuple>
 #include <vector>
+#include "base/IndexHandle.h"
 #include "renderer/gfx-base/GFXBuffer.h"
 #include "renderer/gfx-base/GFXDef-common.h"
 #include "scene/AABB.h"
@@ -67,6 +68,14 @@ public:
     virtual void updateUBOs(uint32_t stamp);
     void         updateWorldBoundUBOs();
 
+    // updateTransform and updateUBOs split into phases for the parallel update of RenderScene,
+    // only DEFAULT models go through them. updateNodeTransform and updateSubModels run on the
+    // updating thread, stageUBOs may run on a job worker: it only touches the model itself and
+    // maps the buffers it fills, which the caller submits with endUpdate afterwards.
+    bool updateNodeTransform();
+    void stageUBOs(std::vector<gfx::Buffer *> *mappedBuffers);
+    void updateSubModels(uint32_t stamp);
+
     void setSubModel(uint32_t idx, SubModel *subModel);
 
     inline void setCastShadow(bool value) { _castShadow = value; }
@@ -89,6 +98,7 @@ public:
         _transformUpdated       = true;
     }
     inline void setOctreeNode(OctreeNode *node) { _octreeNode = node; }
+    inline void setOctreeHandle(IndexHandle<uint32_t> handle) { _octreeHandle = handle; }
     inline void setScene(RenderScene *scene) { _scene = scene; if (scene) _transformUpdated = true;  }
 
     inline bool                               getCastShadow() const { return _castShadow; }
@@ -112,6 +122,7 @@ public:
     inline AABB *                             getWorldBounds() const { return _worldBounds; }
     inline ModelType                          getType() const { return _type; };
     inline OctreeNode *                       getOctreeNode() const { return _octreeNode; }
+    inline IndexHandle<uint32_t>              getOctreeHandle() const { return _octreeHandle; }
     inline RenderScene *                      getScene() const { return _scene; }
 
 protected:
@@ -122,7 +133,13 @@ protected:
     OctreeNode * _octreeNode{nullptr};
     RenderScene *_scene{nullptr};
 
+    IndexHandle<uint32_t> _octreeHandle; // slot in the LinearOctree
+
+    void fillLocalUBO(float *data) const;
+    void fillWorldBoundUBO(float *data) const;
+
 private:
+    bool _worldBoundsDirty{false}; // set by updateNodeTransform, consumed by stageUBOs
     bool _enabled{false};
     bool _castShadow{false};
     bool _receiveShadow{false};
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
 #include "cocos/bindings/manual/jsb_conversions.h"
 #include "math/Mat3.h"
@@ -50,6 +51,10 @@ struct NodeLayout {
     cc::Vec3       localPosition;
     cc::Quaternion localRotation;
 };
+// The member offsets and size seen by JS must not move, whatever the USE_MATH_SIMD option.
+static_assert(offsetof(NodeLayout, worldMatrix) == 48 && offsetof(NodeLayout, localRotation) == 136, "NodeLayout must match the JS layout");
+static_assert(sizeof(NodeLayout) == 152, "NodeLayout must match the JS layout");
+static_assert(sizeof(cc::Mat4) == 64 && alignof(cc::Mat4) == 4 && sizeof(cc::Vec4) == 16 && alignof(cc::Vec4) == 4, "math types must stay packed");
 
 class Node final : public BaseNode {
 public:
@@ -24,8 +24,9 @@
  ****************************************************************************/
 
 #include "Octree.h"
-#include <future>
 #include <utility>
+#include "base/CoreStd.h"
+#include "base/job-system/JobSystem.h"
 #include "scene/Camera.h"
 #include "scene/Model.h"
 
@@ -184,6 +185,20 @@ void OctreeNode::gatherModels(std::vector<Model*>& results) const { // NOLINT(mi
 }
 
 void OctreeNode::doQueryVisibility(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const {
+    AABBBatchBuffer<AABB_BATCH_SIZE>           bounds;
+    std::array<Model*, AABB_BATCH_SIZE>        candidates{};
+    std::array<uint32_t, AABB_BATCH_SIZE / 32> visible{};
+
+    const auto flush = [&]() {
+        AABB::aabbFrustumBatch(bounds.batch(), frustum, visible.data());
+        for (uint32_t i = 0; i < bounds.count; ++i) {
+            if (getVisibilityBit(visible.data(), i)) {
+                results.push_back(candidates[i]);
+            }
+        }
+        bounds.count = 0;
+    };
+
     const auto visibility = camera->visibility;
     for (auto* model : _models) {
         if (!model->getEnabled()) {
@@ -194,47 +209,44 @@ void OctreeNode::doQueryVisibility(const Camera* camera, const Frustum& frustum,
         if ((node && ((visibility & node->getLayer()) == node->getLayer())) ||
             (visibility & model->getVisFlags())) {
             const AABB* modelWorldBounds = model->getWorldBounds();
-            if (!modelWorldBounds) {
+            if (!modelWorldBounds || (isShadow && !model->getCastShadow())) {
                 continue;
             }
 
-            if (isShadow) {
-                if (model->getCastShadow() && modelWorldBounds->aabbFrustum(frustum)) {
-                    results.push_back(model);
-                }
-            } else {
-                if (modelWorldBounds->aabbFrustum(frustum)) {
-                    results.push_back(model);
-                }
+            // frustum test the candidates in batches
+            candidates[bounds.count] = model;
+            bounds.push(*modelWorldBounds);
+            if (bounds.count == AABB_BATCH_SIZE) {
+                flush();
             }
         }
     }
+
+    if (bounds.count) {
+        flush();
+    }
 }
 
-void OctreeNode::queryVisibilityParallelly(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const {
+void OctreeNode::collectQueryTasks(const Frustum& frustum, uint32_t splitDepth, std::vector<OctreeQueryTask>& tasks) const { // NOLINT(misc-no-recursion)
+    if (_depth >= splitDepth) {
+        tasks.push_back({this, true});
+        return;
+    }
+
     AABB box;
     AABB::fromPoints(_aabb.min, _aabb.max, &box);
     if (!box.aabbFrustum(frustum)) {
         return;
     }
 
-    std::array<std::future<std::vector<Model*>>, OCTREE_CHILDREN_NUM> futures{};
-    for (auto i = 0; i < OCTREE_CHILDREN_NUM; i++) {
-        if (_children[i]) {
-            futures[i] = std::async(std::launch::async, [=, &frustum] {
-                std::vector<Model*> models;
-                _children[i]->queryVisibilitySequentially(camera, frustum, isShadow, models);
-                return models;
-            });
-        }
+    if (!_models.empty()) {
+        tasks.push_back({this, false});
     }
 
-    doQueryVisibility(camera, frustum, isShadow, results);
-
-    for (auto i = 0; i < OCTREE_CHILDREN_NUM; i++) {
-        if (_children[i]) {
-            auto models = futures[i].get();
-            results.insert(results.end(), models.begin(), models.end());
+    // split recursively, in the same order as the sequential query.
+    for (auto* child : _children) {
+        if (child) {
+            child->collectQueryTasks(frustum, splitDepth, tasks);
         }
     }
 }
@@ -325,13 +337,58 @@ void Octree::update(Model* model) {
 }
 
 void Octree::queryVisibility(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const {
-    if (_totalCount > USE_MULTI_THRESHOLD) {
-        _root->queryVisibilityParallelly(camera, frustum, isShadow, results);
+    const uint32_t threadCount = JobSystem::getInstance()->threadCount();
+    if (_totalCount > USE_MULTI_THRESHOLD && threadCount > 1) {
+        queryVisibilityParallelly(camera, frustum, isShadow, results, threadCount);
     } else {
         _root->queryVisibilitySequentially(camera, frustum, isShadow, results);
     }
 }
 
+void Octree::queryVisibilityParallelly(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results, uint32_t threadCount) const {
+    // split the tree until there are enough subtrees to keep all workers busy
+    uint32_t splitDepth = 0;
+    uint32_t taskCount  = 1;
+    while (taskCount < threadCount * TASKS_PER_THREAD && splitDepth + 1 < _maxDepth) {
+        taskCount *= OCTREE_CHILDREN_NUM;
+        ++splitDepth;
+    }
+
+    _queryTasks.clear();
+    _root->collectQueryTasks(frustum, splitDepth, _queryTasks);
+
+    const auto count = static_cast<uint32_t>(_queryTasks.size());
+    if (_queryResults.size() < count) {
+        _queryResults.resize(count);
+    }
+
+    auto runTask = [&](uint32_t i) {
+        const OctreeQueryTask& task        = _queryTasks[i];
+        std::vector<Model*>&   taskResults = _queryResults[i];
+        taskResults.clear();
+        if (task.recursive) {
+            task.node->queryVisibilitySequentially(camera, frustum, isShadow, taskResults);
+        } else {
+            task.node->doQueryVisibility(camera, frustum, isShadow, taskResults);
+        }
+    };
+
+    if (count > 1) {
+        JobGraph g(JobSystem::getInstance());
+        g.createForEachIndexJob(1U, count, 1U, runTask);
+        g.run();
+        runTask(0U);
+        g.waitForAll();
+    } else if (count == 1) {
+        runTask(0U);
+    }
+
+    // gather the results in task order, the same order as the sequential query
+    for (uint32_t i = 0; i < count; ++i) {
+        results.insert(results.end(), _queryResults[i].begin(), _queryResults[i].end());
+    }
+}
+
 bool Octree::isInside(Model* model) const {
     const BBox& rootBox  = _root->getBox();
     BBox        modelBox = BBox(*model->getWorldBounds());
@@ -37,6 +37,7 @@ namespace scene {
 struct Camera;
 class Model;
 class Octree;
+class OctreeNode;
 
 constexpr int OCTREE_CHILDREN_NUM    = 8;
 constexpr int DEFAULT_OCTREE_DEPTH   = 8;
@@ -44,6 +45,7 @@ const Vec3    DEFAULT_WORLD_MIN_POS  = {-1024.0F, -1024.0F, -1024.0F};
 const Vec3    DEFAULT_WORLD_MAX_POS  = {1024.0F, 1024.0F, 1024.0F};
 const float   OCTREE_BOX_EXPAND_SIZE = 10.0F;
 constexpr int USE_MULTI_THRESHOLD    = 1024; // use parallel culling if greater than this value
+constexpr int TASKS_PER_THREAD       = 4;    // split the tree until there are about this many query tasks for each worker
 
 // Axis aligned bounding box
 struct CC_DLL BBox {
@@ -77,6 +79,12 @@ struct CC_DLL BBox {
     }
 };
 
+// A unit of work of a parallel visibility query
+struct OctreeQueryTask {
+    const OctreeNode* node{nullptr};
+    bool              recursive{false}; // query the whole subtree, or only the models of this node
+};
+
 /**
  * OctreeNode class
  */
@@ -96,7 +104,7 @@ private:
     void               onRemoved();
     void               gatherModels(std::vector<Model*>& results) const;
     void               doQueryVisibility(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const;
-    void               queryVisibilityParallelly(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const;
+    void               collectQueryTasks(const Frustum& frustum, uint32_t splitDepth, std::vector<OctreeQueryTask>& tasks) const;
     void               queryVisibilitySequentially(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const;
 
     Octree*                                      _owner{nullptr};
@@ -111,30 +119,48 @@ private:
 };
 
 /**
- * Octree class
+ * Octree interface, implemented by the pointer based Octree and the LinearOctree
  */
-class CC_DLL Octree {
+class CC_DLL IOctree {
 public:
-    explicit Octree(const Vec3& minPos = DEFAULT_WORLD_MIN_POS, const Vec3& maxPos = DEFAULT_WORLD_MAX_POS, uint32_t maxDepth = DEFAULT_OCTREE_DEPTH);
-    ~Octree();
+    virtual ~IOctree() = default;
 
     // reinsert all models in the tree when you change the aabb or max depth in editor
-    void resize(const Vec3& minPos, const Vec3& maxPos, uint32_t maxDepth);
+    virtual void resize(const Vec3& minPos, const Vec3& maxPos, uint32_t maxDepth) = 0;
 
     // insert a model to tree.
-    void insert(Model* model);
+    virtual void insert(Model* model) = 0;
 
     // remove a model from tree.
-    void remove(Model* model);
+    virtual void remove(Model* model) = 0;
 
     // update model's location in the tree.
-    void update(Model* model);
+    virtual void update(Model* model) = 0;
 
     // return octree depth
-    inline uint32_t getMaxDepth() const { return _maxDepth; }
+    virtual uint32_t getMaxDepth() const = 0;
 
     // view frustum culling
-    void queryVisibility(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const;
+    virtual void queryVisibility(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const = 0;
+};
+
+/**
+ * Octree class
+ */
+class CC_DLL Octree final : public IOctree {
+public:
+    explicit Octree(const Vec3& minPos = DEFAULT_WORLD_MIN_POS, const Vec3& maxPos = DEFAULT_WORLD_MAX_POS, uint32_t maxDepth = DEFAULT_OCTREE_DEPTH);
+    ~Octree() override;
+
+    void            resize(const Vec3& minPos, const Vec3& maxPos, uint32_t maxDepth) override;
+    void            insert(Model* model) override;
+    void            remove(Model* model) override;
+    void            update(Model* model) override;
+    inline uint32_t getMaxDepth() const override { return _maxDepth; }
+    void            queryVisibility(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results) const override;
+
+    // view frustum culling split into subtree tasks for threadCount workers, returns the same models in the same order as the sequential query
+    void queryVisibilityParallelly(const Camera* camera, const Frustum& frustum, bool isShadow, std::vector<Model*>& results, uint32_t threadCount) const;
 
 private:
     bool isInside(Model* model) const;
@@ -142,6 +168,10 @@ private:
     OctreeNode* _root{nullptr};
     uint32_t    _maxDepth{DEFAULT_OCTREE_DEPTH};
     uint32_t    _totalCount{0};
+
+    // reused by parallel queries to avoid per frame allocations
+    mutable std::vector<OctreeQueryTask>     _queryTasks;
+    mutable std::vector<std::vector<Model*>> _queryResults;
 };
 
 } // namespace scene
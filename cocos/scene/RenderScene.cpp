@@ -24,9 +24,13 @@
  ****************************************************************************/
 
 #include "scene/RenderScene.h"
+#include <algorithm>
 #include <utility>
+#include "base/CoreStd.h"
 #include "base/Log.h"
+#include "base/job-system/JobSystem.h"
 #include "renderer/pipeline/RenderPipeline.h"
+#include "scene/LinearOctree.h"
 #include "scene/Octree.h"
 
 extern void jsbFlushFastMQ();
@@ -44,7 +48,11 @@ void RenderScene::activate() {
     const auto *info       = sharedData->octree;
 
     if (info->enabled) {
-        _octree = new Octree(info->minPos, info->maxPos, info->depth);
+        if (info->linear) {
+            _octree = new LinearOctree(info->minPos, info->maxPos, info->depth);
+        } else {
+            _octree = new Octree(info->minPos, info->maxPos, info->depth);
+        }
     }
 }
 
@@ -60,6 +68,17 @@ void RenderScene::update(uint32_t stamp) {
     for (SpotLight *spotLight : _spotLights) {
         spotLight->update();
     }
+
+    updateModels(stamp, JobSystem::getInstance()->threadCount());
+}
+
+void RenderScene::updateModels(uint32_t stamp, uint32_t threadCount) {
+    const uint32_t chunkCount = getUpdateChunkCount(threadCount);
+    if (chunkCount > 1U) {
+        updateModelsParallel(stamp, chunkCount);
+        return;
+    }
+
     for (auto *model : _models) {
         if (model->getEnabled()) {
             model->updateTransform(stamp);
@@ -68,6 +87,79 @@ void RenderScene::update(uint32_t stamp) {
     }
 }
 
+uint32_t RenderScene::getUpdateChunkCount(uint32_t threadCount) const {
+    const auto modelCount = static_cast<uint32_t>(_models.size());
+    if (!_parallelUpdateThreshold || modelCount < _parallelUpdateThreshold) {
+        return 1U;
+    }
+
+    if (threadCount < 2U) {
+        return 1U;
+    }
+
+    // one chunk for each worker plus one for the calling thread, but never less than a threshold worth of models per chunk
+    return std::min(threadCount + 1U, modelCount / _parallelUpdateThreshold + 1U);
+}
+
+void RenderScene::updateModelsParallel(uint32_t stamp, uint32_t chunkCount) {
+    // node transforms stay serial, they can not be resolved level by level on the workers: Node::updateWorldTransform
+    // walks the dirty ancestors through the dirty node list shared with JS, which only the script thread may use,
+    // and models may share dirty ancestors
+    _movedModels.clear();
+    for (auto *model : _models) {
+        if (!model->getEnabled()) continue;
+
+        if (model->getType() != ModelType::DEFAULT) {
+            model->updateTransform(stamp);
+            model->updateUBOs(stamp);
+        } else if (model->updateNodeTransform()) {
+            _movedModels.emplace_back(model);
+        }
+    }
+
+    if (_updateChunks.size() < chunkCount) {
+        _updateChunks.resize(chunkCount);
+    }
+
+    const auto     modelCount = static_cast<uint32_t>(_models.size());
+    const uint32_t chunkSize  = (modelCount - 1) / chunkCount + 1; // ceil(modelCount / chunkCount)
+
+    auto stageChunk = [&](uint32_t chunk) {
+        auto &         mappedBuffers = _updateChunks[chunk].mappedBuffers;
+        const uint32_t begin         = chunk * chunkSize;
+        const uint32_t end           = std::min(begin + chunkSize, modelCount);
+        mappedBuffers.clear();
+        for (uint32_t i = begin; i < end; ++i) {
+            auto *model = _models[i];
+            if (model->getEnabled() && model->getType() == ModelType::DEFAULT) {
+                model->stageUBOs(&mappedBuffers);
+            }
+        }
+    };
+
+    // the calling thread stages the first chunk while the workers handle the rest
+    JobGraph g(JobSystem::getInstance());
+    g.createForEachIndexJob(1U, chunkCount, 1U, stageChunk);
+    g.run();
+    stageChunk(0U);
+    g.waitForAll();
+
+    // octree and gfx work is applied serially, in model order
+    for (auto *model : _movedModels) {
+        updateOctree(model);
+    }
+    for (auto *model : _models) {
+        if (model->getEnabled() && model->getType() == ModelType::DEFAULT) {
+            model->updateSubModels(stamp);
+        }
+    }
+    for (uint32_t i = 0; i < chunkCount; ++i) {
+        for (auto *buffer : _updateChunks[i].mappedBuffers) {
+            buffer->endUpdate();
+        }
+    }
+}
+
 void RenderScene::addSphereLight(SphereLight *light) {
     _sphereLights.push_back(light);
 }
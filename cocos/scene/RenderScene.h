@@ -37,7 +37,7 @@
 namespace cc {
 namespace scene {
 
-class Octree;
+class IOctree;
 
 class RenderScene final {
 public:
@@ -50,6 +50,8 @@ public:
 
     void activate();
     void update(uint32_t stamp);
+    // the model part of update, split into chunks for threadCount workers when the scene is large enough
+    void updateModels(uint32_t stamp, uint32_t threadCount);
 
     void addSphereLight(SphereLight *);
     void removeSphereLight(SphereLight *);
@@ -78,16 +80,34 @@ public:
     inline const std::vector<Model *> &      getModels() const { return _models; }
     inline const std::vector<SphereLight *> &getSphereLights() const { return _sphereLights; }
     inline const std::vector<SpotLight *> &  getSpotLights() const { return _spotLights; }
-    inline Octree *                          getOctree() const { return _octree; }
+    inline IOctree *                         getOctree() const { return _octree; }
     void                                     updateOctree(Model *model);
 
+    // Scenes with at least this many models update them on the job system, 0 disables the parallel update.
+    inline uint32_t getParallelUpdateThreshold() const { return _parallelUpdateThreshold; }
+    inline void     setParallelUpdateThreshold(uint32_t threshold) { _parallelUpdateThreshold = threshold; }
+
+    static constexpr uint32_t PARALLEL_UPDATE_THRESHOLD = 2048U;
+
 private:
+    struct UpdateChunk {
+        std::vector<gfx::Buffer *> mappedBuffers;
+    };
+
+    uint32_t getUpdateChunkCount(uint32_t threadCount) const;
+    void     updateModelsParallel(uint32_t stamp, uint32_t chunkCount);
+
     DirectionalLight *         _directionalLight{nullptr};
     std::vector<Model *>       _models;
     std::vector<SphereLight *> _sphereLights;
     std::vector<SpotLight *>   _spotLights;
     std::vector<DrawBatch2D *> _drawBatch2Ds;
-    Octree *                   _octree{nullptr};
+    IOctree *                  _octree{nullptr};
+    uint32_t                   _parallelUpdateThreshold{PARALLEL_UPDATE_THRESHOLD};
+
+    // kept across frames so steady state updates do not reallocate
+    std::vector<Model *>     _movedModels;
+    std::vector<UpdateChunk> _updateChunks;
 };
 
 } // namespace scene
@@ -24,57 +24,115 @@
  ****************************************************************************/
 
 #include "scene/SkinningModel.h"
+#include <algorithm>
+#include <unordered_map>
 #include <utility>
 #include "scene/RenderScene.h"
 
 
 namespace cc {
 namespace scene {
-void SkinningModel::updateWorldMatrix(JointInfo* info, uint32_t stamp) {
-    int i = -1;
-    _worldMatrix.setIdentity();
-    auto*                        currTransform = &info->transform;
-    auto                         parentSize    = static_cast<int>(info->parents.size());
-    std::vector<JointTransform*> transStacks;
-    while (currTransform->node) {
-        if ((currTransform->stamp == stamp || currTransform->stamp + 1 == stamp) && !currTransform->node->getFlagsChanged()) {
-            _worldMatrix.set(currTransform->world);
-            currTransform->stamp = stamp;
-            break;
+void SkinningModel::setIndicesAndJoints(std::vector<uint32_t> bufferIndices, std::vector<JointInfo> joints) {
+    _bufferIndices = std::move(bufferIndices);
+    _joints        = std::move(joints);
+    buildJointHierarchy();
+    updateMappedSizes();
+}
+
+void SkinningModel::updateMappedSizes() {
+    // only the slots in use are mapped, so that no stale data past them gets uploaded
+    _mappedSizes.assign(_buffers.size(), 0U);
+    for (const JointInfo& jointInfo : _joints) {
+        for (size_t b = 0; b < jointInfo.buffers.size(); ++b) {
+            const uint32_t buffer = jointInfo.buffers[b];
+            if (buffer < _mappedSizes.size()) {
+                _mappedSizes[buffer] = std::max(_mappedSizes[buffer], static_cast<uint32_t>((jointInfo.indices[b] + 1) * 12 * sizeof(float)));
+            }
+        }
+    }
+}
+
+void SkinningModel::buildJointHierarchy() {
+    _jointNodes.clear();
+    _jointParents.clear();
+    _jointSlots.clear();
+
+    std::unordered_map<Node*, uint32_t> slots;
+    std::vector<Node*>                  chain;
+    for (const JointInfo& jointInfo : _joints) {
+        // same chain as the one walked by the JS side: the joint itself, then its parents up to the skeleton root
+        chain.clear();
+        const JointTransform* currTransform = &jointInfo.transform;
+        for (size_t i = 0; currTransform->node; ++i) {
+            chain.push_back(currTransform->node);
+            if (i >= jointInfo.parents.size()) break;
+            currTransform = &jointInfo.parents[i];
         }
-        currTransform->stamp = stamp;
-        transStacks.push_back(currTransform);
-        i++;
-        if (i >= parentSize) {
-            break;
+
+        int32_t parent = -1;
+        for (auto iter = chain.rbegin(); iter != chain.rend(); ++iter) {
+            auto found = slots.find(*iter);
+            if (found == slots.end()) {
+                found = slots.emplace(*iter, static_cast<uint32_t>(_jointNodes.size())).first;
+                _jointNodes.push_back(*iter);
+                _jointParents.push_back(parent);
+            }
+            parent = static_cast<int32_t>(found->second);
         }
-        currTransform = &info->parents[i];
+        _jointSlots.push_back(static_cast<uint32_t>(parent)); // a joint without node is left at identity
     }
-    while (i > -1) {
-        currTransform = transStacks[i--];
-        auto* node    = currTransform->node;
-        Mat4::fromRTS(node->getRotation(), node->getPosition(), node->getScale(), &currTransform->local);
-        Mat4::multiply(_worldMatrix, currTransform->local, &currTransform->world);
-        _worldMatrix.set(currTransform->world);
+
+    const size_t count = _jointNodes.size();
+    _jointWorlds.assign(count + 1, Mat4::IDENTITY); // the last one backs joints without node
+    _jointUpdated.assign(count, 0);
+    for (auto& slot : _jointSlots) {
+        if (slot == static_cast<uint32_t>(-1)) slot = static_cast<uint32_t>(count);
+    }
+    _jointStamp = -1;
+}
+
+void SkinningModel::updateJointMatrices(uint32_t stamp) {
+    // cached matrices are only trusted if they were evaluated in the current or the previous frame
+    const bool refreshAll = _jointStamp < 0 || static_cast<int64_t>(stamp) > _jointStamp + 1;
+    _jointStamp           = stamp;
+
+    Mat4         local;
+    const size_t count = _jointNodes.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Node*   node    = _jointNodes[i];
+        const int32_t parent  = _jointParents[i];
+        const bool    updated = refreshAll || node->getFlagsChanged() || (parent >= 0 && _jointUpdated[parent]);
+        _jointUpdated[i]      = updated;
+        if (!updated) continue;
+
+        Mat4::fromRTS(node->getRotation(), node->getPosition(), node->getScale(), &local);
+        if (parent < 0) {
+            _jointWorlds[i].set(local);
+        } else {
+            Mat4::multiply(_jointWorlds[parent], local, &_jointWorlds[i]);
+        }
     }
 }
 
 void SkinningModel::updateUBOs(uint32_t stamp) {
     Model::updateUBOs(stamp);
-    uint32_t bIdx = 0;
-    Mat4     mat4;
-    for (const JointInfo& jointInfo : _joints) {
-        Mat4::multiply(jointInfo.transform.world, jointInfo.bindpose, &mat4);
-        for (uint32_t buffer : jointInfo.buffers) {
-            uploadJointData(jointInfo.indices[bIdx] * 12, mat4, _dataArray[buffer]->data());
-            bIdx++;
+
+    // joint data is written straight into the mapped ranges, every slot in them is rewritten each frame
+    for (size_t i = 0; i < _buffers.size(); ++i) {
+        _mappedBuffers[i] = _mappedSizes[i] ? reinterpret_cast<float*>(_buffers[i]->beginUpdate(_mappedSizes[i])) : nullptr;
+    }
+
+    Mat4 mat4;
+    for (size_t j = 0; j < _joints.size(); ++j) {
+        const JointInfo& jointInfo = _joints[j];
+        Mat4::multiply(_jointWorlds[_jointSlots[j]], jointInfo.bindpose, &mat4);
+        for (size_t b = 0; b < jointInfo.buffers.size(); ++b) {
+            uploadJointData(jointInfo.indices[b] * 12, mat4, _mappedBuffers[jointInfo.buffers[b]]);
         }
-        bIdx = 0;
     }
-    bIdx = 0;
-    for (gfx::Buffer* buffer : _buffers) {
-        buffer->update(_dataArray[bIdx]->data(), buffer->getSize());
-        bIdx++;
+
+    for (size_t i = 0; i < _buffers.size(); ++i) {
+        if (_mappedBuffers[i]) _buffers[i]->endUpdate();
     }
 }
 
@@ -85,18 +143,12 @@ void SkinningModel::uploadJointData(uint32_t base, const Mat4& mat, float* dst)
     dst[base + 11] = mat.m[14];
 }
 
-SkinningModel::~SkinningModel() {
-    for (auto* curr : _dataArray) {
-        delete curr;
-    }
-}
+SkinningModel::~SkinningModel() = default;
 
 void SkinningModel::setBuffers(std::vector<gfx::Buffer*> buffers) {
     _buffers = std::move(buffers);
-    for (auto* buffer : _buffers) {
-        auto* data = new std::array<float, pipeline::UBOSkinning::COUNT>();
-        _dataArray.push_back(data);
-    }
+    _mappedBuffers.assign(_buffers.size(), nullptr);
+    updateMappedSizes();
 }
 
 void SkinningModel::updateTransform(uint32_t stamp) {
@@ -105,14 +157,16 @@ void SkinningModel::updateTransform(uint32_t stamp) {
         root->updateWorldTransform();
         _transformUpdated = true;
     }
+
+    updateJointMatrices(stamp);
+
     Vec3 v3Min{INFINITY, INFINITY, INFINITY};
     Vec3 v3Max{-INFINITY, -INFINITY, -INFINITY};
     AABB ab1;
     Vec3 v31;
     Vec3 v32;
-    for (JointInfo& jointInfo : _joints) {
-        updateWorldMatrix(&jointInfo, stamp);
-        jointInfo.bound->transform(_worldMatrix, &ab1);
+    for (size_t j = 0; j < _joints.size(); ++j) {
+        _joints[j].bound->transform(_jointWorlds[_jointSlots[j]], &ab1);
         ab1.getBoundary(&v31, &v32);
         Vec3::min(v3Min, v31, &v3Min);
         Vec3::max(v3Max, v32, &v3Max);
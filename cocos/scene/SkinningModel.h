@@ -54,7 +54,7 @@ struct JointInfo {
 
 class SkinningModel : public Model {
 public:
-    SkinningModel()                      = default;
+    SkinningModel() { _type = ModelType::SKINNING; }
     SkinningModel(const SkinningModel &) = delete;
     SkinningModel(SkinningModel &&)      = delete;
     ~SkinningModel() override;
@@ -62,10 +62,7 @@ public:
     SkinningModel &operator=(SkinningModel &&) = delete;
 
     void        setBuffers(std::vector<gfx::Buffer *> buffers);
-    inline void setIndicesAndJoints(std::vector<uint32_t> bufferIndices, std::vector<JointInfo> joints) {
-        _bufferIndices = std::move(bufferIndices);
-        _joints        = std::move(joints);
-    }
+    void        setIndicesAndJoints(std::vector<uint32_t> bufferIndices, std::vector<JointInfo> joints);
     inline void updateLocalDescriptors(uint32_t submodelIdx, gfx::DescriptorSet *descriptorset) {
         gfx::Buffer *buffer = _buffers[_bufferIndices[submodelIdx]];
         if (buffer) {
@@ -78,18 +75,27 @@ public:
     void updateTransform(uint32_t stamp) override;
     void updateUBOs(uint32_t stamp) override;
 
-protected:
-    ModelType _type{ModelType::SKINNING};
-
 private:
-    static void                                                    uploadJointData(uint32_t base, const Mat4 &mat, float *dst);
-    void                                                           updateWorldMatrix(JointInfo *info, uint32_t stamp);
-    bool                                                           _needUpdate{false};
-    Mat4                                                           _worldMatrix;
-    std::vector<uint32_t>                                          _bufferIndices;
-    std::vector<gfx::Buffer *>                                     _buffers;
-    std::vector<JointInfo>                                         _joints;
-    std::vector<std::array<float, pipeline::UBOSkinning::COUNT> *> _dataArray;
+    static void uploadJointData(uint32_t base, const Mat4 &mat, float *dst);
+    void        buildJointHierarchy();
+    void        updateMappedSizes();
+    void        updateJointMatrices(uint32_t stamp);
+
+    bool                       _needUpdate{false};
+    std::vector<uint32_t>      _bufferIndices;
+    std::vector<gfx::Buffer *> _buffers;
+    std::vector<float *>       _mappedBuffers;
+    std::vector<uint32_t>      _mappedSizes; // bytes up to the last slot in use of each buffer
+    std::vector<JointInfo>     _joints;
+
+    // The joint nodes of all chains without duplicates, parents always precede their children,
+    // so every world matrix (relative to the skeleton root) is computed once per frame in one pass.
+    std::vector<Node *>   _jointNodes;
+    std::vector<int32_t>  _jointParents; // -1 for the topmost node of a chain
+    std::vector<Mat4>     _jointWorlds;
+    std::vector<uint8_t>  _jointUpdated;
+    std::vector<uint32_t> _jointSlots; // index in _jointNodes for each of _joints
+    int64_t               _jointStamp{-1};
 };
 
 } // namespace scene
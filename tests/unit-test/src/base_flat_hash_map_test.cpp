@@ -0,0 +1,213 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "cocos/base/FlatHashMap.h"
+#include "utils.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// The bucket lookup benchmark is a FlatHashMap micro benchmark shaped like the bucket lookup of
+// InstancedBuffer::merge: every sub model pass looks for an item with the same index buffer,
+// lightmap, shader and stride that is not full and copies its instance attributes into it. Gfx
+// objects are stood in for by distinct addresses. It compares the hashed lookup against the linear
+// scan it replaced, the real merge is timed by pipelineInstancedBufferTest.mergeBenchmark.
+
+namespace {
+constexpr uint32_t NO_ITEM          = ~0U;
+constexpr uint32_t INITIAL_CAPACITY = 32;   // InstancedBuffer::INITIAL_CAPACITY
+constexpr uint32_t MAX_CAPACITY     = 1024; // InstancedBuffer::MAX_CAPACITY
+constexpr uint32_t STRIDE           = 64;   // a world matrix of instance attributes
+
+struct BucketKey {
+    const void *indexBuffer{nullptr};
+    const void *lightingMap{nullptr};
+    const void *shader{nullptr};
+    uint32_t    stride{0};
+
+    bool operator==(const BucketKey &rhs) const {
+        return indexBuffer == rhs.indexBuffer && lightingMap == rhs.lightingMap && shader == rhs.shader && stride == rhs.stride;
+    }
+};
+
+struct BucketKeyHasher {
+    size_t operator()(const BucketKey &key) const {
+        size_t seed = 4;
+        for (size_t value : {reinterpret_cast<size_t>(key.indexBuffer), reinterpret_cast<size_t>(key.lightingMap), reinterpret_cast<size_t>(key.shader), size_t{key.stride}}) {
+            seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+};
+
+struct Item {
+    BucketKey            key;
+    uint32_t             count{0};
+    uint32_t             next{NO_ITEM};
+    std::vector<uint8_t> data;
+};
+
+struct Instance {
+    BucketKey key;
+    uint8_t   attributes[STRIDE];
+};
+
+Item createItem(const Instance &instance) {
+    Item item;
+    item.key = instance.key;
+    item.data.resize(INITIAL_CAPACITY * STRIDE);
+    return item;
+}
+
+void append(Item &item, const Instance &instance) {
+    if ((item.count + 1) * STRIDE > item.data.size()) {
+        item.data.resize(item.data.size() * 2);
+    }
+    memcpy(item.data.data() + item.count++ * STRIDE, instance.attributes, STRIDE);
+}
+
+// the lookup InstancedBuffer::merge used to do
+void mergeLinear(std::vector<Item> &items, const Instance &instance) {
+    for (auto &item : items) {
+        if (item.key == instance.key && item.count < MAX_CAPACITY) {
+            append(item, instance);
+            return;
+        }
+    }
+    items.push_back(createItem(instance));
+    append(items.back(), instance);
+}
+
+void mergeHashed(std::vector<Item> &items, cc::FlatHashMap<BucketKey, uint32_t, BucketKeyHasher> &buckets, const Instance &instance) {
+    uint32_t *item = buckets.insert(instance.key, NO_ITEM).first;
+    while (*item != NO_ITEM) {
+        auto &candidate = items[*item];
+        if (candidate.count < MAX_CAPACITY) {
+            append(candidate, instance);
+            return;
+        }
+        item = &candidate.next;
+    }
+    *item = static_cast<uint32_t>(items.size());
+    items.push_back(createItem(instance));
+    append(items.back(), instance);
+}
+
+std::vector<Instance> randomInstances(uint32_t count, uint32_t meshCount) {
+    static uint8_t                          handles[4096];
+    std::mt19937                            rng(2021);
+    std::uniform_int_distribution<uint32_t> mesh(0, meshCount - 1);
+    std::uniform_int_distribution<uint32_t> lightmap(0, 3);
+    std::vector<Instance>                   instances(count);
+    for (auto &instance : instances) {
+        instance.key = {handles + mesh(rng), handles + 2048 + lightmap(rng), handles + 3072, STRIDE};
+        memset(instance.attributes, static_cast<int>(&instance - instances.data()), STRIDE);
+    }
+    return instances;
+}
+
+void resetCounts(std::vector<Item> &items) {
+    for (auto &item : items) item.count = 0;
+}
+} // namespace
+
+TEST(baseFlatHashMapTest, insertFind) {
+    logLabel = "test values are found by key after the table grows";
+    cc::FlatHashMap<uint32_t, uint32_t> map(4);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        const auto result = map.insert(i * 16, i);
+        ExpectEq(result.second && *result.first == i, true);
+    }
+    ExpectEq(map.size() == 1000, true);
+
+    bool allFound = true;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        const uint32_t *value = map.find(i * 16);
+        allFound &= value && *value == i;
+    }
+    ExpectEq(allFound, true);
+    ExpectEq(map.find(1) == nullptr, true);
+
+    logLabel = "test inserting an existing key keeps its value";
+    const auto existing = map.insert(32, 7);
+    ExpectEq(!existing.second && *existing.first == 2, true);
+    map[32] = 9;
+    ExpectEq(*map.find(32) == 9 && map.size() == 1000, true);
+
+    logLabel = "test forEach visits every entry and clear empties the table";
+    uint32_t sum = 0;
+    map.forEach([&](uint32_t /*key*/, uint32_t value) { sum += value; });
+    ExpectEq(sum == 999 * 1000 / 2 - 2 + 9, true);
+    map.clear();
+    ExpectEq(map.empty() && map.find(32) == nullptr, true);
+    map[5] = 1;
+    ExpectEq(map.size() == 1 && *map.find(5) == 1, true);
+}
+
+TEST(baseFlatHashMapTest, bucketLookupBenchmark) {
+    logLabel = "test hashed instance buckets merge like the linear scan";
+    constexpr uint32_t FRAMES = 10;
+    using Microseconds        = std::chrono::duration<double, std::micro>;
+
+    for (uint32_t count : {1000U, 10000U, 50000U}) {
+        // one mesh per 16 instances on average, foliage with many variants
+        const auto instances = randomInstances(count, std::max(1U, std::min(2048U, count / 16)));
+
+        // items are created in a first frame, the timed frames only look them up
+        std::vector<Item> linearItems;
+        auto              start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame <= FRAMES; ++frame) {
+            if (frame == 1) start = std::chrono::steady_clock::now();
+            resetCounts(linearItems);
+            for (const auto &instance : instances) {
+                mergeLinear(linearItems, instance);
+            }
+        }
+        const Microseconds linearTime = std::chrono::steady_clock::now() - start;
+
+        std::vector<Item>                                      hashedItems;
+        cc::FlatHashMap<BucketKey, uint32_t, BucketKeyHasher> buckets;
+        for (uint32_t frame = 0; frame <= FRAMES; ++frame) {
+            if (frame == 1) start = std::chrono::steady_clock::now();
+            resetCounts(hashedItems);
+            for (const auto &instance : instances) {
+                mergeHashed(hashedItems, buckets, instance);
+            }
+        }
+        const Microseconds hashedTime = std::chrono::steady_clock::now() - start;
+
+        bool same = linearItems.size() == hashedItems.size();
+        for (size_t i = 0; same && i < linearItems.size(); ++i) {
+            same = linearItems[i].key == hashedItems[i].key && linearItems[i].count == hashedItems[i].count &&
+                   memcmp(linearItems[i].data.data(), hashedItems[i].data.data(), linearItems[i].count * STRIDE) == 0;
+        }
+        ExpectEq(same, true);
+
+        std::cout << "bucket lookup micro benchmark x" << count << " into " << hashedItems.size() << " items: linear " << linearTime.count() / FRAMES
+                  << "us, hashed " << hashedTime.count() / FRAMES << "us" << std::endl;
+    }
+}
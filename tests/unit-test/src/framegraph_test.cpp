@@ -0,0 +1,244 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "cocos/renderer/GFXDeviceManager.h"
+#include "cocos/renderer/frame-graph/FrameGraph.h"
+#include "utils.h"
+
+namespace {
+using cc::framegraph::FrameGraph;
+using cc::framegraph::TextureHandle;
+
+constexpr uint32_t SIZE = 64;
+
+// A chain of passes over transient textures, the last one writes an imported target.
+struct ChainDesc {
+    uint32_t  width{SIZE};
+    float     clearRed{0.F};
+    bool      extraPass{false};
+};
+
+struct PassData {
+    TextureHandle input;
+    TextureHandle output;
+};
+
+cc::gfx::TextureInfo textureInfo(uint32_t width, cc::gfx::TextureUsage extraUsage = cc::gfx::TextureUsageBit::NONE) {
+    return {cc::gfx::TextureType::TEX2D, cc::gfx::TextureUsageBit::COLOR_ATTACHMENT | cc::gfx::TextureUsageBit::SAMPLED | extraUsage, cc::gfx::Format::RGBA8, width, SIZE};
+}
+
+void addPass(FrameGraph &graph, const char *name, const char *outputName, TextureHandle input, const cc::gfx::TextureInfo &outputInfo,
+             float clearRed, TextureHandle *output, cc::gfx::Texture **deviceInput) {
+    auto setup = [&](cc::framegraph::PassNodeBuilder &builder, PassData &data) {
+        if (input.isValid()) {
+            data.input = builder.read(input);
+        }
+        cc::framegraph::RenderTargetAttachment::Descriptor attachment;
+        attachment.usage      = cc::framegraph::RenderTargetAttachment::Usage::COLOR;
+        attachment.loadOp     = cc::gfx::LoadOp::CLEAR;
+        attachment.clearColor = {clearRed, 0.F, 0.F, 1.F};
+        data.output           = builder.create(FrameGraph::stringToHandle(outputName), outputInfo);
+        data.output           = builder.write(data.output, attachment);
+        *output               = data.output;
+    };
+    // attachments are not listed as writes in the resource table, so textures are looked up where they are read
+    auto execute = [deviceInput](const PassData &data, const cc::framegraph::DevicePassResourceTable &table) {
+        if (deviceInput) {
+            *deviceInput = table.getRead(data.input);
+        }
+    };
+    graph.addPass<PassData>(0, FrameGraph::stringToHandle(name), setup, execute);
+}
+
+void buildChain(FrameGraph &graph, const ChainDesc &desc, cc::gfx::Texture *target) {
+    TextureHandle first;
+    TextureHandle second;
+    addPass(graph, "first", "firstTex", TextureHandle{}, textureInfo(desc.width), desc.clearRed, &first, nullptr);
+    addPass(graph, "second", "secondTex", first, textureInfo(SIZE), 0.F, &second, nullptr);
+    if (desc.extraPass) {
+        addPass(graph, "extra", "extraTex", second, textureInfo(SIZE), 0.F, &second, nullptr);
+    }
+    graph.present(second, target, false);
+}
+
+class FrameGraphTest : public testing::Test {
+protected:
+    void SetUp() override {
+        // no window is available here, so every other backend fails to initialize and the empty device is picked
+        device = cc::gfx::DeviceManager::create(cc::gfx::DeviceInfo{});
+        target = device->createTexture(textureInfo(SIZE));
+    }
+    void TearDown() override {
+        // the pooled transient resources have to go before the device
+        FrameGraph::gc(0);
+        CC_SAFE_DESTROY(target);
+        cc::gfx::DeviceManager::destroy();
+    }
+
+    uint32_t compile(FrameGraph &graph, const ChainDesc &desc) const {
+        const uint32_t hits = graph.getCompileStats().cacheHits;
+        buildChain(graph, desc, target);
+        graph.compile();
+        graph.execute();
+        graph.reset();
+        return graph.getCompileStats().cacheHits - hits;
+    }
+
+    // four passes a -> b -> c -> d over t1 [a, b], t2 [b, c], t3 [c, d] and t4 [d, present]:
+    // t1 and t3 have disjoint lifetimes, t2 overlaps both of them
+    void buildOverlappingChain(FrameGraph &graph, cc::gfx::Texture **textures) const {
+        TextureHandle t1;
+        TextureHandle t2;
+        TextureHandle t3;
+        TextureHandle t4;
+        addPass(graph, "a", "t1", TextureHandle{}, textureInfo(SIZE), 0.F, &t1, nullptr);
+        addPass(graph, "b", "t2", t1, textureInfo(SIZE), 0.F, &t2, &textures[0]);
+        // a different usage, so that only the aliasing pass may share t1 with it
+        addPass(graph, "c", "t3", t2, textureInfo(SIZE, cc::gfx::TextureUsageBit::TRANSFER_SRC), 0.F, &t3, &textures[1]);
+        addPass(graph, "d", "t4", t3, textureInfo(SIZE), 0.F, &t4, &textures[2]);
+        graph.present(t4, target, false);
+    }
+
+    cc::gfx::Device * device{nullptr};
+    cc::gfx::Texture *target{nullptr};
+};
+} // namespace
+
+TEST_F(FrameGraphTest, compileCache) {
+    logLabel = "test the compiled graph is only reused for identical graphs";
+    FrameGraph graph;
+    graph.enableCompileCache(true);
+
+    ChainDesc desc;
+    ExpectEq(compile(graph, desc) == 0U, true);
+    ExpectEq(compile(graph, desc) == 1U, true);
+    ExpectEq(compile(graph, desc) == 1U, true);
+
+    // a different descriptor, attachment clear value or pass list must recompile
+    desc.width = SIZE / 2;
+    ExpectEq(compile(graph, desc) == 0U, true);
+    ExpectEq(compile(graph, desc) == 1U, true);
+    desc.clearRed = 0.5F;
+    ExpectEq(compile(graph, desc) == 0U, true);
+    ExpectEq(compile(graph, desc) == 1U, true);
+    desc.extraPass = true;
+    ExpectEq(compile(graph, desc) == 0U, true);
+    ExpectEq(compile(graph, desc) == 1U, true);
+    desc = ChainDesc{};
+    ExpectEq(compile(graph, desc) == 0U, true);
+    ExpectEq(graph.getCompileStats().cacheMisses == 5U, true);
+}
+
+TEST_F(FrameGraphTest, aliasing) {
+    logLabel = "test transient resources only alias when their lifetimes are disjoint";
+    cc::gfx::Texture *textures[3]{};
+
+    {
+        FrameGraph graph;
+        buildOverlappingChain(graph, textures);
+        graph.compile();
+        graph.execute();
+        // without aliasing only identical descriptors share a device texture
+        ExpectEq(textures[0] != nullptr && textures[1] != nullptr && textures[2] != nullptr, true);
+        ExpectEq(textures[0] != textures[2], true);
+        ExpectEq(textures[0] != textures[1] && textures[1] != textures[2], true);
+        ExpectEq(graph.getTransientMemoryStats().peakWithAliasing == graph.getTransientMemoryStats().peakWithoutAliasing, true);
+        graph.reset();
+    }
+    FrameGraph::gc(0);
+
+    FrameGraph graph;
+    graph.enableAliasing(true);
+    buildOverlappingChain(graph, textures);
+    graph.compile();
+    graph.execute();
+    ExpectEq(textures[0] == textures[2], true);
+    ExpectEq(textures[1] != textures[0], true);
+    ExpectEq(textures[1] != textures[2], true);
+    const auto &stats = graph.getTransientMemoryStats();
+    ExpectEq(stats.peakWithAliasing < stats.peakWithoutAliasing, true);
+    graph.reset();
+}
+
+TEST_F(FrameGraphTest, aliasingWithCompileCache) {
+    logLabel = "test the compiled graph is reused across frames when transient resources alias";
+    cc::gfx::Texture *textures[3]{};
+    FrameGraph        graph;
+    graph.enableCompileCache(true);
+    graph.enableAliasing(true);
+
+    constexpr uint32_t FRAMES = 8;
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        buildOverlappingChain(graph, textures);
+        graph.compile();
+        graph.execute();
+        ExpectEq(textures[0] == textures[2] && textures[1] != textures[0], true);
+        graph.reset();
+    }
+    ExpectEq(graph.getCompileStats().cacheMisses == 1U, true);
+    ExpectEq(graph.getCompileStats().cacheHits == FRAMES - 1, true);
+}
+
+TEST_F(FrameGraphTest, steadyStateStorage) {
+    logLabel = "test node storage and device passes are reused once the graph is stable";
+    FrameGraph graph;
+    graph.enableCompileCache(true);
+
+    ChainDesc desc;
+    desc.extraPass = true;
+    compile(graph, desc);
+    compile(graph, desc);
+    const uint32_t arenaBlocks  = graph.getArenaBlockAllocationCount();
+    const uint32_t devicePasses = graph.getDevicePassAllocationCount();
+    ExpectEq(arenaBlocks > 0 && devicePasses > 0, true);
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        compile(graph, desc);
+    }
+    ExpectEq(graph.getArenaBlockAllocationCount() == arenaBlocks, true);
+    ExpectEq(graph.getArenaOverflowAllocationCount() == 0, true);
+    ExpectEq(graph.getDevicePassAllocationCount() == devicePasses, true);
+
+    // a recompile creates new device passes, the node storage still fits
+    desc.extraPass = false;
+    compile(graph, desc);
+    ExpectEq(graph.getArenaBlockAllocationCount() == arenaBlocks, true);
+    ExpectEq(graph.getArenaOverflowAllocationCount() == 0, true);
+    ExpectEq(graph.getDevicePassAllocationCount() > devicePasses, true);
+}
+
+TEST_F(FrameGraphTest, arenaOverflow) {
+    logLabel = "test arena allocations past the first block are counted until the blocks are coalesced";
+    cc::framegraph::Arena arena(64);
+    arena.allocate(48, 8);
+    ExpectEq(arena.getOverflowAllocationCount() == 0, true);
+    arena.allocate(48, 8);
+    arena.allocate(8, 8);
+    ExpectEq(arena.getOverflowAllocationCount() == 2, true);
+
+    arena.recycle();
+    arena.allocate(48, 8);
+    arena.allocate(48, 8);
+    ExpectEq(arena.getOverflowAllocationCount() == 2, true);
+}
@@ -0,0 +1,145 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+
+#include "cocos/renderer/GFXDeviceManager.h"
+#include "cocos/renderer/gfx-agent/CommandBufferAgent.h"
+#include "cocos/renderer/gfx-agent/DeviceAgent.h"
+#include "cocos/base/threading/MessageQueue.h"
+#include "utils.h"
+#include <thread>
+#include <vector>
+
+// Secondary command buffers are recorded through the gfx agent by several producer threads at once,
+// then executed from a primary. The actors log the draws they receive, so the primary ends up with
+// every draw of every secondary, in the order the secondaries were executed.
+
+namespace {
+constexpr uint32_t RECORDING_THREADS = 4;
+constexpr uint32_t DRAWS_PER_THREAD  = 4096;
+
+class RecordingCommandBuffer final : public cc::gfx::CommandBuffer {
+public:
+    void begin(cc::gfx::RenderPass * /*renderPass*/, uint32_t /*subpass*/, cc::gfx::Framebuffer * /*frameBuffer*/) override { draws.clear(); }
+    void end() override {}
+    void beginRenderPass(cc::gfx::RenderPass * /*renderPass*/, cc::gfx::Framebuffer * /*fbo*/, const cc::gfx::Rect & /*renderArea*/, const cc::gfx::Color * /*colors*/, float /*depth*/, uint32_t /*stencil*/, cc::gfx::CommandBuffer *const * /*secondaryCBs*/, uint32_t /*secondaryCBCount*/) override {}
+    void endRenderPass() override {}
+    void bindPipelineState(cc::gfx::PipelineState * /*pso*/) override {}
+    void bindDescriptorSet(uint32_t /*set*/, cc::gfx::DescriptorSet * /*descriptorSet*/, uint32_t /*dynamicOffsetCount*/, const uint32_t * /*dynamicOffsets*/) override {}
+    void bindInputAssembler(cc::gfx::InputAssembler * /*ia*/) override {}
+    void setViewport(const cc::gfx::Viewport & /*vp*/) override {}
+    void setScissor(const cc::gfx::Rect & /*rect*/) override {}
+    void setLineWidth(float /*width*/) override {}
+    void setDepthBias(float /*constant*/, float /*clamp*/, float /*slope*/) override {}
+    void setBlendConstants(const cc::gfx::Color & /*constants*/) override {}
+    void setDepthBound(float /*minBounds*/, float /*maxBounds*/) override {}
+    void setStencilWriteMask(cc::gfx::StencilFace /*face*/, uint32_t /*mask*/) override {}
+    void setStencilCompareMask(cc::gfx::StencilFace /*face*/, uint32_t /*ref*/, uint32_t /*mask*/) override {}
+    void nextSubpass() override {}
+    void draw(const cc::gfx::DrawInfo &info) override { draws.push_back(info.firstIndex); }
+    void updateBuffer(cc::gfx::Buffer * /*buff*/, const void * /*data*/, uint32_t /*size*/) override {}
+    void copyBuffersToTexture(const uint8_t *const * /*buffers*/, cc::gfx::Texture * /*texture*/, const cc::gfx::BufferTextureCopy * /*regions*/, uint32_t /*count*/) override {}
+    void blitTexture(cc::gfx::Texture * /*srcTexture*/, cc::gfx::Texture * /*dstTexture*/, const cc::gfx::TextureBlit * /*regions*/, uint32_t /*count*/, cc::gfx::Filter /*filter*/) override {}
+    void dispatch(const cc::gfx::DispatchInfo & /*info*/) override {}
+    void pipelineBarrier(const cc::gfx::GlobalBarrier * /*barrier*/, const cc::gfx::TextureBarrier *const * /*textureBarriers*/, const cc::gfx::Texture *const * /*textures*/, uint32_t /*textureBarrierCount*/) override {}
+    void beginQuery(cc::gfx::QueryPool * /*queryPool*/, uint32_t /*id*/) override {}
+    void endQuery(cc::gfx::QueryPool * /*queryPool*/, uint32_t /*id*/) override {}
+    void resetQueryPool(cc::gfx::QueryPool * /*queryPool*/) override {}
+
+    void execute(cc::gfx::CommandBuffer *const *cmdBuffs, uint32_t count) override {
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto &secondaryDraws = static_cast<RecordingCommandBuffer *>(cmdBuffs[i])->draws;
+            draws.insert(draws.end(), secondaryDraws.begin(), secondaryDraws.end());
+        }
+    }
+
+    std::vector<uint32_t> draws;
+
+protected:
+    void doInit(const cc::gfx::CommandBufferInfo & /*info*/) override {}
+    void doDestroy() override {}
+};
+} // namespace
+
+TEST(gfxCommandBufferAgentTest, multiProducerRecording) {
+    logLabel = "test secondary command buffers recorded on several threads are executed in order";
+
+    // no window is available here, so every other backend fails to initialize and the empty device is picked
+    cc::gfx::DeviceManager::create(cc::gfx::DeviceInfo{});
+    auto *device = cc::gfx::DeviceAgent::getInstance();
+    ASSERT_NE(device, nullptr);
+
+    auto *                  primaryActor = new RecordingCommandBuffer;
+    cc::gfx::CommandBuffer *primary      = CC_NEW(cc::gfx::CommandBufferAgent(primaryActor));
+    primary->initialize({device->getQueue(), cc::gfx::CommandBufferType::PRIMARY});
+
+    std::vector<cc::gfx::CommandBuffer *> secondaries;
+    for (uint32_t i = 0; i < RECORDING_THREADS; ++i) {
+        secondaries.push_back(CC_NEW(cc::gfx::CommandBufferAgent(new RecordingCommandBuffer)));
+        secondaries.back()->initialize({device->getQueue(), cc::gfx::CommandBufferType::SECONDARY});
+    }
+
+    for (uint32_t frame = 0; frame < 3; ++frame) {
+        std::vector<std::thread> producers;
+        for (uint32_t i = 0; i < RECORDING_THREADS; ++i) {
+            producers.emplace_back([&secondaries, i]() {
+                auto *cmdBuff = secondaries[i];
+                cmdBuff->begin();
+                for (uint32_t j = 0; j < DRAWS_PER_THREAD; ++j) {
+                    cc::gfx::DrawInfo info;
+                    info.firstIndex = i * DRAWS_PER_THREAD + j;
+                    cmdBuff->draw(info);
+                }
+                cmdBuff->end();
+            });
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+
+        // execute in reverse so the expected order differs from the order the threads were spawned in
+        std::vector<cc::gfx::CommandBuffer *> executionOrder(secondaries.rbegin(), secondaries.rend());
+        primary->begin();
+        primary->execute(executionOrder.data(), RECORDING_THREADS);
+        primary->end();
+
+        cc::gfx::CommandBuffer *cmdBuffs[]{primary};
+        device->flushCommands(cmdBuffs, 1);
+        device->getMessageQueue()->kickAndWait();
+
+        ASSERT_EQ(primaryActor->draws.size(), RECORDING_THREADS * DRAWS_PER_THREAD);
+        uint32_t n = 0;
+        for (uint32_t i = RECORDING_THREADS; i-- > 0;) {
+            for (uint32_t j = 0; j < DRAWS_PER_THREAD; ++j) {
+                ExpectEq(primaryActor->draws[n++] == i * DRAWS_PER_THREAD + j, true);
+            }
+        }
+    }
+
+    for (auto *cmdBuff : secondaries) {
+        CC_SAFE_DESTROY(cmdBuff);
+    }
+    CC_SAFE_DESTROY(primary);
+    cc::gfx::DeviceManager::destroy();
+}
@@ -0,0 +1,118 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "cocos/renderer/gfx-base/GFXPipelineCacheFile.h"
+#include "utils.h"
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace {
+cc::gfx::PipelineCacheDeviceInfo testDevice() {
+    cc::gfx::PipelineCacheDeviceInfo device;
+    device.vendorID      = 0x10DEU;
+    device.deviceID      = 0x1234U;
+    device.driverVersion = 0x00470001U;
+    for (uint8_t i = 0; i < cc::gfx::PIPELINE_CACHE_UUID_SIZE; ++i) {
+        device.uuid[i] = i * 7U;
+    }
+    return device;
+}
+
+std::vector<uint8_t> writeFile(const cc::gfx::PipelineCacheDeviceInfo &device, const std::vector<uint8_t> &blob) {
+    std::vector<uint8_t> file(sizeof(cc::gfx::PipelineCacheFileHeader) + blob.size());
+    if (!blob.empty()) {
+        memcpy(file.data() + sizeof(cc::gfx::PipelineCacheFileHeader), blob.data(), blob.size());
+    }
+    cc::gfx::writePipelineCacheHeader(device, file.data(), blob.size());
+    return file;
+}
+
+bool accepts(const cc::gfx::PipelineCacheDeviceInfo &device, const std::vector<uint8_t> &file) {
+    size_t blobSize = 0U;
+    return cc::gfx::readPipelineCacheBlob(device, file.data(), file.size(), &blobSize) != nullptr;
+}
+
+// patches a header field in a written file
+template <typename T>
+std::vector<uint8_t> patch(std::vector<uint8_t> file, size_t offset, T value) {
+    memcpy(file.data() + offset, &value, sizeof(value));
+    return file;
+}
+} // namespace
+
+TEST(gfxPipelineCacheFileTest, roundTrip) {
+    logLabel = "test that a pipeline cache file returns the blob it was written with";
+    const auto           device = testDevice();
+    std::vector<uint8_t> blob(1000);
+    for (size_t i = 0; i < blob.size(); ++i) {
+        blob[i] = static_cast<uint8_t>(i * 31U);
+    }
+    const auto file = writeFile(device, blob);
+
+    size_t         blobSize = 0U;
+    const uint8_t *result   = cc::gfx::readPipelineCacheBlob(device, file.data(), file.size(), &blobSize);
+    ExpectEq(result == file.data() + sizeof(cc::gfx::PipelineCacheFileHeader), true);
+    ExpectEq(blobSize == blob.size() && !memcmp(result, blob.data(), blobSize), true);
+}
+
+TEST(gfxPipelineCacheFileTest, rejection) {
+    logLabel = "test that incompatible or corrupted pipeline cache files are rejected";
+    using Header      = cc::gfx::PipelineCacheFileHeader;
+    const auto device = testDevice();
+    const auto file   = writeFile(device, std::vector<uint8_t>(256, 0xA5U));
+    ExpectEq(accepts(device, file), true);
+
+    // header fields from another format version or another file type
+    ExpectEq(accepts(device, patch(file, offsetof(Header, magic), 0x12345678U)), false);
+    ExpectEq(accepts(device, patch(file, offsetof(Header, version), cc::gfx::PIPELINE_CACHE_VERSION + 1U)), false);
+
+    // written by another device or driver
+    auto other = device;
+    other.vendorID++;
+    ExpectEq(accepts(other, file), false);
+    other = device;
+    other.deviceID++;
+    ExpectEq(accepts(other, file), false);
+    other = device;
+    other.driverVersion++;
+    ExpectEq(accepts(other, file), false);
+    other = device;
+    other.uuid[cc::gfx::PIPELINE_CACHE_UUID_SIZE - 1]++;
+    ExpectEq(accepts(other, file), false);
+
+    // truncated, extended or corrupted files
+    ExpectEq(accepts(device, std::vector<uint8_t>(file.begin(), file.begin() + sizeof(Header) - 1)), false);
+    ExpectEq(accepts(device, std::vector<uint8_t>(file.begin(), file.end() - 1)), false);
+    auto extended = file;
+    extended.push_back(0U);
+    ExpectEq(accepts(device, extended), false);
+    ExpectEq(accepts(device, patch(file, file.size() - 1, static_cast<uint8_t>(file.back() ^ 1U))), false);
+    ExpectEq(accepts(device, patch(file, offsetof(Header, dataSize), 255U)), false);
+    size_t blobSize = 0U;
+    ExpectEq(cc::gfx::readPipelineCacheBlob(device, nullptr, 0U, &blobSize) == nullptr, true);
+
+    // an empty blob is still a valid file
+    ExpectEq(accepts(device, writeFile(device, {})), true);
+}
@@ -0,0 +1,204 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "cocos/base/threading/MessageQueue.h"
+#include "cocos/renderer/GFXDeviceManager.h"
+#include "cocos/renderer/gfx-agent/BufferAgent.h"
+#include "cocos/renderer/gfx-agent/DeviceAgent.h"
+#include "utils.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Buffers are updated through the gfx agent: `update` copies the caller's data into message
+// queue memory, `beginUpdate/endUpdate` hands out memory from the per-frame upload ring
+// (or the per-frame staging buffers of large host visible buffers) to be written in place.
+// The actors log the updates they receive on the device thread.
+
+namespace {
+constexpr uint32_t FRAMES = 6;
+
+class RecordingBuffer final : public cc::gfx::Buffer {
+public:
+    struct Update {
+        uint32_t size{0};
+        uint8_t  value{0};
+        bool     uniform{false};
+    };
+
+    void update(const void *buffer, uint32_t size) override {
+        if (!record) return;
+        const auto *bytes   = static_cast<const uint8_t *>(buffer);
+        bool        uniform = true;
+        for (uint32_t i = 1; i < size && uniform; ++i) {
+            uniform = bytes[i] == bytes[0];
+        }
+        updates.push_back({size, bytes[0], uniform});
+    }
+
+    bool                record{true};
+    std::vector<Update> updates;
+
+protected:
+    void doInit(const cc::gfx::BufferInfo & /*info*/) override {}
+    void doInit(const cc::gfx::BufferViewInfo & /*info*/) override {}
+    void doResize(uint32_t /*size*/, uint32_t /*count*/) override {}
+    void doDestroy() override {}
+};
+
+class GfxUploadRingTest : public testing::Test {
+protected:
+    void SetUp() override {
+        // no window is available here, so every other backend fails to initialize and the empty device is picked
+        device = cc::gfx::DeviceManager::create(cc::gfx::DeviceInfo{});
+        agent  = cc::gfx::DeviceAgent::getInstance();
+    }
+    void TearDown() override {
+        cc::gfx::DeviceManager::destroy();
+    }
+
+    cc::gfx::Buffer *createBuffer(RecordingBuffer **actor, cc::gfx::MemoryUsage memUsage, uint32_t size) const {
+        *actor       = new RecordingBuffer;
+        auto *buffer = CC_NEW(cc::gfx::BufferAgent(*actor));
+        buffer->initialize({cc::gfx::BufferUsageBit::VERTEX, memUsage, size});
+        return buffer;
+    }
+
+    static void mappedUpdate(cc::gfx::Buffer *buffer, uint32_t size, uint8_t value) {
+        uint8_t *data = buffer->beginUpdate(size);
+        memset(data, value, size);
+        buffer->endUpdate();
+    }
+
+    static void copyUpdate(cc::gfx::Buffer *buffer, std::vector<uint8_t> *source, uint8_t value) {
+        memset(source->data(), value, source->size());
+        buffer->update(source->data(), static_cast<uint32_t>(source->size()));
+    }
+
+    // every frame a full update followed by a partial mapped update and a full mapped update
+    void updateFrames(cc::gfx::Buffer *buffer, const RecordingBuffer *actor, uint32_t updatesPerFrame) {
+        const uint32_t       size = buffer->getSize();
+        std::vector<uint8_t> source(size);
+        for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+            copyUpdate(buffer, &source, static_cast<uint8_t>(frame * 4));
+            mappedUpdate(buffer, size / 2, static_cast<uint8_t>(frame * 4 + 1));
+            for (uint32_t i = 2; i < updatesPerFrame; ++i) {
+                mappedUpdate(buffer, size, static_cast<uint8_t>(frame * 4 + i));
+            }
+            device->present();
+        }
+        agent->getMessageQueue()->kickAndWait();
+
+        ASSERT_EQ(actor->updates.size(), FRAMES * updatesPerFrame);
+        for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+            for (uint32_t i = 0; i < updatesPerFrame; ++i) {
+                const auto &update = actor->updates[frame * updatesPerFrame + i];
+                ExpectEq(update.size == (i == 1 ? size / 2 : size), true);
+                ExpectEq(update.value == static_cast<uint8_t>(frame * 4 + i), true);
+                ExpectEq(update.uniform, true);
+            }
+        }
+    }
+
+    cc::gfx::Device *     device{nullptr};
+    cc::gfx::DeviceAgent *agent{nullptr};
+};
+} // namespace
+
+TEST_F(GfxUploadRingTest, uploadRing) {
+    logLabel = "test mapped updates written to the upload ring reach the actor in order";
+    RecordingBuffer *actor  = nullptr;
+    cc::gfx::Buffer *buffer = createBuffer(&actor, cc::gfx::MemoryUsageBit::DEVICE, 4096);
+    updateFrames(buffer, actor, 3);
+    CC_SAFE_DESTROY(buffer);
+}
+
+TEST_F(GfxUploadRingTest, stagingBuffers) {
+    logLabel = "test mapped updates of large host visible buffers go through the staging buffers";
+    RecordingBuffer *actor  = nullptr;
+    cc::gfx::Buffer *buffer = createBuffer(&actor, cc::gfx::MemoryUsageBit::HOST | cc::gfx::MemoryUsageBit::DEVICE, cc::MessageQueue::MEMORY_CHUNK_SIZE);
+    updateFrames(buffer, actor, 3);
+    CC_SAFE_DESTROY(buffer);
+}
+
+TEST_F(GfxUploadRingTest, ringOverflow) {
+    logLabel = "test mapped updates overflowing the upload ring fall back to the heap";
+    RecordingBuffer *actor = nullptr;
+    // several times the initial ring size per frame, the later frames get a grown ring
+    cc::gfx::Buffer *buffer = createBuffer(&actor, cc::gfx::MemoryUsageBit::DEVICE, 1024 * 1024);
+    updateFrames(buffer, actor, 12);
+    CC_SAFE_DESTROY(buffer);
+}
+
+TEST_F(GfxUploadRingTest, validatedBuffer) {
+    logLabel = "test mapped updates through the validator and the empty backend";
+    cc::gfx::Buffer *buffer = device->createBuffer({cc::gfx::BufferUsageBit::VERTEX, cc::gfx::MemoryUsageBit::DEVICE, 4096});
+    for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+        mappedUpdate(buffer, 4096, static_cast<uint8_t>(frame));
+        mappedUpdate(buffer, 16, static_cast<uint8_t>(frame));
+        // direct updates are allowed again once the mapping is closed
+        std::vector<uint8_t> source(4096);
+        copyUpdate(buffer, &source, static_cast<uint8_t>(frame));
+        device->present();
+    }
+    agent->getMessageQueue()->kickAndWait();
+    CC_SAFE_DESTROY(buffer);
+}
+
+TEST_F(GfxUploadRingTest, mappedUpdateBenchmark) {
+    logLabel = "test buffer upload throughput through the gfx agent";
+    constexpr uint32_t BENCHMARK_FRAMES = 50;
+    constexpr uint32_t UPDATES          = 64;
+    constexpr uint32_t UPDATE_SIZE      = 16 * 1024;
+
+    RecordingBuffer *actor  = nullptr;
+    cc::gfx::Buffer *buffer = createBuffer(&actor, cc::gfx::MemoryUsageBit::DEVICE, UPDATE_SIZE);
+    actor->record           = false;
+
+    std::vector<uint8_t> source(UPDATE_SIZE);
+    const auto           measure = [&](bool mapped) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < BENCHMARK_FRAMES; ++frame) {
+            for (uint32_t i = 0; i < UPDATES; ++i) {
+                if (mapped) {
+                    mappedUpdate(buffer, UPDATE_SIZE, static_cast<uint8_t>(i));
+                } else {
+                    copyUpdate(buffer, &source, static_cast<uint8_t>(i));
+                }
+            }
+            device->present();
+        }
+        agent->getMessageQueue()->kickAndWait();
+        const double megabytes = static_cast<double>(BENCHMARK_FRAMES) * UPDATES * UPDATE_SIZE / (1024.0 * 1024.0);
+        return megabytes / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    const double copyThroughput   = measure(false);
+    const double mappedThroughput = measure(true);
+    std::cout << "buffer upload x" << BENCHMARK_FRAMES * UPDATES << " (" << UPDATE_SIZE << " bytes): update " << copyThroughput
+              << "MB/s, beginUpdate/endUpdate " << mappedThroughput << "MB/s" << std::endl;
+    CC_SAFE_DESTROY(buffer);
+}
@@ -30,6 +30,12 @@ THE SOFTWARE.
 #include "cocos/math/Quaternion.h"
 #include "utils.h"
 #include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
 
 TEST(mathMat4Test, test5) {
     cc::Mat4 mat4;
@@ -268,3 +274,136 @@ TEST(mathMat4Test, test5) {
     matTranspose.transpose();
     ExpectEq(matTranspose.m[1] == 21 && matTranspose.m[4] == 12 && matTranspose.m[7] == 4, true);
 }
+
+namespace {
+cc::Mat4 randomMat4(std::mt19937 &rng) {
+    std::uniform_real_distribution<float> value(-2.0F, 2.0F);
+    cc::Mat4                              mat;
+    do {
+        for (float &v : mat.m) {
+            v = value(rng);
+        }
+    } while (std::abs(mat.determinant()) < 0.5F);
+    return mat;
+}
+
+// Plain loops, used as the reference for both the scalar and the SIMD build.
+void referenceMultiply(const cc::Mat4 &a, const cc::Mat4 &b, double *dst) {
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            double sum = 0.0;
+            for (int k = 0; k < 4; ++k) {
+                sum += static_cast<double>(a.m[k * 4 + r]) * b.m[c * 4 + k];
+            }
+            dst[c * 4 + r] = sum;
+        }
+    }
+}
+
+bool isNear(const cc::Mat4 &mat, const double *expected, double tolerance) {
+    for (int i = 0; i < 16; ++i) {
+        if (std::abs(mat.m[i] - expected[i]) > tolerance * std::max(1.0, std::abs(expected[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST(mathMat4Test, simdConsistency) {
+    std::mt19937 rng(20211);
+    for (int n = 0; n < 200; ++n) {
+        const cc::Mat4 a = randomMat4(rng);
+        const cc::Mat4 b = randomMat4(rng);
+        double         expected[16];
+
+        logLabel = "test the mat4 multiply function against the reference";
+        cc::Mat4 product;
+        cc::Mat4::multiply(a, b, &product);
+        referenceMultiply(a, b, expected);
+        ExpectEq(isNear(product, expected, 1e-5), true);
+        // in place, dst aliasing the right operand
+        cc::Mat4 aliased = b;
+        cc::Mat4::multiply(a, aliased, &aliased);
+        ExpectEq(memcmp(aliased.m, product.m, sizeof(product.m)) == 0, true);
+
+        logLabel = "test the mat4 inverse function against the reference";
+        cc::Mat4 inversed = a.getInversed();
+        cc::Mat4 identity;
+        cc::Mat4::multiply(a, inversed, &identity);
+        referenceMultiply(cc::Mat4::IDENTITY, cc::Mat4::IDENTITY, expected);
+        ExpectEq(isNear(identity, expected, 1e-4), true);
+
+        logLabel = "test the mat4 inverseTranspose function against the reference";
+        cc::Mat4 normalMat;
+        cc::Mat4::inverseTranspose(a, &normalMat);
+        for (int c = 0; c < 3; ++c) {
+            for (int r = 0; r < 3; ++r) {
+                ExpectEq(std::abs(normalMat.m[c * 4 + r] - inversed.m[r * 4 + c]) < 1e-4F, true);
+            }
+        }
+        ExpectEq(normalMat.m[3] == 0 && normalMat.m[7] == 0 && normalMat.m[11] == 0, true);
+        ExpectEq(normalMat.m[12] == 0 && normalMat.m[13] == 0 && normalMat.m[14] == 0 && normalMat.m[15] == 1, true);
+
+        logLabel = "test the mat4 transformVector function against the reference";
+        cc::Vec4 vec(1.5F, -2.0F, 0.5F, 1.0F);
+        cc::Vec4 transformed;
+        a.transformVector(vec, &transformed);
+        const float *v = &vec.x;
+        for (int r = 0; r < 4; ++r) {
+            double sum = 0.0;
+            for (int k = 0; k < 4; ++k) {
+                sum += static_cast<double>(a.m[k * 4 + r]) * v[k];
+            }
+            ExpectEq(std::abs((&transformed.x)[r] - sum) < 1e-4, true);
+        }
+    }
+
+    logLabel = "test the mat4 inverse function with a singular matrix";
+    cc::Mat4 singular(1, 2, 3, 4, 2, 4, 6, 8, 0, 0, 1, 0, 0, 0, 0, 1);
+    cc::Mat4 untouched = singular;
+    ExpectEq(singular.inverse(), false);
+    ExpectEq(memcmp(singular.m, untouched.m, sizeof(untouched.m)) == 0, true);
+}
+
+TEST(mathMat4Test, simdBenchmark) {
+    constexpr int         COUNT      = 1024;
+    constexpr int         ITERATIONS = 200;
+    std::mt19937          rng(4096);
+    std::vector<cc::Mat4> mats;
+    for (int i = 0; i < COUNT; ++i) {
+        mats.push_back(randomMat4(rng));
+    }
+    std::vector<cc::Mat4> out(COUNT);
+
+    using Clock        = std::chrono::steady_clock;
+    using Microseconds = std::chrono::duration<double, std::micro>;
+
+    const auto multiplyStart = Clock::now();
+    for (int n = 0; n < ITERATIONS; ++n) {
+        for (int i = 0; i < COUNT; ++i) {
+            cc::Mat4::multiply(mats[i], mats[(i + n) % COUNT], &out[i]);
+        }
+    }
+    const auto inverseStart = Clock::now();
+    for (int n = 0; n < ITERATIONS; ++n) {
+        for (int i = 0; i < COUNT; ++i) {
+            out[i] = mats[(i + n) % COUNT];
+            out[i].inverse();
+        }
+    }
+    const auto inverseTransposeStart = Clock::now();
+    for (int n = 0; n < ITERATIONS; ++n) {
+        for (int i = 0; i < COUNT; ++i) {
+            cc::Mat4::inverseTranspose(mats[(i + n) % COUNT], &out[i]);
+        }
+    }
+    const auto end = Clock::now();
+
+    // Build with and without USE_MATH_SIMD to compare both modes.
+    std::cout << "mat4 x" << COUNT << (USE_MATH_SIMD ? " (simd)" : " (scalar)")
+              << ": multiply " << Microseconds(inverseStart - multiplyStart).count() / ITERATIONS
+              << "us, inverse " << Microseconds(inverseTransposeStart - inverseStart).count() / ITERATIONS
+              << "us, inverseTranspose " << Microseconds(end - inverseTransposeStart).count() / ITERATIONS << "us" << std::endl;
+    EXPECT_EQ(out.size(), static_cast<size_t>(COUNT));
+}
@@ -0,0 +1,316 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "utils.h"
+
+#if USE_MIDDLEWARE
+    #include "cocos/editor-support/BakedCache.h"
+    #include "cocos/editor-support/IOBuffer.h"
+    #include <cmath>
+    #include <cstring>
+    #include <random>
+    #include <string>
+    #include <vector>
+
+// Round trips cache frames shaped like spine::SkeletonCache ones (two color vertices, color
+// runs, texture segments) through the baked cache writer and the mapped reader.
+
+namespace {
+using cc::middleware::BakedCacheFile;
+using cc::middleware::BakedCacheFormat;
+using cc::middleware::BakedCacheWriter;
+
+constexpr uint32_t VS2        = 13; // floats of a V2F_T2F_C4F_C4F vertex
+constexpr uint32_t ANIMATIONS = 2;
+constexpr uint32_t FRAMES     = 30;
+constexpr uint32_t BONES      = 12;
+constexpr uint32_t VERTICES   = 40;
+constexpr uint32_t RUNS       = 3;
+constexpr uint32_t SEGMENTS   = 2;
+
+struct SampleColor {
+    float    finalColor[4];
+    float    darkColor[4];
+    uint32_t vertexFloatOffset;
+};
+
+struct SampleFrame {
+    std::vector<float>       bones; // 16 floats per bone
+    std::vector<SampleColor> colors;
+    std::vector<uint32_t>    segmentTextures;
+    std::vector<float>       vertices;
+    std::vector<uint16_t>    indices;
+};
+
+SampleFrame randomFrame(std::mt19937 &rng) {
+    std::uniform_real_distribution<float> unit(-1.0F, 1.0F);
+    std::uniform_int_distribution<int>    channel(0, 255);
+    SampleFrame                           frame;
+    frame.bones.resize(BONES * 16, 0.0F);
+    for (auto &value : frame.bones) value = unit(rng) * 100.0F;
+
+    frame.vertices.resize(VERTICES * VS2, 0.0F);
+    const uint32_t runVertices = VERTICES / RUNS;
+    for (uint32_t r = 0; r < RUNS; ++r) {
+        SampleColor color;
+        for (uint32_t k = 0; k < 4; ++k) {
+            color.finalColor[k] = static_cast<float>(channel(rng));
+            color.darkColor[k]  = k == 3 ? 0.0F : static_cast<float>(channel(rng));
+        }
+        color.vertexFloatOffset = (r == RUNS - 1 ? VERTICES : (r + 1) * runVertices) * VS2;
+        frame.colors.push_back(color);
+    }
+    for (uint32_t v = 0, r = 0; v < VERTICES; ++v) {
+        while (v * VS2 >= frame.colors[r].vertexFloatOffset) ++r;
+        float *vertex = &frame.vertices[v * VS2];
+        vertex[0]     = unit(rng) * 300.0F;
+        vertex[1]     = unit(rng) * 300.0F;
+        vertex[3]     = (unit(rng) + 1.0F) / 2.0F;
+        vertex[4]     = (unit(rng) + 1.0F) / 2.0F;
+        for (uint32_t k = 0; k < 4; ++k) {
+            vertex[5 + k] = frame.colors[r].finalColor[k] / 255.0F;
+            vertex[9 + k] = frame.colors[r].darkColor[k] / 255.0F;
+        }
+    }
+
+    // same topology every frame, as for animations that keep their draw order
+    for (uint32_t s = 0; s < SEGMENTS; ++s) {
+        for (uint32_t v = 0; v + 2 < VERTICES / SEGMENTS; ++v) {
+            frame.indices.push_back(static_cast<uint16_t>(v));
+            frame.indices.push_back(static_cast<uint16_t>(v + 1));
+            frame.indices.push_back(static_cast<uint16_t>(v + 2));
+        }
+        frame.segmentTextures.push_back(s);
+    }
+    return frame;
+}
+
+std::vector<std::vector<SampleFrame>> randomAnimations() {
+    std::mt19937                          rng(19);
+    std::vector<std::vector<SampleFrame>> animations(ANIMATIONS);
+    for (auto &frames : animations) {
+        for (uint32_t f = 0; f < FRAMES; ++f) {
+            frames.push_back(randomFrame(rng));
+        }
+    }
+    return animations;
+}
+
+std::string animationName(uint32_t index) {
+    return "animation/" + std::to_string(index);
+}
+
+std::string textureKey(uint32_t index) {
+    return "default\n" + std::to_string(index) + "\nattachment";
+}
+
+BakedCacheWriter writeAnimations(const std::vector<std::vector<SampleFrame>> &animations, bool quantize) {
+    BakedCacheWriter writer(VS2, 255.0F, quantize);
+    for (uint32_t a = 0; a < animations.size(); ++a) {
+        writer.beginAnimation(animationName(a), a == 0, FRAMES / 60.0F);
+        for (const auto &frame : animations[a]) {
+            writer.beginFrame();
+            for (uint32_t b = 0; b < BONES; ++b) {
+                writer.addBone(&frame.bones[b * 16]);
+            }
+            for (const auto &color : frame.colors) {
+                writer.addColor(color.finalColor, color.darkColor, color.vertexFloatOffset);
+            }
+            const auto segmentIndices = static_cast<uint32_t>(frame.indices.size() / SEGMENTS);
+            for (auto texture : frame.segmentTextures) {
+                writer.addSegment(writer.addTexture(textureKey(texture)), texture, segmentIndices, VERTICES / SEGMENTS * VS2);
+            }
+            writer.endFrame(reinterpret_cast<const uint8_t *>(frame.vertices.data()), frame.vertices.size() * sizeof(float),
+                            reinterpret_cast<const uint8_t *>(frame.indices.data()), frame.indices.size() * sizeof(uint16_t));
+        }
+    }
+    return writer;
+}
+
+// Checks everything but the vertices, which depend on the encoding.
+bool sameFrameData(const BakedCacheFile &file, const std::vector<std::vector<SampleFrame>> &animations) {
+    if (file.getAnimationCount() != animations.size() || file.getTextureCount() != SEGMENTS) return false;
+    for (uint32_t t = 0; t < SEGMENTS; ++t) {
+        if (file.getTextureKey(t) != textureKey(t)) return false;
+    }
+    for (uint32_t a = 0; a < animations.size(); ++a) {
+        const auto &animation = file.getAnimation(a);
+        if (file.getAnimationName(a) != animationName(a) || (animation.isComplete != 0) != (a == 0) ||
+            animation.totalTime != FRAMES / 60.0F || animation.frameCount != FRAMES) {
+            return false;
+        }
+        for (uint32_t f = 0; f < FRAMES; ++f) {
+            const auto &expected = animations[a][f];
+            const auto &frame    = file.getFrame(animation.firstFrame + f);
+            if (frame.boneCount != BONES || frame.colorCount != RUNS || frame.segmentCount != SEGMENTS) return false;
+            const float *bones = file.getBones(frame);
+            for (uint32_t b = 0; b < BONES; ++b, bones += BakedCacheFormat::BONE_FLOATS) {
+                const float *matrix = &expected.bones[b * 16];
+                if (bones[0] != matrix[0] || bones[1] != matrix[1] || bones[2] != matrix[4] ||
+                    bones[3] != matrix[5] || bones[4] != matrix[12] || bones[5] != matrix[13]) {
+                    return false;
+                }
+            }
+            const auto *colors = file.getColors(frame);
+            for (uint32_t c = 0; c < RUNS; ++c) {
+                if (memcmp(colors[c].finalColor, expected.colors[c].finalColor, sizeof(float) * 4) != 0 ||
+                    memcmp(colors[c].darkColor, expected.colors[c].darkColor, sizeof(float) * 4) != 0 ||
+                    colors[c].vertexFloatOffset != expected.colors[c].vertexFloatOffset) {
+                    return false;
+                }
+            }
+            const auto *segments = file.getSegments(frame);
+            for (uint32_t s = 0; s < SEGMENTS; ++s) {
+                if (segments[s].texture != expected.segmentTextures[s] || segments[s].blendMode != expected.segmentTextures[s] ||
+                    segments[s].indexCount != expected.indices.size() / SEGMENTS || segments[s].vertexFloatCount != VERTICES / SEGMENTS * VS2) {
+                    return false;
+                }
+            }
+            if (frame.indexBytes != expected.indices.size() * sizeof(uint16_t) ||
+                memcmp(file.getIndices(frame), expected.indices.data(), frame.indexBytes) != 0 ||
+                frame.vertexBytes != expected.vertices.size() * sizeof(float)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST(middlewareBakedCacheTest, roundTrip) {
+    const auto animations = randomAnimations();
+    const auto writer     = writeAnimations(animations, false);
+    const auto path       = testing::TempDir() + "middleware_baked_cache_test.bin";
+
+    logLabel = "test baked cache save";
+    ExpectEq(writer.save(path), true);
+
+    logLabel = "test baked cache mapped load";
+    BakedCacheFile *file = BakedCacheFile::openMapped(path);
+    ExpectEq(file != nullptr, true);
+    if (!file) return;
+    ExpectEq(file->isMapped(), true);
+    ExpectEq(file->isQuantized(), false);
+    ExpectEq(sameFrameData(*file, animations), true);
+
+    logLabel = "test baked cache raw vertices in place";
+    bool sameVertices = true;
+    for (uint32_t a = 0; a < ANIMATIONS; ++a) {
+        for (uint32_t f = 0; f < FRAMES; ++f) {
+            const auto &frame = file->getFrame(file->getAnimation(a).firstFrame + f);
+            sameVertices      = sameVertices && memcmp(file->getVertices(frame), animations[a][f].vertices.data(), frame.vertexBytes) == 0;
+        }
+    }
+    ExpectEq(sameVertices, true);
+
+    logLabel = "test baked cache shared index blocks";
+    bool sharedIndices = true;
+    for (uint32_t f = 1; f < ANIMATIONS * FRAMES; ++f) {
+        sharedIndices = sharedIndices && file->getFrame(f).indexOffset == file->getFrame(0).indexOffset;
+    }
+    ExpectEq(sharedIndices, true);
+
+    logLabel = "test io buffer wraps mapped frames";
+    const auto &frame = file->getFrame(0);
+    {
+        cc::middleware::IOBuffer vb;
+        vb.wrap(file->getVertices(frame), frame.vertexBytes);
+        ExpectEq(vb.getBuffer() == file->getVertices(frame) && vb.length() == frame.vertexBytes && !vb.ownsBuffer(), true);
+        vb.checkSpace(frame.vertexBytes, true);
+        ExpectEq(vb.ownsBuffer() && memcmp(vb.getBuffer(), file->getVertices(frame), frame.vertexBytes) == 0, true);
+    }
+    delete file;
+    std::remove(path.c_str());
+}
+
+TEST(middlewareBakedCacheTest, quantized) {
+    const auto animations = randomAnimations();
+    const auto raw        = writeAnimations(animations, false).serialize();
+    const auto quantized  = writeAnimations(animations, true).serialize();
+
+    logLabel = "test baked cache quantized size";
+    ExpectEq(quantized.size() * 2 < raw.size(), true);
+
+    logLabel = "test baked cache quantized load";
+    BakedCacheFile *file = BakedCacheFile::createWithData(quantized.data(), quantized.size());
+    ExpectEq(file != nullptr, true);
+    if (!file) return;
+    ExpectEq(file->isMapped(), false);
+    ExpectEq(file->isQuantized(), true);
+    ExpectEq(sameFrameData(*file, animations), true);
+
+    logLabel = "test baked cache quantized vertices";
+    bool               closePositions = true;
+    bool               sameColors     = true;
+    std::vector<float> decoded(VERTICES * VS2);
+    for (uint32_t a = 0; a < ANIMATIONS; ++a) {
+        for (uint32_t f = 0; f < FRAMES; ++f) {
+            const auto &frame = file->getFrame(file->getAnimation(a).firstFrame + f);
+            closePositions    = closePositions && file->getVertices(frame) == nullptr;
+            file->decodeVertices(frame, decoded.data());
+            const auto &expected = animations[a][f].vertices;
+            for (uint32_t v = 0; v < VERTICES; ++v) {
+                const float *e = &expected[v * VS2];
+                const float *d = &decoded[v * VS2];
+                // half a step of 600 / 65535 for positions, of 1 / 65535 for uvs
+                closePositions = closePositions && std::abs(e[0] - d[0]) < 0.005F && std::abs(e[1] - d[1]) < 0.005F &&
+                                 std::abs(e[3] - d[3]) < 1e-5F && std::abs(e[4] - d[4]) < 1e-5F && d[2] == 0.0F;
+                sameColors = sameColors && memcmp(e + 5, d + 5, sizeof(float) * 8) == 0;
+            }
+        }
+    }
+    ExpectEq(closePositions, true);
+    ExpectEq(sameColors, true);
+    delete file;
+}
+
+TEST(middlewareBakedCacheTest, invalidFiles) {
+    const auto content = writeAnimations(randomAnimations(), false).serialize();
+
+    logLabel = "test baked cache rejects truncated files";
+    BakedCacheFile *file = BakedCacheFile::createWithData(content.data(), content.size() - 4);
+    ExpectEq(file == nullptr, true);
+    delete file;
+
+    logLabel = "test baked cache rejects other versions";
+    auto  copy   = content;
+    auto *header = reinterpret_cast<BakedCacheFormat::Header *>(copy.data());
+    header->version++;
+    file = BakedCacheFile::createWithData(copy.data(), copy.size());
+    ExpectEq(file == nullptr, true);
+    delete file;
+
+    logLabel = "test baked cache rejects out of range frames";
+    copy                = content;
+    auto *frame         = reinterpret_cast<BakedCacheFormat::FrameRecord *>(copy.data() + header->framesOffset);
+    frame->vertexOffset = 0xFFFFFF00U;
+    file                = BakedCacheFile::createWithData(copy.data(), copy.size());
+    ExpectEq(file == nullptr, true);
+    delete file;
+
+    logLabel = "test baked cache rejects missing files";
+    ExpectEq(BakedCacheFile::openMapped(testing::TempDir() + "middleware_baked_cache_missing.bin") == nullptr, true);
+}
+#endif
@@ -0,0 +1,321 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "utils.h"
+
+#if USE_MIDDLEWARE && (USE_SPINE || USE_DRAGONBONES)
+    #include "cocos/editor-support/BakedCache.h"
+    #include "cocos/editor-support/MiddlewareManager.h"
+    #if USE_SPINE
+        #include "cocos/editor-support/spine-creator-support/SkeletonCache.h"
+        #include "cocos/editor-support/spine-creator-support/spine-cocos2dx.h"
+    #endif
+    #if USE_DRAGONBONES
+        #include "cocos/editor-support/dragonbones-creator-support/ArmatureCache.h"
+        #include "cocos/editor-support/dragonbones-creator-support/ArmatureCacheMgr.h"
+        #include "cocos/editor-support/dragonbones-creator-support/CCFactory.h"
+    #endif
+    #include <cstdio>
+    #include <cstring>
+    #include <map>
+    #include <string>
+
+// Bakes small two page skeletons with spine::SkeletonCache and dragonbones::ArmatureCache, loads
+// the files into second caches and checks that every frame, including the resolved textures,
+// matches the source cache.
+
+namespace {
+std::map<std::string, cc::middleware::Texture2D *> textures;
+
+cc::middleware::Texture2D *loadTexture(const char *path) {
+    auto *&texture = textures[path];
+    if (!texture) {
+        texture = new cc::middleware::Texture2D();
+        texture->setRealTextureIndex(static_cast<int>(textures.size()));
+        texture->setPixelsWide(64);
+        texture->setPixelsHigh(64);
+    }
+    return texture;
+}
+
+    #if USE_SPINE
+using spine::SkeletonCache;
+
+const char *const SPINE_ATLAS =
+    "\n"
+    "body.png\n"
+    "size: 64,64\n"
+    "format: RGBA8888\n"
+    "filter: Linear,Linear\n"
+    "repeat: none\n"
+    "body\n"
+    "  rotate: false\n"
+    "  xy: 0, 0\n"
+    "  size: 32, 32\n"
+    "  orig: 32, 32\n"
+    "  offset: 0, 0\n"
+    "  index: -1\n"
+    "\n"
+    "hand.png\n"
+    "size: 32,32\n"
+    "format: RGBA8888\n"
+    "filter: Linear,Linear\n"
+    "repeat: none\n"
+    "hand\n"
+    "  rotate: false\n"
+    "  xy: 0, 0\n"
+    "  size: 16, 16\n"
+    "  orig: 16, 16\n"
+    "  offset: 0, 0\n"
+    "  index: -1\n";
+
+std::string skeletonJson(const char *handAttachment) {
+    std::string json = R"({"skeleton":{"spine":"3.8.99"},
+        "bones":[{"name":"root"},{"name":"arm","parent":"root","x":20}],
+        "slots":[{"name":"body","bone":"root","attachment":"body"},{"name":"hand","bone":"arm","attachment":"HAND"}],
+        "skins":[{"name":"default","attachments":{
+            "body":{"body":{"width":32,"height":32}},
+            "hand":{"HAND":{"path":"hand","width":16,"height":16}}}}],
+        "animations":{
+            "wave":{"bones":{"arm":{"rotate":[{"time":0,"angle":0},{"time":0.5,"angle":90}]}}},
+            "fade":{"slots":{"hand":{"color":[{"time":0,"color":"ffffffff"},{"time":0.25,"color":"ff000080"}]}}}}})";
+    json.replace(json.find("HAND"), 4, handAttachment);
+    json.replace(json.find("HAND"), 4, handAttachment);
+    return json;
+}
+
+struct TestSkeleton {
+    explicit TestSkeleton(const char *handAttachment = "hand") {
+        atlas  = new spine::Atlas(SPINE_ATLAS, static_cast<int>(strlen(SPINE_ATLAS)), "", &textureLoader);
+        loader = new spine::Cocos2dAtlasAttachmentLoader(atlas);
+        spine::SkeletonJson json(loader);
+        spine::SkeletonData *data = json.readSkeletonData(skeletonJson(handAttachment).c_str());
+        cache                     = new SkeletonCache();
+        if (data) cache->initWithData(data, true);
+    }
+    ~TestSkeleton() {
+        delete cache;
+        delete loader;
+        delete atlas;
+    }
+
+    spine::Cocos2dTextureLoader          textureLoader;
+    spine::Atlas                        *atlas  = nullptr;
+    spine::Cocos2dAtlasAttachmentLoader *loader = nullptr;
+    SkeletonCache                       *cache  = nullptr;
+};
+
+bool sameColor(const SkeletonCache::ColorData *expected, const SkeletonCache::ColorData *actual) {
+    return memcmp(&expected->finalColor, &actual->finalColor, sizeof(expected->finalColor)) == 0 &&
+           memcmp(&expected->darkColor, &actual->darkColor, sizeof(expected->darkColor)) == 0 &&
+           expected->vertexFloatOffset == actual->vertexFloatOffset;
+}
+    #endif
+
+    #if USE_DRAGONBONES
+using dragonBones::ArmatureCache;
+using dragonBones::CCFactory;
+
+const char *const DRAGONBONES_DATA = R"({"frameRate":24,"name":"hero","version":"5.5","compatibleVersion":"5.5",
+    "armature":[{"type":"Armature","frameRate":24,"name":"body",
+        "bone":[{"name":"root"},{"name":"arm","parent":"root","transform":{"x":20}}],
+        "slot":[{"name":"body","parent":"root"},{"name":"hand","parent":"arm"}],
+        "skin":[{"slot":[{"name":"body","display":[{"name":"body"}]},{"name":"hand","display":[{"name":"hand"}]}]}],
+        "animation":[
+            {"duration":12,"playTimes":0,"name":"wave","bone":[{"name":"arm","rotateFrame":[
+                {"duration":12,"tweenEasing":0,"rotate":0},{"duration":0,"rotate":90}]}]},
+            {"duration":6,"playTimes":0,"name":"fade","slot":[{"name":"hand","colorFrame":[
+                {"duration":6,"tweenEasing":0},{"duration":0,"value":{"aM":50}}]}]}]}]})";
+
+// one atlas per page, registered under the same name as texture packers split them
+const char *const DRAGONBONES_BODY_PAGE = R"({"name":"hero","imagePath":"body.png","width":64,"height":64,
+    "SubTexture":[{"name":"body","x":0,"y":0,"width":32,"height":32}]})";
+const char *const DRAGONBONES_HAND_PAGE = R"({"name":"hero","imagePath":"hand.png","width":32,"height":32,
+    "SubTexture":[{"name":"hand","x":0,"y":0,"width":16,"height":16}]})";
+const char *const DRAGONBONES_OTHER_PAGE = R"({"name":"other","imagePath":"other.png","width":64,"height":64,
+    "SubTexture":[{"name":"body","x":0,"y":0,"width":32,"height":32}]})";
+
+bool sameColor(const ArmatureCache::ColorData *expected, const ArmatureCache::ColorData *actual) {
+    return memcmp(&expected->color, &actual->color, sizeof(expected->color)) == 0 && expected->vertexFloatOffset == actual->vertexFloatOffset;
+}
+    #endif
+
+template <typename AnimationData>
+bool sameAnimation(AnimationData *expected, AnimationData *actual) {
+    if (!expected || !actual || expected->isComplete() != actual->isComplete() || expected->getFrameCount() != actual->getFrameCount()) {
+        return false;
+    }
+    for (std::size_t f = 0; f < expected->getFrameCount(); ++f) {
+        auto *e = expected->getFrameData(f);
+        auto *a = actual->getFrameData(f);
+        if (e->getBones().size() != a->getBones().size() || e->getColors().size() != a->getColors().size() ||
+            e->getSegments().size() != a->getSegments().size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < e->getBones().size(); ++i) {
+            const float *em = e->getBones()[i]->globalTransformMatrix.m;
+            const float *am = a->getBones()[i]->globalTransformMatrix.m;
+            if (em[0] != am[0] || em[1] != am[1] || em[4] != am[4] || em[5] != am[5] || em[12] != am[12] || em[13] != am[13]) {
+                return false;
+            }
+        }
+        for (std::size_t i = 0; i < e->getColors().size(); ++i) {
+            if (!sameColor(e->getColors()[i], a->getColors()[i])) return false;
+        }
+        for (std::size_t i = 0; i < e->getSegments().size(); ++i) {
+            const auto *es = e->getSegments()[i];
+            const auto *as = a->getSegments()[i];
+            if (es->getTexture() != as->getTexture() || es->blendMode != as->blendMode || es->indexCount != as->indexCount ||
+                es->vertexFloatCount != as->vertexFloatCount) {
+                return false;
+            }
+        }
+        if (e->vb.getCurPos() != a->vb.getCurPos() || e->ib.getCurPos() != a->ib.getCurPos() ||
+            memcmp(e->vb.getBuffer(), a->vb.getBuffer(), e->vb.getCurPos()) != 0 ||
+            memcmp(e->ib.getBuffer(), a->ib.getBuffer(), e->ib.getCurPos()) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// loaded frames should point into the mapped file instead of owning copies
+template <typename AnimationData>
+bool wrapsFile(AnimationData *animation) {
+    bool wrapped = animation && animation->getFrameCount() > 0;
+    for (std::size_t f = 0; wrapped && f < animation->getFrameCount(); ++f) {
+        wrapped = !animation->getFrameData(f)->vb.ownsBuffer() && !animation->getFrameData(f)->ib.ownsBuffer();
+    }
+    return wrapped;
+}
+
+template <typename AnimationData>
+bool rendersPages(AnimationData *animation) {
+    if (!animation || animation->getFrameCount() < 2 || animation->getFrameData(0)->getSegments().size() != 2) return false;
+    const auto &segments = animation->getFrameData(0)->getSegments();
+    return segments[0]->getTexture() == textures["body.png"] && segments[1]->getTexture() == textures["hand.png"];
+}
+
+class MiddlewareBakedDataTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        se::ScriptEngine::getInstance()->start();
+    #if USE_SPINE
+        spine::spAtlasPage_setCustomTextureLoader(loadTexture);
+        spine::setSpineObjectDisposeCallback([](void * /*object*/) {});
+    #endif
+    #if USE_DRAGONBONES
+        auto *factory = CCFactory::getFactory();
+        factory->parseDragonBonesData(DRAGONBONES_DATA, "hero");
+        factory->parseTextureAtlasData(DRAGONBONES_BODY_PAGE, loadTexture("body.png"), "hero");
+        factory->parseTextureAtlasData(DRAGONBONES_HAND_PAGE, loadTexture("hand.png"), "hero");
+        factory->parseTextureAtlasData(DRAGONBONES_OTHER_PAGE, loadTexture("other.png"), "other");
+    #endif
+    }
+    static void TearDownTestCase() {
+    #if USE_DRAGONBONES
+        CCFactory::destroyFactory();
+    #endif
+        cc::middleware::MiddlewareManager::destroyInstance();
+    }
+};
+} // namespace
+
+    #if USE_SPINE
+TEST_F(MiddlewareBakedDataTest, skeletonCache) {
+    const auto   path = testing::TempDir() + "middleware_baked_data_test.skel.bin";
+    TestSkeleton source;
+    TestSkeleton target;
+
+    logLabel = "test skeleton cache bakes animations never played";
+    ExpectEq(source.cache->getAnimationData("wave") == nullptr, true);
+    ExpectEq(source.cache->saveBakedData(path), true);
+    ExpectEq(source.cache->getAnimationData("wave") != nullptr && source.cache->getAnimationData("fade") != nullptr, true);
+
+    logLabel = "test skeleton cache bakes both atlas pages";
+    ExpectEq(rendersPages(source.cache->getAnimationData("wave")), true);
+
+    logLabel = "test skeleton cache loads baked data";
+    ExpectEq(target.cache->loadBakedData(cc::middleware::BakedCacheFile::openMapped(path)), true);
+    ExpectEq(sameAnimation(source.cache->getAnimationData("wave"), target.cache->getAnimationData("wave")), true);
+    ExpectEq(sameAnimation(source.cache->getAnimationData("fade"), target.cache->getAnimationData("fade")), true);
+
+    logLabel = "test skeleton cache wraps the mapped file";
+    ExpectEq(wrapsFile(target.cache->getAnimationData("wave")), true);
+    ExpectEq(wrapsFile(target.cache->getAnimationData("fade")), true);
+
+    logLabel = "test skeleton cache rejects unresolved textures";
+    TestSkeleton renamed("palm");
+    ExpectEq(renamed.cache->loadBakedData(cc::middleware::BakedCacheFile::openMapped(path)), false);
+    ExpectEq(renamed.cache->getAnimationData("wave") == nullptr, true);
+
+    std::remove(path.c_str());
+}
+    #endif
+
+    #if USE_DRAGONBONES
+TEST_F(MiddlewareBakedDataTest, armatureCache) {
+    const auto path   = testing::TempDir() + "middleware_baked_data_test.dbbin";
+    auto      *source = new ArmatureCache("body", "hero", "hero");
+    auto      *target = new ArmatureCache("body", "hero", "hero");
+
+    logLabel = "test armature cache bakes animations never played";
+    ExpectEq(source->getAnimationData("wave") == nullptr, true);
+    ExpectEq(source->saveBakedData(path), true);
+    ExpectEq(source->getAnimationData("wave") != nullptr && source->getAnimationData("fade") != nullptr, true);
+
+    logLabel = "test armature cache bakes both atlas pages";
+    ExpectEq(rendersPages(source->getAnimationData("wave")), true);
+
+    logLabel = "test armature cache loads baked data";
+    ExpectEq(target->loadBakedData(cc::middleware::BakedCacheFile::openMapped(path)), true);
+    ExpectEq(sameAnimation(source->getAnimationData("wave"), target->getAnimationData("wave")), true);
+    ExpectEq(sameAnimation(source->getAnimationData("fade"), target->getAnimationData("fade")), true);
+
+    logLabel = "test armature cache wraps the mapped file";
+    ExpectEq(wrapsFile(target->getAnimationData("wave")), true);
+    ExpectEq(wrapsFile(target->getAnimationData("fade")), true);
+
+    logLabel = "test armature cache rejects unresolved textures";
+    auto *other = new ArmatureCache("body", "hero", "other");
+    ExpectEq(other->loadBakedData(cc::middleware::BakedCacheFile::openMapped(path)), false);
+    ExpectEq(other->getAnimationData("wave") == nullptr, true);
+
+    logLabel = "test armature cache manager loads baked data into new caches only";
+    auto *mgr    = dragonBones::ArmatureCacheMgr::getInstance();
+    auto *loaded = mgr->loadArmatureCache("body", "hero", "hero", path);
+    auto *wave   = loaded->getAnimationData("wave");
+    ExpectEq(wrapsFile(wave), true);
+    ExpectEq(mgr->loadArmatureCache("body", "hero", "hero", path) == loaded && loaded->getAnimationData("wave") == wave, true);
+    ExpectEq(mgr->buildArmatureCache("body", "hero", "hero") == loaded, true);
+    dragonBones::ArmatureCacheMgr::destroyInstance();
+
+    other->release();
+    target->release();
+    source->release();
+    std::remove(path.c_str());
+}
+    #endif
+#endif
@@ -0,0 +1,273 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "utils.h"
+
+#if USE_MIDDLEWARE
+    #include "cocos/editor-support/MiddlewareManager.h"
+    #include <cstring>
+    #include <functional>
+    #include <memory>
+    #include <random>
+    #include <string>
+    #include <vector>
+
+// Drives the real MiddlewareManager with middleware that log their calls and write vertices
+// tagged with their id, so both the bookkeeping and the stitched mesh buffers can be checked.
+
+namespace {
+using cc::middleware::IMiddleware;
+using cc::middleware::MiddlewareManager;
+using cc::middleware::RenderRange;
+
+constexpr int      FORMAT         = VF_XYZUVC;
+constexpr uint32_t VERTEX_BYTES   = FORMAT * sizeof(float);
+constexpr uint32_t ENOUGH_THREADS = 8;
+
+class TestMiddleware final : public IMiddleware {
+public:
+    TestMiddleware(uint32_t id, std::vector<std::string> &log) : id(id), log(log) {}
+
+    void update(float /*dt*/) override {
+        log.push_back("update " + std::to_string(id));
+        if (onUpdate) onUpdate();
+    }
+    void updateParallel(float /*dt*/) override { ++parallelUpdates; }
+    void dispatchDeferredEvents() override {
+        log.push_back("event " + std::to_string(id));
+        if (onEvent) onEvent();
+    }
+    bool     isParallelUpdateSafe() const override { return parallelUpdate; }
+    uint32_t getRenderOrder() const override { return id; }
+
+    // renders by itself like the spine and dragonbones middleware, the whole range goes into one buffer
+    void render(float dt) override {
+        ++renders;
+        auto *mb = MiddlewareManager::getInstance()->getMeshBuffer(FORMAT);
+        auto &vb = mb->getVB();
+        auto &ib = mb->getIB();
+        vb.checkSpace(vertexCount * VERTEX_BYTES, true);
+        ib.checkSpace(vertexCount * sizeof(uint16_t), true);
+        RenderRange range;
+        range.meshBuffer   = mb;
+        range.bufferPos    = mb->getBufferPos();
+        range.vertexOffset = vb.getCurPos();
+        range.indexOffset  = ib.getCurPos();
+        beginRender(dt, range);
+        renderParallel(range);
+        vb.move(static_cast<int>(vertexCount * VERTEX_BYTES));
+        ib.move(static_cast<int>(vertexCount * sizeof(uint16_t)));
+    }
+
+    bool isParallelRenderSafe() const override { return parallelRender; }
+    void getRenderSize(int &vertexFormat, std::size_t &vertexBytes, std::size_t &indexBytes) const override {
+        vertexFormat = FORMAT;
+        vertexBytes  = vertexCount * VERTEX_BYTES;
+        indexBytes   = vertexCount * sizeof(uint16_t);
+    }
+    // render info: id, buffer, first index
+    void beginRender(float /*dt*/, const RenderRange &range) override {
+        auto *renderInfo = MiddlewareManager::getInstance()->getRenderInfoMgr()->getBuffer();
+        renderInfo->checkSpace(sizeof(uint32_t) * 3, true);
+        renderInfo->writeUint32(id);
+        renderInfo->writeUint32(static_cast<uint32_t>(range.bufferPos));
+        renderInfo->writeUint32(static_cast<uint32_t>(range.indexOffset / sizeof(uint16_t)));
+    }
+    void renderParallel(const RenderRange &range) override {
+        auto *vertices = reinterpret_cast<float *>(range.meshBuffer->getVB().getBuffer() + range.vertexOffset);
+        auto *indices  = reinterpret_cast<uint16_t *>(range.meshBuffer->getIB().getBuffer() + range.indexOffset);
+        const auto firstVertex = static_cast<uint16_t>(range.vertexOffset / VERTEX_BYTES);
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            std::fill(vertices + i * FORMAT, vertices + (i + 1) * FORMAT, static_cast<float>(id));
+            indices[i] = static_cast<uint16_t>(firstVertex + i);
+        }
+    }
+
+    uint32_t                  id;
+    std::vector<std::string> &log;
+    bool                      parallelUpdate{false};
+    bool                      parallelRender{false};
+    uint32_t                  vertexCount{3};
+    uint32_t                  parallelUpdates{0};
+    uint32_t                  renders{0};
+    std::function<void()>     onUpdate;
+    std::function<void()>     onEvent;
+};
+
+struct RenderedFrame {
+    std::vector<std::vector<uint8_t>> vertices;
+    std::vector<std::vector<uint8_t>> indices;
+    std::vector<uint8_t>              renderInfo;
+};
+
+class MiddlewareManagerTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        se::ScriptEngine::getInstance()->start();
+    }
+
+    void TearDown() override {
+        MiddlewareManager::destroyInstance();
+    }
+
+    TestMiddleware *add(bool parallelUpdate = false, bool parallelRender = false) {
+        middleware.emplace_back(new TestMiddleware(static_cast<uint32_t>(middleware.size()), log));
+        middleware.back()->parallelUpdate = parallelUpdate;
+        middleware.back()->parallelRender = parallelRender;
+        MiddlewareManager::getInstance()->addTimer(middleware.back().get());
+        return middleware.back().get();
+    }
+
+    std::vector<std::string> frame(uint32_t threadCount = 1) {
+        log.clear();
+        MiddlewareManager::getInstance()->update(0.0F, threadCount);
+        MiddlewareManager::getInstance()->render(0.0F, threadCount);
+        return log;
+    }
+
+    static RenderedFrame rendered() {
+        auto *        mgr = MiddlewareManager::getInstance();
+        RenderedFrame result;
+        se::AutoHandleScope hs;
+        auto copy = [](se_object_ptr array, std::size_t length) {
+            uint8_t *   data = nullptr;
+            std::size_t size = 0;
+            array->getTypedArrayData(&data, &size);
+            return std::vector<uint8_t>(data, data + length);
+        };
+        for (std::size_t pos = 0; pos < mgr->getBufferCount(FORMAT); ++pos) {
+            result.vertices.push_back(copy(mgr->getVBTypedArray(FORMAT, pos), mgr->getVBTypedArrayLength(FORMAT, pos)));
+            result.indices.push_back(copy(mgr->getIBTypedArray(FORMAT, pos), mgr->getIBTypedArrayLength(FORMAT, pos)));
+        }
+        auto *renderInfo = mgr->getRenderInfoMgr()->getBuffer();
+        result.renderInfo.assign(renderInfo->getBuffer(), renderInfo->getBuffer() + renderInfo->length());
+        return result;
+    }
+
+    std::vector<std::unique_ptr<TestMiddleware>> middleware;
+    std::vector<std::string>                     log;
+};
+} // namespace
+
+TEST_F(MiddlewareManagerTest, timers) {
+    auto *first  = add();
+    auto *second = add();
+    auto *third  = add();
+
+    logLabel = "test middleware are only added once";
+    MiddlewareManager::getInstance()->addTimer(first);
+    ExpectEq(frame() == std::vector<std::string>{"update 0", "update 1", "update 2"}, true);
+
+    logLabel = "test removed middleware stop updating";
+    MiddlewareManager::getInstance()->removeTimer(second);
+    ExpectEq(frame() == std::vector<std::string>{"update 0", "update 2"}, true);
+
+    logLabel = "test middleware removed during the update are skipped for the rest of the frame";
+    first->onUpdate = [&] { MiddlewareManager::getInstance()->removeTimer(third); };
+    ExpectEq(frame() == std::vector<std::string>{"update 0"}, true);
+    ExpectEq(third->renders == 2, true);
+    first->onUpdate = nullptr;
+    ExpectEq(frame() == std::vector<std::string>{"update 0"}, true);
+
+    logLabel = "test a removal is cancelled by adding the middleware again in the same frame";
+    MiddlewareManager::getInstance()->addTimer(third);
+    first->onUpdate = [&] {
+        MiddlewareManager::getInstance()->removeTimer(third);
+        MiddlewareManager::getInstance()->addTimer(third);
+    };
+    ExpectEq(frame() == std::vector<std::string>{"update 0", "update 2"}, true);
+    first->onUpdate = nullptr;
+    ExpectEq(frame() == std::vector<std::string>{"update 0", "update 2"}, true);
+    ExpectEq(third->renders == 4, true);
+}
+
+TEST_F(MiddlewareManagerTest, deferredEvents) {
+    MiddlewareManager::getInstance()->setParallelUpdateThreshold(2);
+    add(true);
+    auto *serial = add();
+    auto *second = add(true);
+    auto *third  = add(true);
+
+    logLabel = "test serial middleware update first and held events are raised in list order";
+    ExpectEq(frame(ENOUGH_THREADS) == std::vector<std::string>{"update 1", "event 0", "event 2", "event 3"}, true);
+    ExpectEq(second->parallelUpdates == 1 && serial->parallelUpdates == 0, true);
+
+    logLabel = "test events of middleware removed by an earlier event are dropped";
+    middleware[0]->onEvent = [&] { MiddlewareManager::getInstance()->removeTimer(second); };
+    ExpectEq(frame(ENOUGH_THREADS) == std::vector<std::string>{"update 1", "event 0", "event 3"}, true);
+    ExpectEq(second->renders == 1 && third->renders == 2, true);
+
+    logLabel = "test middleware removed by a serial update are not updated in parallel";
+    middleware[0]->onEvent = nullptr;
+    serial->onUpdate       = [&] { MiddlewareManager::getInstance()->removeTimer(third); };
+    ExpectEq(frame(ENOUGH_THREADS) == std::vector<std::string>{"update 1", "event 0"}, true);
+    ExpectEq(third->parallelUpdates == 2, true);
+
+    logLabel = "test too few middleware update serially";
+    serial->onUpdate = nullptr;
+    MiddlewareManager::getInstance()->setParallelUpdateThreshold(8);
+    ExpectEq(frame(ENOUGH_THREADS) == std::vector<std::string>{"update 0", "update 1"}, true);
+}
+
+TEST_F(MiddlewareManagerTest, renderRanges) {
+    MiddlewareManager::getInstance()->setParallelUpdateThreshold(4);
+    std::mt19937                            rng(17);
+    std::uniform_int_distribution<uint32_t> vertexCount(200, 3000);
+    std::uniform_int_distribution<uint32_t> serialVertexCount(8000, 20000);
+    for (uint32_t i = 0; i < 120; ++i) {
+        // larger middleware which render by themselves roll the buffers over too
+        auto *editor        = add(false, i % 5 != 0);
+        editor->vertexCount = editor->parallelRender ? vertexCount(rng) : serialVertexCount(rng);
+    }
+
+    frame();
+    const RenderedFrame serial = rendered();
+
+    logLabel = "test the serial render rolls over to several mesh buffers";
+    ExpectEq(serial.vertices.size() > 2, true);
+
+    frame(ENOUGH_THREADS);
+    const RenderedFrame parallel = rendered();
+
+    logLabel = "test reserved ranges are stitched exactly like the serial render";
+    ExpectEq(parallel.vertices == serial.vertices, true);
+    ExpectEq(parallel.indices == serial.indices, true);
+    ExpectEq(parallel.renderInfo == serial.renderInfo, true);
+
+    logLabel = "test only middleware which are not parallel safe render by themselves";
+    for (const auto &editor : middleware) {
+        ExpectEq(editor->renders == (editor->parallelRender ? 1U : 2U), true);
+    }
+
+    logLabel = "test every render info entry points at the vertices of its middleware";
+    const auto *info = reinterpret_cast<const uint32_t *>(parallel.renderInfo.data());
+    for (std::size_t i = 1; i + 2 < parallel.renderInfo.size() / sizeof(uint32_t); i += 3) {
+        const auto &indices  = parallel.indices[info[i + 1]];
+        const auto &vertices = parallel.vertices[info[i + 1]];
+        const auto  index    = reinterpret_cast<const uint16_t *>(indices.data())[info[i + 2]];
+        ExpectEq(reinterpret_cast<const float *>(vertices.data())[index * FORMAT] == static_cast<float>(info[i]), true);
+    }
+}
+#endif
@@ -0,0 +1,334 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "utils.h"
+
+#if USE_MIDDLEWARE
+    #include "cocos/editor-support/VertexKernels.h"
+    #include "cocos/math/Quaternion.h"
+    #include "cocos/math/Vec3.h"
+    #include <chrono>
+    #include <cstring>
+    #include <iostream>
+    #include <random>
+    #include <vector>
+
+// Compares the SkeletonRenderer vertex kernels with the per-vertex code they replace: spine's
+// RegionAttachment / VertexAttachment::computeWorldVertices, the color loops and the batch
+// Vec3::transformMat4 pass. Skeletons need loaded spine data and script backed buffers, so
+// random bones and attachments stand in for them here.
+
+namespace {
+constexpr uint32_t VS1           = sizeof(cc::middleware::V2F_T2F_C4F) / sizeof(float);
+constexpr uint32_t VS2           = sizeof(cc::middleware::V2F_T2F_C4F_C4F) / sizeof(float);
+constexpr uint32_t SKELETONS     = 100;
+constexpr uint32_t BONES         = 40;
+constexpr uint32_t REGIONS       = 30;
+constexpr uint32_t MESHES        = 6;
+constexpr uint32_t MESH_VERTICES = 64;
+constexpr uint32_t INFLUENCES    = 3;
+constexpr uint32_t FRAMES        = 100;
+
+struct Bone {
+    float a, b, c, d, worldX, worldY;
+};
+
+struct Mesh {
+    std::vector<size_t> bones;
+    std::vector<float>  vertices;
+};
+
+struct SampleSkeleton {
+    std::vector<Bone>                        bones;
+    std::vector<float>                       regionOffsets; // 8 floats per region, spine order
+    std::vector<uint32_t>                    regionBones;
+    std::vector<Mesh>                        meshes;
+    std::vector<cc::middleware::V2F_T2F_C4F> setupVertices; // uv source, as AttachmentVertices
+};
+
+SampleSkeleton randomSkeleton(std::mt19937 &rng) {
+    std::uniform_real_distribution<float>   unit(-1.0F, 1.0F);
+    std::uniform_int_distribution<uint32_t> bone(0, BONES - 1);
+    SampleSkeleton                          skeleton;
+    for (uint32_t i = 0; i < BONES; ++i) {
+        skeleton.bones.push_back({unit(rng), unit(rng), unit(rng), unit(rng), unit(rng), unit(rng)});
+    }
+    for (uint32_t i = 0; i < REGIONS; ++i) {
+        for (uint32_t j = 0; j < 8; ++j) {
+            skeleton.regionOffsets.push_back(unit(rng));
+        }
+        skeleton.regionBones.push_back(bone(rng));
+    }
+    for (uint32_t i = 0; i < MESHES; ++i) {
+        Mesh mesh;
+        for (uint32_t v = 0; v < MESH_VERTICES; ++v) {
+            mesh.bones.push_back(INFLUENCES);
+            for (uint32_t j = 0; j < INFLUENCES; ++j) {
+                mesh.bones.push_back(bone(rng));
+                mesh.vertices.push_back(unit(rng));
+                mesh.vertices.push_back(unit(rng));
+                mesh.vertices.push_back(1.0F / INFLUENCES);
+            }
+        }
+        skeleton.meshes.push_back(mesh);
+    }
+    skeleton.setupVertices.resize(MESH_VERTICES);
+    for (auto &vertex : skeleton.setupVertices) {
+        vertex.texCoord.u = (unit(rng) + 1.0F) / 2.0F;
+        vertex.texCoord.v = (unit(rng) + 1.0F) / 2.0F;
+    }
+    return skeleton;
+}
+
+void setBoneAffine(float *affine, const Bone &bone) {
+    cc::middleware::setBoneAffine(affine, bone.a, bone.b, bone.c, bone.d, bone.worldX, bone.worldY);
+}
+
+// Same math and order as RegionAttachment::computeWorldVertices
+void regionReference(const Bone &bone, const float *offsets, float *dst, uint32_t stride) {
+    const uint32_t order[4] = {3, 0, 1, 2};
+    for (uint32_t i = 0; i < 4; ++i, dst += stride) {
+        const float offsetX = offsets[order[i] * 2];
+        const float offsetY = offsets[order[i] * 2 + 1];
+        dst[0]              = offsetX * bone.a + offsetY * bone.b + bone.worldX;
+        dst[1]              = offsetX * bone.c + offsetY * bone.d + bone.worldY;
+    }
+}
+
+// Same math and order as the weighted branch of VertexAttachment::computeWorldVertices
+void weightedReference(const std::vector<Bone> &bones, const Mesh &mesh, const float *deform, float *dst, uint32_t stride) {
+    for (size_t w = 0, v = 0, b = 0, f = 0; w < MESH_VERTICES; ++w, dst += stride) {
+        float  wx = 0;
+        float  wy = 0;
+        size_t n  = mesh.bones[v++];
+        n += v;
+        for (; v < n; v++, b += 3, f += 2) {
+            const Bone &bone   = bones[mesh.bones[v]];
+            const float vx     = mesh.vertices[b] + (deform ? deform[f] : 0.0F);
+            const float vy     = mesh.vertices[b + 1] + (deform ? deform[f + 1] : 0.0F);
+            const float weight = mesh.vertices[b + 2];
+            wx += (vx * bone.a + vy * bone.b + bone.worldX) * weight;
+            wy += (vx * bone.c + vy * bone.d + bone.worldY) * weight;
+        }
+        dst[0] = wx;
+        dst[1] = wy;
+    }
+}
+
+// The previous SkeletonRenderer path for one skeleton: copy the setup vertices, transform,
+// color every vertex and apply the node matrix per vertex.
+void renderReference(const SampleSkeleton &skeleton, const cc::middleware::Color4F &color, const cc::Mat4 &nodeWorldMat, cc::middleware::V2F_T2F_C4F *dst) {
+    for (uint32_t i = 0; i < REGIONS; ++i, dst += 4) {
+        memcpy(static_cast<void *>(dst), skeleton.setupVertices.data(), sizeof(*dst) * 4);
+        regionReference(skeleton.bones[skeleton.regionBones[i]], &skeleton.regionOffsets[i * 8], reinterpret_cast<float *>(dst), VS1);
+        for (uint32_t v = 0; v < 4; ++v) {
+            dst[v].color.r = color.r;
+            dst[v].color.g = color.g;
+            dst[v].color.b = color.b;
+            dst[v].color.a = color.a;
+            dst[v].vertex.transformMat4(dst[v].vertex, nodeWorldMat);
+        }
+    }
+    for (const auto &mesh : skeleton.meshes) {
+        memcpy(static_cast<void *>(dst), skeleton.setupVertices.data(), sizeof(*dst) * MESH_VERTICES);
+        weightedReference(skeleton.bones, mesh, nullptr, reinterpret_cast<float *>(dst), VS1);
+        for (uint32_t v = 0; v < MESH_VERTICES; ++v) {
+            dst[v].color.r = color.r;
+            dst[v].color.g = color.g;
+            dst[v].color.b = color.b;
+            dst[v].color.a = color.a;
+            dst[v].vertex.transformMat4(dst[v].vertex, nodeWorldMat);
+        }
+        dst += MESH_VERTICES;
+    }
+}
+
+// The kernel path SkeletonRenderer::render takes now
+void renderKernels(const SampleSkeleton &skeleton, const cc::middleware::Color4F &color, const cc::Mat4 &nodeWorldMat, std::vector<float> *boneAffines, cc::middleware::V2F_T2F_C4F *dst) {
+    using namespace cc::middleware; // NOLINT(google-build-using-namespace)
+    const float *uvs = &skeleton.setupVertices[0].texCoord.u;
+    for (uint32_t i = 0; i < BONES; ++i) {
+        setBoneAffine(&(*boneAffines)[i * BONE_AFFINE_STRIDE], skeleton.bones[i]);
+    }
+    for (uint32_t i = 0; i < REGIONS; ++i, dst += 4) {
+        auto *verts = reinterpret_cast<float *>(dst);
+        computeRegionVertices(&(*boneAffines)[skeleton.regionBones[i] * BONE_AFFINE_STRIDE], &skeleton.regionOffsets[i * 8], verts, VS1);
+        copyVertexUVs(verts, VS1, uvs, VS1, 4);
+        fillVertexColors(verts, VS1, 4, color);
+        transformVertices(verts, VS1, 4, nodeWorldMat);
+    }
+    for (const auto &mesh : skeleton.meshes) {
+        auto *verts = reinterpret_cast<float *>(dst);
+        computeWeightedMeshVertices(boneAffines->data(), mesh.bones.data(), mesh.vertices.data(), nullptr, MESH_VERTICES, verts, VS1);
+        copyVertexUVs(verts, VS1, uvs, VS1, MESH_VERTICES);
+        fillVertexColors(verts, VS1, MESH_VERTICES, color);
+        transformVertices(verts, VS1, MESH_VERTICES, nodeWorldMat);
+        dst += MESH_VERTICES;
+    }
+}
+
+bool samePositions(const float *expected, const float *actual, uint32_t count, uint32_t stride) {
+    bool same = true;
+    for (uint32_t i = 0; i < count * stride; i += stride) {
+        same = same && IsEqualF(expected[i], actual[i]) && IsEqualF(expected[i + 1], actual[i + 1]);
+    }
+    return same;
+}
+
+bool sameFloats(const float *expected, const float *actual, size_t count) {
+    bool same = true;
+    for (size_t i = 0; i < count; ++i) {
+        same = same && IsEqualF(expected[i], actual[i]);
+    }
+    return same;
+}
+} // namespace
+
+TEST(middlewareVertexKernelsTest, worldVertices) {
+    std::mt19937                          rng(18);
+    std::uniform_real_distribution<float> unit(-1.0F, 1.0F);
+    const SampleSkeleton                  skeleton = randomSkeleton(rng);
+    std::vector<float>                    boneAffines(BONES * cc::middleware::BONE_AFFINE_STRIDE);
+    for (uint32_t i = 0; i < BONES; ++i) {
+        setBoneAffine(&boneAffines[i * cc::middleware::BONE_AFFINE_STRIDE], skeleton.bones[i]);
+    }
+
+    logLabel = "test region world vertices";
+    std::vector<float> expected(MESH_VERTICES * VS2);
+    std::vector<float> actual(MESH_VERTICES * VS2);
+    for (uint32_t i = 0; i < REGIONS; ++i) {
+        const uint32_t bone = skeleton.regionBones[i];
+        regionReference(skeleton.bones[bone], &skeleton.regionOffsets[i * 8], expected.data(), VS2);
+        cc::middleware::computeRegionVertices(&boneAffines[bone * cc::middleware::BONE_AFFINE_STRIDE], &skeleton.regionOffsets[i * 8], actual.data(), VS2);
+        ExpectEq(samePositions(expected.data(), actual.data(), 4, VS2), true);
+    }
+
+    logLabel = "test unweighted mesh world vertices";
+    // odd count to cover the scalar tail
+    std::vector<float> vertices(MESH_VERTICES * 2 - 2);
+    for (auto &v : vertices) v = unit(rng);
+    const auto count = static_cast<uint32_t>(vertices.size() / 2);
+    for (uint32_t i = 0; i < count; ++i) {
+        const Bone &bone        = skeleton.bones[0];
+        expected[i * VS1]     = vertices[i * 2] * bone.a + vertices[i * 2 + 1] * bone.b + bone.worldX;
+        expected[i * VS1 + 1] = vertices[i * 2] * bone.c + vertices[i * 2 + 1] * bone.d + bone.worldY;
+    }
+    cc::middleware::computeMeshVertices(boneAffines.data(), vertices.data(), count, actual.data(), VS1);
+    ExpectEq(samePositions(expected.data(), actual.data(), count, VS1), true);
+
+    logLabel = "test weighted mesh world vertices";
+    std::vector<float> deform(MESH_VERTICES * INFLUENCES * 2);
+    for (auto &v : deform) v = unit(rng) * 0.1F;
+    for (const auto &mesh : skeleton.meshes) {
+        weightedReference(skeleton.bones, mesh, nullptr, expected.data(), VS1);
+        cc::middleware::computeWeightedMeshVertices(boneAffines.data(), mesh.bones.data(), mesh.vertices.data(), nullptr, MESH_VERTICES, actual.data(), VS1);
+        ExpectEq(samePositions(expected.data(), actual.data(), MESH_VERTICES, VS1), true);
+
+        weightedReference(skeleton.bones, mesh, deform.data(), expected.data(), VS1);
+        cc::middleware::computeWeightedMeshVertices(boneAffines.data(), mesh.bones.data(), mesh.vertices.data(), deform.data(), MESH_VERTICES, actual.data(), VS1);
+        ExpectEq(samePositions(expected.data(), actual.data(), MESH_VERTICES, VS1), true);
+    }
+}
+
+TEST(middlewareVertexKernelsTest, vertexAttributes) {
+    std::mt19937                          rng(18);
+    std::uniform_real_distribution<float> unit(-1.0F, 1.0F);
+    const SampleSkeleton                  skeleton = randomSkeleton(rng);
+
+    logLabel = "test uv copy and two color fill";
+    const cc::middleware::Color4F                light(unit(rng), unit(rng), unit(rng), unit(rng));
+    const cc::middleware::Color4F                dark(unit(rng), unit(rng), unit(rng), unit(rng));
+    std::vector<cc::middleware::V2F_T2F_C4F_C4F> verts(MESH_VERTICES);
+    cc::middleware::copyVertexUVs(reinterpret_cast<float *>(verts.data()), VS2, &skeleton.setupVertices[0].texCoord.u, VS1, MESH_VERTICES);
+    cc::middleware::fillVertexColors(reinterpret_cast<float *>(verts.data()), VS2, MESH_VERTICES, light, dark);
+    bool same = true;
+    for (uint32_t i = 0; i < MESH_VERTICES; ++i) {
+        same = same && verts[i].vertex.z == 0.0F;
+        same = same && verts[i].texCoord.u == skeleton.setupVertices[i].texCoord.u && verts[i].texCoord.v == skeleton.setupVertices[i].texCoord.v;
+        same = same && verts[i].color == light && verts[i].color2 == dark;
+    }
+    ExpectEq(same, true);
+
+    logLabel = "test node matrix transform";
+    cc::Mat4 mat;
+    for (float &m : mat.m) m = unit(rng);
+    // keep w away from 0, the projective divide is still exercised
+    mat.m[3]  = unit(rng) * 0.1F;
+    mat.m[7]  = unit(rng) * 0.1F;
+    mat.m[15] = 1.0F;
+    for (const auto &m : {cc::Mat4::IDENTITY, mat}) {
+        for (auto &vertex : verts) {
+            vertex.vertex.set(unit(rng), unit(rng), 0.0F);
+        }
+        std::vector<cc::middleware::V2F_T2F_C4F_C4F> expected = verts;
+        for (auto &vertex : expected) {
+            vertex.vertex.transformMat4(vertex.vertex, m);
+        }
+        cc::middleware::transformVertices(reinterpret_cast<float *>(verts.data()), VS2, MESH_VERTICES, m);
+        same = true;
+        for (uint32_t i = 0; i < MESH_VERTICES; ++i) {
+            same = same && IsEqualF(expected[i].vertex.x, verts[i].vertex.x) && IsEqualF(expected[i].vertex.y, verts[i].vertex.y) && IsEqualF(expected[i].vertex.z, verts[i].vertex.z);
+        }
+        ExpectEq(same, true);
+    }
+}
+
+TEST(middlewareVertexKernelsTest, renderBenchmark) {
+    logLabel = "test the kernel path matches the per-vertex SkeletonRenderer path";
+    std::mt19937                          rng(18);
+    std::uniform_real_distribution<float> unit(-1.0F, 1.0F);
+    std::vector<SampleSkeleton>           skeletons;
+    for (uint32_t i = 0; i < SKELETONS; ++i) {
+        skeletons.push_back(randomSkeleton(rng));
+    }
+    const cc::middleware::Color4F color(unit(rng), unit(rng), unit(rng), 1.0F);
+    cc::Mat4                      nodeWorldMat;
+    cc::Mat4::fromRTS(cc::Quaternion(unit(rng), unit(rng), unit(rng), 1.0F).getNormalized(), {unit(rng), unit(rng), unit(rng)}, cc::Vec3::ONE, &nodeWorldMat);
+
+    constexpr uint32_t                       VERTICES = REGIONS * 4 + MESHES * MESH_VERTICES;
+    std::vector<cc::middleware::V2F_T2F_C4F> expected(SKELETONS * VERTICES);
+    std::vector<cc::middleware::V2F_T2F_C4F> actual(SKELETONS * VERTICES);
+    std::vector<float>                       boneAffines(BONES * cc::middleware::BONE_AFFINE_STRIDE);
+
+    const auto referenceStart = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+        for (uint32_t i = 0; i < SKELETONS; ++i) {
+            renderReference(skeletons[i], color, nodeWorldMat, expected.data() + i * VERTICES);
+        }
+    }
+    const auto kernelStart = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+        for (uint32_t i = 0; i < SKELETONS; ++i) {
+            renderKernels(skeletons[i], color, nodeWorldMat, &boneAffines, actual.data() + i * VERTICES);
+        }
+    }
+    const auto kernelEnd = std::chrono::steady_clock::now();
+
+    ExpectEq(sameFloats(reinterpret_cast<const float *>(expected.data()), reinterpret_cast<const float *>(actual.data()), expected.size() * VS1), true);
+
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    std::cout << "spine vertices " << SKELETONS << " x " << VERTICES << ": per vertex " << Microseconds(kernelStart - referenceStart).count() / FRAMES
+              << "us, kernels " << Microseconds(kernelEnd - kernelStart).count() / FRAMES << "us" << std::endl;
+}
+#endif
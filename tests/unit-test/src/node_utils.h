@@ -0,0 +1,38 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+#include "cocos/bindings/jswrapper/SeApi.h"
+#include "cocos/scene/Node.h"
+
+// Initializes a native node over a transform layout owned by the test, the way the JS side does.
+// The nodes of the tests keep their dirty flags cleared, so the dirty node list shared with JS is never walked.
+inline void initTestNode(cc::scene::Node *node, cc::scene::NodeLayout *layout, uint32_t *flagChunk) {
+    auto *engine = se::ScriptEngine::getInstance();
+    if (!engine->isValid()) {
+        engine->start();
+    }
+    se::AutoHandleScope hs;
+    se::HandleObject    dirtyNodes(se::Object::createArrayObject(0));
+    node->initWithData(reinterpret_cast<uint8_t *>(layout), reinterpret_cast<uint8_t *>(flagChunk), se::Value(dirtyNodes));
+}
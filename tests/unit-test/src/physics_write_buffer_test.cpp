@@ -0,0 +1,91 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "cocos/physics/physx/PhysXWriteBuffer.h"
+#include "utils.h"
+#include <string>
+
+// PhysXWorld buffers the changes of bodies, shapes and joints in a PhysXWriteBuffer from stepAsync
+// until fetchResults. The buffer does not depend on the PhysX SDK, which the unit tests do not link.
+
+TEST(physicsWriteBufferTest, appliesWritesAfterStep) {
+    logLabel = "test writes made during a step are applied in order after it";
+    cc::physics::PhysXWriteBuffer buffer;
+    std::string                   applied;
+    const uintptr_t               body    = 1;
+    const uintptr_t               shape   = 2;
+
+    // outside of a step writes run at once
+    buffer.write(body, [&]() { applied += "a"; });
+    ExpectEq(applied == "a" && !buffer.isBuffering(), true);
+
+    buffer.begin();
+    buffer.write(body, [&]() { applied += "b"; });
+    buffer.write(shape, [&]() { applied += "c"; });
+    buffer.write(body, [&]() {
+        applied += "d";
+        // the step is over, so writes made by a buffered write run at once
+        buffer.write(shape, [&]() { applied += "e"; });
+    });
+    ExpectEq(applied == "a" && buffer.isBuffering(), true);
+
+    buffer.apply();
+    ExpectEq(applied == "abcde" && !buffer.isBuffering(), true);
+
+    // nothing is applied twice
+    buffer.begin();
+    buffer.apply();
+    ExpectEq(applied == "abcde", true);
+}
+
+TEST(physicsWriteBufferTest, dropsWritesOfDestroyedOwners) {
+    logLabel = "test writes of owners destroyed during a step are dropped";
+    cc::physics::PhysXWriteBuffer buffer;
+    std::string                   applied;
+    const uintptr_t               body  = 1;
+    const uintptr_t               joint = 2;
+
+    buffer.begin();
+    buffer.write(body, [&]() { applied += "a"; });
+    buffer.write(joint, [&]() {
+        applied += "b";
+        // a write destroying another owner drops its remaining writes
+        buffer.cancel(body);
+    });
+    buffer.write(body, [&]() { applied += "c"; });
+    buffer.write(joint, [&]() { applied += "d"; });
+    buffer.cancel(joint);
+    buffer.apply();
+    ExpectEq(applied == "ac", true);
+
+    buffer.begin();
+    buffer.write(body, [&]() { applied += "e"; });
+    buffer.write(joint, [&]() {
+        applied += "f";
+        buffer.cancel(body);
+    });
+    buffer.write(body, [&]() { applied += "g"; });
+    buffer.apply();
+    ExpectEq(applied == "acef", true);
+}
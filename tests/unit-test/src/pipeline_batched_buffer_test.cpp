@@ -0,0 +1,179 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "cocos/renderer/GFXDeviceManager.h"
+#include "cocos/renderer/pipeline/BatchedBuffer.h"
+#include "cocos/scene/Node.h"
+#include "node_utils.h"
+#include "utils.h"
+#include <memory>
+#include <vector>
+
+// Merges sub models into a persistent BatchedBuffer on the empty device, one clear, merge and
+// upload round per frame like the render stages, and checks what each frame uploads.
+
+namespace {
+using cc::pipeline::BatchedBuffer;
+using cc::pipeline::UBOLocalBatched;
+
+constexpr uint32_t STRIDE          = 16;
+constexpr uint32_t MATRIX_BYTES    = 16 * sizeof(float);
+constexpr uint32_t INDEX_BYTES     = sizeof(float);
+constexpr uint32_t VERTEX_COUNTS[] = {6, 4, 8, 5};
+
+struct TestNode {
+    cc::scene::NodeLayout layout;
+    uint32_t              flags{0};
+    cc::scene::Node       node;
+
+    TestNode() {
+        layout.localScale.set(1.0F, 1.0F, 1.0F);
+        initTestNode(&node, &layout, &flags);
+    }
+};
+
+// vertices of a member are filled with its id, so the merged buffers show which member sits where
+struct Member {
+    Member(uint8_t id, uint32_t vertexCount, cc::scene::Pass *pass, cc::gfx::DescriptorSet *descriptorSet, cc::gfx::InputAssembler *ia)
+    : vertices(vertexCount * STRIDE, id) {
+        model.setTransform(&node.node);
+        subModel.setPasses({pass});
+        subModel.setShaders({nullptr});
+        subModel.setDescriptorSet(descriptorSet);
+        subModel.setInputAssembler(ia);
+        subModel.setSubMeshBuffers({{STRIDE, vertexCount, vertexCount * STRIDE, vertices.data()}});
+    }
+
+    void moveTo(float x) {
+        node.layout.worldMatrix.m[12] = x;
+    }
+
+    TestNode             node;
+    std::vector<uint8_t> vertices;
+    cc::scene::SubModel  subModel;
+    cc::scene::Model     model;
+};
+
+class PipelineBatchedBufferTest : public testing::Test {
+protected:
+    void SetUp() override {
+        // no window is available here, so every other backend fails to initialize and the empty device is picked
+        device = cc::gfx::DeviceManager::create(cc::gfx::DeviceInfo{});
+        layout = device->createDescriptorSetLayout({{UBOLocalBatched::DESCRIPTOR}});
+        vb     = device->createBuffer({cc::gfx::BufferUsageBit::VERTEX, cc::gfx::MemoryUsageBit::DEVICE, STRIDE * 8, STRIDE});
+        ia     = device->createInputAssembler({{{"a_position", cc::gfx::Format::RGBA32F}}, {vb}});
+        for (uint32_t i = 0; i < 4; ++i) {
+            descriptorSets.push_back(device->createDescriptorSet({layout}));
+            members.emplace_back(new Member(static_cast<uint8_t>(i + 1), VERTEX_COUNTS[i], &pass, descriptorSets.back(), ia));
+        }
+        BatchedBuffer::setPersistentBatching(true);
+        buffer = BatchedBuffer::get(&pass);
+    }
+    void TearDown() override {
+        BatchedBuffer::destroyBatchedBuffer();
+        members.clear();
+        for (auto *descriptorSet : descriptorSets) CC_SAFE_DESTROY(descriptorSet);
+        CC_SAFE_DESTROY(ia);
+        CC_SAFE_DESTROY(vb);
+        CC_SAFE_DESTROY(layout);
+        cc::gfx::DeviceManager::destroy();
+    }
+
+    // one frame of a render stage, returns what it uploaded
+    cc::pipeline::BatchedUploadStats frame(const std::vector<uint32_t> &merged) {
+        BatchedBuffer::resetUploadStats();
+        buffer->clear();
+        for (auto i : merged) {
+            buffer->merge(&members[i]->subModel, 0, &members[i]->model);
+        }
+        buffer->uploadBuffers(device->getCommandBuffer());
+        return BatchedBuffer::getUploadStats();
+    }
+
+    static bool sameStats(const cc::pipeline::BatchedUploadStats &stats, uint32_t vertices, uint32_t matrices) {
+        return stats.vertexBytes == vertices * STRIDE && stats.indexBytes == vertices * INDEX_BYTES &&
+               stats.uboBytes == (UBOLocalBatched::MAT_WORLDS_OFFSET * sizeof(float) + matrices * MATRIX_BYTES);
+    }
+
+    // the batch holds the members in order, their vertices back to back and tagged with their slot,
+    // which the shader reads as the floor of the batch id
+    bool holdsMembers(const std::vector<uint32_t> &expected) const {
+        const auto &batches = buffer->getBatches();
+        if (batches.size() != 1 || batches[0].slots.size() != expected.size() || batches[0].mergeCount != expected.size()) return false;
+        const auto &batch  = batches[0];
+        uint32_t    offset = 0;
+        for (uint32_t s = 0; s < expected.size(); ++s) {
+            const auto &member = *members[expected[s]];
+            if (batch.slots[s].subModel != &member.subModel || batch.slots[s].vertexOffset != offset) return false;
+            for (uint32_t v = offset; v < offset + VERTEX_COUNTS[expected[s]]; ++v) {
+                if (batch.vbDatas[0][v * STRIDE] != member.vertices[0] || static_cast<uint32_t>(batch.indexData[v]) != s) return false;
+            }
+            if (batch.uboData[UBOLocalBatched::MAT_WORLDS_OFFSET + s * 16 + 12] != member.node.layout.worldMatrix.m[12]) return false;
+            offset += VERTEX_COUNTS[expected[s]];
+        }
+        return batch.vbCount == offset && batch.ia->getVertexCount() == offset;
+    }
+
+    cc::gfx::Device *                     device{nullptr};
+    cc::gfx::DescriptorSetLayout *        layout{nullptr};
+    cc::gfx::Buffer *                     vb{nullptr};
+    cc::gfx::InputAssembler *             ia{nullptr};
+    std::vector<cc::gfx::DescriptorSet *> descriptorSets;
+    std::vector<std::unique_ptr<Member>>  members;
+    cc::scene::Pass                       pass;
+    BatchedBuffer *                       buffer{nullptr};
+};
+} // namespace
+
+TEST_F(PipelineBatchedBufferTest, uploadStats) {
+    logLabel = "test batched buffer uploads new members";
+    // the first member is uploaded with the new batch, the others as a dirty prefix
+    auto stats = frame({0, 1, 2});
+    ExpectEq(stats.vertexBytes == (VERTEX_COUNTS[0] + VERTEX_COUNTS[0] + VERTEX_COUNTS[1] + VERTEX_COUNTS[2]) * STRIDE, true);
+    ExpectEq(holdsMembers({0, 1, 2}), true);
+
+    logLabel = "test batched buffer uploads nothing for static members";
+    ExpectEq(sameStats(frame({0, 1, 2}), 0, 0), true);
+    ExpectEq(sameStats(frame({0, 1, 2}), 0, 0), true);
+
+    logLabel = "test batched buffer uploads the matrices of moved members";
+    members[1]->moveTo(5.0F);
+    ExpectEq(sameStats(frame({0, 1, 2}), 0, 2), true);
+    ExpectEq(holdsMembers({0, 1, 2}), true);
+    ExpectEq(sameStats(frame({0, 1, 2}), 0, 0), true);
+
+    logLabel = "test batched buffer uploads up to added members";
+    ExpectEq(sameStats(frame({0, 1, 2, 3}), VERTEX_COUNTS[0] + VERTEX_COUNTS[1] + VERTEX_COUNTS[2] + VERTEX_COUNTS[3], 4), true);
+    ExpectEq(holdsMembers({0, 1, 2, 3}), true);
+
+    logLabel = "test batched buffer moves the members after a removed one down";
+    ExpectEq(sameStats(frame({0, 2, 3}), VERTEX_COUNTS[0] + VERTEX_COUNTS[2] + VERTEX_COUNTS[3], 3), true);
+    ExpectEq(holdsMembers({0, 2, 3}), true);
+
+    logLabel = "test batched buffer uploads nothing when the last member is removed";
+    ExpectEq(sameStats(frame({0, 2}), 0, 0), true);
+    ExpectEq(holdsMembers({0, 2}), true);
+    ExpectEq(sameStats(frame({0, 2}), 0, 0), true);
+}
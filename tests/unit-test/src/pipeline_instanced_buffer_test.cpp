@@ -0,0 +1,192 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "cocos/renderer/GFXDeviceManager.h"
+#include "cocos/renderer/pipeline/GPUInstanceCulling.h"
+#include "cocos/renderer/pipeline/InstancedBuffer.h"
+#include "cocos/renderer/pipeline/RenderInstancedQueue.h"
+#include "cocos/scene/Camera.h"
+#include "cocos/scene/Node.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Merges instanced models into InstancedBuffer on the empty device, the way the render stages do
+// every frame. Meshes are told apart by their index buffers, like the instancing buckets.
+
+namespace {
+using cc::pipeline::InstancedBuffer;
+using cc::pipeline::UBOLocalBatched;
+
+constexpr uint32_t STRIDE = 64; // a world matrix of instance attributes
+
+struct InstancedModel {
+    InstancedModel(uint32_t id, cc::scene::Pass *pass, cc::gfx::DescriptorSet *descriptorSet, cc::gfx::InputAssembler *ia,
+                   const std::vector<cc::gfx::Attribute> &attributes)
+    : attributes(STRIDE) {
+        memcpy(this->attributes.data(), &id, sizeof(id));
+        model.setInstancedAttrBlock(this->attributes.data(), STRIDE, cc::scene::InstancedAttributeBlock{}, attributes);
+        subModel.setPasses({pass});
+        subModel.setShaders({nullptr});
+        subModel.setDescriptorSet(descriptorSet);
+        subModel.setInputAssembler(ia);
+    }
+
+    std::vector<uint8_t> attributes;
+    cc::scene::SubModel  subModel;
+    cc::scene::Model     model;
+};
+
+class PipelineInstancedBufferTest : public testing::Test {
+protected:
+    void SetUp() override {
+        // no window is available here, so every other backend fails to initialize and the empty device is picked
+        device        = cc::gfx::DeviceManager::create(cc::gfx::DeviceInfo{});
+        layout        = device->createDescriptorSetLayout({{UBOLocalBatched::DESCRIPTOR}});
+        descriptorSet = device->createDescriptorSet({layout});
+        vb            = device->createBuffer({cc::gfx::BufferUsageBit::VERTEX, cc::gfx::MemoryUsageBit::DEVICE, 12 * 3, 12});
+    }
+    void TearDown() override {
+        InstancedBuffer::destroyInstancedBuffer();
+        models.clear();
+        for (auto *ia : meshes) CC_SAFE_DESTROY(ia);
+        for (auto *ib : indexBuffers) CC_SAFE_DESTROY(ib);
+        CC_SAFE_DESTROY(vb);
+        CC_SAFE_DESTROY(descriptorSet);
+        CC_SAFE_DESTROY(layout);
+        cc::gfx::DeviceManager::destroy();
+    }
+
+    void createModels(uint32_t count, uint32_t meshCount) {
+        const std::vector<cc::gfx::Attribute> instanceAttributes{{"a_matWorld0", cc::gfx::Format::RGBA32F, false, 0, true},
+                                                                 {"a_matWorld1", cc::gfx::Format::RGBA32F, false, 0, true},
+                                                                 {"a_matWorld2", cc::gfx::Format::RGBA32F, false, 0, true},
+                                                                 {"a_matWorld3", cc::gfx::Format::RGBA32F, false, 0, true}};
+        for (uint32_t i = 0; i < meshCount; ++i) {
+            indexBuffers.push_back(device->createBuffer({cc::gfx::BufferUsageBit::INDEX, cc::gfx::MemoryUsageBit::DEVICE, 6, 2}));
+            meshes.push_back(device->createInputAssembler({{{"a_position", cc::gfx::Format::RGB32F}}, {vb}, indexBuffers.back()}));
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            models.emplace_back(new InstancedModel(i, &pass, descriptorSet, meshes[i % meshCount], instanceAttributes));
+        }
+    }
+
+    // one frame of a render stage
+    void mergeFrame(InstancedBuffer *buffer) {
+        buffer->clear();
+        for (const auto &model : models) {
+            buffer->merge(&model->model, &model->subModel, 0);
+        }
+    }
+
+    // every model is merged once into an item of its mesh
+    bool holdsModels(const InstancedBuffer *buffer, uint32_t meshCount) const {
+        std::vector<uint32_t> merged(models.size(), 0);
+        for (const auto &item : buffer->getInstances()) {
+            for (uint32_t i = 0; i < item.count; ++i) {
+                uint32_t id = 0;
+                memcpy(&id, item.data + i * item.stride, sizeof(id));
+                if (id >= models.size() || item.ia->getIndexBuffer() != indexBuffers[id % meshCount]) return false;
+                ++merged[id];
+            }
+        }
+        return std::all_of(merged.begin(), merged.end(), [](uint32_t count) { return count == 1; });
+    }
+
+    cc::gfx::Device *                            device{nullptr};
+    cc::gfx::DescriptorSetLayout *               layout{nullptr};
+    cc::gfx::DescriptorSet *                     descriptorSet{nullptr};
+    cc::gfx::Buffer *                            vb{nullptr};
+    std::vector<cc::gfx::Buffer *>               indexBuffers;
+    std::vector<cc::gfx::InputAssembler *>       meshes;
+    std::vector<std::unique_ptr<InstancedModel>> models;
+    cc::scene::Pass                              pass;
+};
+} // namespace
+
+TEST_F(PipelineInstancedBufferTest, mergeBenchmark) {
+    constexpr uint32_t FRAMES = 10;
+    using Microseconds        = std::chrono::duration<double, std::micro>;
+
+    for (uint32_t count : {1000U, 10000U, 50000U}) {
+        logLabel = "test instanced buffer merges every model once, x" + std::to_string(count);
+        // one mesh per 16 instances on average, foliage with many variants
+        const uint32_t meshCount = std::max(1U, std::min(2048U, count / 16));
+        models.clear();
+        createModels(count, meshCount);
+        auto *buffer = InstancedBuffer::get(&pass, count);
+
+        // items are created in a first frame, the timed frames only look them up and copy
+        mergeFrame(buffer);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+            mergeFrame(buffer);
+        }
+        const Microseconds time = std::chrono::steady_clock::now() - start;
+        ExpectEq(holdsModels(buffer, meshCount), true);
+
+        std::cout << "InstancedBuffer::merge x" << count << " into " << buffer->getInstances().size() << " items: " << time.count() / FRAMES
+                  << "us per frame" << std::endl;
+    }
+}
+
+TEST_F(PipelineInstancedBufferTest, queueWithoutGPUCulling) {
+    logLabel = "test instanced items are drawn unculled where the GPU instance culling is not supported";
+    // the culling only runs on Vulkan, on the empty device every instance is uploaded and drawn
+    ExpectEq(cc::pipeline::GPUInstanceCulling::isSupported(device), false);
+    cc::pipeline::GPUInstanceCulling culling;
+    culling.initialize(device);
+    ExpectEq(culling.isInitialized(), false);
+
+    constexpr uint32_t MESH_COUNT = 4;
+    createModels(100, MESH_COUNT);
+    auto *                             buffer = InstancedBuffer::get(&pass);
+    cc::pipeline::RenderInstancedQueue queue;
+    cc::scene::Camera                  camera;
+    auto *                             cmdBuff = device->getCommandBuffer();
+    for (uint32_t frame = 0; frame < 2; ++frame) {
+        queue.clear();
+        ExpectEq(queue.empty() && !buffer->hasPendingModels(), true);
+        for (const auto &model : models) {
+            buffer->merge(&model->model, &model->subModel, 0);
+            queue.add(buffer);
+        }
+        cmdBuff->begin();
+        queue.uploadBuffers(cmdBuff);
+        queue.cullInstances(&culling, &camera, cmdBuff);
+        cmdBuff->end();
+
+        ExpectEq(holdsModels(buffer, MESH_COUNT), true);
+        ExpectEq(buffer->getInstances().size() == MESH_COUNT, true);
+        for (const auto &item : buffer->getInstances()) {
+            ExpectEq(!item.culling && item.ia->getInstanceCount() == item.count, true);
+        }
+    }
+    queue.clear();
+}
@@ -0,0 +1,109 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "cocos/base/job-system/JobSystem.h"
+#include "cocos/renderer/GFXDeviceManager.h"
+#include "cocos/renderer/pipeline/RenderStage.h"
+#include "utils.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Records render queues through RenderStage::recordRenderQueues on the empty device.
+
+namespace {
+constexpr uint32_t SIZE = 16;
+
+class TestStage : public cc::pipeline::RenderStage {
+public:
+    void render(cc::scene::Camera * /*camera*/) override {}
+
+    using RenderStage::recordRenderQueues;
+};
+
+class PipelineRenderStageTest : public testing::Test {
+protected:
+    void SetUp() override {
+        // no window is available here, so every other backend fails to initialize and the empty device is picked
+        device = cc::gfx::DeviceManager::create(cc::gfx::DeviceInfo{});
+
+        cc::gfx::RenderPassInfo renderPassInfo;
+        renderPassInfo.colorAttachments.emplace_back();
+        renderPassInfo.colorAttachments.back().format = cc::gfx::Format::RGBA8;
+        renderPass                                    = device->createRenderPass(renderPassInfo);
+        texture                                       = device->createTexture({cc::gfx::TextureType::TEX2D, cc::gfx::TextureUsageBit::COLOR_ATTACHMENT, cc::gfx::Format::RGBA8, SIZE, SIZE});
+        framebuffer                                   = device->createFramebuffer({renderPass, {texture}});
+        // stages pick up the device when they are constructed
+        stage = std::make_unique<TestStage>();
+    }
+    void TearDown() override {
+        stage->destroy();
+        stage.reset();
+        CC_SAFE_DESTROY(framebuffer);
+        CC_SAFE_DESTROY(texture);
+        CC_SAFE_DESTROY(renderPass);
+        cc::gfx::DeviceManager::destroy();
+    }
+
+    cc::gfx::Device *          device{nullptr};
+    cc::gfx::RenderPass *      renderPass{nullptr};
+    cc::gfx::Texture *         texture{nullptr};
+    cc::gfx::Framebuffer *     framebuffer{nullptr};
+    std::unique_ptr<TestStage> stage;
+};
+} // namespace
+
+TEST_F(PipelineRenderStageTest, recordRenderQueues) {
+    logLabel = "test every render queue is recorded once into a command buffer of its own";
+    constexpr uint32_t QUEUE_COUNT = 8;
+    const cc::gfx::Rect  renderArea{0, 0, SIZE, SIZE};
+    const cc::gfx::Color clearColor{0.F, 0.F, 0.F, 1.F};
+    const bool           concurrent = cc::JobSystem::getInstance()->threadCount() > 1;
+
+    auto *primary = device->getCommandBuffer();
+    for (uint32_t frame = 0; frame < 2; ++frame) {
+        std::vector<std::atomic<uint32_t>>     recordCounts(QUEUE_COUNT);
+        std::vector<cc::gfx::CommandBuffer *> recordedInto(QUEUE_COUNT, nullptr);
+        auto                                   recordQueue = [&](uint32_t i, cc::gfx::CommandBuffer *cmdBuff) {
+            ++recordCounts[i];
+            recordedInto[i] = cmdBuff;
+        };
+
+        primary->begin();
+        stage->recordRenderQueues(primary, renderPass, framebuffer, renderArea, &clearColor, 1.F, 0, QUEUE_COUNT, recordQueue);
+        primary->end();
+
+        bool recordedOnce = true;
+        bool ownBuffers   = true;
+        for (uint32_t i = 0; i < QUEUE_COUNT; ++i) {
+            recordedOnce = recordedOnce && recordCounts[i] == 1;
+            ownBuffers   = ownBuffers && recordedInto[i] && (concurrent ? recordedInto[i] != primary : recordedInto[i] == primary);
+            for (uint32_t j = 0; concurrent && j < i; ++j) {
+                ownBuffers = ownBuffers && recordedInto[i] != recordedInto[j];
+            }
+        }
+        ExpectEq(recordedOnce, true);
+        ExpectEq(ownBuffers, true);
+    }
+}
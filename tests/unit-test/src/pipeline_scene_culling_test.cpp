@@ -0,0 +1,194 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "base/CoreStd.h"
+#include "base/job-system/JobSystem.h"
+#include "cocos/renderer/pipeline/SceneCulling.h"
+#include "cocos/scene/Model.h"
+#include "cocos/scene/Pass.h"
+#include "cocos/scene/SubModel.h"
+#include "utils.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr uint32_t VISIBILITY = 1U;
+
+struct TestScene {
+    std::vector<std::unique_ptr<cc::scene::Model>> models;
+    std::vector<cc::scene::AABB>                   bounds;
+    std::vector<cc::scene::Model *>                modelList;
+    cc::scene::Camera                              camera;
+    cc::scene::Shadow                              shadow;
+    cc::scene::Skybox                              skybox;
+    cc::scene::Frustum                             dirLightFrustum;
+
+    TestScene(uint32_t count, std::mt19937 &rng) : bounds(count) {
+        std::uniform_real_distribution<float> position(-200.0F, 200.0F);
+        std::uniform_real_distribution<float> extent(0.1F, 10.0F);
+        std::uniform_int_distribution<int>    kind(0, 15);
+        for (uint32_t i = 0; i < count; ++i) {
+            auto model = std::make_unique<cc::scene::Model>();
+            bounds[i].set({position(rng), position(rng), position(rng)}, {extent(rng), extent(rng), extent(rng)});
+            const int k = kind(rng);
+            // a few models of each kind the culling tells apart
+            if (k != 0) model->setBounds(&bounds[i]);
+            model->setEnabled(k != 1);
+            model->seVisFlag(k == 2 ? 0U : VISIBILITY);
+            model->setCastShadow(k % 3 == 0);
+            modelList.push_back(model.get());
+            models.push_back(std::move(model));
+        }
+
+        cc::Mat4 transform;
+        cc::Mat4::fromRT(cc::Quaternion(0.2F, 0.3F, 0.1F, 0.927F).getNormalized(), cc::Vec3(10.0F, -5.0F, 20.0F), &transform);
+        camera.frustum.createOrtho(160.0F, 90.0F, 0.1F, 150.0F, transform);
+        camera.visibility = VISIBILITY;
+        cc::Mat4::fromRT(cc::Quaternion(0.5F, 0.0F, 0.0F, 0.866F).getNormalized(), cc::Vec3(0.0F, 50.0F, 0.0F), &transform);
+        dirLightFrustum.createOrtho(200.0F, 200.0F, 0.1F, 300.0F, transform);
+    }
+
+    cc::pipeline::SceneCullingInfo info(bool isShadowMap) const {
+        cc::pipeline::SceneCullingInfo info;
+        info.camera          = &camera;
+        info.shadowInfo      = &shadow;
+        info.skyBox          = &skybox;
+        info.dirLightFrustum = &dirLightFrustum;
+        info.isShadowMap     = isShadowMap;
+        return info;
+    }
+};
+
+bool sameList(const cc::pipeline::RenderObjectList &a, const cc::pipeline::RenderObjectList &b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].model != b[i].model || a[i].depth != b[i].depth) return false;
+    }
+    return true;
+}
+} // namespace
+
+TEST(pipelineSceneCullingTest, chunkedMatchesSerial) {
+    logLabel = "test the chunked scene culling against the serial culling";
+    std::mt19937 rng(2021);
+    for (uint32_t count : {0U, 1U, 5U, 255U, 256U, 257U, 3000U}) {
+        TestScene scene(count, rng);
+        for (bool isShadowMap : {false, true}) {
+            scene.shadow.fixedArea = !scene.shadow.fixedArea;
+            const auto                       info = scene.info(isShadowMap);
+            cc::pipeline::SceneCullingResult serial;
+            cc::pipeline::cullSceneModels(info, scene.modelList, 1U, &serial);
+            if (count > 100) {
+                ExpectEq(!serial.renderObjects.empty() && serial.renderObjects.size() < count, true);
+                ExpectEq(serial.dirShadowObjects.empty(), !isShadowMap);
+            }
+            for (uint32_t chunkCount : {2U, 3U, 8U, count + 3U}) {
+                cc::pipeline::SceneCullingResult chunked;
+                cc::pipeline::cullSceneModels(info, scene.modelList, chunkCount, &chunked);
+                ExpectEq(sameList(serial.renderObjects, chunked.renderObjects), true);
+                ExpectEq(sameList(serial.castShadowObjects, chunked.castShadowObjects), true);
+                ExpectEq(sameList(serial.dirShadowObjects, chunked.dirShadowObjects), true);
+            }
+        }
+    }
+}
+
+TEST(pipelineSceneCullingTest, gpuCulledInstances) {
+    logLabel = "test only instanced models outside the frustum are kept for the GPU instance culling";
+    std::mt19937 rng(2021);
+    TestScene    scene(3000U, rng);
+
+    cc::scene::PassLayout instancingLayout;
+    cc::scene::PassLayout mergingLayout;
+    instancingLayout.batchingScheme = cc::scene::BatchingSchemes::INSTANCING;
+    cc::scene::Pass instancing;
+    cc::scene::Pass merging;
+    instancing.initWithData(reinterpret_cast<uint8_t *>(&instancingLayout));
+    merging.initWithData(reinterpret_cast<uint8_t *>(&mergingLayout));
+    cc::scene::SubModel instancedSubModel;
+    cc::scene::SubModel mixedSubModel;
+    instancedSubModel.setPasses({&instancing});
+    mixedSubModel.setPasses({&instancing, &merging});
+
+    // every third model is only drawn instanced, the others also have a pass drawing them one by one or none at all
+    std::vector<uint8_t>           attributes(64);
+    cc::pipeline::RenderObjectList expected;
+    for (uint32_t i = 0; i < scene.modelList.size(); ++i) {
+        auto *model = scene.modelList[i];
+        if (i % 3 == 2) continue;
+        model->setInstancedAttrBlock(attributes.data(), static_cast<uint32_t>(attributes.size()), cc::scene::InstancedAttributeBlock{}, {});
+        model->setSubModel(0, i % 3 == 0 ? &instancedSubModel : &mixedSubModel);
+        if (i % 3 == 0 && model->getEnabled() && model->getWorldBounds() && model->getVisFlags() == VISIBILITY &&
+            !model->getWorldBounds()->aabbFrustum(scene.camera.frustum)) {
+            expected.push_back({0.0F, model});
+        }
+    }
+    ExpectEq(expected.empty(), false);
+
+    auto                             info = scene.info(false);
+    cc::pipeline::SceneCullingResult cpuCulled;
+    cc::pipeline::cullSceneModels(info, scene.modelList, 1U, &cpuCulled);
+    ExpectEq(cpuCulled.gpuCulledObjects.empty(), true);
+
+    info.gpuInstanceCulling = true;
+    for (uint32_t chunkCount : {1U, 3U, 8U}) {
+        cc::pipeline::SceneCullingResult gpuCulled;
+        cc::pipeline::cullSceneModels(info, scene.modelList, chunkCount, &gpuCulled);
+        // the queues which do not cull on the GPU still only see the models in the frustum
+        ExpectEq(sameList(cpuCulled.renderObjects, gpuCulled.renderObjects), true);
+        ExpectEq(sameList(cpuCulled.castShadowObjects, gpuCulled.castShadowObjects), true);
+        ExpectEq(sameList(expected, gpuCulled.gpuCulledObjects), true);
+    }
+}
+
+TEST(pipelineSceneCullingTest, chunkedBenchmark) {
+    constexpr uint32_t COUNT      = 20000;
+    constexpr uint32_t ITERATIONS = 20;
+    std::mt19937       rng(54321);
+    TestScene          scene(COUNT, rng);
+    const auto         info       = scene.info(false);
+    const uint32_t     chunkCount = cc::JobSystem::getInstance()->threadCount() + 1U;
+
+    cc::pipeline::SceneCullingResult result;
+    const auto                       serialStart = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < ITERATIONS; ++n) {
+        result.clear();
+        cc::pipeline::cullSceneModels(info, scene.modelList, 1U, &result);
+    }
+    const auto chunkedStart = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < ITERATIONS; ++n) {
+        result.clear();
+        cc::pipeline::cullSceneModels(info, scene.modelList, chunkCount, &result);
+    }
+    const auto chunkedEnd = std::chrono::steady_clock::now();
+
+    // with the dummy job system the chunks run one after another on this thread
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    std::cout << "cullSceneModels x" << COUNT << ": serial " << Microseconds(chunkedStart - serialStart).count() / ITERATIONS
+              << "us, " << chunkCount << " chunks on " << cc::JobSystem::getInstance()->threadCount() << " job threads "
+              << Microseconds(chunkedEnd - chunkedStart).count() / ITERATIONS << "us" << std::endl;
+}
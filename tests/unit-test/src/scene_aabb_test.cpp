@@ -0,0 +1,130 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "cocos/scene/AABB.h"
+#include "utils.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+struct BoxArrays {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+
+    cc::scene::AABBBatch batch() const {
+        return {centerX.data(), centerY.data(), centerZ.data(), extentX.data(), extentY.data(), extentZ.data(), static_cast<uint32_t>(centerX.size())};
+    }
+};
+
+BoxArrays randomBoxes(uint32_t count, std::mt19937 &rng) {
+    std::uniform_real_distribution<float> position(-200.0F, 200.0F);
+    std::uniform_real_distribution<float> extent(0.1F, 10.0F);
+    BoxArrays boxes;
+    for (uint32_t i = 0; i < count; ++i) {
+        boxes.centerX.push_back(position(rng));
+        boxes.centerY.push_back(position(rng));
+        boxes.centerZ.push_back(position(rng));
+        boxes.extentX.push_back(extent(rng));
+        boxes.extentY.push_back(extent(rng));
+        boxes.extentZ.push_back(extent(rng));
+    }
+    return boxes;
+}
+
+cc::scene::Frustum testFrustum() {
+    cc::Mat4 transform;
+    cc::Mat4::fromRT(cc::Quaternion(0.2F, 0.3F, 0.1F, 0.927F).getNormalized(), cc::Vec3(10.0F, -5.0F, 20.0F), &transform);
+    cc::scene::Frustum frustum;
+    frustum.createOrtho(160.0F, 90.0F, 0.1F, 150.0F, transform);
+    return frustum;
+}
+
+std::vector<uint32_t> scalarVisibility(const BoxArrays &boxes, const cc::scene::Frustum &frustum) {
+    std::vector<uint32_t> visibility((boxes.centerX.size() + 31) / 32, 0U);
+    cc::scene::AABB       aabb;
+    for (size_t i = 0; i < boxes.centerX.size(); ++i) {
+        aabb.set({boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i]}, {boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i]});
+        if (aabb.aabbFrustum(frustum)) {
+            visibility[i / 32] |= 1U << (i % 32);
+        }
+    }
+    return visibility;
+}
+} // namespace
+
+TEST(sceneAABBTest, frustumBatch) {
+    logLabel = "test the aabb aabbFrustumBatch function";
+    std::mt19937             rng(12345);
+    const cc::scene::Frustum frustum = testFrustum();
+    // odd counts cover the scalar tail of the SIMD kernels
+    for (uint32_t count : {0U, 1U, 3U, 7U, 31U, 32U, 33U, 100U, 1027U}) {
+        const BoxArrays       boxes    = randomBoxes(count, rng);
+        const auto            expected = scalarVisibility(boxes, frustum);
+        std::vector<uint32_t> visibility((count + 31) / 32, 0xFFFFFFFFU);
+        const uint32_t        visibleCount = cc::scene::AABB::aabbFrustumBatch(boxes.batch(), frustum, visibility.data());
+        ExpectEq(visibility == expected, true);
+
+        uint32_t expectedCount = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            expectedCount += (expected[i / 32] >> (i % 32)) & 1U;
+        }
+        ExpectEq(visibleCount == expectedCount, true);
+    }
+}
+
+TEST(sceneAABBTest, frustumBatchBenchmark) {
+    constexpr uint32_t COUNT      = 10000;
+    constexpr uint32_t ITERATIONS = 100;
+    std::mt19937             rng(54321);
+    const cc::scene::Frustum frustum = testFrustum();
+    const BoxArrays          boxes   = randomBoxes(COUNT, rng);
+    std::vector<uint32_t>    visibility((COUNT + 31) / 32);
+
+    cc::scene::AABB aabb;
+    uint32_t        scalarCount = 0;
+    const auto      scalarStart = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < ITERATIONS; ++n) {
+        for (uint32_t i = 0; i < COUNT; ++i) {
+            aabb.set({boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i]}, {boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i]});
+            scalarCount += aabb.aabbFrustum(frustum) ? 1 : 0;
+        }
+    }
+    const auto batchStart = std::chrono::steady_clock::now();
+    uint32_t   batchCount = 0;
+    for (uint32_t n = 0; n < ITERATIONS; ++n) {
+        batchCount += cc::scene::AABB::aabbFrustumBatch(boxes.batch(), frustum, visibility.data());
+    }
+    const auto batchEnd = std::chrono::steady_clock::now();
+
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    std::cout << "aabbFrustum x" << COUNT << ": scalar " << Microseconds(batchStart - scalarStart).count() / ITERATIONS
+              << "us, batch " << Microseconds(batchEnd - batchStart).count() / ITERATIONS << "us" << std::endl;
+    EXPECT_EQ(scalarCount, batchCount);
+}
@@ -0,0 +1,297 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "cocos/scene/CommandStream.h"
+#include "utils.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Scene objects need JS backed nodes, so the handlers write plain records laid out like the
+// scene command elements. The legacy path mirrors the __fastMQ__ records: a length, a function
+// pointer and the payload, one record per update. There is no script engine here, so the
+// benchmark only times the native decode and dispatch of filled buffers, not the JS writes
+// nor the JS to native crossing that the bulk commands are meant to save.
+
+namespace {
+using cc::scene::AlignedPtr;
+using cc::scene::CommandStream;
+using cc::scene::SceneCommand;
+
+struct TransformRecord {
+    float    position[3]{};
+    float    rotation[4]{};
+    float    scale[3]{};
+    uint32_t layer{0};
+    uint32_t updates{0};
+};
+
+struct TRSElement {
+    AlignedPtr<TransformRecord> record;
+    float                       position[3];
+    float                       rotation[4];
+    float                       scale[3];
+};
+static_assert(sizeof(TRSElement) == sizeof(cc::scene::command::NodeLocalTRS), "stand-in of NodeLocalTRS");
+
+struct LayerElement {
+    AlignedPtr<TransformRecord> record;
+    uint32_t                    layer;
+};
+static_assert(sizeof(LayerElement) == sizeof(cc::scene::command::NodeLayer), "stand-in of NodeLayer");
+
+std::vector<uint32_t> commandLog;
+
+void setTRS(const TRSElement &e) {
+    auto *record = e.record.get();
+    memcpy(record->position, e.position, sizeof(e.position));
+    memcpy(record->rotation, e.rotation, sizeof(e.rotation));
+    memcpy(record->scale, e.scale, sizeof(e.scale));
+    ++record->updates;
+}
+
+void runTRS(const TRSElement *elements, uint32_t count) {
+    commandLog.push_back(static_cast<uint32_t>(SceneCommand::NODE_LOCAL_TRS));
+    for (uint32_t i = 0; i < count; ++i) {
+        setTRS(elements[i]);
+    }
+}
+
+void runLayer(const LayerElement *elements, uint32_t count) {
+    commandLog.push_back(static_cast<uint32_t>(SceneCommand::NODE_LAYER));
+    for (uint32_t i = 0; i < count; ++i) {
+        elements[i].record.get()->layer = elements[i].layer;
+    }
+}
+
+void fastSetTRS(void *buffer) {
+    setTRS(*reinterpret_cast<const TRSElement *>(buffer));
+}
+
+void setPtr(void *dst, const void *ptr) {
+    const auto value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+    memcpy(dst, &value, sizeof(value));
+}
+
+TRSElement makeTRS(TransformRecord *record, float value) {
+    TRSElement e{};
+    setPtr(&e.record, record);
+    for (float &v : e.position) v = value;
+    for (float &v : e.rotation) v = value + 1.0F;
+    for (float &v : e.scale) v = value + 2.0F;
+    return e;
+}
+
+// Writes commands the way the JS side fills __fastCS__.buffer.
+class StreamWriter {
+public:
+    explicit StreamWriter(uint32_t capacity) : _storage(capacity / sizeof(uint32_t)) {
+        CommandStream::resetBuffer(data());
+    }
+
+    inline uint8_t *                     data() { return reinterpret_cast<uint8_t *>(_storage.data()); }
+    inline uint32_t                      capacity() const { return static_cast<uint32_t>(_storage.size() * sizeof(uint32_t)); }
+    inline CommandStream::StreamHeader *header() { return reinterpret_cast<CommandStream::StreamHeader *>(data()); }
+
+    template <typename Element>
+    CommandStream::CommandHeader *write(SceneCommand id, const Element *elements, uint32_t count) {
+        const auto size    = static_cast<uint32_t>(sizeof(CommandStream::CommandHeader) + sizeof(Element) * count);
+        auto *     command = reinterpret_cast<CommandStream::CommandHeader *>(data() + header()->size);
+        command->id        = static_cast<uint16_t>(id);
+        command->reserved  = 0;
+        command->count     = count;
+        command->size      = size;
+        memcpy(command + 1, elements, sizeof(Element) * count);
+        header()->size += size;
+        ++header()->commandCount;
+        return command;
+    }
+
+private:
+    std::vector<uint32_t> _storage;
+};
+
+CommandStream makeStream() {
+    CommandStream stream;
+    stream.registerCommand<TRSElement, runTRS>(SceneCommand::NODE_LOCAL_TRS);
+    stream.registerCommand<LayerElement, runLayer>(SceneCommand::NODE_LAYER);
+    return stream;
+}
+
+bool isReset(StreamWriter &writer) {
+    return writer.header()->version == CommandStream::VERSION && writer.header()->size == sizeof(CommandStream::StreamHeader) &&
+           writer.header()->commandCount == 0;
+}
+} // namespace
+
+TEST(sceneCommandStreamTest, execute) {
+    logLabel = "test commands run in the order they were written";
+    const CommandStream          stream = makeStream();
+    StreamWriter                 writer(4096);
+    std::vector<TransformRecord> records(3);
+
+    const TRSElement bulk[3]{makeTRS(&records[0], 1.0F), makeTRS(&records[1], 2.0F), makeTRS(&records[2], 3.0F)};
+    LayerElement     layer{};
+    setPtr(&layer.record, &records[1]);
+    layer.layer               = 0x80;
+    const TRSElement latest   = makeTRS(&records[0], 9.0F);
+    writer.write(SceneCommand::NODE_LOCAL_TRS, bulk, 3);
+    writer.write(SceneCommand::NODE_LAYER, &layer, 1);
+    writer.write(SceneCommand::NODE_LOCAL_TRS, &latest, 1);
+
+    commandLog.clear();
+    ExpectEq(stream.execute(writer.data(), writer.capacity()), true);
+    ExpectEq(commandLog == std::vector<uint32_t>{1, 3, 1}, true);
+    ExpectEq(records[0].updates == 2 && records[0].position[0] == 9.0F && records[0].scale[2] == 11.0F, true);
+    ExpectEq(records[1].updates == 1 && records[1].rotation[3] == 3.0F && records[1].layer == 0x80, true);
+    ExpectEq(records[2].updates == 1 && records[2].position[1] == 3.0F, true);
+    ExpectEq(isReset(writer), true);
+
+    logLabel = "test an empty stream runs nothing";
+    commandLog.clear();
+    ExpectEq(stream.execute(writer.data(), writer.capacity()), true);
+    ExpectEq(commandLog.empty(), true);
+}
+
+TEST(sceneCommandStreamTest, rejectMalformed) {
+    const CommandStream stream = makeStream();
+    StreamWriter        writer(4096);
+    TransformRecord     record;
+    const TRSElement    element = makeTRS(&record, 1.0F);
+
+    logLabel = "test a buffer of another version is rejected";
+    writer.write(SceneCommand::NODE_LOCAL_TRS, &element, 1);
+    writer.header()->version = CommandStream::VERSION + 1;
+    commandLog.clear();
+    ExpectEq(stream.execute(writer.data(), writer.capacity()), false);
+    ExpectEq(commandLog.empty() && record.updates == 0, true);
+    ExpectEq(isReset(writer), true);
+
+    logLabel = "test a stream larger than its buffer is rejected";
+    writer.write(SceneCommand::NODE_LOCAL_TRS, &element, 1);
+    writer.header()->size = writer.capacity() + 4;
+    ExpectEq(stream.execute(writer.data(), writer.capacity()), false);
+    ExpectEq(record.updates == 0 && isReset(writer), true);
+
+    logLabel = "test commands before a malformed one still run";
+    writer.write(SceneCommand::NODE_LOCAL_TRS, &element, 1);
+    writer.write(SceneCommand::NODE_LOCAL_TRS, &element, 1)->count = 2;
+    commandLog.clear();
+    ExpectEq(stream.execute(writer.data(), writer.capacity()), false);
+    ExpectEq(commandLog.size() == 1 && record.updates == 1, true);
+
+    logLabel = "test unregistered and out of range ids are rejected";
+    writer.write(SceneCommand::CAMERA_VIEW, &element, 1);
+    ExpectEq(stream.execute(writer.data(), writer.capacity()), false);
+    writer.write(SceneCommand::NODE_LOCAL_TRS, &element, 1)->id = CommandStream::MAX_COMMANDS;
+    ExpectEq(stream.execute(writer.data(), writer.capacity()), false);
+
+    logLabel = "test a command count past the stream size is rejected";
+    writer.write(SceneCommand::NODE_LOCAL_TRS, &element, 1);
+    ++writer.header()->commandCount;
+    commandLog.clear();
+    ExpectEq(stream.execute(writer.data(), writer.capacity()), false);
+    ExpectEq(commandLog.size() == 1 && record.updates == 2, true);
+}
+
+TEST(sceneCommandStreamTest, nativeDispatchBenchmark) {
+    logLabel = "test bulk, per element and legacy records apply the same updates";
+    constexpr uint32_t COUNT      = 10000;
+    constexpr uint32_t ITERATIONS = 50;
+    using FastFunction            = void (*)(void *);
+
+    const CommandStream          stream = makeStream();
+    std::vector<TransformRecord> records(COUNT);
+    std::vector<TRSElement>      elements;
+    elements.reserve(COUNT);
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        elements.push_back(makeTRS(&records[i], static_cast<float>(i)));
+    }
+
+    StreamWriter bulk(sizeof(CommandStream::StreamHeader) + sizeof(CommandStream::CommandHeader) + sizeof(TRSElement) * COUNT);
+    StreamWriter perElement((sizeof(CommandStream::CommandHeader) + sizeof(TRSElement)) * COUNT + sizeof(CommandStream::StreamHeader));
+
+    // __fastMQ__ records: {len, fn, payload}, executed by jsbFlushFastMQ
+    constexpr uint32_t    LEGACY_RECORD = 12 + sizeof(TRSElement);
+    std::vector<uint32_t> legacy((8 + LEGACY_RECORD * COUNT) / sizeof(uint32_t));
+    auto *                legacyPtr = reinterpret_cast<uint8_t *>(legacy.data());
+    auto                  runLegacy = [&]() {
+        auto *   u32Ptr   = reinterpret_cast<uint32_t *>(legacyPtr);
+        auto     commands = u32Ptr[1];
+        uint8_t *p        = legacyPtr + 8;
+        for (uint32_t i = 0; i < commands; i++) {
+            auto *base = reinterpret_cast<uint32_t *>(p);
+            auto *fn   = reinterpret_cast<FastFunction *>(base + 1);
+            (*fn)(p + 12);
+            p += base[0];
+        }
+        u32Ptr[0] = 8;
+        u32Ptr[1] = 0;
+    };
+    auto fillLegacy = [&]() {
+        uint8_t *p = legacyPtr + 8;
+        for (const auto &e : elements) {
+            const uint32_t     len = LEGACY_RECORD;
+            const FastFunction fn  = fastSetTRS;
+            memcpy(p, &len, sizeof(len));
+            memcpy(p + 4, &fn, sizeof(fn));
+            memcpy(p + 12, &e, sizeof(e));
+            p += len;
+        }
+        reinterpret_cast<uint32_t *>(legacyPtr)[0] = static_cast<uint32_t>(p - legacyPtr);
+        reinterpret_cast<uint32_t *>(legacyPtr)[1] = COUNT;
+    };
+
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    Microseconds bulkTime{0}, perElementTime{0}, legacyTime{0};
+    for (uint32_t n = 0; n < ITERATIONS; ++n) {
+        bulk.write(SceneCommand::NODE_LOCAL_TRS, elements.data(), COUNT);
+        auto start = std::chrono::steady_clock::now();
+        ExpectEq(stream.execute(bulk.data(), bulk.capacity()), true);
+        bulkTime += std::chrono::steady_clock::now() - start;
+
+        for (const auto &e : elements) {
+            perElement.write(SceneCommand::NODE_LOCAL_TRS, &e, 1);
+        }
+        start = std::chrono::steady_clock::now();
+        ExpectEq(stream.execute(perElement.data(), perElement.capacity()), true);
+        perElementTime += std::chrono::steady_clock::now() - start;
+
+        fillLegacy();
+        start = std::chrono::steady_clock::now();
+        runLegacy();
+        legacyTime += std::chrono::steady_clock::now() - start;
+    }
+
+    bool allUpdated = true;
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        allUpdated &= records[i].updates == ITERATIONS * 3 && records[i].position[0] == static_cast<float>(i);
+    }
+    ExpectEq(allUpdated, true);
+
+    const auto callsPerSecond = [](Microseconds time) { return COUNT * ITERATIONS / time.count(); };
+    std::cout << "native dispatch only, scene updates x" << COUNT << " in M/s: bulk " << callsPerSecond(bulkTime) << ", per element " << callsPerSecond(perElementTime)
+              << ", legacy records " << callsPerSecond(legacyTime) << std::endl;
+}
@@ -0,0 +1,258 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "base/CoreStd.h"
+#include "base/job-system/JobSystem.h"
+#include "cocos/renderer/gfx-base/GFXBuffer.h"
+#include "cocos/renderer/pipeline/Define.h"
+#include "cocos/scene/Define.h"
+#include "cocos/scene/Node.h"
+#include "cocos/scene/RenderScene.h"
+#include "cocos/scene/SkinningModel.h"
+#include "node_utils.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Two identical scenes are updated for a few frames, one through the serial path of RenderScene::update
+// and one through the chunked parallel path. Every buffer update the models make is recorded, the results
+// have to be the same. Node transforms are written straight into the node layouts, the way the JS side does.
+
+namespace {
+constexpr uint32_t MODEL_COUNT    = 300;
+constexpr uint32_t SKINNING_COUNT = 4;
+constexpr uint32_t JOINT_COUNT    = 3;
+constexpr uint32_t FRAMES         = 6;
+
+class RecordingBuffer final : public cc::gfx::Buffer {
+public:
+    // only the part the models write is kept, the lightmap parameters of the local UBO are not updated natively
+    void update(const void *buffer, uint32_t size) override {
+        const auto *bytes = static_cast<const uint8_t *>(buffer);
+        data.assign(bytes, bytes + std::min(size, writtenSize));
+        ++updateCount;
+    }
+
+    uint32_t writtenSize{0};
+
+    std::vector<uint8_t> data;
+    uint32_t             updateCount{0};
+
+protected:
+    void doInit(const cc::gfx::BufferInfo & /*info*/) override {}
+    void doInit(const cc::gfx::BufferViewInfo & /*info*/) override {}
+    void doResize(uint32_t /*size*/, uint32_t /*count*/) override {}
+    void doDestroy() override {}
+};
+
+struct TestNode {
+    cc::scene::NodeLayout layout;
+    uint32_t              flags{0};
+    cc::scene::Node       node;
+
+    TestNode() {
+        layout.localScale.set(1.0F, 1.0F, 1.0F);
+        initTestNode(&node, &layout, &flags);
+    }
+
+    // the JS side has already resolved the world transform, only the changed flags are left
+    void moveTo(const cc::Vec3 &position, const cc::Quaternion &rotation) {
+        layout.localPosition.set(position);
+        layout.localRotation.set(rotation);
+        cc::Mat4::fromRTS(rotation, position, layout.localScale, &layout.worldMatrix);
+        flags = static_cast<uint32_t>(cc::scene::TransformBit::POSITION) | static_cast<uint32_t>(cc::scene::TransformBit::ROTATION);
+    }
+};
+
+struct ModelScene {
+    std::vector<std::unique_ptr<TestNode>>        nodes;
+    std::vector<std::unique_ptr<RecordingBuffer>> buffers;
+    std::vector<std::unique_ptr<cc::scene::AABB>> bounds;
+    std::vector<std::unique_ptr<cc::scene::Model>> models;
+    std::vector<RecordingBuffer *>                 jointBuffers;
+    cc::scene::RenderScene                         scene;
+
+    ModelScene() {
+        std::mt19937                          rng(2021);
+        std::uniform_real_distribution<float> unit(-1.0F, 1.0F);
+        std::uniform_real_distribution<float> extent(0.1F, 10.0F);
+
+        for (uint32_t i = 0; i < MODEL_COUNT + SKINNING_COUNT; ++i) {
+            const bool skinning = i % (MODEL_COUNT / SKINNING_COUNT) == 7;
+            auto       model    = skinning ? std::unique_ptr<cc::scene::Model>(new cc::scene::SkinningModel) : std::make_unique<cc::scene::Model>();
+            model->setTransform(newNode());
+            model->getTransform()->setFlagsChanged(static_cast<uint32_t>(cc::scene::TransformBit::TRS));
+            bounds.emplace_back(new cc::scene::AABB);
+            bounds.back()->set({unit(rng), unit(rng), unit(rng)}, {extent(rng), extent(rng), extent(rng)});
+            model->setBounds(bounds.back().get());
+            model->setLocalBuffer(newBuffer(cc::pipeline::UBOLocal::SIZE, cc::pipeline::UBOLocal::LIGHTINGMAP_UVPARAM * 4));
+            if (i % 3) model->setWorldBoundBuffer(newBuffer(cc::pipeline::UBOWorldBound::SIZE, cc::pipeline::UBOWorldBound::SIZE));
+            model->setEnabled(i % 11 != 5);
+
+            if (skinning) {
+                auto *skinningModel = static_cast<cc::scene::SkinningModel *>(model.get());
+                initSkinning(skinningModel, &rng);
+                scene.addSkinningModel(skinningModel);
+            } else {
+                scene.addModel(model.get());
+            }
+            models.push_back(std::move(model));
+        }
+    }
+
+    ~ModelScene() {
+        scene.removeModels();
+    }
+
+    cc::scene::Node *newNode() {
+        nodes.emplace_back(new TestNode);
+        return &nodes.back()->node;
+    }
+
+    RecordingBuffer *newBuffer(uint32_t size, uint32_t writtenSize) {
+        buffers.emplace_back(new RecordingBuffer);
+        buffers.back()->writtenSize = writtenSize;
+        buffers.back()->initialize({cc::gfx::BufferUsageBit::UNIFORM, cc::gfx::MemoryUsageBit::HOST | cc::gfx::MemoryUsageBit::DEVICE, size});
+        return buffers.back().get();
+    }
+
+    // a chain of joints, each one the parent of the next
+    void initSkinning(cc::scene::SkinningModel *model, std::mt19937 *rng) {
+        std::uniform_real_distribution<float>  unit(-1.0F, 1.0F);
+        std::vector<cc::scene::JointInfo>      joints(JOINT_COUNT);
+        std::vector<cc::scene::JointTransform> chain;
+        for (uint32_t j = 0; j < JOINT_COUNT; ++j) {
+            auto &joint = joints[j];
+            bounds.emplace_back(new cc::scene::AABB);
+            bounds.back()->set({0.0F, 0.0F, 0.0F}, {0.5F, 0.5F, 0.5F});
+            joint.bound          = bounds.back().get();
+            joint.transform.node = newNode();
+            nodes.back()->moveTo({unit(*rng), unit(*rng), unit(*rng)}, cc::Quaternion::identity());
+            cc::Mat4::fromRTS(cc::Quaternion::identity(), {unit(*rng), unit(*rng), unit(*rng)}, cc::Vec3::ONE, &joint.bindpose);
+            joint.parents.assign(chain.rbegin(), chain.rend());
+            joint.buffers = {0};
+            joint.indices = {j};
+            chain.push_back(joint.transform);
+        }
+        model->setBuffers({newBuffer(cc::pipeline::UBOSkinning::SIZE, JOINT_COUNT * 12 * 4)});
+        jointBuffers.push_back(buffers.back().get());
+        model->setIndicesAndJoints({0}, std::move(joints));
+    }
+
+    // moves the same nodes in both scenes, the last ones belong to the joints
+    void moveNodes(uint32_t frame) {
+        for (auto &node : nodes) {
+            node->flags = 0;
+        }
+        for (size_t i = frame % 5; i < nodes.size(); i += 5) {
+            const float t = static_cast<float>(frame + i);
+            nodes[i]->moveTo({t, -t * 0.5F, 2.0F}, cc::Quaternion(cc::Vec3::UNIT_Y, t * 0.1F));
+        }
+    }
+};
+
+bool sameResults(const ModelScene &lhs, const ModelScene &rhs) {
+    for (size_t i = 0; i < lhs.buffers.size(); ++i) {
+        if (lhs.buffers[i]->data != rhs.buffers[i]->data || lhs.buffers[i]->updateCount != rhs.buffers[i]->updateCount) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < lhs.models.size(); ++i) {
+        const auto *l = lhs.models[i].get();
+        const auto *r = rhs.models[i].get();
+        if (l->getUpdatStamp() != r->getUpdatStamp() || l->getTransformUpdated() != r->getTransformUpdated() ||
+            l->getWorldBounds()->getCenter() != r->getWorldBounds()->getCenter() ||
+            l->getWorldBounds()->getHalfExtents() != r->getWorldBounds()->getHalfExtents()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool localBuffersUpToDate(const ModelScene &scene) {
+    for (const auto &model : scene.models) {
+        if (!model->getEnabled()) continue;
+        const auto &data = static_cast<RecordingBuffer *>(model->getLocalBuffer())->data;
+        if (data.empty() || memcmp(data.data(), model->getTransform()->getWorldMatrix().m, sizeof(cc::Mat4)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST(sceneModelUpdateTest, parallelUpdateMatchesSerial) {
+    logLabel = "test the parallel model update of RenderScene matches the serial one";
+    for (uint32_t threadCount : {2U, 3U, 8U}) {
+        ModelScene serial;
+        ModelScene parallel;
+        serial.scene.setParallelUpdateThreshold(0);
+        parallel.scene.setParallelUpdateThreshold(16);
+
+        for (uint32_t frame = 1; frame <= FRAMES; ++frame) {
+            serial.moveNodes(frame);
+            parallel.moveNodes(frame);
+            serial.scene.update(frame);
+            parallel.scene.updateModels(frame, threadCount);
+
+            ExpectEq(sameResults(serial, parallel), true);
+            ExpectEq(localBuffersUpToDate(parallel), true);
+        }
+
+        // skinning models go through their own update in both paths, and upload their joints every frame
+        size_t skinningIndex = 0;
+        for (const auto &model : parallel.models) {
+            if (model->getType() != cc::scene::ModelType::SKINNING) continue;
+            ExpectEq(parallel.jointBuffers[skinningIndex++]->updateCount == (model->getEnabled() ? FRAMES : 0U), true);
+        }
+        ExpectEq(skinningIndex == parallel.jointBuffers.size(), true);
+    }
+}
+
+TEST(sceneModelUpdateTest, updateBenchmark) {
+    logLabel = "test the model update benchmark";
+    constexpr uint32_t ITERATIONS = 20;
+    ModelScene         scene;
+
+    // the parallel update only runs concurrently with a multi-threaded job system backend
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    std::cout << "scene update x" << scene.models.size() << " models, " << cc::JobSystem::getInstance()->threadCount() << " job thread(s):";
+    for (uint32_t threshold : {0U, 16U}) {
+        scene.scene.setParallelUpdateThreshold(threshold);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t n = 1; n <= ITERATIONS; ++n) {
+            scene.moveNodes(n);
+            scene.scene.update(n);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        std::cout << (threshold ? ", parallel " : " serial ") << Microseconds(end - start).count() / ITERATIONS << "us";
+    }
+    std::cout << std::endl;
+}
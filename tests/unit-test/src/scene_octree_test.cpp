@@ -0,0 +1,204 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "gtest/gtest.h"
+#include "base/CoreStd.h"
+#include "base/job-system/JobSystem.h"
+#include "cocos/scene/Camera.h"
+#include "cocos/scene/LinearOctree.h"
+#include "cocos/scene/Model.h"
+#include "cocos/scene/Octree.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr uint32_t VISIBILITY = 1U;
+constexpr float    WORLD_SIZE = 500.0F;
+
+struct OctreeScene {
+    std::vector<std::unique_ptr<cc::scene::Model>> models;
+    std::vector<cc::scene::AABB>                   bounds;
+    cc::scene::Octree                              octree;
+    cc::scene::Camera                              camera;
+
+    OctreeScene(uint32_t count, uint32_t depth, std::mt19937 &rng)
+    : bounds(count),
+      octree({-WORLD_SIZE, -WORLD_SIZE, -WORLD_SIZE}, {WORLD_SIZE, WORLD_SIZE, WORLD_SIZE}, depth) {
+        std::uniform_real_distribution<float> position(-WORLD_SIZE + 20.0F, WORLD_SIZE - 20.0F);
+        std::uniform_real_distribution<float> extent(0.1F, 15.0F);
+        std::uniform_int_distribution<int>    kind(0, 15);
+        for (uint32_t i = 0; i < count; ++i) {
+            auto model = std::make_unique<cc::scene::Model>();
+            bounds[i].set({position(rng), position(rng), position(rng)}, {extent(rng), extent(rng), extent(rng)});
+            const int k = kind(rng);
+            model->setBounds(&bounds[i]);
+            model->setEnabled(k != 1);
+            model->seVisFlag(k == 2 ? 0U : VISIBILITY);
+            model->setCastShadow(k % 3 == 0);
+            octree.insert(model.get());
+            models.push_back(std::move(model));
+        }
+
+        cc::Mat4 transform;
+        cc::Mat4::fromRT(cc::Quaternion(0.2F, 0.3F, 0.1F, 0.927F).getNormalized(), cc::Vec3(10.0F, -5.0F, 20.0F), &transform);
+        camera.frustum.createOrtho(400.0F, 250.0F, 0.1F, 400.0F, transform);
+        camera.visibility = VISIBILITY;
+    }
+};
+} // namespace
+
+TEST(sceneOctreeTest, parallelQueryMatchesSequential) {
+    logLabel = "test the parallel octree query against the sequential query";
+    std::mt19937 rng(2021);
+    for (uint32_t depth : {1U, 2U, 4U, 6U, 8U}) {
+        for (uint32_t count : {0U, 1U, 100U, 2000U, 10000U}) {
+            OctreeScene scene(count, depth, rng);
+            for (bool isShadow : {false, true}) {
+                std::vector<cc::scene::Model *> sequential;
+                scene.octree.queryVisibility(&scene.camera, scene.camera.frustum, isShadow, sequential);
+                if (count > 1000) {
+                    ExpectEq(!sequential.empty() && sequential.size() < count, true);
+                }
+                for (uint32_t threadCount : {1U, 2U, 3U, 8U, 32U}) {
+                    std::vector<cc::scene::Model *> parallel;
+                    scene.octree.queryVisibilityParallelly(&scene.camera, scene.camera.frustum, isShadow, parallel, threadCount);
+                    ExpectEq(parallel == sequential, true);
+                }
+            }
+        }
+    }
+}
+
+TEST(sceneOctreeTest, parallelQueryBenchmark) {
+    constexpr uint32_t ITERATIONS = 20;
+    std::mt19937       rng(54321);
+    const uint32_t     threadCount = std::max(cc::JobSystem::getInstance()->threadCount(), 2U);
+    using Microseconds             = std::chrono::duration<double, std::micro>;
+
+    for (uint32_t depth : {4U, 6U, 8U}) {
+        for (uint32_t count : {2000U, 20000U}) {
+            OctreeScene                     scene(count, depth, rng);
+            std::vector<cc::scene::Model *> results;
+            const auto                      sequentialStart = std::chrono::steady_clock::now();
+            for (uint32_t n = 0; n < ITERATIONS; ++n) {
+                results.clear();
+                scene.octree.queryVisibility(&scene.camera, scene.camera.frustum, false, results);
+            }
+            const auto parallelStart = std::chrono::steady_clock::now();
+            for (uint32_t n = 0; n < ITERATIONS; ++n) {
+                results.clear();
+                scene.octree.queryVisibilityParallelly(&scene.camera, scene.camera.frustum, false, results, threadCount);
+            }
+            const auto parallelEnd = std::chrono::steady_clock::now();
+
+            // with the dummy job system the query tasks run one after another on this thread
+            std::cout << "Octree depth " << depth << " x" << count << ": sequential "
+                      << Microseconds(parallelStart - sequentialStart).count() / ITERATIONS << "us, split for " << threadCount
+                      << " workers on " << cc::JobSystem::getInstance()->threadCount() << " job threads "
+                      << Microseconds(parallelEnd - parallelStart).count() / ITERATIONS << "us" << std::endl;
+        }
+    }
+}
+
+TEST(sceneOctreeTest, linearOctreeMatchesOctree) {
+    logLabel = "test the LinearOctree query against the Octree query";
+    std::mt19937                          rng(1024);
+    std::uniform_real_distribution<float> position(-WORLD_SIZE + 20.0F, WORLD_SIZE - 20.0F);
+    for (uint32_t depth : {1U, 2U, 4U, 8U, 10U}) {
+        for (uint32_t count : {0U, 1U, 100U, 5000U}) {
+            OctreeScene             scene(count, depth, rng);
+            cc::scene::LinearOctree linear({-WORLD_SIZE, -WORLD_SIZE, -WORLD_SIZE}, {WORLD_SIZE, WORLD_SIZE, WORLD_SIZE}, depth);
+            ExpectEq(linear.getMaxDepth() == depth, true);
+            // both trees keep their node in the model, so insert into a fresh model set
+            std::vector<std::unique_ptr<cc::scene::Model>> linearModels;
+            std::vector<cc::scene::Model *>                 octreeToLinear;
+            for (const auto &model : scene.models) {
+                auto copy = std::make_unique<cc::scene::Model>();
+                copy->setBounds(model->getWorldBounds());
+                copy->setEnabled(model->getEnabled());
+                copy->seVisFlag(model->getVisFlags());
+                copy->setCastShadow(model->getCastShadow());
+                linear.insert(copy.get());
+                octreeToLinear.push_back(copy.get());
+                linearModels.push_back(std::move(copy));
+            }
+
+            auto compare = [&]() {
+                for (bool isShadow : {false, true}) {
+                    std::vector<cc::scene::Model *> expected;
+                    std::vector<cc::scene::Model *> results;
+                    scene.octree.queryVisibility(&scene.camera, scene.camera.frustum, isShadow, expected);
+                    linear.queryVisibility(&scene.camera, scene.camera.frustum, isShadow, results);
+                    for (auto *&model : expected) {
+                        const auto index = std::find_if(scene.models.begin(), scene.models.end(), [&](const auto &m) { return m.get() == model; }) - scene.models.begin();
+                        model            = octreeToLinear[index];
+                    }
+                    std::sort(expected.begin(), expected.end());
+                    std::sort(results.begin(), results.end());
+                    ExpectEq(results == expected, true);
+                }
+            };
+            compare();
+
+            // move and remove some models, then query again
+            for (uint32_t i = 0; i < count; i += 3) {
+                scene.bounds[i].setCenter({position(rng), position(rng), position(rng)});
+                scene.octree.update(scene.models[i].get());
+                linear.update(linearModels[i].get());
+            }
+            for (uint32_t i = 1; i < count; i += 7) {
+                scene.octree.remove(scene.models[i].get());
+                linear.remove(linearModels[i].get());
+            }
+            compare();
+        }
+    }
+}
+
+TEST(sceneOctreeTest, linearOctreeResizeClampedDepth) {
+    logLabel = "test LinearOctree::resize with a depth beyond the clamp keeps the tree";
+    const cc::Vec3          minPos{-WORLD_SIZE, -WORLD_SIZE, -WORLD_SIZE};
+    const cc::Vec3          maxPos{WORLD_SIZE, WORLD_SIZE, WORLD_SIZE};
+    const uint32_t          depth = cc::scene::LINEAR_OCTREE_MAX_DEPTH + 2;
+    cc::scene::LinearOctree linear(minPos, maxPos, depth);
+    ExpectEq(linear.getMaxDepth() == cc::scene::LINEAR_OCTREE_MAX_DEPTH, true);
+
+    cc::scene::AABB  bounds[2];
+    cc::scene::Model models[2];
+    bounds[0].set({-100.0F, 10.0F, 10.0F}, {1.0F, 1.0F, 1.0F});
+    bounds[1].set({100.0F, 10.0F, 10.0F}, {1.0F, 1.0F, 1.0F});
+    for (uint32_t i = 0; i < 2; ++i) {
+        models[i].setBounds(&bounds[i]);
+        linear.insert(&models[i]);
+    }
+
+    // a rebuild would hand the freed slot 0 to the remaining model
+    linear.remove(&models[0]);
+    linear.resize(minPos, maxPos, depth);
+    ExpectEq(models[1].getOctreeHandle() == 1U, true);
+}
@@ -0,0 +1,334 @@
+/****************************************************************************
+Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "cocos/renderer/gfx-base/GFXBuffer.h"
+#include "cocos/renderer/pipeline/Define.h"
+#include "cocos/scene/Define.h"
+#include "cocos/scene/Node.h"
+#include "cocos/scene/SkinningModel.h"
+#include "node_utils.h"
+#include "utils.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// SkinningModel evaluates the joint nodes of all chains once, parents first, and only the ones that
+// changed since the previous frame. Its uploads are checked against walking the parent chain of every
+// joint from scratch. Joint transforms are written straight into the node layouts, like the JS side does.
+// The benchmark also times the per-joint chain walk SkinningModel used before.
+
+namespace {
+constexpr uint32_t JOINTS            = 50;
+constexpr uint32_t JOINTS_PER_BUFFER = cc::pipeline::JOINT_UNIFORM_CAPACITY;
+constexpr uint32_t FLOATS_PER_JOINT  = 12;
+
+class RecordingBuffer final : public cc::gfx::Buffer {
+public:
+    void update(const void *buffer, uint32_t size) override {
+        data.assign(static_cast<const float *>(buffer), static_cast<const float *>(buffer) + size / sizeof(float));
+        ++updateCount;
+    }
+
+    std::vector<float> data;
+    uint32_t           updateCount{0};
+
+protected:
+    void doInit(const cc::gfx::BufferInfo & /*info*/) override {}
+    void doInit(const cc::gfx::BufferViewInfo & /*info*/) override {}
+    void doResize(uint32_t /*size*/, uint32_t /*count*/) override {}
+    void doDestroy() override {}
+};
+
+struct TestNode {
+    cc::scene::NodeLayout layout;
+    uint32_t              flags{0};
+    cc::scene::Node       node;
+
+    TestNode() {
+        initTestNode(&node, &layout, &flags);
+    }
+};
+
+struct Character {
+    std::vector<std::unique_ptr<TestNode>>        joints;
+    std::vector<int32_t>                          parents; // parents precede their children
+    std::vector<cc::Mat4>                         bindposes;
+    std::vector<std::unique_ptr<RecordingBuffer>> buffers;
+    std::vector<cc::scene::AABB>                  jointBounds;
+    TestNode                                      root;
+    cc::scene::AABB                               worldBounds;
+    cc::scene::SkinningModel                      model;
+    std::mt19937                                  rng;
+
+    // state of the previous per-joint path, see legacyUpdate
+    std::vector<cc::scene::JointInfo>                                legacyJoints;
+    std::vector<std::array<float, cc::pipeline::UBOSkinning::COUNT>> legacyData;
+    cc::scene::AABB                                                  legacyBounds;
+
+    explicit Character(uint32_t seed) : jointBounds(JOINTS), rng(seed) {
+        std::uniform_real_distribution<float> unit(-1.0F, 1.0F);
+        for (uint32_t i = 0; i < JOINTS; ++i) {
+            std::uniform_int_distribution<int32_t> parent(-1, static_cast<int32_t>(i) - 1);
+            joints.emplace_back(new TestNode);
+            parents.push_back(i ? parent(rng) : -1);
+            cc::Mat4 bindpose;
+            cc::Mat4::fromRTS(cc::Quaternion(unit(rng), unit(rng), unit(rng), 1.0F).getNormalized(), {unit(rng), unit(rng), unit(rng)}, cc::Vec3::ONE, &bindpose);
+            bindposes.push_back(bindpose);
+            jointBounds[i].set({0.0F, 0.0F, 0.0F}, {0.1F, 0.1F, 0.1F});
+            move(i);
+        }
+
+        // what the JS side hands over: for each joint its node and the chain of its parents
+        std::vector<cc::scene::JointInfo> infos(JOINTS);
+        for (uint32_t i = 0; i < JOINTS; ++i) {
+            auto &info          = infos[i];
+            info.bound          = &jointBounds[i];
+            info.bindpose       = bindposes[i];
+            info.transform.node = &joints[i]->node;
+            for (int32_t p = parents[i]; p >= 0; p = parents[p]) {
+                info.parents.emplace_back();
+                info.parents.back().node = &joints[p]->node;
+            }
+            info.buffers = {i / JOINTS_PER_BUFFER};
+            info.indices = {i % JOINTS_PER_BUFFER};
+        }
+
+        std::vector<cc::gfx::Buffer *> jointBuffers;
+        for (uint32_t b = 0; b < (JOINTS - 1) / JOINTS_PER_BUFFER + 1; ++b) {
+            buffers.emplace_back(new RecordingBuffer);
+            buffers.back()->initialize({cc::gfx::BufferUsageBit::UNIFORM, cc::gfx::MemoryUsageBit::HOST | cc::gfx::MemoryUsageBit::DEVICE, cc::pipeline::UBOSkinning::SIZE});
+            jointBuffers.push_back(buffers.back().get());
+        }
+
+        root.layout.worldMatrix.setIdentity();
+        root.flags = static_cast<uint32_t>(cc::scene::TransformBit::TRS);
+        worldBounds.set({0.0F, 0.0F, 0.0F}, {1.0F, 1.0F, 1.0F});
+        model.setTransform(&root.node);
+        model.setBounds(&worldBounds);
+        model.setBuffers(std::move(jointBuffers));
+        legacyJoints = infos;
+        legacyData.resize(buffers.size());
+        model.setIndicesAndJoints({0}, std::move(infos));
+    }
+
+    void move(uint32_t i) {
+        std::uniform_real_distribution<float> unit(-1.0F, 1.0F);
+        std::uniform_real_distribution<float> scale(0.5F, 1.5F);
+        auto &                                layout = joints[i]->layout;
+        layout.localRotation.set(cc::Quaternion(unit(rng), unit(rng), unit(rng), 1.0F).getNormalized());
+        layout.localPosition.set(unit(rng), unit(rng), unit(rng));
+        layout.localScale.set(scale(rng), scale(rng), scale(rng));
+        joints[i]->flags = static_cast<uint32_t>(cc::scene::TransformBit::TRS);
+    }
+
+    void update(uint32_t stamp) {
+        model.updateTransform(stamp);
+        model.updateUBOs(stamp);
+        clearFlags();
+    }
+
+    // the JS side clears the changed flags at the end of every frame
+    void clearFlags() {
+        for (auto &joint : joints) {
+            joint->flags = 0;
+        }
+        root.flags = 0;
+    }
+
+    // SkinningModel::updateTransform and updateUBOs before the joints were flattened:
+    // every joint walks its own parent chain until a transform evaluated in this or the previous frame
+    void legacyUpdate(uint32_t stamp) {
+        cc::Vec3        v3Min{INFINITY, INFINITY, INFINITY};
+        cc::Vec3        v3Max{-INFINITY, -INFINITY, -INFINITY};
+        cc::scene::AABB ab1;
+        cc::Vec3        v31;
+        cc::Vec3        v32;
+        cc::Mat4        worldMatrix;
+        for (auto &info : legacyJoints) {
+            legacyWorldMatrix(&info, stamp, &worldMatrix);
+            info.bound->transform(worldMatrix, &ab1);
+            ab1.getBoundary(&v31, &v32);
+            cc::Vec3::min(v3Min, v31, &v3Min);
+            cc::Vec3::max(v3Max, v32, &v3Max);
+        }
+        cc::scene::AABB::fromPoints(v3Min, v3Max, &legacyBounds);
+
+        cc::Mat4 mat4;
+        for (const auto &info : legacyJoints) {
+            cc::Mat4::multiply(info.transform.world, info.bindpose, &mat4);
+            for (size_t b = 0; b < info.buffers.size(); ++b) {
+                float *dst = legacyData[info.buffers[b]].data() + info.indices[b] * FLOATS_PER_JOINT;
+                memcpy(dst, mat4.m, sizeof(float) * FLOATS_PER_JOINT);
+                dst[3]  = mat4.m[12];
+                dst[7]  = mat4.m[13];
+                dst[11] = mat4.m[14];
+            }
+        }
+        for (size_t b = 0; b < buffers.size(); ++b) {
+            buffers[b]->update(legacyData[b].data(), buffers[b]->getSize());
+        }
+    }
+
+    static void legacyWorldMatrix(cc::scene::JointInfo *info, uint32_t stamp, cc::Mat4 *worldMatrix) {
+        int i = -1;
+        worldMatrix->setIdentity();
+        auto *                                   currTransform = &info->transform;
+        auto                                     parentSize    = static_cast<int>(info->parents.size());
+        std::vector<cc::scene::JointTransform *> transStacks;
+        while (currTransform->node) {
+            if ((currTransform->stamp == static_cast<int>(stamp) || currTransform->stamp + 1 == static_cast<int>(stamp)) && !currTransform->node->getFlagsChanged()) {
+                worldMatrix->set(currTransform->world);
+                currTransform->stamp = static_cast<int>(stamp);
+                break;
+            }
+            currTransform->stamp = static_cast<int>(stamp);
+            transStacks.push_back(currTransform);
+            i++;
+            if (i >= parentSize) {
+                break;
+            }
+            currTransform = &info->parents[i];
+        }
+        while (i > -1) {
+            currTransform = transStacks[i--];
+            auto *node    = currTransform->node;
+            cc::Mat4::fromRTS(node->getRotation(), node->getPosition(), node->getScale(), &currTransform->local);
+            cc::Mat4::multiply(*worldMatrix, currTransform->local, &currTransform->world);
+            worldMatrix->set(currTransform->world);
+        }
+    }
+
+    // walks the parent chain of every joint from scratch
+    bool matchesChains() const {
+        for (uint32_t i = 0; i < JOINTS; ++i) {
+            cc::Mat4 world;
+            cc::Mat4 local;
+            for (int32_t j = static_cast<int32_t>(i); j >= 0; j = parents[j]) {
+                const auto &layout = joints[j]->layout;
+                cc::Mat4::fromRTS(layout.localRotation, layout.localPosition, layout.localScale, &local);
+                cc::Mat4::multiply(local, world, &world);
+            }
+            cc::Mat4 joint;
+            cc::Mat4::multiply(world, bindposes[i], &joint);
+
+            const float *data = buffers[i / JOINTS_PER_BUFFER]->data.data() + (i % JOINTS_PER_BUFFER) * FLOATS_PER_JOINT;
+            const float  expected[FLOATS_PER_JOINT]{joint.m[0], joint.m[1], joint.m[2], joint.m[12], joint.m[4], joint.m[5], joint.m[6], joint.m[13], joint.m[8], joint.m[9], joint.m[10], joint.m[14]};
+            for (uint32_t k = 0; k < FLOATS_PER_JOINT; ++k) {
+                // the chains are multiplied in another order, so allow for rounding
+                if (std::abs(data[k] - expected[k]) > 1e-4F * std::max(1.0F, std::abs(expected[k]))) return false;
+            }
+        }
+        return true;
+    }
+};
+} // namespace
+
+TEST(sceneSkinningTest, jointsMatchChains) {
+    logLabel = "test the skinning model uploads the same joints as walking every parent chain";
+    Character character(60);
+
+    uint32_t stamp = 1;
+    character.update(stamp);
+    ExpectEq(character.matchesChains(), true);
+
+    // only the joints that moved and their descendants are evaluated again
+    for (uint32_t frame = 0; frame < 10; ++frame) {
+        for (uint32_t i = frame % 7; i < JOINTS; i += 7) {
+            character.move(i);
+        }
+        character.update(++stamp);
+        ExpectEq(character.matchesChains(), true);
+    }
+    character.update(++stamp);
+    ExpectEq(character.matchesChains(), true);
+
+    // after a skipped frame the cached joints are not trusted anymore, changed flags may have been missed
+    character.move(0);
+    character.joints[0]->flags = 0;
+    stamp += 2;
+    character.update(stamp);
+    ExpectEq(character.matchesChains(), true);
+
+    // every frame uploads only the slots in use of each buffer
+    for (uint32_t b = 0; b < character.buffers.size(); ++b) {
+        const uint32_t slots = std::min(JOINTS - b * JOINTS_PER_BUFFER, JOINTS_PER_BUFFER);
+        ExpectEq(character.buffers[b]->data.size() == slots * FLOATS_PER_JOINT, true);
+        ExpectEq(character.buffers[b]->updateCount == 13, true);
+    }
+}
+
+TEST(sceneSkinningTest, jointUpdateBenchmark) {
+    logLabel = "test the skinning model update benchmark against the per-joint path";
+    constexpr uint32_t CHARACTERS = 100;
+    constexpr uint32_t FRAMES     = 100;
+
+    std::vector<std::unique_ptr<Character>> characters;
+    for (uint32_t i = 0; i < CHARACTERS; ++i) {
+        characters.emplace_back(new Character(i));
+    }
+
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    std::cout << "skinning " << CHARACTERS << " x " << JOINTS << " joints:";
+    uint32_t stamp = 0;
+    for (bool animated : {true, false}) {
+        double elapsed       = 0.0;
+        double legacyElapsed = 0.0;
+        for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+            ++stamp;
+            if (animated) {
+                for (auto &character : characters) {
+                    for (uint32_t i = 0; i < JOINTS; ++i) character->move(i);
+                }
+            }
+            // both paths see the same changed flags, they are cleared once both ran
+            const auto start = std::chrono::steady_clock::now();
+            for (auto &character : characters) {
+                character->model.updateTransform(stamp);
+                character->model.updateUBOs(stamp);
+            }
+            const auto legacyStart = std::chrono::steady_clock::now();
+            for (auto &character : characters) {
+                character->legacyUpdate(stamp);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            for (auto &character : characters) {
+                character->clearFlags();
+            }
+            elapsed += Microseconds(legacyStart - start).count();
+            legacyElapsed += Microseconds(end - legacyStart).count();
+        }
+        std::cout << (animated ? " all joints moving " : ", at rest ") << elapsed / FRAMES << "us (per-joint path " << legacyElapsed / FRAMES << "us)";
+    }
+    std::cout << std::endl;
+
+    // the per-joint path wrote last, it has to upload the same joints
+    ExpectEq(characters[0]->matchesChains(), true);
+}